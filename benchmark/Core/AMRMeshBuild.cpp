@@ -135,4 +135,70 @@ BENCHMARK(AMRMeshBuild3D)
         ->UseRealTime()
         ->Unit(benchmark::kSecond);
 
+static void AMRMeshBuild3DLarge(benchmark::State& state) {
+    using namespace OpFlow;
+    auto plan = getGlobalParallelPlan();
+    plan.shared_memory_workers_count = state.range(0);
+    setGlobalParallelPlan(plan);
+    for (auto _ : state) {
+        using Mesh = CartesianAMRMesh<Meta::int_<3>>;
+        constexpr int n = 129, maxlevel = 3, ratio = 2, buffWidth = 2;
+        constexpr auto h = 1. / (n - 1);
+        benchmark::DoNotOptimize(MeshBuilder<Mesh>()
+                                         .setBaseMesh(MeshBuilder<CartesianMesh<Meta::int_<3>>>()
+                                                              .newMesh(n, n, n)
+                                                              .setMeshOfDim(0, 0., 1.)
+                                                              .setMeshOfDim(1, 0., 1.)
+                                                              .setMeshOfDim(2, 0., 1.)
+                                                              .build())
+                                         .setRefinementRatio(ratio)
+                                         .setFillRateThreshold(0.8)
+                                         .setSlimThreshold(buffWidth)
+                                         .setBuffWidth(buffWidth)
+                                         .setMaxLevel(maxlevel)
+                                         .setMarkerFunction([&](auto&& i) {
+                                             // a thin spherical shell, i.e., a level-set interface
+                                             double ht = h / Math::int_pow(ratio, i.l);
+                                             double x = ht * (i[0] + 0.5) - 0.5, y = ht * (i[1] + 0.5) - 0.5,
+                                                    z = ht * (i[2] + 0.5) - 0.45;
+                                             double r = std::sqrt(x * x + y * y + z * z);
+                                             return std::abs(r - 0.3) < 2 * ht;
+                                         })
+                                         .build());
+    }
+}
+
+BENCHMARK(AMRMeshBuild3DLarge)
+        ->RangeMultiplier(2)
+        ->Range(1, omp_get_max_threads())
+        ->UseRealTime()
+        ->Unit(benchmark::kSecond);
+
+static void AMRBoxGen3D(benchmark::State& state) {
+    using namespace OpFlow;
+    auto plan = getGlobalParallelPlan();
+    plan.shared_memory_workers_count = state.range(0);
+    setGlobalParallelPlan(plan);
+    // about 2.1 million tagged cells on a shell of width 4 in a 512^3 index space
+    constexpr int n = 512;
+    std::vector<DS::Point<int, 3>> points;
+    for (auto i = 0; i < n; ++i)
+        for (auto j = 0; j < n; ++j)
+            for (auto k = 0; k < n; ++k) {
+                double x = i - n / 2 + 0.5, y = j - n / 2 + 0.5, z = k - n / 2 + 0.5;
+                if (std::abs(std::sqrt(x * x + y * y + z * z) - 0.4 * n) < 2) points.emplace_back(i, j, k);
+            }
+    for (auto _ : state) {
+        AMRTagMap<3> tags(points);
+        benchmark::DoNotOptimize(domainPartition(tags, 0.8, 2));
+    }
+    state.counters["tags"] = points.size();
+}
+
+BENCHMARK(AMRBoxGen3D)
+        ->RangeMultiplier(2)
+        ->Range(1, omp_get_max_threads())
+        ->UseRealTime()
+        ->Unit(benchmark::kMillisecond);
+
 BENCHMARK_MAIN();
\ No newline at end of file
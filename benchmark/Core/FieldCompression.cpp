@@ -0,0 +1,106 @@
+//  ----------------------------------------------------------------------------
+//
+//  Copyright (c) 2019 - 2026  by the OpFlow developers
+//
+//  This file is part of OpFlow.
+//
+//  OpFlow is free software and is distributed under the MPL v2.0 license.
+//  The full text of the license can be found in the file LICENSE at the top
+//  level directory of OpFlow.
+//
+//  ----------------------------------------------------------------------------
+
+#include <OpFlow>
+#include <benchmark/benchmark.h>
+
+using Mesh = OpFlow::CartesianMesh<OpFlow::Meta::int_<3>>;
+using Field = OpFlow::CartesianField<OpFlow::Real, Mesh>;
+
+static auto makeField(int n) {
+    using namespace OpFlow;
+    auto m = MeshBuilder<Mesh>()
+                     .newMesh(n, n, n)
+                     .setMeshOfDim(0, 0., 1.)
+                     .setMeshOfDim(1, 0., 1.)
+                     .setMeshOfDim(2, 0., 1.)
+                     .build();
+    auto u = ExprBuilder<Field>().setName("u").setMesh(m).setLoc(LocOnMesh::Center).build();
+    u.initBy([](auto&& x) { return std::sin(6 * x[0]) * std::cos(4 * x[1]) + std::exp(-x[2]); });
+    return u;
+}
+
+static void FieldWrite_Raw(benchmark::State& state) {
+    using namespace OpFlow;
+    auto u = makeField(state.range(0));
+    Utils::RawBinaryOStream stream("./");
+    for (auto _ : state) {
+        stream.setCounterTo(0);
+        stream << u;
+    }
+    state.SetBytesProcessed(state.iterations() * u.localRange.count() * sizeof(Real));
+    state.counters["ratio"] = 1.;
+}
+
+static void FieldWrite_Lossless(benchmark::State& state) {
+    using namespace OpFlow;
+    auto u = makeField(state.range(0));
+    Utils::CompressedStream stream("./u.opz");
+    for (auto _ : state) stream << Utils::TimeStamp(0.) << u;
+    state.SetBytesProcessed(state.iterations() * u.localRange.count() * sizeof(Real));
+    state.counters["ratio"] = stream.getCompressionRatio();
+}
+
+static void FieldWrite_ErrorBounded(benchmark::State& state) {
+    using namespace OpFlow;
+    auto u = makeField(state.range(0));
+    Utils::CompressedStream stream("./u.opz");
+    stream.setTolerance(std::pow(10., -state.range(1)));
+    for (auto _ : state) stream << Utils::TimeStamp(0.) << u;
+    state.SetBytesProcessed(state.iterations() * u.localRange.count() * sizeof(Real));
+    state.counters["ratio"] = stream.getCompressionRatio();
+}
+
+static void FieldRead_Raw(benchmark::State& state) {
+    using namespace OpFlow;
+    auto u = makeField(state.range(0));
+    {
+        Utils::RawBinaryOStream stream("./");
+        stream << u;
+    }
+    Utils::RawBinaryIStream stream("./");
+    for (auto _ : state) {
+        stream.setCounterTo(0);
+        stream >> u;
+    }
+    state.SetBytesProcessed(state.iterations() * u.localRange.count() * sizeof(Real));
+}
+
+static void FieldRead_ErrorBounded(benchmark::State& state) {
+    using namespace OpFlow;
+    auto u = makeField(state.range(0));
+    {
+        Utils::CompressedStream stream("./u.opz");
+        stream.setTolerance(std::pow(10., -state.range(1)));
+        stream << Utils::TimeStamp(0.) << u;
+    }
+    Utils::CompressedStream stream("./u.opz", StreamIn);
+    for (auto _ : state) stream.moveToTime(Utils::TimeStamp(0.)) >> u;
+    state.SetBytesProcessed(state.iterations() * u.localRange.count() * sizeof(Real));
+}
+
+static void FieldIO_Params(benchmark::internal::Benchmark* b) {
+    for (auto n = 64; n <= 256; n *= 2) b->Args({n + 1, 4});
+}
+
+static void FieldIO_Tolerance_Params(benchmark::internal::Benchmark* b) {
+    for (auto n = 64; n <= 256; n *= 2)
+        for (auto tol = 2; tol <= 6; tol += 2) b->Args({n + 1, tol});
+}
+
+BENCHMARK(FieldWrite_Raw)->Apply(FieldIO_Params)->UseRealTime();
+BENCHMARK(FieldWrite_Lossless)->Apply(FieldIO_Params)->UseRealTime();
+BENCHMARK(FieldWrite_ErrorBounded)->Apply(FieldIO_Tolerance_Params)->UseRealTime();
+BENCHMARK(FieldRead_Raw)->Apply(FieldIO_Params)->UseRealTime();
+BENCHMARK(FieldRead_ErrorBounded)->Apply(FieldIO_Tolerance_Params)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,59 @@
+//  ----------------------------------------------------------------------------
+//
+//  Copyright (c) 2019 - 2026 by the OpFlow developers
+//
+//  This file is part of OpFlow.
+//
+//  OpFlow is free software and is distributed under the MPL v2.0 license.
+//  The full text of the license can be found in the file LICENSE at the top
+//  level directory of OpFlow.
+//
+//  ----------------------------------------------------------------------------
+
+#include <OpFlow>
+#include <benchmark/benchmark.h>
+
+// explicit diffusion step of a field stored in precision D, with the coefficients in double
+template <typename D>
+static void Diffusion_3d(benchmark::State& state) {
+    using namespace OpFlow;
+
+    using Mesh = CartesianMesh<Meta::int_<3>>;
+    using Field = CartesianField<D, Mesh>;
+
+    auto n = state.range(0);
+    auto m = MeshBuilder<Mesh>()
+                     .newMesh(n, n, n)
+                     .setMeshOfDim(0, 0., 1.)
+                     .setMeshOfDim(1, 0., 1.)
+                     .setMeshOfDim(2, 0., 1.)
+                     .build();
+    auto u = ExprBuilder<Field>()
+                     .setMesh(m)
+                     .setLoc(LocOnMesh::Center)
+                     .setBC(0, DimPos::start, BCType::Periodic)
+                     .setBC(0, DimPos::end, BCType::Periodic)
+                     .setBC(1, DimPos::start, BCType::Periodic)
+                     .setBC(1, DimPos::end, BCType::Periodic)
+                     .setBC(2, DimPos::start, BCType::Periodic)
+                     .setBC(2, DimPos::end, BCType::Periodic)
+                     .setExt(1)
+                     .build();
+    u.initBy([](auto&& x) { return std::sin(2 * PI * x[0]) * std::sin(2 * PI * x[1]) * x[2]; });
+    auto v = u;
+
+    const double dt = 1e-6;
+    for (auto _ : state) {
+        // two steps per iteration, ping-ponging between u & v
+        v = u + dt * (d2x<D2SecondOrderCentered>(u) + d2y<D2SecondOrderCentered>(u)
+                      + d2z<D2SecondOrderCentered>(u));
+        u = v + dt * (d2x<D2SecondOrderCentered>(v) + d2y<D2SecondOrderCentered>(v)
+                      + d2z<D2SecondOrderCentered>(v));
+    }
+    state.SetBytesProcessed(state.iterations() * 4 * sizeof(D) * u.localRange.count());
+}
+
+BENCHMARK_TEMPLATE(Diffusion_3d, float)->RangeMultiplier(2)->Range(64, 256)->UseRealTime();
+BENCHMARK_TEMPLATE(Diffusion_3d, double)->RangeMultiplier(2)->Range(64, 256)->UseRealTime();
+
+BENCHMARK_MAIN();
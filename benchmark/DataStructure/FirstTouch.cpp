@@ -0,0 +1,56 @@
+//  ----------------------------------------------------------------------------
+//
+//  Copyright (c) 2019 - 2026 by the OpFlow developers
+//
+//  This file is part of OpFlow.
+//
+//  OpFlow is free software and is distributed under the MPL v2.0 license.
+//  The full text of the license can be found in the file LICENSE at the top
+//  level directory of OpFlow.
+//
+//  ----------------------------------------------------------------------------
+
+#include <OpFlow>
+#include <benchmark/benchmark.h>
+
+// STREAM triad a = b + s * c over tensors allocated with (arg 1 = 1) or without first touch placement
+static void Triad3D(benchmark::State& state) {
+    using namespace OpFlow;
+    auto plan = getGlobalParallelPlan();
+    plan.shared_memory_workers_count = state.range(0);
+    plan.first_touch = state.range(1);
+    setGlobalParallelPlan(plan);
+
+    constexpr int n = 256;
+    DS::PlainTensor<double, 3> a(n, n, n), b(n, n, n), c(n, n, n);
+    DS::Range<3> range {std::array {n, n, n}};
+    if (plan.first_touch) {
+        // the pages are placed by the parallel fill of the constructors already
+        rangeFor(range, [&](auto&& i) {
+            b[i] = 1.;
+            c[i] = 2.;
+        });
+    } else {
+        // a serial fill places all pages on the node of the calling thread, as plain allocations do
+        a.setZero();
+        b.setConstant(1.);
+        c.setConstant(2.);
+    }
+    const double s = 3.;
+    for (auto _ : state) {
+        rangeFor(range, [&](auto&& i) { a[i] = b[i] + s * c[i]; });
+        benchmark::DoNotOptimize(a.raw());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * 3 * sizeof(double) * range.count());
+
+    plan.first_touch = false;
+    setGlobalParallelPlan(plan);
+}
+
+BENCHMARK(Triad3D)
+        ->ArgsProduct({benchmark::CreateRange(1, omp_get_max_threads(), 2), {0, 1}})
+        ->UseRealTime()
+        ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -46,7 +46,7 @@ int main(int argc, char* argv[]) {
             amgcl::mpi::solver::bicgstab<DBackend>>
             Solver;
     {
-        auto ass_splitMap = u.splitMap;
+        auto ass_splitMap = u.getSplitMap();
         for (auto& r : ass_splitMap) { r = DS::commonRange(r, u.assignableRange); }
 
         IJSolverParams<Solver> p;
@@ -57,11 +57,25 @@ def gen_expression_hpp(n=20):
 #include "Core/Expr/Expr.hpp"
 #include "Core/Expr/ExprTrait.hpp"
 #include "Core/Operator/Operator.hpp"
+#include <algorithm>
+#include <initializer_list>
 
 namespace OpFlow {
     template <typename Op, ExprType... Args>
     struct Expression;
 
+    namespace internal {
+        /// \\brief Read width of an expr of \\p Op given the read widths of its args, see Expr::readWidth
+        template <typename Op>
+        int composeReadWidth(std::initializer_list<int> args) {
+            auto w = std::max(args);
+            if (w < 0 || w == unknown_read_width) return w;
+            if constexpr (requires { Op::bc_width; }) return w + Op::bc_width;
+            else
+                return unknown_read_width;
+        }
+    }// namespace internal
+
     template <typename Op>
     requires(!ExprType<Op>) struct Expression<Op> : ResultType<Op>::type {
         friend Expr<Expression<Op>>;
@@ -114,6 +128,10 @@ namespace OpFlow {
 
         bool containsImpl_final(const auto& t) const { return arg1.contains(t); }
 
+        int readWidthImpl_final(const auto& t) const {
+            return internal::composeReadWidth<Op>({arg1.readWidth(t)});
+        }
+
         DEFINE_EVAL_OPS(arg1)
     public:
         typename internal::ExprProxy<Arg>::type arg1;
@@ -137,6 +155,10 @@ struct Expression<Op, {}> : ResultType<Op, {}>::type {{
         bool containsImpl_final(const auto& t) const {{
             return {};
         }}
+
+        int readWidthImpl_final(const auto& t) const {{
+            return internal::composeReadWidth<Op>({{{}}});
+        }}
         
         DEFINE_EVAL_OPS({})
     public:
@@ -156,6 +178,7 @@ struct Expression<Op, {}> : ResultType<Op, {}>::type {{
                 concat_repeat(lambda j: "arg{}(e.arg{})".format(j, j), ",", 1, i),
                 concat_repeat(lambda j: "arg{}.prepare();".format(j), "\n", 1, i),
                 concat_repeat(lambda j: "arg{}.contains(t)".format(j), "||", 1, i),
+                concat_repeat(lambda j: "arg{}.readWidth(t)".format(j), ",", 1, i),
                 concat_repeat(lambda j: "arg{}".format(j), ",", 1, i),
                 concat_repeat(lambda j: "typename internal::ExprProxy<Arg{}>::type arg{};".format(j, j), "\n", 1, i)
             ))
@@ -13,330 +13,358 @@
 #ifndef OPFLOW_AMRGEN_HPP
 #define OPFLOW_AMRGEN_HPP
 
+#include "Core/Environment.hpp"
 #include "Core/Loops/RangeFor.hpp"
-#include "Core/Meta.hpp"
-#include "DataStructures/Arrays/OffsetVector.hpp"
+#include "Core/Macros.hpp"
 #include "DataStructures/Geometry/BasicElements.hpp"
-#include "DataStructures/Geometry/KdTree.hpp"
 #include "DataStructures/Range/Ranges.hpp"
 #ifndef OPFLOW_INSIDE_MODULE
 #include <algorithm>
-#include <deque>
-#include <vtkPoints.h>
-#include <vtkPolyData.h>
-#include <vtkXMLPolyDataWriter.h>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <optional>
+#include <tbb/tbb.h>
+#include <vector>
 #endif
 
 OPFLOW_MODULE_EXPORT namespace OpFlow {
-    inline auto int_pow(int a, int n) {
-        auto ret = 1;
-        for (auto i = 0; i < n; ++i) ret *= a;
-        return ret;
-    }
+    /// \brief Flat bitmap of the tagged cells within their bounding box
+    /// \details The last dimension varies fastest and each row along it is padded to whole words,
+    /// so that counts & signatures of a box are histogram reductions over rows using popcount
+    /// rather than traversals of a point tree.
+    /// \tparam d Dimension
+    template <std::size_t d>
+    struct AMRTagMap {
+        using Box = DS::Box<int, d>;
+        using Signature = std::array<std::vector<int>, d>;
 
-    auto getFillRate(const auto &marker, const auto &box) {
-        constexpr static auto dim = Meta::RealType<decltype(box)>::dim;
-        auto total = 1;
-        for (auto i = 0; i < dim; ++i) { total *= (box.hi[i] - box.lo[i] + 1); }
-        auto count = marker.countInBox(box);
-        return (double) count / total;
-    }
+        AMRTagMap() = default;
+        explicit AMRTagMap(const auto& points) { build(points); }
 
-    auto domainPartition(const auto &marker, double fr_threshold, int slim_threshold = 3) {
-        constexpr auto dim = Meta::RealType<decltype(marker)>::dim;
-        std::deque<DS::Box<int, dim>> queue;
-        // find the global AABB and push it into queue
-        queue.push_back(marker.boundingBox());
-        // the result vector
-        std::vector<DS::Box<int, dim>> ret;
-        // start the main loop
-        while (!queue.empty()) {
-            auto box = queue.front();
-            queue.pop_front();
-            auto fillRate = getFillRate(marker, box);
-            // if the box is empty, continue
-            if (fillRate == 0) continue;
-            if (fillRate >= fr_threshold) {
-                // take the box
-                ret.push_back(box);
-                goto next_cycle;
-            } else {
-                // calculate the signature
-                // init arrays
-                std::array<DS::OffsetVector<int>, dim> sigs;
-                for (auto i = 0; i < dim; ++i) {
-                    sigs[i].resize(box.hi[i] - box.lo[i] + 1);
-                    sigs[i].setConstant(0);
-                    sigs[i].setOffset(box.lo[i]);
-                }
-                // traverse all the points & accumulate sigs
-                marker.traverseInBox(box, [&](auto &&p) {
-                    for (auto i = 0; i < dim; ++i) { sigs[i][p[i]]++; }
-                });
-                // find all continues non-zero intervals in sigs
-                std::array<std::vector<int>, dim> split_points;
-                for (auto i = 0; i < dim; ++i) {
-                    const auto begin = sigs[i].begin();
-                    const auto end = sigs[i].end();
-                    auto p1 = begin;
-                    while (p1 != end) {
-                        // move p1 to the next non-zero interval's begin
-                        while (p1 != end && *p1 == 0) ++p1;
-                        if (p1 == end) break;
-                        split_points[i].push_back(p1 - begin + sigs[i].getOffset());
-                        // move p2 to the end of the current interval
-                        auto p2 = p1;
-                        while (p2 != end && *p2 != 0) ++p2;
-                        // whether p2 equals end doesn't matter, just push the end
-                        split_points[i].push_back(p2 - begin + sigs[i].getOffset() - 1);
-                        // step p1 to p2, go to next loop
-                        p1 = p2;
-                    }
-                }
-                // check if the current box needs to be split or shrink
-                bool split_or_shrink = false;
-                for (auto i = 0; i < dim; ++i) {
-                    if (split_points[i].size() > 2
-                        || (split_points[i][0] > sigs[i].getOffset()
-                            || split_points[i][1] < sigs[i].getOffset() + sigs[i].size() - 1))
-                        split_or_shrink = true;
+        /// \brief Build the bitmap from a list of tagged cells
+        /// \param points Tagged cells. Duplicates are allowed
+        void build(const auto& points) {
+            words.clear();
+            tagCount = 0;
+            if (points.empty()) return;
+            bbox.lo = bbox.hi = points[0].cord;
+            for (const auto& p : points) {
+                for (auto i = 0; i < d; ++i) {
+                    bbox.lo[i] = std::min(bbox.lo[i], p[i]);
+                    bbox.hi[i] = std::max(bbox.hi[i], p[i]);
                 }
-                if (split_or_shrink) {
-                    // construct all the possible compact boxes
-                    DS::Range<dim> range;
-                    for (auto i = 0; i < dim; ++i) {
-                        range.start[i] = 0;
-                        range.end[i] = split_points[i].size() / 2;
+            }
+            rowWords = (extent(d - 1) + 63) / 64;
+            rowCount = 1;
+            for (auto i = 0; i < d - 1; ++i) rowCount *= extent(i);
+            words.assign(rowCount * rowWords, 0);
+            tbb::task_arena arena(getGlobalParallelPlan().shared_memory_workers_count);
+            arena.execute([&]() {
+                tbb::parallel_for(tbb::blocked_range<std::size_t>(0, points.size()), [&](const auto& r) {
+                    for (auto k = r.begin(); k != r.end(); ++k) {
+                        const auto& p = points[k];
+                        auto bit = p[d - 1] - bbox.lo[d - 1];
+                        std::atomic_ref<std::uint64_t> w(words[rowOf(p.cord) * rowWords + bit / 64]);
+                        w.fetch_or(std::uint64_t(1) << (bit % 64), std::memory_order_relaxed);
                     }
-                    range.reValidPace();
-                    rangeFor_s(range, [&](auto &&idx) {
-                        // construct box
-                        DS::Box<int, dim> t;
-                        for (auto i = 0; i < dim; ++i) {
-                            t.lo[i] = split_points[i][idx[i] * 2];
-                            t.hi[i] = split_points[i][idx[i] * 2 + 1];
-                        }
-                        queue.push_back(t);
+                });
+            });
+            tagCount = count(bbox);
+        }
+
+        [[nodiscard]] bool empty() const { return tagCount == 0; }
+        [[nodiscard]] const auto& boundingBox() const { return bbox; }
+
+        /// \brief Number of tagged cells in \p box
+        long long count(const Box& box) const {
+            auto b = clip(box);
+            if (!b) return 0;
+            return reduceRows(*b, 0ll, [&](long long row, const auto&, long long acc) {
+                return acc + rowPopCount(row, b->lo[d - 1], b->hi[d - 1]);
+            }, std::plus<> {});
+        }
+
+        /// \brief Number of tagged cells on each slice of \p box, in each dimension
+        /// \return sig[i][j] is the count on the slice at index box.lo[i] + j in dim i
+        Signature signatures(const Box& box) const {
+            Signature ret;
+            for (auto i = 0; i < d; ++i) ret[i].assign(box.hi[i] - box.lo[i] + 1, 0);
+            auto b = clip(box);
+            if (!b) return ret;
+            return reduceRows(
+                    *b, ret,
+                    [&](long long row, const std::array<int, d>& idx, Signature acc) {
+                        auto c = rowPopCount(row, b->lo[d - 1], b->hi[d - 1]);
+                        if (c == 0) return acc;
+                        for (auto i = 0; i < d - 1; ++i) acc[i][idx[i] - box.lo[i]] += c;
+                        forEachBitInRow(row, b->lo[d - 1], b->hi[d - 1],
+                                        [&](int j) { acc[d - 1][j - box.lo[d - 1]]++; });
+                        return acc;
+                    },
+                    [](Signature a, const Signature& b) {
+                        for (auto i = 0; i < d; ++i)
+                            for (auto j = 0; j < a[i].size(); ++j) a[i][j] += b[i][j];
+                        return a;
                     });
-                    goto next_cycle;
-                } else {
-                    // the current box is already compact.
-                    // we first deal with some corner cases
-                    // case 1: the box is sufficient slim in one dim
-                    std::array<bool, dim> slim_in_dim;
-                    bool all_slim = true;
-                    for (auto i = 0; i < dim; ++i) {
-                        // 1, 2, 3 points thick are considered slim
-                        slim_in_dim[i] = box.hi[i] - box.lo[i] < slim_threshold;
-                        all_slim &= slim_in_dim[i];
-                    }
-                    // if the box is slim in all dims, accept it
-                    if (all_slim) {
-                        ret.push_back(box);
-                        goto next_cycle;
-                    }
-                    // find the edge to split
-                    // calculate the lap of sig
-                    std::array<DS::OffsetVector<int>, dim> laps = sigs;
-                    for (auto i = 0; i < dim; ++i) {
-                        // for slim dims, we won't split
-                        if (slim_in_dim[i]) continue;
-                        for (auto j = laps[i].getOffset() + 1; j < laps[i].getOffset() + laps[i].size() - 1;
-                             ++j) {
-                            laps[i][j] = (sigs[i][j - 1] - 2 * sigs[i][j] + sigs[i][j + 1]);
-                        }
-                    }
-                    // find all the sign-change points of lap
-                    std::array<std::vector<int>, dim> zero_points;
-                    std::array<int, dim> max_jumps;
-                    max_jumps.fill(0);
-                    for (auto i = 0; i < dim; ++i) {
-                        for (auto j = box.lo[i] + 1; j <= box.hi[i] - 2; ++j) {
-                            if ((laps[i][j] <= 0 && laps[i][j + 1] >= 0)
-                                || (laps[i][j] >= 0 && laps[i][j + 1] <= 0)) {
-                                // always take the max jump
-                                if (std::abs(laps[i][j] - laps[i][j + 1]) > max_jumps[i]) {
-                                    // clear the existing list and take the new one
-                                    max_jumps[i] = std::abs(laps[i][j] - laps[i][j + 1]);
-                                    zero_points[i].clear();
-                                    zero_points[i].push_back(j);
-                                } else if (std::abs(laps[i][j] - laps[i][j + 1]) == max_jumps[i]) {
-                                    // append the current point
-                                    zero_points[i].push_back(j);
-                                }
-                            }
-                        }
-                    }
-                    std::array<int, dim> final_splits;
-                    for (auto i = 0; i < dim; ++i) {
-                        final_splits[i] = box.lo[i] - 1;
-                        // take the most center split point
-                        if (zero_points[i].size() == 0) continue;
-                        else if (zero_points[i].size() == 1)
-                            final_splits[i] = zero_points[i][0];
-                        else {
-                            auto median = (box.hi[i] + box.lo[i]) / 2;
-                            final_splits[i] = zero_points[i][0];
-                            for (auto &p : zero_points[i]) {
-                                if (std::abs(final_splits[i] - median) > std::abs(p - median))
-                                    final_splits[i] = p;
-                            }
-                        }
-                    }
-                    // sort the dims according to the max jumps. the dim with the max jumps
-                    // is preferred for split
-                    std::array<int, dim> split_priority;
-                    for (auto i = 0; i < dim; ++i) split_priority[i] = i;
-                    std::sort(split_priority.begin(), split_priority.end(),
-                              [&](auto a, auto b) { return max_jumps[a] > max_jumps[b]; });
-                    // try split the box according to the priority dims
-                    for (auto i : split_priority) {
-                        if (zero_points[i].size() > 0) {
-                            // if the split won't generate slim boxes
-                            if (final_splits[i] - box.lo[i] + 1 > slim_threshold
-                                && box.hi[i] - final_splits[i] + 1 > slim_threshold) {
-                                // do the split
-                                auto box1 = box, box2 = box;
-                                box1.hi[i] = final_splits[i];
-                                box2.lo[i] = final_splits[i] + 1;
-                                queue.push_back(box1);
-                                queue.push_back(box2);
-                                goto next_cycle;
-                            } else {
-                                // the split will make slim boxes, take the next dim for test
-                                continue;
-                            }
-                        }
-                    }
+        }
 
-                    // if could reach here, any of the split plan will make slim boxes
-                    // or they can't make slice at all. we then bisect along the longest dim
-                    auto longest_dim = 0, length = 0;
-                    for (auto i = 0; i < dim; ++i) {
-                        if (box.hi[i] - box.lo[i] + 1 > length) {
-                            length = box.hi[i] - box.lo[i] + 1;
-                            longest_dim = i;
-                        }
-                    }
-                    // bisect the box
-                    auto box1 = box, box2 = box;
-                    box1.hi[longest_dim] = (box.lo[longest_dim] + box.hi[longest_dim]) / 2;
-                    box2.lo[longest_dim] = box1.hi[longest_dim] + 1;
-                    queue.push_back(box1);
-                    queue.push_back(box2);
-                    goto next_cycle;
-                }
+        /// \brief The bounding box of the tagged cells in \p box
+        /// \return std::nullopt if there is no tagged cell in \p box
+        std::optional<Box> shrink(const Box& box) const {
+            auto sigs = signatures(box);
+            Box ret = box;
+            for (auto i = 0; i < d; ++i) {
+                auto first = std::find_if(sigs[i].begin(), sigs[i].end(), [](int c) { return c > 0; });
+                if (first == sigs[i].end()) return std::nullopt;
+                auto last = std::find_if(sigs[i].rbegin(), sigs[i].rend(), [](int c) { return c > 0; });
+                ret.lo[i] = box.lo[i] + (first - sigs[i].begin());
+                ret.hi[i] = box.lo[i] + (sigs[i].rend() - last) - 1;
             }
-        next_cycle:
-            continue;
+            return ret;
         }
-        // return all the generated boxes
-        return ret;
-    }
-
-    void dump_points(auto &points, double h, const std::string &fname) {
-        vtkNew<vtkPoints> vtkp;
-        for (auto &p : points) { vtkp->InsertNextPoint((p[0] + 0.5) * h, (p[1] + 0.5) * h, 0); }
-        vtkNew<vtkPolyData> polydata;
-        polydata->SetPoints(vtkp);
 
-        vtkNew<vtkXMLPolyDataWriter> writer;
-        writer->SetFileName(fname.c_str());
-        writer->SetInputData(polydata);
-        writer->Write();
-    }
+    private:
+        [[nodiscard]] int extent(int i) const { return bbox.hi[i] - bbox.lo[i] + 1; }
 
-    auto init_grid(auto &stack, int max_level, int buff_width, double th, auto &&func) {
-        const auto &baseMesh = stack.levels.front().zones.front().baseMesh;
-        constexpr static auto dim = Meta::RealType<decltype(baseMesh)>::dim;
-        auto ratio = stack.ratio;
-        for (auto level = max_level - 1; level >= 0; --level) {
-            auto currentDims = baseMesh.dims;
-            auto currentOffsets = baseMesh.offsets;
-            // we fix the (0, 0, ...) index and scale the existing range
-            for (auto i = 0; i < dim; ++i) {
-                currentOffsets[i] *= int_pow(ratio, level);
-                currentDims[i] = (currentDims[i] - 1) * int_pow(ratio, level);
+        std::optional<Box> clip(const Box& box) const {
+            if (words.empty()) return std::nullopt;
+            Box ret;
+            for (auto i = 0; i < d; ++i) {
+                ret.lo[i] = std::max(box.lo[i], bbox.lo[i]);
+                ret.hi[i] = std::min(box.hi[i], bbox.hi[i]);
+                if (ret.lo[i] > ret.hi[i]) return std::nullopt;
             }
-            using Point = DS::Point<int, dim>;
-            std::vector<Point> points;
-            DS::Range<dim> range;// cell centered range
-            for (auto i = 0; i < dim; ++i) {
-                range.start[i] = currentOffsets[i];
-                range.end[i] = currentOffsets[i] + currentDims[i] - 1;
+            return ret;
+        }
+
+        long long rowOf(const std::array<int, d>& p) const {
+            long long ret = 0;
+            for (auto i = 0; i < d - 1; ++i) ret = ret * extent(i) + (p[i] - bbox.lo[i]);
+            return ret;
+        }
+
+        // visit the words of a row covering [lo, hi] with the bits outside masked out
+        void forEachWordInRow(long long row, int lo, int hi, auto&& func) const {
+            auto b0 = lo - bbox.lo[d - 1], b1 = hi - bbox.lo[d - 1];
+            const auto* w = words.data() + row * rowWords;
+            for (auto k = b0 / 64; k <= b1 / 64; ++k) {
+                auto word = w[k];
+                if (k == b0 / 64) word &= ~std::uint64_t(0) << (b0 % 64);
+                if (k == b1 / 64 && b1 % 64 != 63) word &= (std::uint64_t(1) << (b1 % 64 + 1)) - 1;
+                func(k, word);
             }
-            // label all the necessary cells on the current level
-            rangeFor_s(range, [&](auto &&i) {
-                if (func(level, i)) points.template emplace_back(i.get());
+        }
+
+        int rowPopCount(long long row, int lo, int hi) const {
+            int ret = 0;
+            forEachWordInRow(row, lo, hi, [&](int, std::uint64_t w) { ret += std::popcount(w); });
+            return ret;
+        }
+
+        void forEachBitInRow(long long row, int lo, int hi, auto&& func) const {
+            forEachWordInRow(row, lo, hi, [&](int k, std::uint64_t w) {
+                while (w) {
+                    func(bbox.lo[d - 1] + k * 64 + std::countr_zero(w));
+                    w &= w - 1;
+                }
             });
-#ifndef NDEBUG
-            OP_DEBUG("Points at level {}:", level);
-            for (const auto &p : points) { OP_DEBUG("{}", p.toString()); }
-#endif
+        }
 
-#ifndef NDEBUG
-            std::vector<Point> p_add;
-#endif
-            // label all the points under level + 1
-            if (level < max_level - 1) {
-                for (auto &z : (std::next(stack.levels.begin()))->zones) {
-                    auto _range = z.baseMesh.range;
-                    // convert level l + 1 's range to level l - 1 's range
-                    for (auto i = 0; i < dim; ++i) {
-                        _range.start[i] = (_range.start[i] - buff_width * ratio) / (ratio * ratio);
-                        _range.end[i] = (_range.end[i] + buff_width * ratio - 1 + ratio * ratio - 1)
-                                        / (ratio * ratio);
+        // reduce over all rows of a (clipped) box. large boxes are reduced in parallel
+        template <typename T>
+        T reduceRows(const Box& b, T init, auto&& body, auto&& join) const {
+            if constexpr (d == 1) {
+                std::array<int, d> idx {b.lo[0]};
+                return body(0, idx, std::move(init));
+            } else {
+                DS::Range<d - 1> rows;
+                for (auto i = 0; i < d - 1; ++i) {
+                    rows.start[i] = b.lo[i];
+                    rows.end[i] = b.hi[i] + 1;
+                }
+                rows.reValidPace();
+                auto row_body = [&](const DS::Range<d - 1>& r, T acc) {
+                    rangeFor_s(r, [&](auto&& i) {
+                        std::array<int, d> idx;
+                        for (auto k = 0; k < d - 1; ++k) idx[k] = i[k];
+                        idx[d - 1] = b.lo[d - 1];
+                        acc = body(rowOf(idx), idx, std::move(acc));
+                    });
+                    return acc;
+                };
+                if (rows.count() < parallel_row_threshold) return row_body(rows, std::move(init));
+                T ret;
+                tbb::task_arena arena(getGlobalParallelPlan().shared_memory_workers_count);
+                arena.execute([&]() {
+                    ret = tbb::parallel_reduce(rows, init, row_body,
+                                               [&](T a, const T& c) { return join(std::move(a), c); });
+                });
+                return ret;
+            }
+        }
+
+        static constexpr long long parallel_row_threshold = 1024;
+        Box bbox {};
+        int rowWords = 0;
+        long long rowCount = 0, tagCount = 0;
+        std::vector<std::uint64_t> words;
+    };
+
+    /// \brief Berger-Rigoutsos style clustering of the tagged cells into boxes
+    /// \details Candidate boxes are independent of each other, hence are processed concurrently
+    /// with a work-feeding parallel loop. Each box's fill rate & signatures come from one histogram
+    /// reduction over the tag bitmap. The result is sorted to be independent of the scheduling.
+    /// \param tags The tagged cells
+    /// \param fr_threshold Min fill rate of an accepted box
+    /// \param slim_threshold Boxes are not split into pieces thinner than this width
+    /// \return Disjoint boxes covering all the tagged cells
+    template <std::size_t d>
+    auto domainPartition(const AMRTagMap<d>& tags, double fr_threshold, int slim_threshold = 3) {
+        using Box = DS::Box<int, d>;
+        tbb::concurrent_vector<Box> accepted;
+        auto process = [&](const Box& box, auto&& push) {
+            auto sigs = tags.signatures(box);
+            long long total = 1, count = 0;
+            for (auto i = 0; i < d; ++i) total *= (box.hi[i] - box.lo[i] + 1);
+            for (auto c : sigs[0]) count += c;
+            // if the box is empty, drop it
+            if (count == 0) return;
+            if ((double) count / total >= fr_threshold) {
+                accepted.push_back(box);
+                return;
+            }
+            // find all continues non-zero intervals in sigs
+            std::array<std::vector<int>, d> split_points;
+            for (auto i = 0; i < d; ++i) {
+                auto p1 = 0, size = (int) sigs[i].size();
+                while (p1 != size) {
+                    while (p1 != size && sigs[i][p1] == 0) ++p1;
+                    if (p1 == size) break;
+                    split_points[i].push_back(p1 + box.lo[i]);
+                    auto p2 = p1;
+                    while (p2 != size && sigs[i][p2] != 0) ++p2;
+                    split_points[i].push_back(p2 + box.lo[i] - 1);
+                    p1 = p2;
+                }
+            }
+            // check if the current box needs to be split or shrink
+            bool split_or_shrink = false;
+            for (auto i = 0; i < d; ++i) {
+                if (split_points[i].size() > 2 || split_points[i][0] > box.lo[i]
+                    || split_points[i][1] < box.hi[i])
+                    split_or_shrink = true;
+            }
+            if (split_or_shrink) {
+                // construct all the possible compact boxes
+                DS::Range<d> range;
+                for (auto i = 0; i < d; ++i) {
+                    range.start[i] = 0;
+                    range.end[i] = split_points[i].size() / 2;
+                }
+                range.reValidPace();
+                rangeFor_s(range, [&](auto&& idx) {
+                    Box t;
+                    for (auto i = 0; i < d; ++i) {
+                        t.lo[i] = split_points[i][idx[i] * 2];
+                        t.hi[i] = split_points[i][idx[i] * 2 + 1];
                     }
-                    // restrict _range
-                    for (auto i = 0; i < dim; ++i) {
-                        _range.start[i] = std::max(currentOffsets[i], _range.start[i]);
-                        _range.end[i] = std::min(currentOffsets[i] + currentDims[i], _range.end[i]);
+                    push(t);
+                });
+                return;
+            }
+            // the current box is already compact. if it's slim in all dims, accept it
+            std::array<bool, d> slim_in_dim;
+            bool all_slim = true;
+            for (auto i = 0; i < d; ++i) {
+                slim_in_dim[i] = box.hi[i] - box.lo[i] < slim_threshold;
+                all_slim &= slim_in_dim[i];
+            }
+            if (all_slim) {
+                accepted.push_back(box);
+                return;
+            }
+            // calculate the laplacian of the signatures. slim dims won't be split
+            auto laps = sigs;
+            for (auto i = 0; i < d; ++i) {
+                if (slim_in_dim[i]) continue;
+                for (auto j = 1; j < (int) laps[i].size() - 1; ++j)
+                    laps[i][j] = sigs[i][j - 1] - 2 * sigs[i][j] + sigs[i][j + 1];
+            }
+            // find all the sign-change points of lap with the max jump
+            std::array<std::vector<int>, d> zero_points;
+            std::array<int, d> max_jumps;
+            max_jumps.fill(0);
+            for (auto i = 0; i < d; ++i) {
+                for (auto j = 1; j <= box.hi[i] - box.lo[i] - 2; ++j) {
+                    auto a = laps[i][j], b = laps[i][j + 1];
+                    if ((a <= 0 && b >= 0) || (a >= 0 && b <= 0)) {
+                        if (std::abs(a - b) > max_jumps[i]) {
+                            max_jumps[i] = std::abs(a - b);
+                            zero_points[i].clear();
+                            zero_points[i].push_back(j + box.lo[i]);
+                        } else if (std::abs(a - b) == max_jumps[i]) {
+                            zero_points[i].push_back(j + box.lo[i]);
+                        }
                     }
-                    // label all points in _range
-                    rangeFor_s(_range, [&](auto &&i) {
-                        points.template emplace_back(i.get());
-#ifndef NDEBUG
-                        p_add.template emplace_back(i.get());
-#endif
-                    });
                 }
             }
-            // remove duplicates in points
-            std::sort(points.begin(), points.end());
-            auto last = std::unique(points.begin(), points.end());
-            points.erase(last, points.end());
-#ifndef NDEBUG
-            OP_DEBUG("Points at level {}:", level);
-            for (const auto &p : points) { OP_DEBUG("{}", p.toString()); }
-            dump_points(points, 1. / int_pow(ratio, level), std::format("p_level{}.vtp", level));
-            dump_points(p_add, 1. / int_pow(ratio, level), std::format("padd_level{}.vtp", level));
-#endif
-            auto tree = DS::KdTree<int, dim>(points);
-            auto boxes = domainPartition(tree, th, 2);
-#ifndef NDEBUG
-            OP_DEBUG("Boxes at level {}:", level);
-            for (auto &b : boxes) { OP_DEBUG("{}", b.toString()); }
-#endif
-            using Level = Meta::RealType<decltype(stack.levels.front())>;
-            using Zone = typename Level::ZoneType;
-            Level newLevel;
-            auto newMesh = baseMesh.getRefinedMesh(int_pow(ratio, level + 1));
-            // construct each zone in new level
-            for (auto &box : boxes) {
-                // convert box to next level's range
-                DS::Range<dim> r;
-                for (auto i = 0; i < dim; ++i) {
-                    r.start[i] = ratio * box.lo[i];
-                    r.end[i] = ratio * (box.hi[i] + 1) + 1;
+            // take the most centered split point
+            std::array<int, d> final_splits;
+            for (auto i = 0; i < d; ++i) {
+                final_splits[i] = box.lo[i] - 1;
+                if (zero_points[i].empty()) continue;
+                auto median = (box.hi[i] + box.lo[i]) / 2;
+                final_splits[i] = zero_points[i][0];
+                for (auto p : zero_points[i])
+                    if (std::abs(final_splits[i] - median) > std::abs(p - median)) final_splits[i] = p;
+            }
+            // the dim with the max jumps is preferred for split
+            std::array<int, d> split_priority;
+            for (auto i = 0; i < d; ++i) split_priority[i] = i;
+            std::sort(split_priority.begin(), split_priority.end(),
+                      [&](auto a, auto b) { return max_jumps[a] > max_jumps[b]; });
+            for (auto i : split_priority) {
+                // only split if it won't generate slim boxes
+                if (!zero_points[i].empty() && final_splits[i] - box.lo[i] + 1 > slim_threshold
+                    && box.hi[i] - final_splits[i] + 1 > slim_threshold) {
+                    auto box1 = box, box2 = box;
+                    box1.hi[i] = final_splits[i];
+                    box2.lo[i] = final_splits[i] + 1;
+                    push(box1);
+                    push(box2);
+                    return;
                 }
-                r.reValidPace();
-                // get submesh
-                auto submesh = newMesh.getSubMesh(r);
-                auto newZone = typename Zone::Builder().setMesh(submesh).build();
-                newLevel.zones.push_back(newZone);
             }
-            stack.levels.insert(std::next(stack.levels.begin()), std::move(newLevel));
-        }
+            // all split plans make slim boxes or no plan at all. bisect along the longest dim
+            auto longest_dim = 0, length = 0;
+            for (auto i = 0; i < d; ++i) {
+                if (box.hi[i] - box.lo[i] + 1 > length) {
+                    length = box.hi[i] - box.lo[i] + 1;
+                    longest_dim = i;
+                }
+            }
+            auto box1 = box, box2 = box;
+            box1.hi[longest_dim] = (box.lo[longest_dim] + box.hi[longest_dim]) / 2;
+            box2.lo[longest_dim] = box1.hi[longest_dim] + 1;
+            push(box1);
+            push(box2);
+        };
+
+        std::vector<Box> roots;
+        if (!tags.empty()) roots.push_back(tags.boundingBox());
+        tbb::task_arena arena(getGlobalParallelPlan().shared_memory_workers_count);
+        arena.execute([&]() {
+            tbb::parallel_for_each(roots.begin(), roots.end(), [&](const Box& box, tbb::feeder<Box>& feeder) {
+                process(box, [&](const Box& b) { feeder.add(b); });
+            });
+        });
+        std::vector<Box> ret(accepted.begin(), accepted.end());
+        std::sort(ret.begin(), ret.end(), [](const Box& a, const Box& b) {
+            return a.lo < b.lo || (a.lo == b.lo && a.hi < b.hi);
+        });
+        return ret;
     }
 }// namespace OpFlow
 #endif//OPFLOW_AMRGEN_HPP
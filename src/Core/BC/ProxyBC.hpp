@@ -37,7 +37,7 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
 
         typename internal::FieldExprTrait<To>::elem_type
         evalAt(const typename internal::FieldExprTrait<To>::index_type& index) const override {
-            return typename internal::FieldExprTrait<To>::elem_type {_src->evalAt(index)};
+            return typename internal::FieldExprTrait<To>::elem_type(_src->evalAt(index));
         }
 
         std::unique_ptr<BCBase<To>> getCopy() const override { return std::make_unique<ProxyBC>(*_src); }
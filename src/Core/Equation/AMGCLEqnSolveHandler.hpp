@@ -118,6 +118,7 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
             Meta::static_for<size>([&]<int i>(Meta::int_<i>) {
                 auto target = eqn_holder->template getTargetPtr<i>();
                 DS::MDRangeMapper local_mapper {target->getLocalWritableRange()};
+                target->detachStorage();
                 rangeFor(target->getLocalWritableRange(),
                          [&](auto&& k) { (*target)[k] = x[local_mapper(k) + offsets[i]]; });
                 target->updatePadding();
@@ -179,6 +179,7 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
         }
 
         void returnValues() {
+            target->detachStorage();
             rangeFor(DS::commonRange(target->assignableRange, target->localRange), [&](auto&& k) {
                 Real val;
                 HYPRE_StructVectorGetValues(x, const_cast<int*>(k.get().data()), &val);
@@ -418,6 +419,7 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
         void returnValues() {
             for (auto l = 0; l < target->getLevels(); ++l) {
                 for (auto p = 0; p < target->localRanges[l].size(); ++p) {
+                    target->detachPatch(l, p);
                     rangeFor(target->localRanges[l][p], [&](auto&& i) {
                         Real val;
                         HYPRE_SStructVectorGetValues(x, l, i.c_arr(), 0, &val);
@@ -91,6 +91,7 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
         Meta::static_for<decltype(st_holder)::size>([&]<int i>(Meta::int_<i>) {
             auto target = eqn_holder.template getTargetPtr<i>();
             auto local_mapper = DS::MDRangeMapper {target->getLocalWritableRange()};
+            target->detachStorage();
             rangeFor(target->getLocalWritableRange(), [&](auto&& k) {
                 (*target)[k] = x[mapper.getLocalRank(DS::ColoredIndex<Meta::RealType<decltype(k)>> {k, i})];
             });
@@ -18,10 +18,14 @@
 #include "Core/Macros.hpp"
 #include "Core/Meta.hpp"
 #ifndef OPFLOW_INSIDE_MODULE
+#include <limits>
 #include <string>
 #endif
 
 OPFLOW_MODULE_EXPORT namespace OpFlow {
+    namespace internal {
+        constexpr int unknown_read_width = std::numeric_limits<int>::max();
+    }// namespace internal
 
     template <typename Derived, bool rw, bool dir>
     struct Expr;
@@ -31,14 +35,30 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
         /// \typedef The result type of the expr
         using type = typename internal::ExprTrait<Derived>::type;
         mutable std::string name;
+        /// \brief Generator of the default name, invoked on the first query of an unnamed expr
+        mutable std::string (*name_gen)(const Derived&) = nullptr;
 
         [[nodiscard]] static constexpr bool isConcrete() { return true; }
-        [[maybe_unused]] [[nodiscard]] const auto& getName() const { return name; }
+        [[maybe_unused]] [[nodiscard]] const auto& getName() const {
+            if (name.empty() && name_gen) name = name_gen(this->derived());
+            return name;
+        }
         template <typename T>
         bool contains(const T& t) const {
             return this->derived().containsImpl_final(t);
         }
 
+        /// \brief Half width of the neighbourhood of \p t read to evaluate the expr at one point
+        /// \return 0 if \p t is only read at the evaluated point, -1 if \p t is not read at all,
+        /// internal::unknown_read_width if some op on the way doesn't declare its bc_width
+        template <typename T>
+        int readWidth(const T& t) const {
+            if constexpr (requires { this->derived().readWidthImpl_final(t); })
+                return this->derived().readWidthImpl_final(t);
+            else
+                return contains(t) ? 0 : -1;
+        }
+
         /// \brief prepare all meta infos of the expr
         void prepare() const { this->derived().prepareImpl_final(); }
 
@@ -122,16 +142,16 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
         // return the result field
         auto instantiate() const { return this->derived(); }
 
-        // getters
-        auto& operator()(auto&&... i) { return evalAt(OP_PERFECT_FOWD(i)...); }
-        auto& operator[](auto&& i) { return evalAt(OP_PERFECT_FOWD(i)); }
+        // getters. Packed storages (e.g., of bools) return proxies instead of references
+        decltype(auto) operator()(auto&&... i) { return evalAt(OP_PERFECT_FOWD(i)...); }
+        decltype(auto) operator[](auto&& i) { return evalAt(OP_PERFECT_FOWD(i)); }
         // const getters
-        const auto& operator()(auto&&... i) const { return evalAt(OP_PERFECT_FOWD(i)...); }
-        const auto& operator[](auto&& i) const { return evalAt(OP_PERFECT_FOWD(i)); }
-        const auto& evalAt(auto&&... i) const {
+        decltype(auto) operator()(auto&&... i) const { return evalAt(OP_PERFECT_FOWD(i)...); }
+        decltype(auto) operator[](auto&& i) const { return evalAt(OP_PERFECT_FOWD(i)); }
+        decltype(auto) evalAt(auto&&... i) const {
             return this->derived().evalAtImpl_final(std::forward<decltype(i)>(i)...);
         }
-        auto& evalAt(auto&&... i) {
+        decltype(auto) evalAt(auto&&... i) {
             return this->derived().evalAtImpl_final(std::forward<decltype(i)>(i)...);
         }
 
@@ -144,14 +164,30 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
         /// \typedef The result type of the expr
         using type = typename internal::ExprTrait<Derived>::type;
         mutable std::string name;
+        /// \brief Generator of the default name, invoked on the first query of an unnamed expr
+        mutable std::string (*name_gen)(const Derived&) = nullptr;
 
         [[nodiscard]] static constexpr bool isConcrete() { return false; }
-        [[maybe_unused]] [[nodiscard]] const auto& getName() const { return name; }
+        [[maybe_unused]] [[nodiscard]] const auto& getName() const {
+            if (name.empty() && name_gen) name = name_gen(this->derived());
+            return name;
+        }
         template <typename T>
         bool contains(const T& t) const {
             return this->derived().containsImpl_final(t);
         }
 
+        /// \brief Half width of the neighbourhood of \p t read to evaluate the expr at one point
+        /// \return 0 if \p t is only read at the evaluated point, -1 if \p t is not read at all,
+        /// internal::unknown_read_width if some op on the way doesn't declare its bc_width
+        template <typename T>
+        int readWidth(const T& t) const {
+            if constexpr (requires { this->derived().readWidthImpl_final(t); })
+                return this->derived().readWidthImpl_final(t);
+            else
+                return contains(t) ? 0 : -1;
+        }
+
         /// \brief prepare all meta infos of the expr
         void prepare() const { this->derived().prepareImpl_final(); }
 
@@ -249,14 +285,30 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
         /// \typedef The result type of the expr
         using type = typename internal::ExprTrait<Derived>::type;
         mutable std::string name;
+        /// \brief Generator of the default name, invoked on the first query of an unnamed expr
+        mutable std::string (*name_gen)(const Derived&) = nullptr;
 
         [[nodiscard]] static constexpr bool isConcrete() { return true; }
-        [[maybe_unused]] [[nodiscard]] const auto& getName() const { return name; }
+        [[maybe_unused]] [[nodiscard]] const auto& getName() const {
+            if (name.empty() && name_gen) name = name_gen(this->derived());
+            return name;
+        }
         template <typename T>
         bool contains(const T& t) const {
             return this->derived().containsImpl_final(t);
         }
 
+        /// \brief Half width of the neighbourhood of \p t read to evaluate the expr at one point
+        /// \return 0 if \p t is only read at the evaluated point, -1 if \p t is not read at all,
+        /// internal::unknown_read_width if some op on the way doesn't declare its bc_width
+        template <typename T>
+        int readWidth(const T& t) const {
+            if constexpr (requires { this->derived().readWidthImpl_final(t); })
+                return this->derived().readWidthImpl_final(t);
+            else
+                return contains(t) ? 0 : -1;
+        }
+
         /// \brief prepare all meta infos of the expr
         void prepare() const { this->derived().prepareImpl_final(); }
 
@@ -286,14 +338,30 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
         /// \typedef The result type of the expr
         using type = typename internal::ExprTrait<Derived>::type;
         mutable std::string name;
+        /// \brief Generator of the default name, invoked on the first query of an unnamed expr
+        mutable std::string (*name_gen)(const Derived&) = nullptr;
 
         [[nodiscard]] static constexpr bool isConcrete() { return false; }
-        [[maybe_unused]] [[nodiscard]] const auto& getName() const { return name; }
+        [[maybe_unused]] [[nodiscard]] const auto& getName() const {
+            if (name.empty() && name_gen) name = name_gen(this->derived());
+            return name;
+        }
         template <typename T>
         bool contains(const T& t) const {
             return this->derived().containsImpl_final(t);
         }
 
+        /// \brief Half width of the neighbourhood of \p t read to evaluate the expr at one point
+        /// \return 0 if \p t is only read at the evaluated point, -1 if \p t is not read at all,
+        /// internal::unknown_read_width if some op on the way doesn't declare its bc_width
+        template <typename T>
+        int readWidth(const T& t) const {
+            if constexpr (requires { this->derived().readWidthImpl_final(t); })
+                return this->derived().readWidthImpl_final(t);
+            else
+                return contains(t) ? 0 : -1;
+        }
+
         /// \brief prepare all meta infos of the expr
         void prepare() const { this->derived().prepareImpl_final(); }
 
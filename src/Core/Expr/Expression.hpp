@@ -19,11 +19,27 @@
 #include "Core/Expr/Expr.hpp"
 #include "Core/Expr/ExprTrait.hpp"
 #include "Core/Operator/Operator.hpp"
+#ifndef OPFLOW_INSIDE_MODULE
+#include <algorithm>
+#include <initializer_list>
+#endif
 
 OPFLOW_MODULE_EXPORT namespace OpFlow {
     template <typename Op, ExprType... Args>
     struct Expression;
 
+    namespace internal {
+        /// \brief Read width of an expr of \p Op given the read widths of its args, see Expr::readWidth
+        template <typename Op>
+        int composeReadWidth(std::initializer_list<int> args) {
+            auto w = std::max(args);
+            if (w < 0 || w == unknown_read_width) return w;
+            if constexpr (requires { Op::bc_width; }) return w + Op::bc_width;
+            else
+                return unknown_read_width;
+        }
+    }// namespace internal
+
     template <typename Op>
     requires(!ExprType<Op>) struct Expression<Op> : ResultType<Op>::type {
         friend Expr<Expression<Op>>;
@@ -82,6 +98,10 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
 
         bool containsImpl_final(const auto& t) const { return arg1.contains(t); }
 
+        int readWidthImpl_final(const auto& t) const {
+            return internal::composeReadWidth<Op>({arg1.readWidth(t)});
+        }
+
         DEFINE_EVAL_OPS(arg1)
     public:
         typename internal::ExprProxy<Arg>::type arg1;
@@ -104,6 +124,10 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
 
         bool containsImpl_final(const auto& t) const { return arg1.contains(t) || arg2.contains(t); }
 
+        int readWidthImpl_final(const auto& t) const {
+            return internal::composeReadWidth<Op>({arg1.readWidth(t), arg2.readWidth(t)});
+        }
+
         DEFINE_EVAL_OPS(arg1, arg2)
     public:
         typename internal::ExprProxy<Arg1>::type arg1;
@@ -133,6 +157,10 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
             return arg1.contains(t) || arg2.contains(t) || arg3.contains(t);
         }
 
+        int readWidthImpl_final(const auto& t) const {
+            return internal::composeReadWidth<Op>({arg1.readWidth(t), arg2.readWidth(t), arg3.readWidth(t)});
+        }
+
         DEFINE_EVAL_OPS(arg1, arg2, arg3)
     public:
         typename internal::ExprProxy<Arg1>::type arg1;
@@ -166,6 +194,11 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
             return arg1.contains(t) || arg2.contains(t) || arg3.contains(t) || arg4.contains(t);
         }
 
+        int readWidthImpl_final(const auto& t) const {
+            return internal::composeReadWidth<Op>({arg1.readWidth(t), arg2.readWidth(t), arg3.readWidth(t),
+                                                   arg4.readWidth(t)});
+        }
+
         DEFINE_EVAL_OPS(arg1, arg2, arg3, arg4)
     public:
         typename internal::ExprProxy<Arg1>::type arg1;
@@ -202,6 +235,11 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
                    || arg5.contains(t);
         }
 
+        int readWidthImpl_final(const auto& t) const {
+            return internal::composeReadWidth<Op>({arg1.readWidth(t), arg2.readWidth(t), arg3.readWidth(t),
+                                                   arg4.readWidth(t), arg5.readWidth(t)});
+        }
+
         DEFINE_EVAL_OPS(arg1, arg2, arg3, arg4, arg5)
     public:
         typename internal::ExprProxy<Arg1>::type arg1;
@@ -242,6 +280,11 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
                    || arg5.contains(t) || arg6.contains(t);
         }
 
+        int readWidthImpl_final(const auto& t) const {
+            return internal::composeReadWidth<Op>({arg1.readWidth(t), arg2.readWidth(t), arg3.readWidth(t),
+                                                   arg4.readWidth(t), arg5.readWidth(t), arg6.readWidth(t)});
+        }
+
         DEFINE_EVAL_OPS(arg1, arg2, arg3, arg4, arg5, arg6)
     public:
         typename internal::ExprProxy<Arg1>::type arg1;
@@ -286,6 +329,12 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
                    || arg5.contains(t) || arg6.contains(t) || arg7.contains(t);
         }
 
+        int readWidthImpl_final(const auto& t) const {
+            return internal::composeReadWidth<Op>({arg1.readWidth(t), arg2.readWidth(t), arg3.readWidth(t),
+                                                   arg4.readWidth(t), arg5.readWidth(t), arg6.readWidth(t),
+                                                   arg7.readWidth(t)});
+        }
+
         DEFINE_EVAL_OPS(arg1, arg2, arg3, arg4, arg5, arg6, arg7)
     public:
         typename internal::ExprProxy<Arg1>::type arg1;
@@ -334,6 +383,12 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
                    || arg5.contains(t) || arg6.contains(t) || arg7.contains(t) || arg8.contains(t);
         }
 
+        int readWidthImpl_final(const auto& t) const {
+            return internal::composeReadWidth<Op>({arg1.readWidth(t), arg2.readWidth(t), arg3.readWidth(t),
+                                                   arg4.readWidth(t), arg5.readWidth(t), arg6.readWidth(t),
+                                                   arg7.readWidth(t), arg8.readWidth(t)});
+        }
+
         DEFINE_EVAL_OPS(arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8)
     public:
         typename internal::ExprProxy<Arg1>::type arg1;
@@ -385,6 +440,12 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
                    || arg9.contains(t);
         }
 
+        int readWidthImpl_final(const auto& t) const {
+            return internal::composeReadWidth<Op>({arg1.readWidth(t), arg2.readWidth(t), arg3.readWidth(t),
+                                                   arg4.readWidth(t), arg5.readWidth(t), arg6.readWidth(t),
+                                                   arg7.readWidth(t), arg8.readWidth(t), arg9.readWidth(t)});
+        }
+
         DEFINE_EVAL_OPS(arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9)
     public:
         typename internal::ExprProxy<Arg1>::type arg1;
@@ -439,6 +500,13 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
                    || arg9.contains(t) || arg10.contains(t);
         }
 
+        int readWidthImpl_final(const auto& t) const {
+            return internal::composeReadWidth<Op>({arg1.readWidth(t), arg2.readWidth(t), arg3.readWidth(t),
+                                                   arg4.readWidth(t), arg5.readWidth(t), arg6.readWidth(t),
+                                                   arg7.readWidth(t), arg8.readWidth(t), arg9.readWidth(t),
+                                                   arg10.readWidth(t)});
+        }
+
         DEFINE_EVAL_OPS(arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10)
     public:
         typename internal::ExprProxy<Arg1>::type arg1;
@@ -496,6 +564,13 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
                    || arg9.contains(t) || arg10.contains(t) || arg11.contains(t);
         }
 
+        int readWidthImpl_final(const auto& t) const {
+            return internal::composeReadWidth<Op>({arg1.readWidth(t), arg2.readWidth(t), arg3.readWidth(t),
+                                                   arg4.readWidth(t), arg5.readWidth(t), arg6.readWidth(t),
+                                                   arg7.readWidth(t), arg8.readWidth(t), arg9.readWidth(t),
+                                                   arg10.readWidth(t), arg11.readWidth(t)});
+        }
+
         DEFINE_EVAL_OPS(arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10, arg11)
     public:
         typename internal::ExprProxy<Arg1>::type arg1;
@@ -558,6 +633,14 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
                    || arg9.contains(t) || arg10.contains(t) || arg11.contains(t) || arg12.contains(t);
         }
 
+        int readWidthImpl_final(const auto& t) const {
+            return internal::composeReadWidth<Op>({arg1.readWidth(t), arg2.readWidth(t), arg3.readWidth(t),
+                                                   arg4.readWidth(t), arg5.readWidth(t), arg6.readWidth(t),
+                                                   arg7.readWidth(t), arg8.readWidth(t), arg9.readWidth(t),
+                                                   arg10.readWidth(t), arg11.readWidth(t),
+                                                   arg12.readWidth(t)});
+        }
+
         DEFINE_EVAL_OPS(arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10, arg11, arg12)
     public:
         typename internal::ExprProxy<Arg1>::type arg1;
@@ -628,6 +711,14 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
                    || arg13.contains(t);
         }
 
+        int readWidthImpl_final(const auto& t) const {
+            return internal::composeReadWidth<Op>({arg1.readWidth(t), arg2.readWidth(t), arg3.readWidth(t),
+                                                   arg4.readWidth(t), arg5.readWidth(t), arg6.readWidth(t),
+                                                   arg7.readWidth(t), arg8.readWidth(t), arg9.readWidth(t),
+                                                   arg10.readWidth(t), arg11.readWidth(t), arg12.readWidth(t),
+                                                   arg13.readWidth(t)});
+        }
+
         DEFINE_EVAL_OPS(arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10, arg11, arg12, arg13)
     public:
         typename internal::ExprProxy<Arg1>::type arg1;
@@ -700,6 +791,14 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
                    || arg13.contains(t) || arg14.contains(t);
         }
 
+        int readWidthImpl_final(const auto& t) const {
+            return internal::composeReadWidth<Op>({arg1.readWidth(t), arg2.readWidth(t), arg3.readWidth(t),
+                                                   arg4.readWidth(t), arg5.readWidth(t), arg6.readWidth(t),
+                                                   arg7.readWidth(t), arg8.readWidth(t), arg9.readWidth(t),
+                                                   arg10.readWidth(t), arg11.readWidth(t), arg12.readWidth(t),
+                                                   arg13.readWidth(t), arg14.readWidth(t)});
+        }
+
         DEFINE_EVAL_OPS(arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10, arg11, arg12, arg13,
                         arg14)
     public:
@@ -775,6 +874,15 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
                    || arg13.contains(t) || arg14.contains(t) || arg15.contains(t);
         }
 
+        int readWidthImpl_final(const auto& t) const {
+            return internal::composeReadWidth<Op>({arg1.readWidth(t), arg2.readWidth(t), arg3.readWidth(t),
+                                                   arg4.readWidth(t), arg5.readWidth(t), arg6.readWidth(t),
+                                                   arg7.readWidth(t), arg8.readWidth(t), arg9.readWidth(t),
+                                                   arg10.readWidth(t), arg11.readWidth(t), arg12.readWidth(t),
+                                                   arg13.readWidth(t), arg14.readWidth(t),
+                                                   arg15.readWidth(t)});
+        }
+
         DEFINE_EVAL_OPS(arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10, arg11, arg12, arg13,
                         arg14, arg15)
     public:
@@ -854,6 +962,15 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
                    || arg13.contains(t) || arg14.contains(t) || arg15.contains(t) || arg16.contains(t);
         }
 
+        int readWidthImpl_final(const auto& t) const {
+            return internal::composeReadWidth<Op>({arg1.readWidth(t), arg2.readWidth(t), arg3.readWidth(t),
+                                                   arg4.readWidth(t), arg5.readWidth(t), arg6.readWidth(t),
+                                                   arg7.readWidth(t), arg8.readWidth(t), arg9.readWidth(t),
+                                                   arg10.readWidth(t), arg11.readWidth(t), arg12.readWidth(t),
+                                                   arg13.readWidth(t), arg14.readWidth(t), arg15.readWidth(t),
+                                                   arg16.readWidth(t)});
+        }
+
         DEFINE_EVAL_OPS(arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10, arg11, arg12, arg13,
                         arg14, arg15, arg16)
     public:
@@ -936,6 +1053,15 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
                    || arg17.contains(t);
         }
 
+        int readWidthImpl_final(const auto& t) const {
+            return internal::composeReadWidth<Op>({arg1.readWidth(t), arg2.readWidth(t), arg3.readWidth(t),
+                                                   arg4.readWidth(t), arg5.readWidth(t), arg6.readWidth(t),
+                                                   arg7.readWidth(t), arg8.readWidth(t), arg9.readWidth(t),
+                                                   arg10.readWidth(t), arg11.readWidth(t), arg12.readWidth(t),
+                                                   arg13.readWidth(t), arg14.readWidth(t), arg15.readWidth(t),
+                                                   arg16.readWidth(t), arg17.readWidth(t)});
+        }
+
         DEFINE_EVAL_OPS(arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10, arg11, arg12, arg13,
                         arg14, arg15, arg16, arg17)
     public:
@@ -1024,6 +1150,16 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
                    || arg17.contains(t) || arg18.contains(t);
         }
 
+        int readWidthImpl_final(const auto& t) const {
+            return internal::composeReadWidth<Op>({arg1.readWidth(t), arg2.readWidth(t), arg3.readWidth(t),
+                                                   arg4.readWidth(t), arg5.readWidth(t), arg6.readWidth(t),
+                                                   arg7.readWidth(t), arg8.readWidth(t), arg9.readWidth(t),
+                                                   arg10.readWidth(t), arg11.readWidth(t), arg12.readWidth(t),
+                                                   arg13.readWidth(t), arg14.readWidth(t), arg15.readWidth(t),
+                                                   arg16.readWidth(t), arg17.readWidth(t),
+                                                   arg18.readWidth(t)});
+        }
+
         DEFINE_EVAL_OPS(arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10, arg11, arg12, arg13,
                         arg14, arg15, arg16, arg17, arg18)
     public:
@@ -1115,6 +1251,16 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
                    || arg17.contains(t) || arg18.contains(t) || arg19.contains(t);
         }
 
+        int readWidthImpl_final(const auto& t) const {
+            return internal::composeReadWidth<Op>({arg1.readWidth(t), arg2.readWidth(t), arg3.readWidth(t),
+                                                   arg4.readWidth(t), arg5.readWidth(t), arg6.readWidth(t),
+                                                   arg7.readWidth(t), arg8.readWidth(t), arg9.readWidth(t),
+                                                   arg10.readWidth(t), arg11.readWidth(t), arg12.readWidth(t),
+                                                   arg13.readWidth(t), arg14.readWidth(t), arg15.readWidth(t),
+                                                   arg16.readWidth(t), arg17.readWidth(t), arg18.readWidth(t),
+                                                   arg19.readWidth(t)});
+        }
+
         DEFINE_EVAL_OPS(arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10, arg11, arg12, arg13,
                         arg14, arg15, arg16, arg17, arg18, arg19)
     public:
@@ -1208,6 +1354,16 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
                    || arg17.contains(t) || arg18.contains(t) || arg19.contains(t) || arg20.contains(t);
         }
 
+        int readWidthImpl_final(const auto& t) const {
+            return internal::composeReadWidth<Op>({arg1.readWidth(t), arg2.readWidth(t), arg3.readWidth(t),
+                                                   arg4.readWidth(t), arg5.readWidth(t), arg6.readWidth(t),
+                                                   arg7.readWidth(t), arg8.readWidth(t), arg9.readWidth(t),
+                                                   arg10.readWidth(t), arg11.readWidth(t), arg12.readWidth(t),
+                                                   arg13.readWidth(t), arg14.readWidth(t), arg15.readWidth(t),
+                                                   arg16.readWidth(t), arg17.readWidth(t), arg18.readWidth(t),
+                                                   arg19.readWidth(t), arg20.readWidth(t)});
+        }
+
         DEFINE_EVAL_OPS(arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10, arg11, arg12, arg13,
                         arg14, arg15, arg16, arg17, arg18, arg19, arg20)
     public:
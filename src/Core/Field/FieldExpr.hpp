@@ -32,7 +32,9 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
     protected:
         // recurse end
         void initPropsFromImpl_FieldExpr(auto&& expr) const {
-            if (this->name.empty()) this->name = expr.getName();
+            // only concrete fields inherit the name; expressions name themselves lazily
+            if constexpr (FieldExpr::isConcrete())
+                if (this->name.empty()) this->name = expr.getName();
         }
 
     private:
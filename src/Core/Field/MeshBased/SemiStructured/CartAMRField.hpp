@@ -19,6 +19,7 @@
 #include "Core/Field/MeshBased/SemiStructured/CartAMRFieldExpr.hpp"
 #include "Core/Field/MeshBased/SemiStructured/CartAMRFieldExprTrait.hpp"
 #include "Core/Field/MeshBased/SemiStructured/CartAMRFieldTrait.hpp"
+#include "Core/Loops/AMRFor.hpp"
 #include "Core/Loops/FieldAssigner.hpp"
 #include "Core/Macros.hpp"
 #include "Core/Mesh/SemiStructured/CartesianAMRMesh.hpp"
@@ -51,7 +52,8 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
 
         CartAMRField() = default;
         CartAMRField(const CartAMRField& other)
-            : CartAMRFieldExpr<CartAMRField<D, M, C>>(other), data(other.data), offset(other.offset) {}
+            : CartAMRFieldExpr<CartAMRField<D, M, C>>(other), data(shareStorage(other.data)),
+              offset(other.offset) {}
         CartAMRField(CartAMRField&& other) noexcept
             : CartAMRFieldExpr<CartAMRField<D, M, C>>(std::move(other)), data(std::move(other.data)),
               offset(std::move(other.offset)) {}
@@ -89,40 +91,31 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
 
         template <BasicArithOp Op = BasicArithOp::Eq>
         auto& assignImpl_final(const D& c) {
-            auto levels = data.size();
-#pragma omp parallel
-            for (auto l = 0; l < levels; ++l) {
-                auto parts = data[l].size();
-#pragma omp for schedule(dynamic) nowait
-                for (auto p = 0; p < parts; ++p) {
-                    if constexpr (Op == BasicArithOp::Eq)
-                        rangeFor_s(this->assignableRanges[l][p], [&](auto&& i) { this->operator[](i) = c; });
-                    else if constexpr (Op == BasicArithOp::Add)
-                        rangeFor_s(this->assignableRanges[l][p], [&](auto&& i) { this->operator[](i) += c; });
-                    else if constexpr (Op == BasicArithOp::Minus)
-                        rangeFor_s(this->assignableRanges[l][p], [&](auto&& i) { this->operator[](i) -= c; });
-                    else if constexpr (Op == BasicArithOp::Mul)
-                        rangeFor_s(this->assignableRanges[l][p], [&](auto&& i) { this->operator[](i) *= c; });
-                    else if constexpr (Op == BasicArithOp::Div)
-                        rangeFor_s(this->assignableRanges[l][p], [&](auto&& i) { this->operator[](i) /= c; });
-                    else if constexpr (Op == BasicArithOp::Mod)
-                        rangeFor_s(this->assignableRanges[l][p], [&](auto&& i) { this->operator[](i) %= c; });
-                    else if constexpr (Op == BasicArithOp::And)
-                        rangeFor_s(this->assignableRanges[l][p], [&](auto&& i) { this->operator[](i) &= c; });
-                    else if constexpr (Op == BasicArithOp::Or)
-                        rangeFor_s(this->assignableRanges[l][p], [&](auto&& i) { this->operator[](i) |= c; });
-                    else if constexpr (Op == BasicArithOp::Xor)
-                        rangeFor_s(this->assignableRanges[l][p], [&](auto&& i) { this->operator[](i) ^= c; });
-                    else if constexpr (Op == BasicArithOp::LShift)
-                        rangeFor_s(this->assignableRanges[l][p],
-                                   [&](auto&& i) { this->operator[](i) <<= c; });
-                    else if constexpr (Op == BasicArithOp::RShift)
-                        rangeFor_s(this->assignableRanges[l][p],
-                                   [&](auto&& i) { this->operator[](i) >>= c; });
-                    else
-                        OP_NOT_IMPLEMENTED;
-                }
-            }
+            detachPatches(this->assignableRanges);
+            if constexpr (Op == BasicArithOp::Eq)
+                amrFor(this->assignableRanges, [&](auto&& i) { this->operator[](i) = c; });
+            else if constexpr (Op == BasicArithOp::Add)
+                amrFor(this->assignableRanges, [&](auto&& i) { this->operator[](i) += c; });
+            else if constexpr (Op == BasicArithOp::Minus)
+                amrFor(this->assignableRanges, [&](auto&& i) { this->operator[](i) -= c; });
+            else if constexpr (Op == BasicArithOp::Mul)
+                amrFor(this->assignableRanges, [&](auto&& i) { this->operator[](i) *= c; });
+            else if constexpr (Op == BasicArithOp::Div)
+                amrFor(this->assignableRanges, [&](auto&& i) { this->operator[](i) /= c; });
+            else if constexpr (Op == BasicArithOp::Mod)
+                amrFor(this->assignableRanges, [&](auto&& i) { this->operator[](i) %= c; });
+            else if constexpr (Op == BasicArithOp::And)
+                amrFor(this->assignableRanges, [&](auto&& i) { this->operator[](i) &= c; });
+            else if constexpr (Op == BasicArithOp::Or)
+                amrFor(this->assignableRanges, [&](auto&& i) { this->operator[](i) |= c; });
+            else if constexpr (Op == BasicArithOp::Xor)
+                amrFor(this->assignableRanges, [&](auto&& i) { this->operator[](i) ^= c; });
+            else if constexpr (Op == BasicArithOp::LShift)
+                amrFor(this->assignableRanges, [&](auto&& i) { this->operator[](i) <<= c; });
+            else if constexpr (Op == BasicArithOp::RShift)
+                amrFor(this->assignableRanges, [&](auto&& i) { this->operator[](i) >>= c; });
+            else
+                OP_NOT_IMPLEMENTED;
             updateCovering();
             updatePadding();
             return *this;
@@ -134,23 +127,15 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
             ->std::convertible_to<D>;
         }
         auto& initBy(F&& f) {
-            auto levels = data.size();
-#pragma omp parallel
-            for (auto l = 0; l < levels; ++l) {
-                auto parts = data[l].size();
-#pragma omp for schedule(dynamic) nowait
-                for (auto p = 0; p < parts; ++p) {
-                    rangeFor_s(this->assignableRanges[l][p], [&](auto&& i) {
-                        std::array<Real, internal::CartesianAMRMeshTrait<M>::dim> cords;
-                        for (auto k = 0; k < internal::CartesianAMRMeshTrait<M>::dim; ++k)
-                            cords[k]
-                                    = this->loc[k] == LocOnMesh::Corner
-                                              ? this->mesh.x(k, i.l, i[k])
-                                              : this->mesh.x(k, i.l, i[k]) + .5 * this->mesh.dx(k, i.l, i[k]);
-                        this->operator[](i) = f(cords);
-                    });
-                }
-            }
+            detachPatches(this->assignableRanges);
+            amrFor(this->assignableRanges, [&](auto&& i) {
+                std::array<Real, internal::CartesianAMRMeshTrait<M>::dim> cords;
+                for (auto k = 0; k < internal::CartesianAMRMeshTrait<M>::dim; ++k)
+                    cords[k] = this->loc[k] == LocOnMesh::Corner
+                                       ? this->mesh.x(k, i.l, i[k])
+                                       : this->mesh.x(k, i.l, i[k]) + .5 * this->mesh.dx(k, i.l, i[k]);
+                this->operator[](i) = f(cords);
+            });
             updateCovering();
             updatePadding();
             return *this;
@@ -163,6 +148,7 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
         void updateBCImpl_final() {
             if (this->localRanges[0][0] == this->assignableRanges[0][0]) return;
             else {
+                detachPatch(0, 0);
                 for (auto i = 0; i < dim; ++i) {
                     if (this->loc[i] == LocOnMesh::Center) continue;// only nodal dims needs to be update
                     auto type = this->bc[i].start ? this->bc[i].start->getBCType() : BCType::Undefined;
@@ -204,15 +190,15 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
 
     public:
         void updatePadding() {
+            using range_type = typename internal::CartAMRFieldExprTrait<CartAMRField>::range_type;
             // step 1: fill all halo regions covered by parents
-#pragma omp parallel
+            AMRTaskList<range_type> tasks;
             for (auto l = 1; l < this->accessibleRanges.size(); ++l) {
-#pragma omp for schedule(dynamic)
                 for (auto p = 0; p < this->accessibleRanges[l].size(); ++p) {
                     // here to avoid the accessibleRanges[l][p] is already been trimmed by the maxLogicalRange[l]
                     auto bc_ranges = this->localRanges[l][p]
                                              .getInnerRange(-this->mesh.buffWidth)
-                                             .getBCRanges(this->mesh.buffWidth);
+                                             .getDisjointBCRanges(this->mesh.buffWidth);
                     for (auto r_p : this->mesh.parents[l][p]) {
                         // convert the parent range into this level
                         auto p_range = this->localRanges[l - 1][r_p];
@@ -220,46 +206,52 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
                             p_range.start[i] *= this->mesh.refinementRatio;
                             p_range.end[i] *= this->mesh.refinementRatio;
                         }
+                        p_range.level = l;
                         // for each potential intersections
-                        for (auto& bc_r : bc_ranges) {
-                            rangeFor_s(DS::commonRange(bc_r, p_range), [&](auto&& i) {
-                                // use piecewise constant interpolation
-                                auto i_base = i.toLevel(l - 1, this->mesh.refinementRatio);
-                                i_base.p = r_p;
-                                this->operator[](i) = this->operator[](i_base);
-                            });
-                        }
+                        for (auto& bc_r : bc_ranges) tasks.push(DS::commonRange(bc_r, p_range), r_p);
+                        detachPatch(l, p);
                     }
                 }
             }
+            amrTaskFor(tasks, [&](const AMRTask<range_type>& t) {
+                rangeFor_s(t.range, [&](auto&& i) {
+                    // use piecewise constant interpolation
+                    auto i_base = i.toLevel(i.l - 1, this->mesh.refinementRatio);
+                    i_base.p = t.tag;
+                    this->operator[](i) = this->operator[](i_base);
+                });
+            });
             // step 2: fill all halo regions covered by neighbors
-#pragma omp parallel
+            tasks.clear();
             for (auto l = 1; l < this->accessibleRanges.size(); ++l) {
-#pragma omp for nowait schedule(dynamic)
                 for (auto p = 0; p < this->accessibleRanges[l].size(); ++p) {
                     auto bc_ranges = this->localRanges[l][p]
                                              .getInnerRange(-this->mesh.buffWidth)
-                                             .getBCRanges(this->mesh.buffWidth);
+                                             .getDisjointBCRanges(this->mesh.buffWidth);
                     for (auto r_n : this->mesh.neighbors[l][p]) {
                         // for each potential intersections
-                        for (auto& bc_r : bc_ranges) {
-                            auto _r = DS::commonRange(bc_r, this->localRanges[l][r_n]);
-                            rangeFor_s(DS::commonRange(bc_r, this->localRanges[l][r_n]), [&](auto&& i) {
-                                // copy from other fine cells
-                                auto other_i = i;
-                                other_i.p = r_n;
-                                this->operator[](i) = this->operator[](other_i);
-                            });
-                        }
+                        for (auto& bc_r : bc_ranges)
+                            tasks.push(DS::commonRange(bc_r, this->localRanges[l][r_n]), r_n);
+                        detachPatch(l, p);
                     }
                 }
             }
+            amrTaskFor(tasks, [&](const AMRTask<range_type>& t) {
+                rangeFor_s(t.range, [&](auto&& i) {
+                    // copy from other fine cells
+                    auto other_i = i;
+                    other_i.p = t.tag;
+                    this->operator[](i) = this->operator[](other_i);
+                });
+            });
         }
         void updateCovering() {
+            using range_type = typename internal::CartAMRFieldExprTrait<CartAMRField>::range_type;
             auto ratio = this->mesh.refinementRatio;
-#pragma omp parallel
-            for (auto l = this->localRanges.size() - 1; l > 0; --l) {
-#pragma omp for schedule(dynamic)
+            AMRTaskList<range_type> tasks;
+            // levels are restricted from fine to coarse, one level at a time
+            for (auto l = (int) this->localRanges.size() - 1; l > 0; --l) {
+                tasks.clear();
                 for (auto p = 0; p < this->localRanges[l].size(); ++p) {
                     for (auto& i_p : this->mesh.parents[l][p]) {
                         auto rp = this->localRanges[l - 1][i_p];
@@ -269,20 +261,25 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
                             rc.end[i] /= ratio;
                         }
                         rc.level = l - 1;
-                        rangeFor_s(DS::commonRange(rp, rc), [&](auto&& i) {
-                            auto rt = rc;
-                            for (auto k = 0; k < dim; ++k) {
-                                rt.start[k] = i[k] * ratio;
-                                rt.end[k] = (i[k] + 1) * ratio;
-                            }
-                            rt.level = l;
-                            this->operator[](i) = rangeReduce_s(
-                                                          rt, [](auto&& a, auto&& b) { return a + b; },
-                                                          [&](auto&& k) { return this->operator[](k); })
-                                                  / Math::int_pow(ratio, dim);
-                        });
+                        tasks.push(DS::commonRange(rp, rc), p);
+                        detachPatch(l - 1, i_p);
                     }
                 }
+                amrTaskFor(tasks, [&](const AMRTask<range_type>& t) {
+                    rangeFor_s(t.range, [&](auto&& i) {
+                        auto rt = t.range;
+                        for (auto k = 0; k < dim; ++k) {
+                            rt.start[k] = i[k] * ratio;
+                            rt.end[k] = (i[k] + 1) * ratio;
+                        }
+                        rt.level = l;
+                        rt.part = t.tag;
+                        this->operator[](i) = rangeReduce_s(
+                                                      rt, [](auto&& a, auto&& b) { return a + b; },
+                                                      [&](auto&& k) { return this->operator[](k); })
+                                              / Math::int_pow(ratio, dim);
+                    });
+                });
             }
         }
         void replaceMeshBy(auto&& m) {
@@ -293,31 +290,53 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
                 builder.setBC(i, DimPos::end, this->bc[i].end);
             }
             auto f = builder.build();
+            if (this->mesh.patchIndex.size() != this->mesh.ranges.size()) this->mesh.buildRelations();
+            // find the new patches identical to an old one. their storage is moved instead of copied
+            auto same_range = [](const auto& a, const auto& b) { return a.start == b.start && a.end == b.end; };
+            std::vector<std::vector<int>> reuse(f.accessibleRanges.size());
+            for (auto l = 0; l < reuse.size(); ++l) {
+                reuse[l].assign(f.accessibleRanges[l].size(), -1);
+                if (l >= this->accessibleRanges.size()) continue;
+                for (auto p_new = 0; p_new < reuse[l].size(); ++p_new) {
+                    this->mesh.patchIndex[l].query(f.localRanges[l][p_new], [&](int p) {
+                        if (same_range(this->localRanges[l][p], f.localRanges[l][p_new])
+                            && same_range(this->accessibleRanges[l][p], f.accessibleRanges[l][p_new]))
+                            reuse[l][p_new] = p;
+                    });
+                }
+            }
+            // the new mesh may have more or fewer levels than the old one. new levels are only
+            // filled from the coarser data, & extra old levels are dropped
+            const int old_levels = this->accessibleRanges.size();
 #pragma omp parallel
-            for (auto l = 0; l < this->accessibleRanges.size(); ++l) {
+            for (auto l = 0; l < f.accessibleRanges.size(); ++l) {
                 if (l > 0) {
                     // copy all coarser data from new to new
 #pragma omp for schedule(dynamic)
                     for (auto p_new = 0; p_new < f.accessibleRanges[l].size(); ++p_new) {
-                        for (auto p = 0; p < f.accessibleRanges[l - 1].size(); ++p) {
+                        if (reuse[l][p_new] >= 0) continue;
+                        for (auto p : f.mesh.parents[l][p_new]) {
                             auto r_upcast = f.localRanges[l - 1][p];
                             for (auto i = 0; i < dim; ++i) {
-                                r_upcast.start[i] *= this->mesh.refinementRatio;
-                                r_upcast.end[i] *= this->mesh.refinementRatio;
+                                r_upcast.start[i] *= f.mesh.refinementRatio;
+                                r_upcast.end[i] *= f.mesh.refinementRatio;
                             }
                             r_upcast.level = l;
                             rangeFor_s(DS::commonRange(r_upcast, f.localRanges[l][p_new]), [&](auto&& i) {
                                 auto i_new = i;
                                 i_new.p = p_new;
-                                auto i_old = i.toLevel(l - 1, this->mesh.refinementRatio);
+                                auto i_old = i.toLevel(l - 1, f.mesh.refinementRatio);
                                 f[i_new] = f[i_old];
                             });
                         }
                     }
                 }
+                if (l >= old_levels) continue;
 #pragma omp for schedule(dynamic)
                 for (auto p_new = 0; p_new < f.accessibleRanges[l].size(); ++p_new) {
-                    for (auto p = 0; p < this->accessibleRanges[l].size(); ++p) {
+                    if (reuse[l][p_new] >= 0) continue;
+                    // only visit the old patches overlapping with p_new
+                    this->mesh.patchIndex[l].query(f.localRanges[l][p_new], [&](int p) {
                         // copy each overlapping region of (p, p_new)
                         rangeFor_s(DS::commonRange(this->localRanges[l][p], f.localRanges[l][p_new]),
                                    [&](auto&& i) {
@@ -327,7 +346,12 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
                                        i_new.p = p_new;
                                        f[i_new] = this->operator[](i_old);
                                    });
-                    }
+                    });
+                }
+                // old data on level l is no longer read from here on
+#pragma omp for
+                for (auto p_new = 0; p_new < f.accessibleRanges[l].size(); ++p_new) {
+                    if (reuse[l][p_new] >= 0) f.data[l][p_new] = std::move(this->data[l][reuse[l][p_new]]);
                 }
             }
             std::swap(this->data, f.data);
@@ -341,19 +365,57 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
             updateCovering();
         }
 
+        /// \brief Take private copies of the patches shared with other fields before writing to them
+        /// \details Writes through operator[] detach the patch by themselves. Assignments, initBy & padding
+        /// updates detach the patches they write ahead of the loop, so that the copies are made in parallel.
+        void detachStorage() {
+            for (auto& l : data)
+                for (auto& p : l) detachTensor(p);
+        }
+
+        void detachPatch(int l, int p) { detachTensor(data[l][p]); }
+
+    private:
+        static void detachTensor(C& c) {
+            if constexpr (requires { c.detach(); }) c.detach();
+        }
+
+        // detach the patches with non-empty ranges in \p ranges
+        void detachPatches(const auto& ranges) {
+            for (auto l = 0; l < ranges.size(); ++l)
+                for (auto p = 0; p < ranges[l].size(); ++p)
+                    if (!ranges[l][p].empty()) detachPatch(l, p);
+        }
+
+        /// \brief Copy of the patches of \p d, each sharing its storage until either side writes to it
+        /// \details Patches detach one by one on their first write, so only the written ones are copied.
+        static std::vector<std::vector<C>> shareStorage(const std::vector<std::vector<C>>& d) {
+            if constexpr (requires(const C& c) { c.share(); }) {
+                std::vector<std::vector<C>> ret(d.size());
+                for (auto l = 0; l < d.size(); ++l) {
+                    ret[l].reserve(d[l].size());
+                    for (const auto& p : d[l]) ret[l].push_back(p.share());
+                }
+                return ret;
+            } else
+                return d;
+        }
+
     protected:
         auto getViewImpl_final() {
             OP_NOT_IMPLEMENTED;
             return 0;
         }
-        const auto& evalAtImpl_final(const index_type& i) const {
+        decltype(auto) evalAtImpl_final(const index_type& i) const {
+            return data[i.l][i.p][i - offset[i.l][i.p]];
+        }
+        decltype(auto) evalSafeAtImpl_final(const index_type& i) const {
             return data[i.l][i.p][i - offset[i.l][i.p]];
         }
-        const auto& evalSafeAtImpl_final(const index_type& i) const {
+        decltype(auto) evalAtImpl_final(const index_type& i) { return data[i.l][i.p][i - offset[i.l][i.p]]; }
+        decltype(auto) evalSafeAtImpl_final(const index_type& i) {
             return data[i.l][i.p][i - offset[i.l][i.p]];
         }
-        auto& evalAtImpl_final(const index_type& i) { return data[i.l][i.p][i - offset[i.l][i.p]]; }
-        auto& evalSafeAtImpl_final(const index_type& i) { return data[i.l][i.p][i - offset[i.l][i.p]]; }
 
         template <typename Other>
         requires(!std::same_as<Other, CartAMRField>) bool containsImpl_final(const Other& o) const {
@@ -49,7 +49,7 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
         }
         StencilField(StencilField&&) noexcept = default;
         explicit StencilField(const T& base, int color = 0) : base(&base), color(color) {
-            this->name = std::format("StencilField({})", base.name);
+            this->name = std::format("StencilField({})", base.getName());
             if constexpr (StructuredFieldExprType<T>) this->loc = base.loc;
             this->mesh = base.mesh.getView();
             this->localRange = base.localRange;
@@ -387,7 +387,7 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
             : CartAMRFieldExpr<StencilField>(std::move(other)), data(std::move(other.data)),
               block_mark(std::move(other.block_mark)), offset(std::move(other.offset)) {}
         explicit StencilField(const T& base, int color) : color(color) {
-            this->name = std::format("StencilField({})", base.name);
+            this->name = std::format("StencilField({})", base.getName());
             this->loc = base.loc;
             this->mesh = base.mesh;
             this->localRanges = base.localRanges;
@@ -531,8 +531,9 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
             return data[i.l][i.p][i - offset[i.l][i.p]];
         }
         auto& evalAtImpl_final(const index_type& i) { return data[i.l][i.p][i - offset[i.l][i.p]]; }
-        auto& blocked(const index_type& i) { return block_mark[i.l][i.p][i - offset[i.l][i.p]]; }
-        const auto& blocked(const index_type& i) const { return block_mark[i.l][i.p][i - offset[i.l][i.p]]; }
+        // the marks are bit-packed, so a proxy to the bit is returned
+        auto blocked(const index_type& i) { return block_mark[i.l][i.p][i - offset[i.l][i.p]]; }
+        bool blocked(const index_type& i) const { return block_mark[i.l][i.p][i - offset[i.l][i.p]]; }
 
         template <typename Other>
         requires(!std::same_as<Other, StencilField>) bool containsImpl_final(const Other& o) const {
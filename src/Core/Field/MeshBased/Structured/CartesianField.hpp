@@ -34,6 +34,9 @@
 #endif
 
 OPFLOW_MODULE_EXPORT namespace OpFlow {
+    template <typename D, typename M, int N>
+    struct CartesianVectorField;
+
     template <typename D, typename M, typename C = DS::PlainTensor<D, internal::MeshTrait<M>::dim>>
     struct CartesianField : CartesianFieldExpr<CartesianField<D, M, C>> {
         using index_type = typename internal::CartesianFieldExprTrait<CartesianField>::index_type;
@@ -41,12 +44,18 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
     private:
         C data;
         std::array<DS::Pair<int>, internal::MeshTrait<M>::dim> ext_width;
+        bool pitch_padding = false;// pad the storage extents against cache set conflicts, see allocStorage
         bool initialized = false;
         constexpr static auto dim = internal::MeshTrait<M>::dim;
 
     public:
         friend ExprBuilder<CartesianField>;
         friend Expr<CartesianField>;
+        template <typename, typename, int>
+        friend struct CartesianVectorField;
+        template <typename, typename, typename>
+        friend struct CartesianField;
+        friend internal::FieldAssigner;
         using Expr<CartesianField>::operator();
         using Expr<CartesianField>::operator[];
         using Expr<CartesianField>::operator=;
@@ -55,8 +64,8 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
 
         CartesianField() = default;
         CartesianField(const CartesianField& other)
-            : CartesianFieldExpr<CartesianField<D, M, C>>(other), data(other.data),
-              ext_width(other.ext_width), initialized(true) {
+            : CartesianFieldExpr<CartesianField<D, M, C>>(other), data(shareStorage(other.data)),
+              ext_width(other.ext_width), pitch_padding(other.pitch_padding), initialized(true) {
             for (auto i = 0; i < internal::ExprTrait<CartesianField>::dim; ++i) {
                 bc[i].start = other.bc[i].start ? other.bc[i].start->getCopy() : nullptr;
                 if (bc[i].start && isLogicalBC(bc[i].start->getBCType()))
@@ -66,9 +75,15 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
                     dynamic_cast<LogicalBCBase<CartesianField>*>(bc[i].end.get())->rebindField(*this);
             }
         }
+        /// \brief Copy of a field stored in another precision
+        template <typename OD, typename OC>
+        requires(!std::same_as<OD, D>) explicit CartesianField(const CartesianField<OD, M, OC>& other) {
+            assignImpl_final(other);
+        }
         CartesianField(CartesianField&& other) noexcept
             : CartesianFieldExpr<CartesianField<D, M, C>>(std::move(other)), data(std::move(other.data)),
-              initialized(true), bc(std::move(other.bc)), ext_width(std::move(other.ext_width)) {}
+              initialized(true), bc(std::move(other.bc)), ext_width(std::move(other.ext_width)),
+              pitch_padding(other.pitch_padding) {}
 
         CartesianField& operator=(const CartesianField& other) {
             assignImpl_final(other);
@@ -87,7 +102,7 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
 #if defined(OPFLOW_WITH_MPI) && defined(OPFLOW_DISTRIBUTE_MODEL_MPI)
             if (!strategy) return;
             auto old_local_range = this->localRange;
-            auto old_splitMap = this->splitMap;
+            auto old_splitMap = this->getSplitMap();
             auto new_local_range = strategy->splitRange(this->mesh.getRange(), getGlobalParallelPlan());
             auto new_splitMap = strategy->getSplitMap(this->mesh.getRange(), getGlobalParallelPlan());
             for (int i = 0; i < dim; ++i) {
@@ -103,7 +118,7 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
 
             // find each potential intersections with each rank
             std::vector<DS::Range<dim>> intersections(getWorkerCount());
-            for (int i = 0; i < this->splitMap.size(); ++i) {
+            for (int i = 0; i < old_splitMap.size(); ++i) {
                 intersections[i] = DS::commonRange(old_local_range, new_splitMap[i]);
             }
             std::vector<std::vector<D>> send_buff;
@@ -147,11 +162,8 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
                 }
             }
             // reshape data array
-            this->data.reShape(new_local_range.getInnerRange(-this->padding).getExtends());
-            this->offset = typename internal::CartesianFieldExprTrait<CartesianField>::index_type(
-                    new_local_range.getInnerRange(-this->padding).getOffset());
+            allocStorage(new_local_range);
             this->localRange = new_local_range;
-            this->splitMap = new_splitMap;
 
             // loop over all requests
             int finished_count = 0;
@@ -171,19 +183,91 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
                     }
                 }
             }
-            this->updateNeighbors();
+            this->updateLayout(std::move(new_splitMap));
             updatePaddingImpl_final();
 #endif
         }
 
+        /// \brief Number of true points in the local range of a mask stored bit-packed
+        long long count() const requires requires(const C& c, const DS::Range<dim>& r) { c.count(r); }
+        {
+            auto range = this->localRange;
+            for (int i = 0; i < dim; ++i) {
+                range.start[i] -= this->offset[i];
+                range.end[i] -= this->offset[i];
+            }
+            return data.count(range);
+        }
+
+        /// \brief Re-allocate the storage with the same shape. Values are discarded
+        void reallocStorage() { allocStorage(this->localRange); }
+
+        /// \brief Allocate the storage for \p local extended by the padding & set the index offset
+        /// \details In first touch mode the pages are placed following the partition of the loops over
+        /// \p local, if the container supports it. With pitch padding the inner extents of the storage are
+        /// grown by C::paddedPitch; indices & ranges are unaffected.
+        void allocStorage(const DS::Range<dim>& local) {
+            auto padded = local.getInnerRange(-this->padding);
+            auto extends = padded.getExtends();
+            if constexpr (requires { data.reShape(extends, padded); }) {
+                auto start = local.start, end = local.end;
+                for (int i = 0; i < dim; ++i) {
+                    start[i] -= padded.start[i];
+                    end[i] -= padded.start[i];
+                }
+                if constexpr (requires { C::paddedPitch(extends); }) {
+                    data.reShape(extends, DS::Range<dim>(start, end),
+                                 pitch_padding ? C::paddedPitch(extends) : extends);
+                } else {
+                    data.reShape(extends, DS::Range<dim>(start, end));
+                }
+            } else {
+                data.reShape(extends);
+            }
+            this->offset = typename internal::CartesianFieldExprTrait<CartesianField>::index_type(
+                    padded.getOffset());
+        }
+
+        /// \brief BC of this field converted from \p src of a field of another type
+        /// \details Logical BCs read from the field they're bound to, so they're rebuilt by type for this
+        /// field; the others are evaluated through a proxy.
+        template <typename F>
+        std::unique_ptr<BCBase<CartesianField>> convertBC(const BCBase<F>& src, int d, DimPos pos) const {
+            switch (src.getBCType()) {
+                case BCType::Symm:
+                    return genLogicalBC<BCType::Symm>(*this, d, pos);
+                case BCType::ASymm:
+                    return genLogicalBC<BCType::ASymm>(*this, d, pos);
+                case BCType::Periodic:
+                    return genLogicalBC<BCType::Periodic>(*this, d, pos);
+                default:
+                    return genProxyBC<CartesianField>(src);
+            }
+        }
+
+        /// \brief Copy of \p c sharing its storage until either side writes, if the container supports it
+        static C shareStorage(const C& c) {
+            if constexpr (requires { c.share(); }) return c.share();
+            else
+                return c;
+        }
+
+        /// \brief Take a private copy of the storage shared with other fields before writing to it
+        /// \details Writes through operator[] detach by themselves; loops writing the whole field call this
+        /// before they start, so that the copy is made in parallel with the first touch placement.
+        void detachStorage() {
+            if constexpr (requires { data.detach(); }) data.detach();
+        }
+
         template <BasicArithOp Op = BasicArithOp::Eq>
         auto& assignImpl_final(const CartesianField& other) {
             if (!initialized) {
                 OP_ASSERT_MSG(Op == BasicArithOp::Eq,
                               "Incremental assignment to uninitialized field is illegal");
                 this->initPropsFrom(other);
-                data = other.data;
+                data = shareStorage(other.data);
                 ext_width = other.ext_width;
+                pitch_padding = other.pitch_padding;
                 initialized = true;
             } else if (this != &other) {
                 internal::FieldAssigner::assign<Op>(other, *this);
@@ -201,7 +285,11 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
                               "Incremental assignment to uninitialized field is illegal");
                 this->initPropsFrom(other);
                 if constexpr (CartesianFieldType<T>) {
-                    data = other.data;
+                    // fields of other element types are converted by the assigner below
+                    pitch_padding = other.pitch_padding;
+                    if constexpr (std::same_as<decltype(data), decltype(other.data)>) data = other.data;
+                    else
+                        allocStorage(this->localRange);
                     ext_width = other.ext_width;
                     if constexpr (std::same_as<Meta::RealType<T>, CartesianField>)
                         for (int i = 0; i < dim; ++i) {
@@ -211,15 +299,13 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
                     else
                         for (int i = 0; i < dim; ++i) {
                             this->bc[i].start = other.bc[i].start
-                                                        ? genProxyBC<CartesianField>(*other.bc[i].start)
+                                                        ? convertBC(*other.bc[i].start, i, DimPos::start)
                                                         : nullptr;
-                            this->bc[i].end = other.bc[i].end ? genProxyBC<CartesianField>(*other.bc[i].end)
-                                                              : nullptr;
+                            this->bc[i].end
+                                    = other.bc[i].end ? convertBC(*other.bc[i].end, i, DimPos::end) : nullptr;
                         }
                 } else {
-                    this->data.reShape(this->localRange.getInnerRange(-this->padding).getExtends());
-                    this->offset = typename internal::CartesianFieldExprTrait<CartesianField>::index_type(
-                            this->localRange.getInnerRange(-this->padding).getOffset());
+                    allocStorage(this->localRange);
                 }
                 // invoke the assigner
                 internal::FieldAssigner::assign<Op>(other, *this);
@@ -239,6 +325,7 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
                 OP_CRITICAL("CartesianField not initialized. Cannot assign constant to it.");
                 OP_ABORT;
             }
+            detachStorage();
             if constexpr (Op == BasicArithOp::Eq)
                 rangeFor(DS::commonRange(this->assignableRange, this->localRange),
                          [&](auto&& i) { this->operator[](i) = c; });
@@ -281,6 +368,7 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
 
         auto&
         initBy(const std::function<D(const std::array<Real, internal::CartesianMeshTrait<M>::dim>&)>& f) {
+            detachStorage();
             rangeFor(DS::commonRange(this->assignableRange, this->localRange), [&](auto&& i) {
                 std::array<Real, internal::CartesianMeshTrait<M>::dim> cords;
                 for (auto k = 0; k < internal::CartesianMeshTrait<M>::dim; ++k)
@@ -295,23 +383,26 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
 
         void prepareImpl_final() const {}
 
-        void updateNeighbors() {
-            if (this->splitMap.size() == 1) {
-                // single node mode
-                this->neighbors.clear();
-            } else {
+        /// \brief Rebuild the shared layout from a new split map
+        /// \details The old layout may still be referenced by expressions built before, so a new one is
+        /// always created instead of being modified in place.
+        void updateLayout(std::vector<DS::Range<dim>> splitMap) {
+            auto layout = std::make_shared<internal::StructuredLayout<DS::Range<dim>>>();
+            layout->splitMap = std::move(splitMap);
+            const auto& split = layout->splitMap;
+            auto& neighbors = layout->neighbors;
+            if (split.size() != 1) {
 #if defined(OPFLOW_WITH_MPI) && defined(OPFLOW_DISTRIBUTE_MODEL_MPI)
                 int rank = getWorkerId();
-                this->neighbors.clear();
                 std::array<bool, dim> is_periodic;
                 for (int d = 0; d < dim; ++d) {
                     is_periodic[d] = this->bc[d].start && this->bc[d].start->getBCType() == BCType::Periodic;
                 }
                 int range_count = Math::int_pow(3, std::count(is_periodic.begin(), is_periodic.end(), true));
-                for (auto i = 0; i < this->splitMap.size(); ++i) {
+                for (auto i = 0; i < split.size(); ++i) {
                     auto mesh_range_extends = this->mesh.getRange().getExtends();
                     for (int k = 0; k < range_count; ++k) {
-                        auto r = this->splitMap[i];
+                        auto r = split[i];
                         for (int d = 0; d < dim; ++d) {
                             int direction
                                     = (k % Math::int_pow(3, d + 1)) / Math::int_pow(3, d);// 0, 1(+), 2(-)
@@ -335,7 +426,7 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
                             auto recv_range
                                     = DS::commonRange(this->localRange.getInnerRange(-this->padding), r);
                             if (send_range.count() > 0) {
-                                this->neighbors.emplace_back(i, send_range, recv_range, k);
+                                neighbors.emplace_back(i, send_range, recv_range, k);
                             }
                         }
                     }
@@ -344,9 +435,35 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
                 OP_CRITICAL("MPI not provided.");
 #endif
             }
+            this->layout = std::move(layout);
         }
 
         void updatePaddingImpl_final() {
+            // the values written come from this field's BCs, which copies sharing the storage may not have,
+            // so a shared storage is detached whenever something is written
+            if (writesPadding()) detachStorage();
+            updateBoundaryPadding();
+            if (this->getSplitMap().size() != 1) exchangePadding();
+        }
+
+        // whether updatePadding writes to the storage, i.e., there's a padding to fill or a Dirichlet
+        // boundary on a nodal dim
+        bool writesPadding() const {
+            if (this->padding > 0 || this->getSplitMap().size() != 1) return true;
+            for (int i = 0; i < dim; ++i) {
+                if (this->loc[i] != LocOnMesh::Corner) continue;
+                if (this->localRange.start[i] == this->accessibleRange.start[i] && this->bc[i].start
+                    && this->bc[i].start->getBCType() == BCType::Dirc)
+                    return true;
+                if (this->localRange.end[i] == this->accessibleRange.end[i] && this->bc[i].end
+                    && this->bc[i].end->getBCType() == BCType::Dirc)
+                    return true;
+            }
+            return false;
+        }
+
+        // fill the paddings from bcs, and along periodic dims of a local field
+        void updateBoundaryPadding() {
             // step 0: update dirc bc for corner case
             for (int i = 0; i < dim; ++i) {
                 // lower side
@@ -366,7 +483,8 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
             // start/end record the start/end index of last padding operation
             // the latter padding op pads the outer range of the former padding zone
             std::array<int, dim> start, end;
-            if constexpr (requires(D v) {
+            // floats narrower than Real are promoted by the scaling with mesh coordinates
+            if constexpr (std::floating_point<D> || requires(D v) {
                               { v + v }
                               ->std::same_as<D>;
                               { v - v }
@@ -605,8 +723,8 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
                 }
             }
 
-            // step 2: update paddings by MPI communication
-            if (this->splitMap.size() == 1) {// no MPI or local field
+            // step 2: update paddings along periodic dims
+            if (this->getSplitMap().size() == 1) {// no MPI or local field
                 // update along periodic dims
                 for (int i = 0; i < dim; ++i) {
                     if (this->bc[i].start && this->bc[i].start->getBCType() == BCType::Periodic) {
@@ -627,158 +745,167 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
                         });
                     }
                 }
-            } else {
-#if defined(OPFLOW_WITH_MPI) && defined(OPFLOW_DISTRIBUTE_MODEL_MPI)
-                int rank = getWorkerId();
-                // one of the following pairs of buffer is used
-                std::vector<std::vector<D>> send_buff, recv_buff;
-                std::vector<std::vector<std::byte>> send_buff_byte, recv_buff_byte;
-                std::vector<std::vector<int>> send_buff_offsets, recv_buff_offsets;
-                std::vector<MPI_Request> requests;
-                auto padded_my_range = this->localRange.getInnerRange(-this->padding);
-                auto mesh_range_extends = this->mesh.getRange().getExtends();
+            }
+        }
 
-                for (const auto& [other_rank, send_range, recv_range, code] : this->neighbors) {
-                    // calculate the intersect range to be send
-                    if constexpr (std::is_trivial_v<D> && std::is_standard_layout_v<D>) {
-                        // pack data into send buffer
-                        send_buff.emplace_back();
-                        requests.emplace_back();
-                        rangeFor_s(send_range, [&](auto&& i) {
-                            OP_DEBUG("Send {} = {}", i, this->operator()(i));
-                            send_buff.back().push_back(this->evalAt(i));
-                        });
-                    } else if constexpr (Serializable<D>) {
-                        // pack data into send buffer
-                        send_buff_byte.emplace_back();
-                        send_buff_offsets.emplace_back();
-                        send_buff_offsets.back().push_back(0);
-                        requests.emplace_back();
-                        rangeFor_s(send_range, [&](auto&& i) {
-                            OP_DEBUG("Send {} = {}", i, this->operator()(i));
-                            std::vector<std::byte> tmp = this->operator()(i).serialize();
-                            send_buff_byte.back().insert(send_buff_byte.back().end(), tmp.begin(), tmp.end());
-                            send_buff_offsets.back().push_back((int) send_buff_byte.back().size());
-                        });
-                    } else {
-                        OP_ERROR("Datatype cannot be serialized.");
-                        OP_ABORT;
-                    }
-                    OP_DEBUG("Send range {} from rank {} to rank {}", send_range.toString(), rank,
-                             other_rank);
-                    auto o_recv_range = send_range;
-                    // inverse the shift to get the recv range on the receiver side
-                    for (int d = 0; d < dim; ++d) {
-                        int direction
-                                = (code % Math::int_pow(3, d + 1)) / Math::int_pow(3, d);// 0, 1(+), 2(-)
-                        switch (direction) {
-                            case 1:
-                                o_recv_range.start[d] -= mesh_range_extends[d] - 1;
-                                o_recv_range.end[d] -= mesh_range_extends[d] - 1;
-                                break;
-                            default:
-                            case 0:
-                                break;
-                            case 2:
-                                o_recv_range.start[d] += mesh_range_extends[d] - 1;
-                                o_recv_range.end[d] += mesh_range_extends[d] - 1;
-                                break;
-                        }
-                    }
-                    if constexpr (std::is_trivial_v<D> && std::is_standard_layout_v<D>)
-                        MPI_Isend(send_buff.back().data(), send_buff.back().size() * sizeof(D) / sizeof(char),
-                                  MPI_CHAR, other_rank,
-                                  std::hash<Meta::RealType<decltype(o_recv_range)>> {}(o_recv_range)
-                                          % (1 << 24),
-                                  MPI_COMM_WORLD, &requests.back());
-                    else if constexpr (Serializable<D>) {
-                        MPI_Isend(send_buff_offsets.back().data(), send_buff_offsets.back().size(), MPI_INT,
-                                  other_rank, rank, MPI_COMM_WORLD, &requests.back());
-                        requests.template emplace_back();
-                        MPI_Isend(send_buff_byte.back().data(), send_buff_byte.back().size(), MPI_BYTE,
-                                  other_rank,
-                                  std::hash<Meta::RealType<decltype(o_recv_range)>> {}(o_recv_range)
-                                          % (1 << 24),
-                                  MPI_COMM_WORLD, &requests.back());
-                    }
+        // fill the paddings shared with other workers
+        void exchangePadding() {
+#if defined(OPFLOW_WITH_MPI) && defined(OPFLOW_DISTRIBUTE_MODEL_MPI)
+            int rank = getWorkerId();
+            // one of the following pairs of buffer is used
+            std::vector<std::vector<D>> send_buff, recv_buff;
+            std::vector<std::vector<std::byte>> send_buff_byte, recv_buff_byte;
+            std::vector<std::vector<int>> send_buff_offsets, recv_buff_offsets;
+            std::vector<MPI_Request> requests;
 
-                    // calculate the intersect range to be received
+            for (const auto& [other_rank, send_range, recv_range, code] : this->getNeighbors()) {
+                // calculate the intersect range to be send
+                if constexpr (std::is_trivial_v<D> && std::is_standard_layout_v<D>) {
+                    // pack data into send buffer
+                    send_buff.emplace_back();
                     requests.emplace_back();
-                    // issue receive request
-                    OP_DEBUG("Recv range {} from rank {} to rank {}", recv_range.toString(), other_rank,
-                             rank);
-                    if constexpr (std::is_trivial_v<D> && std::is_standard_layout_v<D>) {
-                        recv_buff.emplace_back();
-                        recv_buff.back().resize(recv_range.count());
-                        MPI_Irecv(recv_buff.back().data(), recv_buff.back().size() * sizeof(D) / sizeof(char),
-                                  MPI_CHAR, other_rank,
-                                  std::hash<Meta::RealType<decltype(recv_range)>> {}(recv_range) % (1 << 24),
-                                  MPI_COMM_WORLD, &requests.back());
-                    } else if constexpr (Serializable<D>) {
-                        recv_buff_offsets.emplace_back(recv_range.count() + 1);
-                        MPI_Recv(recv_buff_offsets.back().data(), recv_buff_offsets.back().size(), MPI_INT,
-                                 other_rank, other_rank, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-                        recv_buff_byte.emplace_back(recv_buff_offsets.back().back());
-                        MPI_Irecv(recv_buff_byte.back().data(), recv_buff_byte.back().size(), MPI_BYTE,
-                                  other_rank,
-                                  std::hash<Meta::RealType<decltype(recv_range)>> {}(recv_range) % (1 << 24),
-                                  MPI_COMM_WORLD, &requests.back());
-                    }
+                    rangeFor_s(send_range, [&](auto&& i) {
+                        OP_DEBUG("Send {} = {}", i, this->operator()(i));
+                        send_buff.back().push_back(this->evalAt(i));
+                    });
+                } else if constexpr (Serializable<D>) {
+                    // pack data into send buffer
+                    send_buff_byte.emplace_back();
+                    send_buff_offsets.emplace_back();
+                    send_buff_offsets.back().push_back(0);
+                    requests.emplace_back();
+                    rangeFor_s(send_range, [&](auto&& i) {
+                        OP_DEBUG("Send {} = {}", i, this->operator()(i));
+                        std::vector<std::byte> tmp = this->operator()(i).serialize();
+                        send_buff_byte.back().insert(send_buff_byte.back().end(), tmp.begin(), tmp.end());
+                        send_buff_offsets.back().push_back((int) send_buff_byte.back().size());
+                    });
+                } else {
+                    OP_ERROR("Datatype cannot be serialized.");
+                    OP_ABORT;
                 }
-                // wait all communication done
-                std::vector<MPI_Status> status(requests.size());
-                MPI_Waitall(requests.size(), requests.data(), status.data());
-                // check status
-                for (const auto& s : status) {
-                    if (s.MPI_ERROR != MPI_SUCCESS)
-                        OP_CRITICAL("Field {}'s updatePadding failed.", this->getName());
+                OP_DEBUG("Send range {} from rank {} to rank {}", send_range.toString(), rank,
+                         other_rank);
+                auto o_recv_range = getPeerRecvRange(send_range, code);
+                if constexpr (std::is_trivial_v<D> && std::is_standard_layout_v<D>)
+                    MPI_Isend(send_buff.back().data(), send_buff.back().size() * sizeof(D) / sizeof(char),
+                              MPI_CHAR, other_rank,
+                              std::hash<Meta::RealType<decltype(o_recv_range)>> {}(o_recv_range)
+                                      % (1 << 24),
+                              MPI_COMM_WORLD, &requests.back());
+                else if constexpr (Serializable<D>) {
+                    MPI_Isend(send_buff_offsets.back().data(), send_buff_offsets.back().size(), MPI_INT,
+                              other_rank, rank, MPI_COMM_WORLD, &requests.back());
+                    requests.template emplace_back();
+                    MPI_Isend(send_buff_byte.back().data(), send_buff_byte.back().size(), MPI_BYTE,
+                              other_rank,
+                              std::hash<Meta::RealType<decltype(o_recv_range)>> {}(o_recv_range)
+                                      % (1 << 24),
+                              MPI_COMM_WORLD, &requests.back());
                 }
-                // unpack receive buffer
+
+                // calculate the intersect range to be received
+                requests.emplace_back();
+                // issue receive request
+                OP_DEBUG("Recv range {} from rank {} to rank {}", recv_range.toString(), other_rank,
+                         rank);
                 if constexpr (std::is_trivial_v<D> && std::is_standard_layout_v<D>) {
-                    auto recv_iter = recv_buff.begin();
-                    for (const auto& [other_rank, send_range, recv_range, code] : this->neighbors) {
-                        auto _iter = recv_iter->begin();
-                        OP_DEBUG("Unpacking range {}", recv_range.toString());
-                        rangeFor_s(recv_range, [&](auto&& i) {
-                            OP_DEBUG("Unpack {} = {}", i, *_iter);
-                            this->operator()(i) = *_iter++;
-                        });
-                        ++recv_iter;
-                    }
+                    recv_buff.emplace_back();
+                    recv_buff.back().resize(recv_range.count());
+                    MPI_Irecv(recv_buff.back().data(), recv_buff.back().size() * sizeof(D) / sizeof(char),
+                              MPI_CHAR, other_rank,
+                              std::hash<Meta::RealType<decltype(recv_range)>> {}(recv_range) % (1 << 24),
+                              MPI_COMM_WORLD, &requests.back());
                 } else if constexpr (Serializable<D>) {
-                    auto recv_iter = recv_buff_byte.begin();
-                    auto recv_offset_iter = recv_buff_offsets.begin();
-                    for (const auto& [other_rank, send_range, recv_range, code] : this->neighbors) {
-                        auto _iter = recv_iter->begin();
-                        auto _offset_iter = recv_offset_iter->begin();
-                        OP_DEBUG("Unpacking range {}", recv_range.toString());
-                        rangeFor_s(recv_range, [&](auto&& i) {
-                            //OP_INFO("Unpack {} = {}", i, *(char*)&*_iter);
-                            this->operator()(i).deserialize(&(*_iter) + *_offset_iter,
-                                                            *(_offset_iter + 1) - *_offset_iter);
-                            _offset_iter++;
-                        });
-                        ++recv_iter;
-                        ++recv_offset_iter;
-                    }
+                    recv_buff_offsets.emplace_back(recv_range.count() + 1);
+                    MPI_Recv(recv_buff_offsets.back().data(), recv_buff_offsets.back().size(), MPI_INT,
+                             other_rank, other_rank, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+                    recv_buff_byte.emplace_back(recv_buff_offsets.back().back());
+                    MPI_Irecv(recv_buff_byte.back().data(), recv_buff_byte.back().size(), MPI_BYTE,
+                              other_rank,
+                              std::hash<Meta::RealType<decltype(recv_range)>> {}(recv_range) % (1 << 24),
+                              MPI_COMM_WORLD, &requests.back());
                 }
+            }
+            // wait all communication done
+            std::vector<MPI_Status> status(requests.size());
+            MPI_Waitall(requests.size(), requests.data(), status.data());
+            // check status
+            for (const auto& s : status) {
+                if (s.MPI_ERROR != MPI_SUCCESS)
+                    OP_CRITICAL("Field {}'s updatePadding failed.", this->getName());
+            }
+            // unpack receive buffer
+            if constexpr (std::is_trivial_v<D> && std::is_standard_layout_v<D>) {
+                auto recv_iter = recv_buff.begin();
+                for (const auto& [other_rank, send_range, recv_range, code] : this->getNeighbors()) {
+                    auto _iter = recv_iter->begin();
+                    OP_DEBUG("Unpacking range {}", recv_range.toString());
+                    rangeFor_s(recv_range, [&](auto&& i) {
+                        OP_DEBUG("Unpack {} = {}", i, *_iter);
+                        this->operator()(i) = *_iter++;
+                    });
+                    ++recv_iter;
+                }
+            } else if constexpr (Serializable<D>) {
+                auto recv_iter = recv_buff_byte.begin();
+                auto recv_offset_iter = recv_buff_offsets.begin();
+                for (const auto& [other_rank, send_range, recv_range, code] : this->getNeighbors()) {
+                    auto _iter = recv_iter->begin();
+                    auto _offset_iter = recv_offset_iter->begin();
+                    OP_DEBUG("Unpacking range {}", recv_range.toString());
+                    rangeFor_s(recv_range, [&](auto&& i) {
+                        //OP_INFO("Unpack {} = {}", i, *(char*)&*_iter);
+                        this->operator()(i).deserialize(&(*_iter) + *_offset_iter,
+                                                        *(_offset_iter + 1) - *_offset_iter);
+                        _offset_iter++;
+                    });
+                    ++recv_iter;
+                    ++recv_offset_iter;
+                }
+            }
 #else
-                OP_CRITICAL("MPI not provided.");
+            OP_CRITICAL("MPI not provided.");
 #endif
+        }
+
+#if defined(OPFLOW_WITH_MPI) && defined(OPFLOW_DISTRIBUTE_MODEL_MPI)
+        /// \brief The range \p send_range sent to the neighbor of \p code is received into on its side
+        auto getPeerRecvRange(const DS::Range<dim>& send_range, int code) const {
+            auto mesh_range_extends = this->mesh.getRange().getExtends();
+            auto o_recv_range = send_range;
+            // inverse the shift to get the recv range on the receiver side
+            for (int d = 0; d < dim; ++d) {
+                int direction = (code % Math::int_pow(3, d + 1)) / Math::int_pow(3, d);// 0, 1(+), 2(-)
+                switch (direction) {
+                    case 1:
+                        o_recv_range.start[d] -= mesh_range_extends[d] - 1;
+                        o_recv_range.end[d] -= mesh_range_extends[d] - 1;
+                        break;
+                    default:
+                    case 0:
+                        break;
+                    case 2:
+                        o_recv_range.start[d] += mesh_range_extends[d] - 1;
+                        o_recv_range.end[d] += mesh_range_extends[d] - 1;
+                        break;
+                }
             }
+            return o_recv_range;
         }
+#endif
 
         auto getViewImpl_final() {
             OP_NOT_IMPLEMENTED;
             return 0;
         }
-        const auto& evalAtImpl_final(const index_type& i) const {
+        decltype(auto) evalAtImpl_final(const index_type& i) const {
             OP_ASSERT_MSG(DS::inRange(this->getLocalReadableRange(), i),
                           "Cannot eval {} at {}: out of range {}", this->getName(), i,
                           this->getLocalReadableRange().toString());
             return data[i - this->offset];
         }
-        auto& evalAtImpl_final(const index_type& i) {
+        decltype(auto) evalAtImpl_final(const index_type& i) {
             OP_ASSERT_MSG(DS::inRange(this->getLocalReadableRange(), i),
                           "Cannot eval {} at {}: out of range {}", this->getName(), i,
                           this->getLocalWritableRange().toString());
@@ -921,6 +1048,13 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
             return *this;
         }
 
+        /// \brief Pad the inner extents of the storage to break power-of-two strides
+        /// \details Only the memory layout changes; see DS::PlainTensor::paddedPitch.
+        auto& setPitchPadding(bool p = true) {
+            f.pitch_padding = p;
+            return *this;
+        }
+
         auto& setSplitStrategy(std::shared_ptr<AbstractSplitStrategy<CartesianField<D, M, C>>> s) {
             strategy = s;
             return *this;
@@ -930,9 +1064,7 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
             calculateRanges();
             validateRanges();
             OP_ASSERT(f.localRange.check() && f.accessibleRange.check() && f.assignableRange.check());
-            f.data.reShape(f.localRange.getInnerRange(-f.padding).getExtends());
-            f.offset = typename internal::CartesianFieldExprTrait<Field>::index_type(
-                    f.localRange.getInnerRange(-f.padding).getOffset());
+            f.allocStorage(f.localRange);
             f.updatePadding();
             return f;
         }
@@ -1002,11 +1134,12 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
                 f.logicalRange.end[i] = f.accessibleRange.end[i] + f.ext_width[i].end;
             }
             // calculate localRange
+            std::vector<DS::Range<dim>> splitMap;
             if (strategy) {
                 // always split the mesh range to make sure associated fields shares the same split
                 // note: the returned local range is in centered mode
                 f.localRange = strategy->splitRange(f.mesh.getRange(), getGlobalParallelPlan());
-                f.splitMap = strategy->getSplitMap(f.mesh.getRange(), getGlobalParallelPlan());
+                splitMap = strategy->getSplitMap(f.mesh.getRange(), getGlobalParallelPlan());
                 // adjust the local range according to the location & bc
                 for (auto i = 0; i < dim; ++i) {
                     auto loc = f.loc[i];
@@ -1015,17 +1148,16 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
                     // periodic bc can be trimmed by the min operation
                     if (loc == LocOnMesh::Corner && f.localRange.end[i] == f.mesh.getRange().end[i] - 1)
                         f.localRange.end[i] = std::min(f.localRange.end[i] + 1, f.accessibleRange.end[i]);
-                    for (auto& range : f.splitMap) {
+                    for (auto& range : splitMap) {
                         if (loc == LocOnMesh::Corner && range.end[i] == f.mesh.getRange().end[i] - 1)
                             range.end[i] = std::min(range.end[i] + 1, f.accessibleRange.end[i]);
                     }
                 }
             } else {
                 f.localRange = f.accessibleRange;
-                f.splitMap.clear();
-                f.splitMap.push_back(f.localRange);
+                splitMap.push_back(f.localRange);
             }
-            f.updateNeighbors();
+            f.updateLayout(std::move(splitMap));
         }
 
         CartesianField<D, M, C> f;
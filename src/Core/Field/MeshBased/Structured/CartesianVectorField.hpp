@@ -0,0 +1,293 @@
+// ----------------------------------------------------------------------------
+//
+// Copyright (c) 2019 - 2026 by the OpFlow developers
+//
+// This file is part of OpFlow.
+//
+// OpFlow is free software and is distributed under the MPL v2.0 license.
+// The full text of the license can be found in the file LICENSE at the top
+// level directory of OpFlow.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef OPFLOW_CARTESIANVECTORFIELD_HPP
+#define OPFLOW_CARTESIANVECTORFIELD_HPP
+
+#include "CartesianField.hpp"
+#include "Core/Loops/RangeFor.hpp"
+#include "Core/Macros.hpp"
+#include "Utils/Allocator/ScratchPool.hpp"
+#ifndef OPFLOW_INSIDE_MODULE
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#endif
+
+OPFLOW_MODULE_EXPORT namespace OpFlow {
+    /// \brief A field of N components sharing the mesh, location, ranges & halo plan
+    /// \details Each component is a regular CartesianField, but their storages are packed one after
+    /// another (SoA) into one block. The components can be assigned in one sweep by assign(), and their
+    /// paddings are exchanged with one message per neighbor instead of one per component.
+    /// \tparam D Element type of a component
+    /// \tparam M Mesh type
+    /// \tparam N Number of components
+    template <typename D, typename M, int N>
+    struct CartesianVectorField {
+        using Field = CartesianField<D, M>;
+        using index_type = typename Field::index_type;
+        constexpr static auto dim = internal::MeshTrait<M>::dim;
+        static_assert(N > 0, "A vector field needs at least one component");
+
+        friend ExprBuilder<CartesianVectorField>;
+
+        CartesianVectorField() = default;
+        CartesianVectorField(const CartesianVectorField& other)
+            : CartesianVectorField(other, std::make_index_sequence<N> {}) {}
+        CartesianVectorField(CartesianVectorField&&) noexcept = default;
+
+        CartesianVectorField& operator=(const CartesianVectorField& other) {
+            if (this == &other) return *this;
+            if (!comps) *this = CartesianVectorField(other);
+            else
+                assignFrom(other, std::make_index_sequence<N> {});
+            return *this;
+        }
+        CartesianVectorField& operator=(CartesianVectorField&&) noexcept = default;
+
+        auto& operator[](int i) { return (*comps)[i]; }
+        const auto& operator[](int i) const { return (*comps)[i]; }
+        constexpr static int size() { return N; }
+        const auto& getName() const { return name; }
+
+        /// \brief Assign \p es to the components
+        /// \details The expressions are evaluated in one sweep unless they read the components around the
+        /// points being updated, in which case they're evaluated into pooled temporaries first.
+        template <CartesianFieldExprType... E>
+        requires(sizeof...(E) == N) auto& assign(E&&... es) {
+            assignImpl(std::make_index_sequence<N> {}, es...);
+            updatePadding();
+            return *this;
+        }
+
+        void updatePadding() {
+            for (auto& c : *comps) c.updateBoundaryPadding();
+            if ((*comps)[0].getSplitMap().size() == 1) return;
+            if constexpr (std::is_trivial_v<D> && std::is_standard_layout_v<D>) {
+                if (sharesLayout()) {
+                    exchangePadding();
+                    return;
+                }
+            }
+            for (auto& c : *comps) c.exchangePadding();
+        }
+
+    private:
+        CartesianVectorField(std::unique_ptr<std::array<Field, N>> c, std::string n)
+            : comps(std::move(c)), name(std::move(n)) {
+            pack();
+        }
+
+        template <std::size_t... I>
+        CartesianVectorField(const CartesianVectorField& other, std::index_sequence<I...>)
+            : comps(other.comps ? new std::array<Field, N> {Field(other[I])...} : nullptr), name(other.name) {
+            if (comps) pack();
+        }
+
+        // move the storage of each component into the block & share the halo plan of the first component
+        void pack() {
+            auto& c = *comps;
+            for (int k = 1; k < N; ++k) {
+                if (!(c[k].localRange == c[0].localRange) || c[k].padding != c[0].padding) {
+                    OP_CRITICAL("Components of vector field {} have different local ranges.", name);
+                    OP_ABORT;
+                }
+            }
+            // keep each component aligned as the block is
+            constexpr long long lane = 64 % sizeof(D) == 0 ? 64 / sizeof(D) : 1;
+            auto stride = (c[0].data.size() + lane - 1) / lane * lane;
+            block.reShape(std::array {(int) (N * stride)});
+            for (int k = 0; k < N; ++k) {
+                c[k].data.bindStorage(block.raw() + k * stride);
+                if (samePeriodicity(c[k], c[0])) c[k].layout = c[0].layout;
+            }
+        }
+
+        static bool samePeriodicity(const Field& a, const Field& b) {
+            auto periodic = [](const auto& bc) { return bc && bc->getBCType() == BCType::Periodic; };
+            for (int d = 0; d < dim; ++d)
+                if (periodic(a.bc[d].start) != periodic(b.bc[d].start)) return false;
+            return true;
+        }
+
+        bool sharesLayout() const {
+            return std::all_of(comps->begin(), comps->end(),
+                               [&](const auto& c) { return c.layout == (*comps)[0].layout; });
+        }
+
+        static auto assignRange(const Field& f) { return DS::commonRange(f.assignableRange, f.localRange); }
+
+        template <std::size_t... I>
+        void assignFrom(const CartesianVectorField& other, std::index_sequence<I...>) {
+            assign(other[I]...);
+        }
+
+        template <std::size_t... I, typename... E>
+        void assignImpl(std::index_sequence<I...>, E&... es) {
+            auto& c = *comps;
+            (es.prepare(), ...);
+            auto width = -1;
+            for (const auto& f : c) width = std::max({width, es.readWidth(f)...});
+            auto same_ranges = ((assignRange(c[I]) == assignRange(c[0])) && ...);
+            if (width > 0 || (width == 0 && !same_ranges)) {
+                // a component may still be read after its own update, either by the neighbors of a point
+                // or by a later sweep over another range, so none is written before all are done
+                std::array<Field, N> temps {Utils::scratchCopy(c[I])...};
+                (rangeFor(assignRange(temps[I]), [&](auto&& i) { temps[I][i] = es.evalAt(i); }), ...);
+                (rangeFor(assignRange(c[I]), [&](auto&& i) { c[I][i] = temps[I][i]; }), ...);
+            } else if (same_ranges) {
+                rangeFor(assignRange(c[0]), [&](auto&& i) {
+                    std::array<D, N> v {static_cast<D>(es.evalAt(i))...};
+                    ((c[I][i] = v[I]), ...);
+                });
+            } else {
+                (rangeFor(assignRange(c[I]), [&](auto&& i) { c[I][i] = es.evalAt(i); }), ...);
+            }
+        }
+
+        // exchange the paddings of all components with one message per neighbor
+        void exchangePadding() {
+#if defined(OPFLOW_WITH_MPI) && defined(OPFLOW_DISTRIBUTE_MODEL_MPI)
+            auto& c = *comps;
+            const auto& neighbors = c[0].getNeighbors();
+            std::vector<std::vector<D>> send_buff(neighbors.size()), recv_buff(neighbors.size());
+            std::vector<MPI_Request> requests(2 * neighbors.size());
+            for (std::size_t n = 0; n < neighbors.size(); ++n) {
+                const auto& [other_rank, send_range, recv_range, code] = neighbors[n];
+                send_buff[n].reserve(N * send_range.count());
+                for (const auto& f : c)
+                    rangeFor_s(send_range, [&](auto&& i) { send_buff[n].push_back(f.evalAt(i)); });
+                auto o_recv_range = c[0].getPeerRecvRange(send_range, code);
+                MPI_Isend(send_buff[n].data(), send_buff[n].size() * sizeof(D), MPI_BYTE, other_rank,
+                          std::hash<DS::Range<dim>> {}(o_recv_range) % (1 << 24), MPI_COMM_WORLD,
+                          &requests[2 * n]);
+                recv_buff[n].resize(N * recv_range.count());
+                MPI_Irecv(recv_buff[n].data(), recv_buff[n].size() * sizeof(D), MPI_BYTE, other_rank,
+                          std::hash<DS::Range<dim>> {}(recv_range) % (1 << 24), MPI_COMM_WORLD,
+                          &requests[2 * n + 1]);
+            }
+            std::vector<MPI_Status> status(requests.size());
+            MPI_Waitall(requests.size(), requests.data(), status.data());
+            for (const auto& s : status) {
+                if (s.MPI_ERROR != MPI_SUCCESS)
+                    OP_CRITICAL("Vector field {}'s updatePadding failed.", name);
+            }
+            for (std::size_t n = 0; n < neighbors.size(); ++n) {
+                auto iter = recv_buff[n].begin();
+                for (auto& f : c) rangeFor_s(neighbors[n].recv_range, [&](auto&& i) { f(i) = *iter++; });
+            }
+#else
+            OP_CRITICAL("MPI not provided.");
+#endif
+        }
+
+        // held by pointer, so that moves keep the components & the bcs bound to them in place
+        std::unique_ptr<std::array<Field, N>> comps;
+        DS::PlainTensor<D, 1> block;
+        std::string name;
+    };
+
+    template <typename D, typename M, int N>
+    struct ExprBuilder<CartesianVectorField<D, M, N>> {
+        using Field = CartesianVectorField<D, M, N>;
+        using Component = CartesianField<D, M>;
+        using Mesh = M;
+        static constexpr auto dim = internal::MeshTrait<M>::dim;
+        ExprBuilder() = default;
+
+        /// \brief Set the name of the field. Components are named \p n_0, \p n_1, ...
+        auto& setName(const std::string& n) {
+            name = n;
+            for (int k = 0; k < N; ++k) comps[k].setName(n + "_" + std::to_string(k));
+            return *this;
+        }
+
+        auto& setNameOfComp(int k, const std::string& n) {
+            comps[k].setName(n);
+            return *this;
+        }
+
+        auto& setMesh(const Mesh& m) {
+            for (auto& c : comps) c.setMesh(m);
+            return *this;
+        }
+
+        auto& setLoc(const std::array<LocOnMesh, dim>& loc) {
+            for (auto& c : comps) c.setLoc(loc);
+            return *this;
+        }
+
+        auto& setLoc(LocOnMesh loc) {
+            for (auto& c : comps) c.setLoc(loc);
+            return *this;
+        }
+
+        auto& setLocOfDim(int i, LocOnMesh loc) {
+            for (auto& c : comps) c.setLocOfDim(i, loc);
+            return *this;
+        }
+
+        // set the same bc for all components
+        template <typename... Args>
+        auto& setBC(int d, DimPos pos, BCType type, const Args&... args) {
+            for (auto& c : comps) c.setBC(d, pos, type, args...);
+            return *this;
+        }
+
+        // set the bc of the k-th component
+        template <typename... Args>
+        auto& setBCOfComp(int k, int d, DimPos pos, Args&&... args) {
+            comps[k].setBC(d, pos, std::forward<Args>(args)...);
+            return *this;
+        }
+
+        auto& setExt(int d, DimPos pos, int width) {
+            for (auto& c : comps) c.setExt(d, pos, width);
+            return *this;
+        }
+
+        auto& setExt(int width) {
+            for (auto& c : comps) c.setExt(width);
+            return *this;
+        }
+
+        auto& setPadding(int p) {
+            for (auto& c : comps) c.setPadding(p);
+            return *this;
+        }
+
+        auto& setSplitStrategy(std::shared_ptr<AbstractSplitStrategy<Component>> s) {
+            for (auto& c : comps) c.setSplitStrategy(s);
+            return *this;
+        }
+
+        auto& build() {
+            f = Field(buildComps(std::make_index_sequence<N> {}), name);
+            return f;
+        }
+
+    private:
+        template <std::size_t... I>
+        auto buildComps(std::index_sequence<I...>) {
+            return std::unique_ptr<std::array<Component, N>>(
+                    new std::array<Component, N> {Component(comps[I].build())...});
+        }
+
+        std::array<ExprBuilder<Component>, N> comps;
+        std::string name;
+        Field f;
+    };
+}// namespace OpFlow
+#endif//OPFLOW_CARTESIANVECTORFIELD_HPP
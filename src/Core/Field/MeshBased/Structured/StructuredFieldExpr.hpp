@@ -34,6 +34,16 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
             R send_range, recv_range;
             int shift_code;
         };
+
+        /// \brief Distribution layout of a structured field
+        /// \details The layout is immutable once built & shared by a field and all the expressions derived
+        /// from it, so that propagating it through an expression tree only copies a pointer. A field which
+        /// changes its distribution builds a new layout instead of modifying the shared one.
+        template <typename R>
+        struct StructuredLayout {
+            std::vector<R> splitMap;               ///< Map of rank to range for distributed parallelization
+            std::vector<NeighborInfo<R>> neighbors;///< Neighbor patches rank & range info
+        };
     }// namespace internal
 
     template <typename Derived>
@@ -47,26 +57,30 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
         mutable RangeType logicalRange;         ///< logical accessible range, extended range
         mutable IndexType offset;               ///< index offset for distributed parallelization
         mutable int padding = 0;                ///< padding width for distributed parallelization
-        mutable std::vector<RangeType> splitMap;///< Map of rank to range for distributed parallelization
-        mutable std::vector<internal::NeighborInfo<RangeType>>
-                neighbors;///< Neighbor patches rank & range info
+        mutable std::shared_ptr<const internal::StructuredLayout<RangeType>>
+                layout;///< Shared distribution layout
 
         StructuredFieldExpr() = default;
         StructuredFieldExpr(const StructuredFieldExpr& other)
             : MeshBasedFieldExpr<Derived>(other), loc(other.loc), localRange(other.localRange),
               assignableRange(other.assignableRange), accessibleRange(other.accessibleRange),
               logicalRange(other.logicalRange), offset(other.offset), padding(other.padding),
-              splitMap(other.splitMap), neighbors(other.neighbors) {}
+              layout(other.layout) {}
         StructuredFieldExpr(StructuredFieldExpr&& other) noexcept
             : MeshBasedFieldExpr<Derived>(std::move(other)), loc(std::move(other.loc)),
               localRange(std::move(other.localRange)), assignableRange(std::move(other.assignableRange)),
               accessibleRange(std::move(other.accessibleRange)), logicalRange(std::move(other.logicalRange)),
-              offset(std::move(other.offset)), padding(other.padding), splitMap(std::move(other.splitMap)),
-              neighbors(std::move(other.neighbors)) {}
+              offset(std::move(other.offset)), padding(other.padding), layout(std::move(other.layout)) {}
 
         auto getDims() const { return this->mesh.getDims(); }
         auto getOffset() const { return this->offset; }
         void updatePadding() { this->derived().updatePaddingImpl_final(); }
+        const auto& getSplitMap() const { return getLayout().splitMap; }
+        const auto& getNeighbors() const { return getLayout().neighbors; }
+        const auto& getLayout() const {
+            static const internal::StructuredLayout<RangeType> empty {};
+            return layout ? *layout : empty;
+        }
 
         auto getLocalReadableRange() const {
             return DS::commonRange(this->localRange.getInnerRange(-padding), this->logicalRange);
@@ -88,8 +102,7 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
             this->logicalRange = other.logicalRange;
             this->offset = other.offset;
             this->padding = other.padding;
-            this->splitMap = other.splitMap;
-            this->neighbors = other.neighbors;
+            this->layout = other.layout;
         }
 
         bool couldEvalAtImpl_final(auto&& i) const {
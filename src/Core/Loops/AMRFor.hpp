@@ -0,0 +1,139 @@
+// ----------------------------------------------------------------------------
+//
+// Copyright (c) 2019 - 2026 by the OpFlow developers
+//
+// This file is part of OpFlow.
+//
+// OpFlow is free software and is distributed under the MPL v2.0 license.
+// The full text of the license can be found in the file LICENSE at the top
+// level directory of OpFlow.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef OPFLOW_AMRFOR_HPP
+#define OPFLOW_AMRFOR_HPP
+
+#include "Core/Environment.hpp"
+#include "Core/Macros.hpp"
+#include "RangeFor.hpp"
+#ifndef OPFLOW_INSIDE_MODULE
+#include <algorithm>
+#include <tbb/tbb.h>
+#include <vector>
+#endif
+
+OPFLOW_MODULE_EXPORT namespace OpFlow {
+    /// Max number of cells in a single AMR task. Patches larger than this are split into sub-tiles.
+    inline int amr_task_tile_size = 4096;
+
+    /// \brief A single work item of the AMR scheduler, i.e., one (level, patch, sub-tile) triple
+    /// \tparam R Range type
+    template <typename R>
+    struct AMRTask {
+        R range;      ///< The looped (sub-)range. Level & part are carried by the range itself
+        int tag = -1; ///< User defined tag, e.g., the source patch of a halo copy
+        int cost = 0; ///< Estimated cost (number of cells) of the task
+    };
+
+    /// \brief Flattened list of AMR tasks
+    /// \details All (level, patch) ranges are flattened into one list. Each range is cut into
+    /// sub-tiles with at most amr_task_tile_size cells along the slowest varying dimensions,
+    /// so that large patches are shared among workers and small patches are batched. Tasks
+    /// are ordered by descending cost before execution to balance lopsided patch distributions.
+    /// \tparam R Range type
+    template <typename R>
+    struct AMRTaskList {
+        std::vector<AMRTask<R>> tasks;
+
+        AMRTaskList() = default;
+        explicit AMRTaskList(const std::vector<std::vector<R>>& ranges) {
+            for (const auto& level : ranges)
+                for (const auto& r : level) push(r);
+        }
+
+        /// \brief Append a range to the task list
+        /// \param r The range
+        /// \param tag User defined tag attached to all sub-tiles of \p r
+        void push(const R& r, int tag = -1) {
+            if (r.empty()) return;
+            sorted = false;
+            std::vector<R> stack {r};
+            while (!stack.empty()) {
+                auto cur = stack.back();
+                stack.pop_back();
+                auto count = cur.count();
+                // split along the slowest varying dim to keep lines contiguous
+                int k = R::dim - 1;
+                while (k >= 0 && cur.end[k] - cur.start[k] <= 1) --k;
+                if (count <= amr_task_tile_size || k < 0) {
+                    tasks.push_back(AMRTask<R> {cur, tag, count});
+                } else {
+                    auto lo = cur, hi = cur;
+                    lo.end[k] = cur.start[k] + (cur.end[k] - cur.start[k]) / 2;
+                    hi.start[k] = lo.end[k];
+                    lo.reValidPace();
+                    hi.reValidPace();
+                    stack.push_back(hi);
+                    stack.push_back(lo);
+                }
+            }
+        }
+
+        /// \brief Order the tasks by descending cost. Called automatically by amrTaskFor
+        void sort() {
+            if (sorted) return;
+            std::stable_sort(tasks.begin(), tasks.end(),
+                             [](const auto& a, const auto& b) { return a.cost > b.cost; });
+            sorted = true;
+        }
+
+        void clear() {
+            tasks.clear();
+            sorted = true;
+        }
+
+        [[nodiscard]] auto size() const { return tasks.size(); }
+        [[nodiscard]] bool empty() const { return tasks.empty(); }
+
+    private:
+        bool sorted = true;
+    };
+
+    /// \brief Parallel loop over the tasks of an AMR task list
+    /// \param tasks The task list
+    /// \param func Functor applied to each task, with signature func(const AMRTask<R>&)
+    /// \return The input functor
+    template <typename R, typename F>
+    F amrTaskFor(AMRTaskList<R>& tasks, F&& func) {
+        if (tasks.empty()) return std::forward<F>(func);
+        tasks.sort();
+        tbb::task_arena arena(getGlobalParallelPlan().shared_memory_workers_count);
+        arena.execute([&]() {
+            tbb::parallel_for(tbb::blocked_range<std::size_t>(0, tasks.size()), [&](const auto& r) {
+                for (auto i = r.begin(); i != r.end(); ++i) func(tasks.tasks[i]);
+            });
+        });
+        return std::forward<F>(func);
+    }
+
+    /// \brief Parallel loop over all indexes covered by an AMR task list
+    /// \param tasks The task list
+    /// \param func Functor applied to each index
+    /// \return The input functor
+    template <typename R, typename F>
+    F amrFor(AMRTaskList<R>& tasks, F&& func) {
+        amrTaskFor(tasks, [&](const AMRTask<R>& t) { rangeFor_s(t.range, func); });
+        return std::forward<F>(func);
+    }
+
+    /// \brief Parallel loop over a (level, patch) list of ranges
+    /// \param ranges The ranges, indexed by [level][part]
+    /// \param func Functor applied to each index
+    /// \return The input functor
+    template <typename R, typename F>
+    F amrFor(const std::vector<std::vector<R>>& ranges, F&& func) {
+        AMRTaskList<R> tasks(ranges);
+        return amrFor(tasks, std::forward<F>(func));
+    }
+}// namespace OpFlow
+#endif//OPFLOW_AMRFOR_HPP
@@ -13,22 +13,58 @@
 #ifndef OPFLOW_FIELDASSIGNER_HPP
 #define OPFLOW_FIELDASSIGNER_HPP
 
+#include "Core/Expr/Expression.hpp"
 #include "Core/Field/FieldExprTrait.hpp"
 #include "Core/Field/MeshBased/SemiStructured/CartAMRFieldExprTrait.hpp"
 #include "Core/Field/MeshBased/SemiStructured/CartAMRFieldTrait.hpp"
 #include "Core/Field/MeshBased/Structured/CartesianFieldExprTrait.hpp"
 #include "Core/Field/MeshBased/Structured/CartesianFieldTrait.hpp"
+#include "Core/Operator/Operator.hpp"
+#include "Utils/Allocator/ScratchPool.hpp"
+#include "AMRFor.hpp"
 #include "RangeFor.hpp"
 #include "StructFor.hpp"
+#ifndef OPFLOW_INSIDE_MODULE
+#include <cstdint>
+#include <type_traits>
+#endif
 
 OPFLOW_MODULE_EXPORT namespace OpFlow::internal {
+    /// \brief Whether \p From can be evaluated into the bit-packed storage of \p To a word at a time
+    /// \details True for fields of type \p To with packed storage & for logical ops of them which have a
+    /// WordwiseOp.
+    template <typename To, typename From>
+    struct WordwiseExpr : std::false_type {};
+
+    template <typename D, typename M, typename C>
+    struct WordwiseExpr<CartesianField<D, M, C>, CartesianField<D, M, C>>
+        : std::bool_constant<requires { typename C::word_type; }> {};
+
+    template <typename To, typename Op, typename... Args>
+    struct WordwiseExpr<To, Expression<Op, Args...>>
+        : std::bool_constant<(WordwiseExpr<To, Meta::RealType<Args>>::value && ...) && requires {
+              WordwiseOp<Op>::apply((sizeof(Args), std::uint64_t {})...);
+          }> {};
+
     struct FieldAssigner {
         template <BasicArithOp Op = BasicArithOp::Eq>
         static auto& assign(auto&& src, auto&& dst) {
+            // dst may share its storage with its copies; detach it ahead of the loops so that the copy is
+            // made in parallel. AMR fields detach patch by patch in assign_impl
+            if constexpr (CartesianFieldType<decltype(dst)>) dst.detachStorage();
             if (src.contains(dst)) {
-                auto temp = dst;
-                assign_impl<BasicArithOp::Eq>(src, temp);
-                assign_impl<Op>(temp, dst);
+                auto width = src.readWidth(dst);
+                if (width == 0) {
+                    // each element of dst is only read by its own update, so it can be updated in place
+                    assign_impl<Op>(src, dst);
+                } else if (canRoll(dst, width)) {
+                    assign_rolling<Op>(src, dst, width);
+                } else {
+                    // the temporary is recreated by every aliased assignment, so reuse pooled storage
+                    auto temp = Utils::scratchCopy(dst);
+                    assign_impl<BasicArithOp::Eq>(src, temp);
+                    assign_impl<Op>(temp, dst);
+                }
             } else {
                 assign_impl<Op>(src, dst);
             }
@@ -36,6 +72,127 @@ OPFLOW_MODULE_EXPORT namespace OpFlow::internal {
         }
 
     private:
+        // whether a ring of planes is smaller than a full copy of dst
+        template <typename To>
+        static bool canRoll(const To& dst, int width) {
+            if constexpr (CartesianFieldType<To> && internal::CartesianFieldExprTrait<To>::dim > 1) {
+                constexpr auto outer = internal::CartesianFieldExprTrait<To>::dim - 1;
+                auto range = DS::commonRange(dst.assignableRange, dst.localRange);
+                return width != unknown_read_width && width + 1 < range.end[outer] - range.start[outer];
+            } else
+                return false;
+        }
+
+        // Masks combined by logical ops are assigned 64 points at a time when all the masks share dst's
+        // storage layout. Returns false if src has to be evaluated point by point.
+        template <CartesianFieldType To, CartesianFieldExprType From>
+        static bool assign_words(const From& src, To& dst) {
+            if constexpr (WordwiseExpr<To, Meta::RealType<From>>::value) {
+                if (!sameWords(src, dst)) return false;
+                auto range = DS::commonRange(dst.assignableRange, dst.localRange);
+                for (auto i = 0; i < internal::CartesianFieldExprTrait<To>::dim; ++i) {
+                    range.start[i] -= dst.offset[i];
+                    range.end[i] -= dst.offset[i];
+                }
+                dst.data.assignWords(range, [&](long long w) { return loadWord(src, w); });
+                return true;
+            } else
+                return false;
+        }
+
+        template <typename D, typename M, typename C>
+        static bool sameWords(const CartesianField<D, M, C>& f, const CartesianField<D, M, C>& dst) {
+            return f.data.dims == dst.data.dims && f.offset == dst.offset;
+        }
+
+        template <typename To, typename Op, typename... Args>
+        static bool sameWords(const Expression<Op, Args...>& e, const To& dst) {
+            if constexpr (sizeof...(Args) == 1) return sameWords(e.arg1, dst);
+            else
+                return sameWords(e.arg1, dst) && sameWords(e.arg2, dst);
+        }
+
+        template <typename D, typename M, typename C>
+        static auto loadWord(const CartesianField<D, M, C>& f, long long w) {
+            return f.data.loadWord(w);
+        }
+
+        template <typename Op, typename... Args>
+        static auto loadWord(const Expression<Op, Args...>& e, long long w) {
+            if constexpr (sizeof...(Args) == 1) return WordwiseOp<Op>::apply(loadWord(e.arg1, w));
+            else
+                return WordwiseOp<Op>::apply(loadWord(e.arg1, w), loadWord(e.arg2, w));
+        }
+
+        template <BasicArithOp Op>
+        static void apply(auto&& dst, const auto& v) {
+            if constexpr (Op == BasicArithOp::Eq) dst = v;
+            else if constexpr (Op == BasicArithOp::Add)
+                dst += v;
+            else if constexpr (Op == BasicArithOp::Minus)
+                dst -= v;
+            else if constexpr (Op == BasicArithOp::Mul)
+                dst *= v;
+            else if constexpr (Op == BasicArithOp::Div)
+                dst /= v;
+            else if constexpr (Op == BasicArithOp::Mod)
+                dst %= v;
+            else if constexpr (Op == BasicArithOp::And)
+                dst &= v;
+            else if constexpr (Op == BasicArithOp::Or)
+                dst |= v;
+            else if constexpr (Op == BasicArithOp::Xor)
+                dst ^= v;
+            else if constexpr (Op == BasicArithOp::LShift)
+                dst <<= v;
+            else if constexpr (Op == BasicArithOp::RShift)
+                dst >>= v;
+            else
+                OP_NOT_IMPLEMENTED;
+        }
+
+        // Evaluate src plane by plane along the outermost dim into a ring of (width + 1) planes. A plane
+        // is written back to dst once the last plane reading it, i.e., the one width planes above, is done.
+        template <BasicArithOp Op, CartesianFieldType To, CartesianFieldExprType From>
+        static auto& assign_rolling(From& src, To& dst, int width) {
+            src.prepare();
+            OP_EXPECT_MSG(dst.assignableRange == DS::commonRange(dst.assignableRange, src.logicalRange),
+                          "Assign warning: dst's assignableRange not covered by src's accessibleRange.\ndst "
+                          "= {}, range = {}\nsrc = {}, range = {}",
+                          dst.getName(), dst.assignableRange.toString(), src.getName(),
+                          src.logicalRange.toString());
+
+            constexpr auto dim = internal::CartesianFieldExprTrait<To>::dim;
+            constexpr auto outer = dim - 1;
+            using elem_type = typename internal::CartesianFieldExprTrait<To>::elem_type;
+            auto range = DS::commonRange(dst.assignableRange, dst.localRange);
+            auto slots = width + 1;
+            auto ring_dims = range.getExtends();
+            ring_dims[outer] = slots;
+            DS::PlainTensor<elem_type, dim> ring;
+            {
+                Utils::ScratchScope scope;
+                ring.reShape(ring_dims);
+            }
+            auto ring_index = [&](auto i) {
+                for (auto d = 0; d < dim; ++d) i[d] -= range.start[d];
+                i[outer] %= slots;
+                return i;
+            };
+            auto flush = [&](int k) {
+                rangeFor(range.slice(outer, k), [&](auto&& i) { apply<Op>(dst[i], ring[ring_index(i)]); });
+            };
+            for (auto k = range.start[outer]; k < range.end[outer]; ++k) {
+                rangeFor(range.slice(outer, k), [&](auto&& i) { ring[ring_index(i)] = src.evalAt(i); });
+                if (k - width >= range.start[outer]) flush(k - width);
+            }
+            for (auto k = std::max(range.start[outer], range.end[outer] - width); k < range.end[outer]; ++k)
+                flush(k);
+
+            dst.updatePadding();
+            return dst;
+        }
+
         template <BasicArithOp Op = BasicArithOp::Eq, CartesianFieldType To, CartesianFieldExprType From>
         static auto& assign_impl(From& src, To& dst) {
             src.prepare();
@@ -45,6 +202,12 @@ OPFLOW_MODULE_EXPORT namespace OpFlow::internal {
                           dst.getName(), dst.assignableRange.toString(), src.getName(),
                           src.logicalRange.toString());
 
+            if constexpr (Op == BasicArithOp::Eq) {
+                if (assign_words(src, dst)) {
+                    dst.updatePadding();
+                    return dst;
+                }
+            }
             if constexpr (Op == BasicArithOp::Eq)
                 rangeFor(DS::commonRange(dst.assignableRange, dst.localRange),
                          [&](auto&& i) { dst[i] = src.evalAt(i); });
@@ -88,10 +251,10 @@ OPFLOW_MODULE_EXPORT namespace OpFlow::internal {
         static auto& assign_impl(From& src, To& dst) {
             src.prepare();
             auto levels = dst.getLevels();
-#pragma omp parallel
+            // flatten all (level, patch) pairs into one task list
+            AMRTaskList<typename internal::CartAMRFieldExprTrait<To>::range_type> tasks;
             for (auto i = 0; i < levels; ++i) {
                 auto parts = dst.accessibleRanges[i].size();
-#pragma omp for nowait schedule(dynamic)
                 for (auto j = 0; j < parts; ++j) {
                     OP_EXPECT_MSG(DS::inRange(dst.assignableRanges[i][j], src.logicalRanges[i][j]),
                                   "Assign warning: dst's assignableRange not covered by src's "
@@ -99,43 +262,34 @@ OPFLOW_MODULE_EXPORT namespace OpFlow::internal {
                                   "= {}, range = {}\nsrc = {}, range = {}",
                                   i, j, dst.getName(), dst.assignableRanges[i][j].toString(), src.getName(),
                                   src.logicalRanges[i][j].toString());
-                    if constexpr (Op == BasicArithOp::Eq)
-                        rangeFor_s(DS::commonRange(dst.assignableRanges[i][j], dst.logicalRanges[i][j]),
-                                   [&](auto&& k) { dst[k] = src.evalAt(k); });
-                    else if constexpr (Op == BasicArithOp::Add)
-                        rangeFor_s(DS::commonRange(dst.assignableRanges[i][j], dst.logicalRanges[i][j]),
-                                   [&](auto&& k) { dst[k] += src.evalAt(k); });
-                    else if constexpr (Op == BasicArithOp::Minus)
-                        rangeFor_s(DS::commonRange(dst.assignableRanges[i][j], dst.logicalRanges[i][j]),
-                                   [&](auto&& k) { dst[k] -= src.evalAt(k); });
-                    else if constexpr (Op == BasicArithOp::Mul)
-                        rangeFor_s(DS::commonRange(dst.assignableRanges[i][j], dst.logicalRanges[i][j]),
-                                   [&](auto&& k) { dst[k] *= src.evalAt(k); });
-                    else if constexpr (Op == BasicArithOp::Div)
-                        rangeFor_s(DS::commonRange(dst.assignableRanges[i][j], dst.logicalRanges[i][j]),
-                                   [&](auto&& k) { dst[k] /= src.evalAt(k); });
-                    else if constexpr (Op == BasicArithOp::Mod)
-                        rangeFor_s(DS::commonRange(dst.assignableRanges[i][j], dst.logicalRanges[i][j]),
-                                   [&](auto&& k) { dst[k] %= src.evalAt(k); });
-                    else if constexpr (Op == BasicArithOp::And)
-                        rangeFor_s(DS::commonRange(dst.assignableRanges[i][j], dst.logicalRanges[i][j]),
-                                   [&](auto&& k) { dst[k] &= src.evalAt(k); });
-                    else if constexpr (Op == BasicArithOp::Or)
-                        rangeFor_s(DS::commonRange(dst.assignableRanges[i][j], dst.logicalRanges[i][j]),
-                                   [&](auto&& k) { dst[k] |= src.evalAt(k); });
-                    else if constexpr (Op == BasicArithOp::Xor)
-                        rangeFor_s(DS::commonRange(dst.assignableRanges[i][j], dst.logicalRanges[i][j]),
-                                   [&](auto&& k) { dst[k] ^= src.evalAt(k); });
-                    else if constexpr (Op == BasicArithOp::LShift)
-                        rangeFor_s(DS::commonRange(dst.assignableRanges[i][j], dst.logicalRanges[i][j]),
-                                   [&](auto&& k) { dst[k] <<= src.evalAt(k); });
-                    else if constexpr (Op == BasicArithOp::RShift)
-                        rangeFor_s(DS::commonRange(dst.assignableRanges[i][j], dst.logicalRanges[i][j]),
-                                   [&](auto&& k) { dst[k] >>= src.evalAt(k); });
-                    else
-                        OP_NOT_IMPLEMENTED;
+                    auto range = DS::commonRange(dst.assignableRanges[i][j], dst.logicalRanges[i][j]);
+                    if (!range.empty()) dst.detachPatch(i, j);
+                    tasks.push(range);
                 }
             }
+            if constexpr (Op == BasicArithOp::Eq) amrFor(tasks, [&](auto&& k) { dst[k] = src.evalAt(k); });
+            else if constexpr (Op == BasicArithOp::Add)
+                amrFor(tasks, [&](auto&& k) { dst[k] += src.evalAt(k); });
+            else if constexpr (Op == BasicArithOp::Minus)
+                amrFor(tasks, [&](auto&& k) { dst[k] -= src.evalAt(k); });
+            else if constexpr (Op == BasicArithOp::Mul)
+                amrFor(tasks, [&](auto&& k) { dst[k] *= src.evalAt(k); });
+            else if constexpr (Op == BasicArithOp::Div)
+                amrFor(tasks, [&](auto&& k) { dst[k] /= src.evalAt(k); });
+            else if constexpr (Op == BasicArithOp::Mod)
+                amrFor(tasks, [&](auto&& k) { dst[k] %= src.evalAt(k); });
+            else if constexpr (Op == BasicArithOp::And)
+                amrFor(tasks, [&](auto&& k) { dst[k] &= src.evalAt(k); });
+            else if constexpr (Op == BasicArithOp::Or)
+                amrFor(tasks, [&](auto&& k) { dst[k] |= src.evalAt(k); });
+            else if constexpr (Op == BasicArithOp::Xor)
+                amrFor(tasks, [&](auto&& k) { dst[k] ^= src.evalAt(k); });
+            else if constexpr (Op == BasicArithOp::LShift)
+                amrFor(tasks, [&](auto&& k) { dst[k] <<= src.evalAt(k); });
+            else if constexpr (Op == BasicArithOp::RShift)
+                amrFor(tasks, [&](auto&& k) { dst[k] >>= src.evalAt(k); });
+            else
+                OP_NOT_IMPLEMENTED;
             dst.updatePadding();
             return dst;
         }
@@ -20,6 +20,9 @@
 #include "DataStructures/Index/RangedIndex.hpp"
 #include "DataStructures/Range/Ranges.hpp"
 #ifndef OPFLOW_INSIDE_MODULE
+#include <map>
+#include <memory>
+#include <mutex>
 #include <omp.h>
 #include <tbb/tbb.h>
 #endif
@@ -30,6 +33,25 @@
 #endif
 
 OPFLOW_MODULE_EXPORT namespace OpFlow {
+    namespace internal {
+        /// \brief Arena kept alive across loops in first touch mode
+        /// \details Static partitioning only maps a sub-range to the same thread in every loop if the
+        /// loops share the arena. One arena is kept per worker count & never terminated, as loops may
+        /// run from other threads, e.g., the background writer of IOGroup, while the count changes.
+        inline tbb::task_arena& firstTouchArena() {
+            static std::mutex mutex;
+            static std::map<int, std::unique_ptr<tbb::task_arena>> arenas;
+            auto n = getGlobalParallelPlan().shared_memory_workers_count;
+            std::lock_guard lock(mutex);
+            auto& arena = arenas[n];
+            if (!arena) {
+                arena = std::make_unique<tbb::task_arena>(n);
+                arena->initialize();
+            }
+            return *arena;
+        }
+    }// namespace internal
+
     /// \brief Serial version of range for
     /// \tparam dim Range dim
     /// \tparam F Functor type
@@ -49,12 +71,16 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
     template <typename R, typename ReOp, typename F>
     auto rangeReduce_s(const R& range, ReOp&& op, F&& func) {
         //OP_INFO("Called on {}, size = {}", range.toString(), range.count());
+        using resultType = Meta::accumulateType_t<
+                Meta::RealType<decltype(func(std::declval<typename R::base_index_type&>()))>>;
         typename R::index_type idx(range);
-        auto result = func(static_cast<typename R::base_index_type&>(idx));
+        resultType result = func(static_cast<typename R::base_index_type&>(idx));
         ++idx;
         auto total_count = range.count();
         for (auto count = 1; count < total_count; ++count, ++idx) {
-            result = op(result, func(static_cast<typename R::base_index_type&>(idx)));
+            // the element is widened first, so that op sees two values of the same type, e.g., for std::max
+            result = op(result,
+                        static_cast<resultType>(func(static_cast<typename R::base_index_type&>(idx))));
         }
         return result;
     }
@@ -72,10 +98,14 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
         auto line_size = range.end[0] - range.start[0];
         if (line_size <= 0) return std::forward<F>(func);
         if (range.stride[0] == 1) {
-            tbb::task_arena arena(getGlobalParallelPlan().shared_memory_workers_count);
-            arena.execute([&]() {
-                tbb::parallel_for(range, [&](const R& r) { rangeFor_s(r, OP_PERFECT_FOWD(func)); });
-            });
+            auto body = [&](const R& r) { rangeFor_s(r, OP_PERFECT_FOWD(func)); };
+            if (getGlobalParallelPlan().first_touch) {
+                internal::firstTouchArena().execute(
+                        [&]() { tbb::parallel_for(range, body, tbb::static_partitioner {}); });
+            } else {
+                tbb::task_arena arena(getGlobalParallelPlan().shared_memory_workers_count);
+                arena.execute([&]() { tbb::parallel_for(range, body); });
+            }
         } else {
             OP_NOT_IMPLEMENTED;
             std::abort();
@@ -85,7 +115,8 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
 
     template <typename R, typename ReOp, typename F>
     auto rangeReduce(const R& range, ReOp&& op, F&& func) {
-        using resultType = Meta::RealType<decltype(func(std::declval<typename R::base_index_type&>()))>;
+        using resultType = Meta::accumulateType_t<
+                Meta::RealType<decltype(func(std::declval<typename R::base_index_type&>()))>>;
         constexpr static auto dim = R::dim;
         auto line_size = range.end[0] - range.start[0];
         if (line_size <= 0) return resultType();
@@ -111,8 +142,13 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
         } reducer {op, func};
 
         if (range.stride[0] == 1) {
-            tbb::task_arena arena(getGlobalParallelPlan().shared_memory_workers_count);
-            arena.template execute([&]() { tbb::parallel_reduce(range, reducer); });
+            if (getGlobalParallelPlan().first_touch) {
+                internal::firstTouchArena().execute(
+                        [&]() { tbb::parallel_reduce(range, reducer, tbb::static_partitioner {}); });
+            } else {
+                tbb::task_arena arena(getGlobalParallelPlan().shared_memory_workers_count);
+                arena.template execute([&]() { tbb::parallel_reduce(range, reducer); });
+            }
             return reducer.result;
         } else {
             OP_NOT_IMPLEMENTED;
@@ -13,18 +13,21 @@
 #ifndef OPFLOW_CARTESIANAMRMESH_HPP
 #define OPFLOW_CARTESIANAMRMESH_HPP
 
+#include "Core/AMR/AMRGen.hpp"
 #include "Core/Loops/RangeFor.hpp"
 #include "Core/Mesh/SemiStructured/CartesianAMRMeshBase.hpp"
 #include "Core/Mesh/SemiStructured/CartesianAMRMeshView.hpp"
 #include "Core/Mesh/Structured/CartesianMesh.hpp"
 #include "DataStructures/Geometry/BasicElements.hpp"
-#include "DataStructures/Geometry/KdTree.hpp"
 #include "DataStructures/Index/LevelMDIndex.hpp"
+#include "DataStructures/Range/LevelRangeIndex.hpp"
 #include "DataStructures/Range/LevelRanges.hpp"
 #include "Math/Function/Numeric.hpp"
 #ifndef OPFLOW_INSIDE_MODULE
-#include <deque>
+#include <algorithm>
+#include <iterator>
 #include <map>
+#include <memory>
 #include <vector>
 #endif
 #ifdef OPFLOW_WITH_VTK
@@ -47,6 +50,11 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
         std::vector<CartesianMesh<Dim>> meshes;
         std::vector<std::vector<DS::LevelRange<dim>>> ranges;
         std::vector<std::vector<std::vector<int>>> neighbors, parents;
+        /// Spatial index of the patches on each level, built along with ranges
+        std::vector<DS::LevelRangeIndex<dim>> patchIndex;
+        /// Sorted tagged cells (on level l - 1) used to generate level l. Only kept for incremental
+        /// regridding; shared among copies of the mesh as it's never modified after generation
+        std::vector<std::shared_ptr<const std::vector<DS::PointWithLabel<int, int, dim>>>> markers;
 
         // Control parameters for AMR
         /// Fill rate threshold for remeshing
@@ -87,6 +95,33 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
         bool operator==(const CartesianAMRMesh &other) const {
             return ranges == other.ranges && meshes == other.meshes;
         }
+
+        /// \brief Rebuild the patch index and the neighbor & parent relations of all patches
+        void buildRelations() {
+            auto floor_div = [](int a, int b) { return a >= 0 ? a / b : -((-a + b - 1) / b); };
+            patchIndex.resize(ranges.size());
+            neighbors.resize(ranges.size());
+            parents.resize(ranges.size());
+            for (auto l = 0; l < ranges.size(); ++l) patchIndex[l].build(ranges[l]);
+            for (auto l = (int) ranges.size() - 1; l > 0; --l) {
+                neighbors[l].resize(ranges[l].size());
+                parents[l].resize(ranges[l].size());
+                for (auto p = 0; p < ranges[l].size(); ++p) {
+                    auto ext = ranges[l][p].getInnerRange(-buffWidth);
+                    // neighbors
+                    neighbors[l][p] = patchIndex[l].query(ext);
+                    std::erase(neighbors[l][p], p);
+                    // parents. query the coarser level with the coarse cover of ext
+                    auto ext_coarse = ext;
+                    for (auto i = 0; i < dim; ++i) {
+                        ext_coarse.start[i] = floor_div(ext.start[i], refinementRatio);
+                        ext_coarse.end[i] = -floor_div(-ext.end[i], refinementRatio);
+                    }
+                    ext_coarse.level = l - 1;
+                    parents[l][p] = patchIndex[l - 1].query(ext_coarse);
+                }
+            }
+        }
     };
 
     template <typename Dim>
@@ -154,6 +189,16 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
             return *this;
         }
 
+        /// \brief Enable incremental regridding
+        /// \details The tagged cells of each level are kept in the built mesh. When building with
+        /// a reference mesh, only the old patches touched by changed tags are re-partitioned, while
+        /// the other patches are kept as they are. CartAMRField::replaceMeshBy then moves the
+        /// storage of these unchanged patches instead of copying them.
+        auto &setIncremental(bool inc) {
+            incremental = inc;
+            return *this;
+        }
+
         auto build() {
             check();
             if (!ref) init_grid(marker);
@@ -165,6 +210,7 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
 
     private:
         std::function<bool(const DS::LevelMDIndex<dim> &)> marker;
+        bool incremental = false;
 
         void check() {
             // We only have to check if the refinement ratio has been set
@@ -172,6 +218,8 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
         }
         auto init_grid(auto &&func) {
             const auto &baseMesh = ret.meshes[0];
+            ret.markers.clear();
+            ret.markers.resize(ret.maxLevel);
             auto ratio = ret.refinementRatio;
             for (auto _level = ret.maxLevel - 1; _level > 0; --_level) {
                 auto currentDims = baseMesh.getDims();
@@ -227,7 +275,7 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
                     }
                 }
                 // remove duplicates in points
-                std::sort(points.begin(), points.end());
+                tbb::parallel_sort(points.begin(), points.end());
                 auto last = std::unique(points.begin(), points.end());
                 points.erase(last, points.end());
 #ifndef NDEBUG
@@ -238,8 +286,9 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
                 dump_points(p_add, 1. / Math::int_pow(ratio, _level - 1),
                             std::format("padd_level{}.vtp", _level));
 #endif
-                auto tree = MarkerTree(points);
-                auto boxes = domainPartition(tree, ret.fillRateThreshold, ret.slimThreshold);
+                auto boxes = domainPartition(TagMap(points), ret.fillRateThreshold, ret.slimThreshold);
+                if (incremental)
+                    ret.markers[_level] = std::make_shared<const std::vector<Point>>(std::move(points));
 #ifndef NDEBUG
                 OP_DEBUG("Boxes at _level {}:", _level);
                 for (auto &b : boxes) { OP_DEBUG("{}", b.toString()); }
@@ -268,6 +317,8 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
         }
         auto init_grid_with_ref(auto &&func) {
             const auto &baseMesh = ret.meshes[0];
+            ret.markers.clear();
+            ret.markers.resize(ret.maxLevel);
             auto ratio = ret.refinementRatio;
             for (auto _level = ret.maxLevel - 1; _level > 0; --_level) {
                 using Point = DS::PointWithLabel<int, int, dim>;
@@ -316,7 +367,7 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
                     }
                 }
                 // remove duplicates in points
-                std::sort(points.begin(), points.end());
+                tbb::parallel_sort(points.begin(), points.end());
                 auto last = std::unique(points.begin(), points.end());
                 points.erase(last, points.end());
 #ifndef NDEBUG
@@ -327,8 +378,15 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
                 dump_points(p_add, 1. / Math::int_pow(ratio, _level - 1),
                             std::format("padd_level{}.vtp", _level));
 #endif
-                auto tree = MarkerTree(points);
-                auto boxes = domainPartition(tree, ret.fillRateThreshold, ret.slimThreshold);
+                std::vector<Box> boxes;
+                if (incremental && _level < ref->markers.size() && ref->markers[_level]
+                    && _level < ref->ranges.size()) {
+                    boxes = incrementalPartition(points, *ref->markers[_level], ref->ranges[_level]);
+                } else {
+                    boxes = domainPartition(TagMap(points), ret.fillRateThreshold, ret.slimThreshold);
+                }
+                if (incremental)
+                    ret.markers[_level] = std::make_shared<const std::vector<Point>>(std::move(points));
 #ifndef NDEBUG
                 OP_DEBUG("Boxes at _level {}:", _level);
                 for (auto &b : boxes) { OP_DEBUG("{}", b.toString()); }
@@ -356,50 +414,89 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
             }
         }
 
-        auto gen_relation() {
-            ret.neighbors.resize(ret.ranges.size());
-            ret.parents.resize(ret.ranges.size());
-            for (auto l = ret.maxLevel - 1; l > 0; --l) {
-                // neighbors
-                ret.neighbors[l].resize(ret.ranges[l].size());
-                for (auto &p : ret.neighbors[l]) p.clear();
-                for (auto p = 0; p < ret.ranges[l].size(); ++p) {
-                    for (auto pp = p + 1; pp < ret.ranges[l].size(); ++pp) {
-                        auto ext = ret.ranges[l][p].getInnerRange(-ret.buffWidth);
-                        if (DS::intersectRange(ext, ret.ranges[l][pp])) {
-                            ret.neighbors[l][p].push_back(pp);
-                            ret.neighbors[l][pp].push_back(p);
-                        }
-                    }
-                }
-                // parents
-                ret.parents[l].resize(ret.ranges[l].size());
-                for (auto &p : ret.parents[l]) p.clear();
-                if (l - 1 >= 0) {
-                    for (auto p = 0; p < ret.ranges[l].size(); ++p) {
-                        for (auto pp = 0; pp < ret.ranges[l - 1].size(); ++pp) {
-                            auto ext = ret.ranges[l][p].getInnerRange(-ret.buffWidth);
-                            auto p_upcast = ret.ranges[l - 1][pp];
-                            for (auto i = 0; i < dim; ++i) {
-                                p_upcast.start[i] *= ret.refinementRatio;
-                                p_upcast.end[i] *= ret.refinementRatio;
-                            }
-                            if (DS::intersectRange(ext, p_upcast)) { ret.parents[l][p].push_back(pp); }
-                        }
-                    }
-                }
-            }
-        }
+        auto gen_relation() { ret.buildRelations(); }
 
     private:
-        using MarkerTree = DS::KdTree<DS::PointWithLabel<int, int, dim>, DS::Box<int, dim>>;
+        using TagMap = AMRTagMap<dim>;
         using Box = DS::Box<int, dim>;
 
-        static auto getFillRate(const MarkerTree &tree, const Box &box) {
-            auto total = 1;
-            for (auto i = 0; i < dim; ++i) { total *= (box.hi[i] - box.lo[i] + 1); }
-            auto count = tree.countInBox(box);
-            return (double) count / total;
+        /// \brief Re-partition only the old boxes touched by changed tags
+        /// \param points New sorted tagged cells
+        /// \param old_points Sorted tagged cells used to generate \p old_ranges
+        /// \param old_ranges Old patches on the generated level
+        /// \return The boxes in the coarser level's index space. Clean old boxes come first in
+        /// their original order, followed by the newly partitioned ones.
+        auto incrementalPartition(const std::vector<DS::PointWithLabel<int, int, dim>> &points,
+                                  const std::vector<DS::PointWithLabel<int, int, dim>> &old_points,
+                                  const std::vector<DS::LevelRange<dim>> &old_ranges) const {
+            auto ratio = ret.refinementRatio;
+            auto to_range = [](const Box &b) {
+                DS::LevelRange<dim> r;
+                for (auto i = 0; i < dim; ++i) {
+                    r.start[i] = b.lo[i];
+                    r.end[i] = b.hi[i] + 1;
+                }
+                r.reValidPace();
+                return r;
+            };
+            // convert old patches back to cell boxes on the coarser level
+            std::vector<Box> old_boxes;
+            for (const auto &r : old_ranges) {
+                Box b;
+                for (auto i = 0; i < dim; ++i) {
+                    b.lo[i] = r.start[i] / ratio;
+                    b.hi[i] = (r.end[i] - 1) / ratio - 1;
+                }
+                old_boxes.push_back(b);
+            }
+            std::vector<DS::PointWithLabel<int, int, dim>> changed;
+            std::set_symmetric_difference(points.begin(), points.end(), old_points.begin(), old_points.end(),
+                                          std::back_inserter(changed));
+            if (changed.empty()) return old_boxes;
+
+            // old boxes containing no changed tag keep exactly the same tags, hence are kept
+            std::vector<DS::LevelRange<dim>> old_cells;
+            for (const auto &b : old_boxes) old_cells.push_back(to_range(b));
+            DS::LevelRangeIndex<dim> old_index(old_cells);
+            std::vector<bool> dirty(old_boxes.size(), false);
+            for (const auto &p : changed) {
+                Box b {p.cord, p.cord};
+                old_index.query(to_range(b), [&](int k) { dirty[k] = true; });
+            }
+            std::vector<Box> ret_boxes;
+            std::vector<DS::LevelRange<dim>> clean_cells;
+            for (auto k = 0; k < old_boxes.size(); ++k) {
+                if (dirty[k]) continue;
+                ret_boxes.push_back(old_boxes[k]);
+                clean_cells.push_back(old_cells[k]);
+            }
+            DS::LevelRangeIndex<dim> clean_index(clean_cells);
+            // partition the tags not covered by the clean boxes
+            std::vector<DS::PointWithLabel<int, int, dim>> free_points;
+            for (const auto &p : points) {
+                bool covered = false;
+                clean_index.query(to_range(Box {p.cord, p.cord}), [&](int) { covered = true; });
+                if (!covered) free_points.push_back(p);
+            }
+            if (free_points.empty()) return ret_boxes;
+            TagMap tags(free_points);
+            auto boxes = domainPartition(tags, ret.fillRateThreshold, ret.slimThreshold);
+            // cut the new boxes by the clean boxes and shrink the pieces to their tags
+            auto clean_count = ret_boxes.size();
+            for (const auto &box : boxes) {
+                std::vector<Box> pieces {box};
+                clean_index.query(to_range(box), [&](int k) {
+                    std::vector<Box> next;
+                    for (const auto &piece : pieces)
+                        for (const auto &b : DS::boxSubtract(piece, ret_boxes[k])) next.push_back(b);
+                    pieces = std::move(next);
+                });
+                for (const auto &piece : pieces)
+                    if (auto bound = tags.shrink(piece)) ret_boxes.push_back(*bound);
+            }
+            OP_DEBUG("Incremental regrid: {} of {} boxes kept, {} boxes regenerated", clean_count,
+                     old_boxes.size(), ret_boxes.size() - clean_count);
+            return ret_boxes;
         }
 
         static void dump_points(auto &points, double h, const std::string &fname) {
@@ -417,197 +514,6 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
             OP_ERROR("MeshBuilder::dump_points not working because VTK is not enabled");
 #endif
         }
-
-        static auto domainPartition(const MarkerTree &marker, double fr_threshold, int slim_threshold) {
-            std::deque<Box> queue;
-            // find the global AABB and push it into queue
-            queue.push_back(marker.boundingBox());
-            // the result vector
-            std::vector<OpFlow::DS::Box<int, dim>> ret;
-            // start the main loop
-            while (!queue.empty()) {
-                auto box = queue.front();
-                queue.pop_front();
-                auto fillRate = getFillRate(marker, box);
-                // if the box is empty, continue
-                if (fillRate == 0) continue;
-                if (fillRate >= fr_threshold) {
-                    // take the box
-                    ret.push_back(box);
-                    goto next_cycle;
-                } else {
-                    // calculate the signature
-                    // init arrays
-                    std::array<DS::OffsetVector<int>, dim> sigs;
-                    for (auto i = 0; i < dim; ++i) {
-                        sigs[i].resize(box.hi[i] - box.lo[i] + 1);
-                        sigs[i].setConstant(0);
-                        sigs[i].setOffset(box.lo[i]);
-                    }
-                    // traverse all the points & accumulate sigs
-                    marker.traverseInBox(box, [&](auto &&p) {
-                        for (auto i = 0; i < dim; ++i) { sigs[i][p[i]]++; }
-                    });
-                    // find all continues non-zero intervals in sigs
-                    std::array<std::vector<int>, dim> split_points;
-                    for (auto i = 0; i < dim; ++i) {
-                        const auto begin = sigs[i].begin();
-                        const auto end = sigs[i].end();
-                        auto p1 = begin;
-                        while (p1 != end) {
-                            // move p1 to the next non-zero interval's begin
-                            while (p1 != end && *p1 == 0) ++p1;
-                            if (p1 == end) break;
-                            split_points[i].push_back(p1 - begin + sigs[i].getOffset());
-                            // move p2 to the end of the current interval
-                            auto p2 = p1;
-                            while (p2 != end && *p2 != 0) ++p2;
-                            // whether p2 equals end doesn't matter, just push the end
-                            split_points[i].push_back(p2 - begin + sigs[i].getOffset() - 1);
-                            // step p1 to p2, go to next loop
-                            p1 = p2;
-                        }
-                    }
-                    // check if the current box needs to be split or shrink
-                    bool split_or_shrink = false;
-                    for (auto i = 0; i < dim; ++i) {
-                        if (split_points[i].size() > 2
-                            || (split_points[i][0] > sigs[i].getOffset()
-                                || split_points[i][1] < sigs[i].getOffset() + sigs[i].size() - 1))
-                            split_or_shrink = true;
-                    }
-                    if (split_or_shrink) {
-                        // construct all the possible compact boxes
-                        DS::LevelRange<dim> range;
-                        for (auto i = 0; i < dim; ++i) {
-                            range.start[i] = 0;
-                            range.end[i] = split_points[i].size() / 2;
-                        }
-                        range.reValidPace();
-                        rangeFor_s(range, [&](auto &&idx) {
-                            // construct box
-                            DS::Box<int, dim> t;
-                            for (auto i = 0; i < dim; ++i) {
-                                t.lo[i] = split_points[i][idx[i] * 2];
-                                t.hi[i] = split_points[i][idx[i] * 2 + 1];
-                            }
-                            queue.push_back(t);
-                        });
-                        goto next_cycle;
-                    } else {
-                        // the current box is already compact.
-                        // we first deal with some corner cases
-                        // case 1: the box is sufficient slim in one dim
-                        std::array<bool, dim> slim_in_dim;
-                        bool all_slim = true;
-                        for (auto i = 0; i < dim; ++i) {
-                            // 1, 2, 3 points thick are considered slim
-                            slim_in_dim[i] = box.hi[i] - box.lo[i] < slim_threshold;
-                            all_slim &= slim_in_dim[i];
-                        }
-                        // if the box is slim in all dims, accept it
-                        if (all_slim) {
-                            ret.push_back(box);
-                            goto next_cycle;
-                        }
-                        // find the edge to split
-                        // calculate the lap of sig
-                        std::array<DS::OffsetVector<int>, dim> laps = sigs;
-                        for (auto i = 0; i < dim; ++i) {
-                            // for slim dims, we won't split
-                            if (slim_in_dim[i]) continue;
-                            for (auto j = laps[i].getOffset() + 1;
-                                 j < laps[i].getOffset() + laps[i].size() - 1; ++j) {
-                                laps[i][j] = (sigs[i][j - 1] - 2 * sigs[i][j] + sigs[i][j + 1]);
-                            }
-                        }
-                        // find all the sign-change points of lap
-                        std::array<std::vector<int>, dim> zero_points;
-                        std::array<int, dim> max_jumps;
-                        max_jumps.fill(0);
-                        for (auto i = 0; i < dim; ++i) {
-                            for (auto j = box.lo[i] + 1; j <= box.hi[i] - 2; ++j) {
-                                if ((laps[i][j] <= 0 && laps[i][j + 1] >= 0)
-                                    || (laps[i][j] >= 0 && laps[i][j + 1] <= 0)) {
-                                    // always take the max jump
-                                    if (std::abs(laps[i][j] - laps[i][j + 1]) > max_jumps[i]) {
-                                        // clear the existing list and take the new one
-                                        max_jumps[i] = std::abs(laps[i][j] - laps[i][j + 1]);
-                                        zero_points[i].clear();
-                                        zero_points[i].push_back(j);
-                                    } else if (std::abs(laps[i][j] - laps[i][j + 1]) == max_jumps[i]) {
-                                        // append the current point
-                                        zero_points[i].push_back(j);
-                                    }
-                                }
-                            }
-                        }
-                        std::array<int, dim> final_splits;
-                        for (auto i = 0; i < dim; ++i) {
-                            final_splits[i] = box.lo[i] - 1;
-                            // take the most center split point
-                            if (zero_points[i].size() == 0) continue;
-                            else if (zero_points[i].size() == 1)
-                                final_splits[i] = zero_points[i][0];
-                            else {
-                                auto median = (box.hi[i] + box.lo[i]) / 2;
-                                final_splits[i] = zero_points[i][0];
-                                for (auto &p : zero_points[i]) {
-                                    if (std::abs(final_splits[i] - median) > std::abs(p - median))
-                                        final_splits[i] = p;
-                                }
-                            }
-                        }
-                        // sort the dims according to the max jumps. the dim with the max jumps
-                        // is preferred for split
-                        std::array<int, dim> split_priority;
-                        for (auto i = 0; i < dim; ++i) split_priority[i] = i;
-                        std::sort(split_priority.begin(), split_priority.end(),
-                                  [&](auto a, auto b) { return max_jumps[a] > max_jumps[b]; });
-                        // try split the box according to the priority dims
-                        for (auto i : split_priority) {
-                            if (zero_points[i].size() > 0) {
-                                // if the split won't generate slim boxes
-                                if (final_splits[i] - box.lo[i] + 1 > slim_threshold
-                                    && box.hi[i] - final_splits[i] + 1 > slim_threshold) {
-                                    // do the split
-                                    auto box1 = box, box2 = box;
-                                    box1.hi[i] = final_splits[i];
-                                    box2.lo[i] = final_splits[i] + 1;
-                                    queue.push_back(box1);
-                                    queue.push_back(box2);
-                                    goto next_cycle;
-                                } else {
-                                    // the split will make slim boxes, take the next dim for test
-                                    continue;
-                                }
-                            }
-                        }
-
-                        // if could reach here, any of the split plan will make slim boxes
-                        // or they can't make slice at all. we then bisect along the longest dim
-                        auto longest_dim = 0, length = 0;
-                        for (auto i = 0; i < dim; ++i) {
-                            if (box.hi[i] - box.lo[i] + 1 > length) {
-                                length = box.hi[i] - box.lo[i] + 1;
-                                longest_dim = i;
-                            }
-                        }
-                        // bisect the box
-                        auto box1 = box, box2 = box;
-                        box1.hi[longest_dim] = (box.lo[longest_dim] + box.hi[longest_dim]) / 2;
-                        box2.lo[longest_dim] = box1.hi[longest_dim] + 1;
-                        queue.push_back(box1);
-                        queue.push_back(box2);
-                        goto next_cycle;
-                    }
-                }
-            next_cycle:
-                continue;
-            }
-            // return all the generated boxes
-            return ret;
-        }
     };
 
     template <typename Dim>
@@ -665,40 +571,7 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
         }
 
     private:
-        void gen_relation() {
-            ret.neighbors.resize(ret.ranges.size());
-            ret.parents.resize(ret.ranges.size());
-            for (auto l = ret.maxLevel - 1; l > 0; --l) {
-                // neighbors
-                ret.neighbors[l].resize(ret.ranges[l].size());
-                for (auto &p : ret.neighbors[l]) p.clear();
-                for (auto p = 0; p < ret.ranges[l].size(); ++p) {
-                    for (auto pp = p + 1; pp < ret.ranges[l].size(); ++pp) {
-                        auto ext = ret.ranges[l][p].getInnerRange(-ret.buffWidth);
-                        if (DS::intersectRange(ext, ret.ranges[l][pp])) {
-                            ret.neighbors[l][p].push_back(pp);
-                            ret.neighbors[l][pp].push_back(p);
-                        }
-                    }
-                }
-                // parents
-                ret.parents[l].resize(ret.ranges[l].size());
-                for (auto &p : ret.parents[l]) p.clear();
-                if (l - 1 >= 0) {
-                    for (auto p = 0; p < ret.ranges[l].size(); ++p) {
-                        for (auto pp = 0; pp < ret.ranges[l - 1].size(); ++pp) {
-                            auto ext = ret.ranges[l][p].getInnerRange(-ret.buffWidth);
-                            auto p_upcast = ret.ranges[l - 1][pp];
-                            for (auto i = 0; i < dim; ++i) {
-                                p_upcast.start[i] *= ret.refinementRatio;
-                                p_upcast.end[i] *= ret.refinementRatio;
-                            }
-                            if (DS::intersectRange(ext, p_upcast)) { ret.parents[l][p].push_back(pp); }
-                        }
-                    }
-                }
-            }
-        }
+        void gen_relation() { ret.buildRelations(); }
         void check() {
             // check if refinementRatio has been set
             OP_ASSERT(ret.refinementRatio > 0);
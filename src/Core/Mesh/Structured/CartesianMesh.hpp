@@ -27,26 +27,39 @@
 #include <array>
 #include <concepts>
 #include <cstdarg>
+#include <memory>
+#include <vector>
 #endif
 
 OPFLOW_MODULE_EXPORT namespace OpFlow {
     enum class MeshExtMode { Undefined, Symm, Periodic, Uniform };
 
+    namespace internal {
+        /// \brief Coordinates of a cartesian mesh, with the spacings & their inverses
+        /// \details Built once by MeshBuilder & shared immutably by all the copies of the mesh, so that
+        /// copying a mesh into a field or an expression only copies a pointer.
+        template <std::size_t dim>
+        struct CartesianMeshCoords {
+            std::array<std::vector<OpFlow::Real>, dim> x, dx, idx;
+        };
+    }// namespace internal
+
     template <typename Dim>
     struct CartesianMesh : CartesianMeshBase<CartesianMesh<Dim>> {
         static constexpr Size dim = internal::MeshTrait<CartesianMesh>::dim;
 
         std::array<int, dim> _dims;
         DS::Range<dim> _range, _ext_range;
-        std::array<std::vector<OpFlow::Real>, dim> _x;
-        std::array<std::vector<OpFlow::Real>, dim> _dx, _idx;
+        std::shared_ptr<const internal::CartesianMeshCoords<dim>> coords;
 
-        auto x(int d, int i) const { return _x[d][i - _ext_range.start[d]]; }
-        auto x(int d, const DS::MDIndex<dim>& i) const { return _x[d][i[d] - _ext_range.start[d]]; }
-        auto dx(int d, int i) const { return _dx[d][i - _ext_range.start[d]]; }
-        auto dx(int d, const DS::MDIndex<dim>& i) const { return _dx[d][i[d] - _ext_range.start[d]]; }
-        auto idx(int d, int i) const { return _idx[d][i - _ext_range.start[d]]; }
-        auto idx(int d, const DS::MDIndex<dim>& i) const { return _idx[d][i[d] - _ext_range.start[d]]; }
+        auto x(int d, int i) const { return coords->x[d][i - _ext_range.start[d]]; }
+        auto x(int d, const DS::MDIndex<dim>& i) const { return coords->x[d][i[d] - _ext_range.start[d]]; }
+        auto dx(int d, int i) const { return coords->dx[d][i - _ext_range.start[d]]; }
+        auto dx(int d, const DS::MDIndex<dim>& i) const { return coords->dx[d][i[d] - _ext_range.start[d]]; }
+        auto idx(int d, int i) const { return coords->idx[d][i - _ext_range.start[d]]; }
+        auto idx(int d, const DS::MDIndex<dim>& i) const {
+            return coords->idx[d][i[d] - _ext_range.start[d]];
+        }
 
         auto getPtr() const { return this; }
 
@@ -79,26 +92,33 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
             _dims = view.getDims();
             _range = view.getRange();
             _ext_range = view.getExtRange();
+            // the coordinates may be shared with other meshes, build new ones
+            auto c = std::make_shared<internal::CartesianMeshCoords<dim>>();
             for (auto i = 0; i < dim; ++i) {
+                c->x[i].resize(_ext_range.end[i] - _ext_range.start[i]);
+                c->dx[i].resize(_ext_range.end[i] - _ext_range.start[i] - 1);
+                c->idx[i].resize(_ext_range.end[i] - _ext_range.start[i] - 1);
                 for (auto j = _ext_range.start[i]; j < _ext_range.end[i]; ++j) {
-                    _x[i][j - _ext_range.start[i]] = view.x(i, j);
+                    c->x[i][j - _ext_range.start[i]] = view.x(i, j);
                 }
                 for (auto j = _ext_range.start[i]; j < _ext_range.end[i] - 1; ++j) {
-                    _dx[i][j - _ext_range.start[i]] = view.dx(i, j);
-                    _idx[i][j - _ext_range.start[i]] = view.idx(i, j);
+                    c->dx[i][j - _ext_range.start[i]] = view.dx(i, j);
+                    c->idx[i][j - _ext_range.start[i]] = view.idx(i, j);
                 }
             }
+            coords = std::move(c);
             return *this;
         }
 
     private:
         bool commonRangeEqualTo(const CartesianMesh& other) const {
+            if (coords == other.coords && _ext_range == other._ext_range) return true;
             bool ret = true;
             for (auto i = 0; i < dim; ++i) {
                 auto start = std::max(_ext_range.start[i], other._ext_range.start[i]);
                 auto end = std::min(_ext_range.end[i], other._ext_range.end[i]);
                 for (auto j = start; j < end; ++j) {
-                    ret &= _x[i][j - _ext_range.start[i]] == other._x[i][j - other._ext_range.start[i]];
+                    ret &= x(i, j) == other.x(i, j);
                     if (!ret) return false;
                 }
             }
@@ -111,7 +131,7 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
                 auto start = std::max(_ext_range.start[i], other.getExtRange().start[i]);
                 auto end = std::min(_ext_range.end[i], other.getExtRange().end[i]);
                 for (auto j = start; j < end; ++j) {
-                    ret &= _x[i][j - _ext_range.start[i]] == other.x(i, j);
+                    ret &= x(i, j) == other.x(i, j);
                     if (!ret) return false;
                 }
             }
@@ -124,6 +144,7 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
     private:
         static constexpr auto dim = internal::MeshTrait<CartesianMesh<Dim>>::dim;
         CartesianMesh<Dim> mesh;
+        internal::CartesianMeshCoords<dim> grid;
         int padding_width = 5;
         std::array<int, dim> start;
         std::array<MeshExtMode, dim> ext_mode;
@@ -146,6 +167,7 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
 
         auto& newMesh(const CartesianMesh<Dim>& m) {
             mesh = m;
+            if (m.coords) grid = *m.coords;
             return *this;
         }
 
@@ -184,18 +206,18 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
         auto& refine(int ratio) {
             for (auto i = 0; i < dim; ++i) {
                 std::vector<Real> x(ratio * (mesh._dims[i] - 1) + 1);
-                x[0] = mesh._x[i][0];
+                x[0] = grid.x[i][0];
                 for (auto j = 0; j < mesh._dims[i] - 1; ++j) {
                     for (auto k = 1; k <= ratio; ++k)
-                        x[ratio * j + k] = mesh._x[i][j] + mesh._dx[i][j] / ratio * k;
+                        x[ratio * j + k] = grid.x[i][j] + grid.dx[i][j] / ratio * k;
                 }
                 mesh._dims[i] = x.size();
-                mesh._x[i] = x;
-                mesh._dx[i].resize(x.size() - 1);
-                mesh._idx[i].resize(x.size() - 1);
+                grid.x[i] = x;
+                grid.dx[i].resize(x.size() - 1);
+                grid.idx[i].resize(x.size() - 1);
                 for (auto j = 0; j < mesh._dims[i] - 1; ++j) {
-                    mesh._dx[i][j] = mesh._x[i][j + 1] - mesh._x[i][j];
-                    mesh._idx[i][j] = 1. / mesh._dx[i][j];
+                    grid.dx[i][j] = grid.x[i][j + 1] - grid.x[i][j];
+                    grid.idx[i][j] = 1. / grid.dx[i][j];
                 }
                 mesh._range.start[i] *= ratio;
                 mesh._range.end[i] = (mesh._range.end[i] - 1) * ratio + 1;
@@ -203,7 +225,10 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
             return *this;
         }
 
-        auto&& build() { return std::move(mesh); }
+        auto&& build() {
+            mesh.coords = std::make_shared<const internal::CartesianMeshCoords<dim>>(grid);
+            return std::move(mesh);
+        }
 
     private:
         void set1DRange(Index k) {
@@ -211,9 +236,9 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
             mesh._range.end[k] = start[k] + mesh._dims[k];
             mesh._ext_range.start[k] = mesh._range.start[k] - padding_width;
             mesh._ext_range.end[k] = mesh._range.end[k] + padding_width;
-            mesh._x[k].resize(mesh._ext_range.end[k] - mesh._ext_range.start[k]);
-            mesh._dx[k].resize(mesh._ext_range.end[k] - mesh._ext_range.start[k] - 1);
-            mesh._idx[k].resize(mesh._ext_range.end[k] - mesh._ext_range.start[k] - 1);
+            grid.x[k].resize(mesh._ext_range.end[k] - mesh._ext_range.start[k]);
+            grid.dx[k].resize(mesh._ext_range.end[k] - mesh._ext_range.start[k] - 1);
+            grid.idx[k].resize(mesh._ext_range.end[k] - mesh._ext_range.start[k] - 1);
         }
 
         void setExtMesh(Index k) {
@@ -223,68 +248,68 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
                 case MeshExtMode::Undefined:
                 case MeshExtMode::Symm:
                     for (Index i = mesh._ext_range.start[k]; i < mesh._range.start[k]; ++i) {
-                        mesh._dx[k][i - mesh._ext_range.start[k]]
-                                = mesh._dx[k][2 * mesh._range.start[k] - 1 - i - mesh._ext_range.start[k]];
-                        mesh._idx[k][i - mesh._ext_range.start[k]]
-                                = 1. / mesh._dx[k][i - mesh._ext_range.start[k]];
+                        grid.dx[k][i - mesh._ext_range.start[k]]
+                                = grid.dx[k][2 * mesh._range.start[k] - 1 - i - mesh._ext_range.start[k]];
+                        grid.idx[k][i - mesh._ext_range.start[k]]
+                                = 1. / grid.dx[k][i - mesh._ext_range.start[k]];
                     }
                     for (Index i = mesh._range.end[k] - 1; i < mesh._ext_range.end[k] - 1; ++i) {
-                        mesh._dx[k][i - mesh._ext_range.start[k]]
-                                = mesh._dx[k][2 * mesh._range.end[k] - 3 - i - mesh._ext_range.start[k]];
-                        mesh._idx[k][i - mesh._ext_range.start[k]]
-                                = 1. / mesh._dx[k][i - mesh._ext_range.start[k]];
+                        grid.dx[k][i - mesh._ext_range.start[k]]
+                                = grid.dx[k][2 * mesh._range.end[k] - 3 - i - mesh._ext_range.start[k]];
+                        grid.idx[k][i - mesh._ext_range.start[k]]
+                                = 1. / grid.dx[k][i - mesh._ext_range.start[k]];
                     }
                     break;
                 case MeshExtMode::Periodic:
                     for (Index i = mesh._ext_range.start[k]; i < mesh._range.start[k]; ++i) {
-                        mesh._dx[k][i - mesh._ext_range.start[k]]
-                                = mesh._dx[k][mesh._range.end[k] - (mesh._range.start[k] - i)
-                                              - mesh._ext_range.start[k]];
-                        mesh._idx[k][i - mesh._ext_range.start[k]]
-                                = 1. / mesh._dx[k][i - mesh._ext_range.start[k]];
+                        grid.dx[k][i - mesh._ext_range.start[k]]
+                                = grid.dx[k][mesh._range.end[k] - (mesh._range.start[k] - i)
+                                             - mesh._ext_range.start[k]];
+                        grid.idx[k][i - mesh._ext_range.start[k]]
+                                = 1. / grid.dx[k][i - mesh._ext_range.start[k]];
                     }
                     for (Index i = mesh._range.end[k] - 1; i < mesh._ext_range.end[k] - 1; ++i) {
-                        mesh._dx[k][i - mesh._ext_range.start[k]]
-                                = mesh._dx[k][mesh._range.start[k] + i - mesh._range.end[k] + 1
-                                              - mesh._ext_range.start[k]];
-                        mesh._idx[k][i - mesh._ext_range.start[k]]
-                                = 1. / mesh._dx[k][i - mesh._ext_range.start[k]];
+                        grid.dx[k][i - mesh._ext_range.start[k]]
+                                = grid.dx[k][mesh._range.start[k] + i - mesh._range.end[k] + 1
+                                             - mesh._ext_range.start[k]];
+                        grid.idx[k][i - mesh._ext_range.start[k]]
+                                = 1. / grid.dx[k][i - mesh._ext_range.start[k]];
                     }
                     break;
                 case MeshExtMode::Uniform:
                     for (Index i = mesh._ext_range.start[k]; i < mesh._range.start[k]; ++i) {
-                        mesh._dx[k][i - mesh._ext_range.start[k]]
-                                = mesh._dx[k][mesh._range.start[k] - mesh._ext_range.start[k]];
-                        mesh._idx[k][i - mesh._ext_range.start[k]]
-                                = 1. / mesh._dx[k][i - mesh._ext_range.start[k]];
+                        grid.dx[k][i - mesh._ext_range.start[k]]
+                                = grid.dx[k][mesh._range.start[k] - mesh._ext_range.start[k]];
+                        grid.idx[k][i - mesh._ext_range.start[k]]
+                                = 1. / grid.dx[k][i - mesh._ext_range.start[k]];
                     }
                     for (Index i = mesh._range.end[k] - 1; i < mesh._ext_range.end[k] - 1; ++i) {
-                        mesh._dx[k][i - mesh._ext_range.start[k]]
-                                = mesh._dx[k][mesh._range.end[k] - 2 - mesh._ext_range.start[k]];
-                        mesh._idx[k][i - mesh._ext_range.start[k]]
-                                = 1. / mesh._idx[k][i - mesh._ext_range.start[k]];
+                        grid.dx[k][i - mesh._ext_range.start[k]]
+                                = grid.dx[k][mesh._range.end[k] - 2 - mesh._ext_range.start[k]];
+                        grid.idx[k][i - mesh._ext_range.start[k]]
+                                = 1. / grid.idx[k][i - mesh._ext_range.start[k]];
                     }
             }
             // integrate x
             for (Index i = mesh._range.start[k] - 1; i >= mesh._ext_range.start[k]; --i) {
-                mesh._x[k][i - mesh._ext_range.start[k]] = mesh._x[k][i + 1 - mesh._ext_range.start[k]]
-                                                           - mesh._dx[k][i - mesh._ext_range.start[k]];
+                grid.x[k][i - mesh._ext_range.start[k]] = grid.x[k][i + 1 - mesh._ext_range.start[k]]
+                                                          - grid.dx[k][i - mesh._ext_range.start[k]];
             }
             for (Index i = mesh._range.end[k]; i < mesh._ext_range.end[k]; ++i) {
-                mesh._x[k][i - mesh._ext_range.start[k]] = mesh._x[k][i - 1 - mesh._ext_range.start[k]]
-                                                           + mesh._dx[k][i - 1 - mesh._ext_range.start[k]];
+                grid.x[k][i - mesh._ext_range.start[k]] = grid.x[k][i - 1 - mesh._ext_range.start[k]]
+                                                          + grid.dx[k][i - 1 - mesh._ext_range.start[k]];
             }
         }
 
         void set1DMesh(const MeshSetter& f, Index k) {
             set1DRange(k);
             for (Index i = mesh._range.start[k]; i < mesh._range.end[k]; ++i) {
-                mesh._x[k][i - mesh._ext_range.start[k]] = f(i);
+                grid.x[k][i - mesh._ext_range.start[k]] = f(i);
             }
             for (Index j = mesh._range.start[k]; j < mesh._range.end[k] - 1; ++j) {
-                mesh._dx[k][j - mesh._ext_range.start[k]] = (mesh._x[k][j + 1 - mesh._ext_range.start[k]]
-                                                             - mesh._x[k][j - mesh._ext_range.start[k]]);
-                mesh._idx[k][j - mesh._ext_range.start[k]] = 1. / mesh._dx[k][j - mesh._ext_range.start[k]];
+                grid.dx[k][j - mesh._ext_range.start[k]] = (grid.x[k][j + 1 - mesh._ext_range.start[k]]
+                                                            - grid.x[k][j - mesh._ext_range.start[k]]);
+                grid.idx[k][j - mesh._ext_range.start[k]] = 1. / grid.dx[k][j - mesh._ext_range.start[k]];
             }
             setExtMesh(k);
         }
@@ -292,12 +317,12 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
         void set1DMesh(Real min, Real max, Index k) {
             set1DRange(k);
             for (Index i = mesh._range.start[k]; i < mesh._range.end[k]; ++i) {
-                mesh._x[k][i - mesh._ext_range.start[k]]
+                grid.x[k][i - mesh._ext_range.start[k]]
                         = (max - min) / (mesh._dims[k] - 1) * (i - mesh._range.start[k]) + min;
             }
             for (Index j = mesh._range.start[k]; j < mesh._range.end[k] - 1; ++j) {
-                mesh._dx[k][j - mesh._ext_range.start[k]] = (max - min) / (mesh._dims[k] - 1);
-                mesh._idx[k][j - mesh._ext_range.start[k]] = 1. / mesh._dx[k][j - mesh._ext_range.start[k]];
+                grid.dx[k][j - mesh._ext_range.start[k]] = (max - min) / (mesh._dims[k] - 1);
+                grid.idx[k][j - mesh._ext_range.start[k]] = 1. / grid.dx[k][j - mesh._ext_range.start[k]];
             }
             setExtMesh(k);
         }
@@ -85,6 +85,22 @@ OPFLOW_MODULE_EXPORT namespace OpFlow::Meta {
         using type = float;
     };
 
+    /// \brief Type in which reductions accumulate values of type T
+    /// \details Floating points narrower than double are summed in double, so that the rounding error
+    /// of a reduction doesn't grow with the extent of a field stored in low precision.
+    template <typename T>
+    struct accumulateType {
+        using type = T;
+    };
+
+    template <std::floating_point T>
+    requires(sizeof(T) < sizeof(double)) struct accumulateType<T> {
+        using type = double;
+    };
+
+    template <typename T>
+    using accumulateType_t = typename accumulateType<T>::type;
+
     template <typename T>
     struct is_numerical {
         constexpr static bool value = std::is_integral_v<T> || std::is_floating_point_v<T>;
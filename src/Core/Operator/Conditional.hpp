@@ -21,6 +21,8 @@
 
 OPFLOW_MODULE_EXPORT namespace OpFlow {
     struct CondOp {
+        constexpr static auto bc_width = 0;
+
         template <ExprType C, ExprType T1, ExprType T2>
         OPFLOW_STRONG_INLINE static auto couldSafeEval(const C& c, const T1& t1, const T2& t2, auto&& i) {
             return DS::inRange(c.accessibleRange, i) && DS::inRange(t1.accessibleRange, i)
@@ -42,7 +44,9 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
         template <FieldExprType C, FieldExprType T1, FieldExprType T2>
         static void prepare(const Expression<CondOp, C, T1, T2>& expr) {
             expr.initPropsFrom(expr.arg2);
-            expr.name = std::format("{} ? {} : {}", expr.arg1.name, expr.arg2.name, expr.arg3.name);
+            expr.name_gen = [](const auto& e) {
+                return std::format("{} ? {} : {}", e.arg1.getName(), e.arg2.getName(), e.arg3.getName());
+            };
             if constexpr (MeshBasedFieldExprType<
                                   T1> && MeshBasedFieldExprType<T2> && MeshBasedFieldExprType<C>) {
                 OP_ASSERT(expr.arg1.mesh == expr.arg2.mesh);
@@ -83,7 +87,9 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
             if constexpr (MeshBasedFieldExprType<T1> && MeshBasedFieldExprType<T2>)
                 OP_ASSERT(expr.arg2.mesh == expr.arg3.mesh);
             expr.initPropsFrom(expr.arg2);
-            expr.name = std::format("{} ? {} : {}", expr.arg1.name, expr.arg2.name, expr.arg3.name);
+            expr.name_gen = [](const auto& e) {
+                return std::format("{} ? {} : {}", e.arg1.getName(), e.arg2.getName(), e.arg3.getName());
+            };
             if constexpr (StructuredFieldExprType<T1>) {
                 expr.accessibleRange = DS::commonRange(expr.arg2.accessibleRange, expr.arg3.accessibleRange);
                 expr.assignableRange.setEmpty();
@@ -106,24 +112,26 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
         static void prepare(const Expression<CondOp, C, T1, ScalarExpr<T2>>& expr) {
             expr.initPropsFrom(expr.arg2);
             if constexpr (ScalarExprType<C>) {
-                if (expr.arg1.get()) {
-                    expr.name = expr.arg2.name;
-                } else
-                    expr.name = std::format("{}", expr.arg3.get());
+                expr.name_gen = [](const auto& e) {
+                    return e.arg1.get() ? e.arg2.getName() : std::format("{}", e.arg3.get());
+                };
             } else
-                expr.name = std::format("{} ? {} : {}", expr.arg1.name, expr.arg2.name, expr.arg3.get());
+                expr.name_gen = [](const auto& e) {
+                    return std::format("{} ? {} : {}", e.arg1.getName(), e.arg2.getName(), e.arg3.get());
+                };
         }
 
         template <typename C, Meta::Numerical T1, FieldExprType T2>
         static void prepare(const Expression<CondOp, C, ScalarExpr<T1>, T2>& expr) {
             expr.initPropsFrom(expr.arg3);
             if constexpr (ScalarExprType<C>) {
-                if (expr.arg1.get()) {
-                    expr.name = std::format("{}", expr.arg2.get());
-                } else
-                    expr.name = expr.arg3.name;
+                expr.name_gen = [](const auto& e) {
+                    return e.arg1.get() ? std::format("{}", e.arg2.get()) : e.arg3.getName();
+                };
             } else
-                expr.name = std::format("{} ? {} : {}", expr.arg1.name, expr.arg2.get(), expr.arg3.name);
+                expr.name_gen = [](const auto& e) {
+                    return std::format("{} ? {} : {}", e.arg1.getName(), e.arg2.get(), e.arg3.getName());
+                };
         }
     };
 
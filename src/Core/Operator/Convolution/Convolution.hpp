@@ -87,7 +87,9 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
             expr.initPropsFrom(expr.arg1);
 
             // name
-            expr.name = std::format("Convolution<{}>({})", d, expr.arg1.name);
+            expr.name_gen = [](const auto& e) {
+                return std::format("Convolution<{}>({})", d, e.arg1.getName());
+            };
 
             // ranges
             for (auto i = 0; i < d; ++i) {
@@ -107,7 +109,9 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
             expr.initPropsFrom(expr.arg1);
 
             // name
-            expr.name = std::format("Convolution<{}>({})", d, expr.arg1.name);
+            expr.name_gen = [](const auto& e) {
+                return std::format("Convolution<{}>({})", d, e.arg1.getName());
+            };
 
             // ranges
             for (auto& l : expr.accessibleRanges)
@@ -69,7 +69,9 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
         static inline void prepare(const Expression<D1FirstOrderBiasedUpwind, E>& expr) {
             expr.initPropsFrom(expr.arg1);
             // name
-            expr.name = std::format("d1<D1FirstOrderBiasedUpwind<{}>>(", d) + expr.arg1.name + ")";
+            expr.name_gen = [](const auto& e) {
+                return std::format("d1<D1FirstOrderBiasedUpwind<{}>>({})", d, e.arg1.getName());
+            };
 
             // mesh
             expr.mesh = expr.arg1.mesh.getView();
@@ -88,7 +90,9 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
             expr.initPropsFrom(expr.arg1);
 
             // name
-            expr.name = std::format("d1<D1FirstOrderBiasedUpwind<{}>>({})", d, expr.arg1.name);
+            expr.name_gen = [](const auto& e) {
+                return std::format("d1<D1FirstOrderBiasedUpwind<{}>>({})", d, e.arg1.getName());
+            };
 
             // ranges
             if (expr.arg1.loc[d] == LocOnMesh::Corner) {
@@ -38,7 +38,9 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
         template <CartesianFieldExprType E>
         static inline void prepare(const Expression<D1FirstOrderCentered, E>& expr) {
             // name
-            expr.name = std::format("d1<D1FirstOrderCentered<{}>>(", d) + expr.arg1.name + ")";
+            expr.name_gen = [](const auto& e) {
+                return std::format("d1<D1FirstOrderCentered<{}>>({})", d, e.arg1.getName());
+            };
 
             // mesh
             expr.mesh = expr.arg1.mesh.getView();
@@ -102,7 +102,9 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
             expr.initPropsFrom(expr.arg1);
 
             // name
-            expr.name = std::format("d1<D1WENO53Downwind<{}>>({})", d, expr.arg1.name);
+            expr.name_gen = [](const auto& e) {
+                return std::format("d1<D1WENO53Downwind<{}>>({})", d, e.arg1.getName());
+            };
 
             // ranges
             expr.accessibleRange.start[d] += 3;
@@ -117,7 +119,9 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
             expr.initPropsFrom(expr.arg1);
 
             // name
-            expr.name = std::format("d1<D1WENO53Downwind<{}>>({})", d, expr.arg1.name);
+            expr.name_gen = [](const auto& e) {
+                return std::format("d1<D1WENO53Downwind<{}>>({})", d, e.arg1.getName());
+            };
             // ranges
             auto levels = expr.getLevels();
             for (auto l = 0; l < levels; ++l) {
@@ -99,7 +99,9 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
             constexpr auto dim = internal::CartesianFieldExprTrait<E>::dim;
             expr.initPropsFrom(expr.arg1);
             // name
-            expr.name = std::format("d1<D1WENO53Upwind<{}>>({})", d, expr.arg1.name);
+            expr.name_gen = [](const auto& e) {
+                return std::format("d1<D1WENO53Upwind<{}>>({})", d, e.arg1.getName());
+            };
             // ranges
             expr.accessibleRange.start[d] += 3;
             expr.accessibleRange.end[d] -= 3;
@@ -113,7 +115,9 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
             expr.initPropsFrom(expr.arg1);
 
             // name
-            expr.name = std::format("d1<D1WENO53Upwind<{}>>({})", d, expr.arg1.name);
+            expr.name_gen = [](const auto& e) {
+                return std::format("d1<D1WENO53Upwind<{}>>({})", d, e.arg1.getName());
+            };
 
             // ranges
             auto levels = expr.getLevels();
@@ -187,7 +187,9 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
         OPFLOW_STRONG_INLINE static void prepare(const Expression<D2SecondOrderCentered, E>& expr) {
             expr.initPropsFrom(expr.arg1);
             // name
-            expr.name = std::format("d2<D2SecondOrderCentered<{}>>({})", d, expr.arg1.name);
+            expr.name_gen = [](const auto& e) {
+                return std::format("d2<D2SecondOrderCentered<{}>>({})", d, e.arg1.getName());
+            };
 
             // mesh
             expr.mesh = expr.arg1.mesh.getView();
@@ -209,7 +211,9 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
             expr.initPropsFrom(expr.arg1);
 
             // name
-            expr.name = std::format("d2<D2SecondOrderCentered<{}>>({})", d, expr.arg1.name);
+            expr.name_gen = [](const auto& e) {
+                return std::format("d2<D2SecondOrderCentered<{}>>({})", d, e.arg1.getName());
+            };
 
             // ranges
             if (expr.arg1.loc[d] == LocOnMesh::Corner) {
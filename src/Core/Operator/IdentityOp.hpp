@@ -33,7 +33,7 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
         static void prepare(const Expression<IdentityOp, E>& expr) {
             expr.initPropsFrom(expr.arg1);
             // name
-            expr.name = std::format("Identity({})", expr.arg1.name);
+            expr.name_gen = [](const auto& e) { return std::format("Identity({})", e.arg1.getName()); };
         }
     };
 
@@ -155,7 +155,9 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
                               "D1FluxLimiterIntp error: Expression {} located in corner in dimension = {}",
                               expr.arg2.getName(), d);
                 expr.initPropsFrom(expr.arg2);
-                expr.name = std::format("D1Intp<D1FluxLimiter, {}, Cen2Cor>({})", d, expr.arg2.name);
+                expr.name_gen = [](const auto& e) {
+                    return std::format("D1Intp<D1FluxLimiter, {}, Cen2Cor>({})", d, e.arg2.getName());
+                };
                 expr.loc[d] = LocOnMesh ::Corner;
                 expr.accessibleRange.start[d] += 2;
                 expr.accessibleRange.end[d] -= 1;
@@ -189,7 +191,9 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
                               "D1FluxLimiterIntp error: Expression {} located in center in dimension = {}",
                               expr.arg2.getName(), d);
                 expr.initPropsFrom(expr.arg2);
-                expr.name = std::format("D1Intp<D1FluxLimiter, {}, Cor2Cen>({})", d, expr.arg2.name);
+                expr.name_gen = [](const auto& e) {
+                    return std::format("D1Intp<D1FluxLimiter, {}, Cor2Cen>({})", d, e.arg2.getName());
+                };
                 expr.loc[d] = LocOnMesh ::Center;
                 expr.accessibleRange.start[d] += 1;
                 expr.accessibleRange.end[d] -= 2;
@@ -32,6 +32,29 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
 
 #undef DEFINE_BINOP
 #undef DEFINE_UNIOP
+
+    namespace internal {
+        template <>
+        struct WordwiseOp<AndOp> {
+            static auto apply(auto a, auto b) { return a & b; }
+        };
+        template <>
+        struct WordwiseOp<BitAndOp> : WordwiseOp<AndOp> {};
+        template <>
+        struct WordwiseOp<OrOp> {
+            static auto apply(auto a, auto b) { return a | b; }
+        };
+        template <>
+        struct WordwiseOp<BitOrOp> : WordwiseOp<OrOp> {};
+        template <>
+        struct WordwiseOp<BitXorOp> {
+            static auto apply(auto a, auto b) { return a ^ b; }
+        };
+        template <>
+        struct WordwiseOp<NotOp> {
+            static auto apply(auto a) { return ~a; }
+        };
+    }// namespace internal
 }// namespace OpFlow
 
 #endif//OPFLOW_BOOLEAN_HPP
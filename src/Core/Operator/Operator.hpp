@@ -21,5 +21,13 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
 
     template <typename Op, typename... Args>
     struct ResultType;
+
+    namespace internal {
+        /// \brief Op applied to words of packed bools, i.e., to 64 points at a time
+        /// \details Specialized with a static apply(words...) for the logical ops which act on each bit
+        /// independently. Other ops are left empty & evaluated point by point.
+        template <typename Op>
+        struct WordwiseOp {};
+    }// namespace internal
 }// namespace OpFlow
 #endif//OPFLOW_OPERATOR_HPP
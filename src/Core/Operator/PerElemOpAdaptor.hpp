@@ -44,7 +44,9 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
         static void prepare(const Expression<UniOpAdaptor, E>& expr) {
             expr.initPropsFrom(expr.arg1);
             // name
-            expr.name = std::format("{}({})", Functor.getName().to_string(), expr.arg1.name);
+            expr.name_gen = [](const auto& e) {
+                return std::format("{}({})", Functor.getName().to_string(), e.arg1.getName());
+            };
         }
     };
 
@@ -86,8 +88,10 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
         static void prepare(const Expression<BinOpAdaptor, E1, E2>& expr) {
             expr.initPropsFrom(expr.arg1);
             // name
-            expr.name = std::format("{}({}, {})", Functor.getName().to_string(), expr.arg1.name,
-                                    expr.arg2.name);
+            expr.name_gen = [](const auto& e) {
+                return std::format("{}({}, {})", Functor.getName().to_string(), e.arg1.getName(),
+                                   e.arg2.getName());
+            };
         }
     };
 
@@ -22,6 +22,9 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
         int distributed_workers_count = 1;
         int shared_memory_workers_count = 1;
         int heterogeneous_workers_count = 0;
+        /// Place tensor storage by parallel first touch & statically partition the loops over it, so
+        /// that loops run on the threads (and NUMA nodes) owning the pages they access
+        bool first_touch = false;
 
         [[nodiscard]] bool serialMode() const {
             return distributed_workers_count == 1 && shared_memory_workers_count == 1
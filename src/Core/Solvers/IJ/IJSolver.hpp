@@ -78,6 +78,16 @@ OPFLOW_MODULE_EXPORT namespace OpFlow {
         bool staticMat = false, pinValue = false, verbose = false, profile = false;
         std::optional<std::string> dumpPath {};
     };
+
+    /// \brief AMGCL solver applying the AMG preconditioner in single precision
+    /// \details The Krylov iterations stay in double, so the solution converges to the same tolerance while
+    /// the preconditioner, which only approximates the inverse, moves half the bytes.
+    template <template <class> class Coarsening = amgcl::coarsening::smoothed_aggregation,
+              template <class> class Relaxation = amgcl::relaxation::spai0,
+              template <class...> class IterativeSolver = amgcl::solver::bicgstab>
+    using AMGCLMixedPrecisionSolver
+            = amgcl::make_solver<amgcl::amg<amgcl::backend::builtin<float>, Coarsening, Relaxation>,
+                                 IterativeSolver<amgcl::backend::builtin<double>>>;
 }// namespace OpFlow
 
 #endif//OPFLOW_IJSOLVER_HPP
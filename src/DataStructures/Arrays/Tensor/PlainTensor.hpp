@@ -20,11 +20,17 @@
 #include "DataStructures/Index/RangedIndex.hpp"
 #include "TensorBase.hpp"
 #include "Utils/Allocator/AlignedAllocator.hpp"
+#include "Utils/Allocator/ScratchPool.hpp"
 #include "Utils/Allocator/StaticAllocator.hpp"
 #ifndef OPFLOW_INSIDE_MODULE
 #include <array>
+#include <atomic>
+#include <bit>
 #include <concepts>
+#include <cstdint>
+#include <functional>
 #include <memory>
+#include <mutex>
 #endif
 
 OPFLOW_MODULE_EXPORT namespace OpFlow::DS {
@@ -52,17 +58,29 @@ OPFLOW_MODULE_EXPORT namespace OpFlow::DS {
     requires Utils::StaticAllocatorType<ScalarType, Allocator> struct PlainTensor
         : public Tensor<PlainTensor<ScalarType, d, Allocator>> {
     private:
+        // number of tensors referring to a storage shared by share()
+        struct SharedCount {
+            std::atomic<int> count;
+        };
+
         ScalarType* data = nullptr;
+        bool pooled = false;  // data is borrowed from the scratch pool
+        bool external = false;// data is owned by someone else, see bindStorage
+        mutable SharedCount* shared = nullptr;// non-null if data may be shared with other tensors
 
     public:
         std::array<int, d> dims;
-        long long total_size = 1, allocated_size = 0;
+        std::array<int, d> pitch;// storage extents, i.e., dims plus the padding of each dim
+        long long total_size = 1, allocated_size = 0;// total_size counts the storage, padding included
 
         using Scalar = ScalarType;
         using value_type = Scalar;// mocking std::vector
 
-        PlainTensor() { dims.fill(0); }
-        ~PlainTensor() { Allocator::deallocate(data, allocated_size); }
+        PlainTensor() {
+            dims.fill(0);
+            pitch.fill(0);
+        }
+        ~PlainTensor() { release(); }
 
         explicit PlainTensor(std::integral auto size, std::integral auto... sizes) {
             reShape(size, sizes...);
@@ -74,65 +92,148 @@ OPFLOW_MODULE_EXPORT namespace OpFlow::DS {
             return reShape(std::array<int, sizeof...(sizes) + 1> {size, sizes...});
         }
 
-        auto& reShape(const std::array<int, d>& sizes) {
-            if (data) Allocator::deallocate(data, allocated_size);
+        auto& reShape(const std::array<int, d>& sizes) { return reShape(sizes, DS::Range<d> {sizes}); }
+
+        /// \brief Reshape the tensor & place its storage for loops over \p touch_range
+        /// \details In first touch mode (ParallelPlan::first_touch) the elements in \p touch_range are
+        /// initialized in parallel with the partition rangeFor uses for \p touch_range, so that the pages
+        /// land on the memory of the threads later looping over it.
+        /// \param sizes New dims
+        /// \param touch_range Range in the index space of the tensor to be looped over
+        auto& reShape(const std::array<int, d>& sizes, const DS::Range<d>& touch_range) {
+            return reShape(sizes, touch_range, sizes);
+        }
+
+        /// \brief Reshape the tensor with padded storage extents
+        /// \details Element k is stored at the position it would have in a dense tensor of dims \p pitch,
+        /// so that indexing is unchanged & only the strides grow. The padding elements are never addressed.
+        /// \param sizes New dims
+        /// \param touch_range Range in the index space of the tensor to be looped over
+        /// \param pitch Storage extents, no less than \p sizes. The outermost one is taken from \p sizes
+        auto& reShape(const std::array<int, d>& sizes, const DS::Range<d>& touch_range,
+                      const std::array<int, d>& pitch) {
+            release();
             dims = sizes;
+            this->pitch = pitch;
+            this->pitch[d - 1] = sizes[d - 1];
             total_size = 1;
-            for (auto i = 0; i < d; ++i) { total_size *= dims[i]; }
-            data = Allocator::allocate(total_size);
-            allocated_size = total_size;
+            for (auto i = 0; i < d; ++i) {
+                OP_ASSERT(this->pitch[i] >= dims[i]);
+                total_size *= this->pitch[i];
+            }
+            // adopted storage holds values already, e.g., the pages of a mapped restart file
+            auto adopted = acquire(total_size);
+            if (getGlobalParallelPlan().first_touch && !adopted)
+                rangeFor(touch_range, [&](auto&& k) { data[getOffset(k)] = ScalarType {}; });
             return *this;
         }
 
+        /// \brief Storage extents of \p sizes padded against cache set conflicts
+        /// \details When the stride of a dim is close to a multiple of the 4 KiB the L1 sets span, e.g., for
+        /// power-of-two grids, neighbors along that dim (the k +- 1 planes of a stencil) compete for the
+        /// same sets. Each inner extent is grown until the first few multiples of the next stride stay
+        /// 2 cache lines away from a multiple of the span.
+        static std::array<int, d> paddedPitch(const std::array<int, d>& sizes) {
+            constexpr long long line = 64, span = 4096;
+            auto conflicts = [&](long long stride) {
+                for (long long m = 1; m <= 4; ++m) {
+                    auto r = m * stride % span;
+                    if (m * stride >= span && std::min(r, span - r) < 2 * line) return true;
+                }
+                return false;
+            };
+            auto ret = sizes;
+            long long stride = sizeof(ScalarType);
+            for (auto i = 0; i < d - 1; ++i) {
+                for (auto n = 0; n < line && conflicts(stride * ret[i]); ++n) ++ret[i];
+                stride *= ret[i];
+            }
+            return ret;
+        }
+
         auto& resize(std::integral auto size, std::integral auto... sizes) {
             return resize(std::array<int, d> {(int) size, (int) sizes...});
         }
 
         auto& resize(const std::array<int, d>& sizes) {
-            if (DS::Range<d> {dims}.covers(DS::Range<d> {sizes})) {
+            if (DS::Range<d> {pitch}.covers(DS::Range<d> {sizes})) {
+                // the elements kept stay in place within the current storage
                 dims = sizes;
-                total_size = 1;
-                for (auto i = 0; i < d; ++i) total_size *= sizes[i];
             } else {
-                ScalarType* new_data;
                 total_size = 1;
                 for (auto i = 0; i < d; ++i) total_size *= sizes[i];
-                new_data = Allocator::allocate(total_size);
-                if (data) {
-                    rangeFor(DS::commonRange(DS::Range<d> {dims}, DS::Range<d> {sizes}),
-                             [&](auto&& k) { new_data[getOffset(k)] = data[getOffset(k)]; });
-                    Allocator::deallocate(data, allocated_size);
-                }
-                allocated_size = total_size;
-                data = new_data;
-                dims = sizes;
+                PlainTensor old(std::move(*this));
+                acquire(total_size);
+                dims = pitch = sizes;
+                if (old.data)
+                    rangeFor(DS::commonRange(DS::Range<d> {old.dims}, DS::Range<d> {sizes}),
+                             [&](auto&& k) { data[getOffset(k)] = old.data[old.getOffset(k)]; });
             }
             return *this;
         }
 
         template <typename OtherScalar>
         explicit PlainTensor(const PlainTensor<OtherScalar, d>& other)
-            : dims(other.dims), total_size(other.total_size) {
+            : dims(other.dims), pitch(pitchOf(other)), total_size(other.total_size) {
             if (other.raw() == nullptr) return;
-            data = Allocator::allocate(total_size);
-            allocated_size = total_size;
+            acquire(total_size);
             // deep copy of data, assuming OtherScalar can be converted to Scalar
-            std::copy(other.raw(), other.raw() + total_size, this->raw());
+            if constexpr (std::same_as<OtherScalar, bool>)// bools are packed, see the specialization below
+                for (long long i = 0; i < total_size; ++i) data[i] = other.get(i);
+            else
+                copyFrom(other.raw());
         }
 
         PlainTensor(const PlainTensor& other)// copy the above impl because we can't call a templated ctor
-            : dims(other.dims), total_size(other.total_size) {
+            : dims(other.dims), pitch(other.pitch), total_size(other.total_size) {
             if (other.raw() == nullptr) return;
-            data = Allocator::allocate(total_size);
-            allocated_size = total_size;
+            acquire(total_size);
             // deep copy of data, assuming OtherScalar can be converted to Scalar
-            std::copy(other.raw(), other.raw() + total_size, this->raw());
+            copyFrom(other.raw());
         }
 
         PlainTensor(PlainTensor&& other) noexcept
-            : dims(std::move(other.dims)), total_size(other.total_size) {
+            : dims(std::move(other.dims)), pitch(std::move(other.pitch)), total_size(other.total_size),
+              allocated_size(other.allocated_size) {
             data = other.data;
+            pooled = other.pooled;
+            external = other.external;
+            shared = other.shared;
             other.data = nullptr;
+            other.shared = nullptr;
+            other.allocated_size = 0;
+        }
+
+        /// \brief Copy sharing the storage with this tensor until either of them writes to it
+        /// \details A tensor sharing its storage takes a private copy on the first non-const access, i.e.,
+        /// through operator[], operator(), get, raw, begin/end, or on detach(). Assignment & setConstant
+        /// drop the share instead, as all the values are overwritten. Storage bound by bindStorage & copies
+        /// made in a Utils::ScratchScope are copied right away.
+        PlainTensor share() const {
+            if (!data || external || Utils::ScratchScope::active()) return PlainTensor(*this);
+            PlainTensor ret;
+            ret.dims = dims;
+            ret.pitch = pitch;
+            ret.total_size = total_size;
+            ret.allocated_size = allocated_size;
+            ret.pooled = pooled;
+            std::lock_guard lock(shareLock());
+            if (!shared) std::atomic_ref(shared).store(new SharedCount {1}, std::memory_order_release);
+            shared->count.fetch_add(1, std::memory_order_relaxed);
+            ret.data = data;
+            ret.shared = shared;
+            return ret;
+        }
+
+        /// \brief Whether the storage is shared with other tensors
+        bool isShared() const { return shared && shared->count.load(std::memory_order_relaxed) > 1; }
+
+        /// \brief Take a private copy of the storage if it's shared
+        /// \details Writes through the element accessors detach by themselves, copying serially; doing it
+        /// ahead of a loop copies in parallel with the first touch placement. Not to be called from within
+        /// a parallel loop.
+        void detach() {
+            if (std::atomic_ref(shared).load(std::memory_order_acquire)) detachImpl(true);
         }
 
         // operator= is simply treated as assignment
@@ -140,72 +241,199 @@ OPFLOW_MODULE_EXPORT namespace OpFlow::DS {
         requires(!std::is_same_v<Scalar, OtherScalar>) auto&
         operator=(const PlainTensor<OtherScalar, d>& other) {
             OP_ASSERT(other.raw());// assign to an empty tensor is an error
-            if (!data) {
-                reShape(other);
-            } else {
-                if (this->total_size < other.total_size) reShape(other);
-            }
-            std::copy(other.raw(), other.raw() + total_size, data);
+            if (shared) release();// all the values are overwritten
+            if (!data || pitch != pitchOf(other))
+                reShape(other.dims, DS::Range<d> {other.dims}, pitchOf(other));
+            dims = other.dims;
+            if constexpr (std::same_as<OtherScalar, bool>)
+                for (long long i = 0; i < other.total_size; ++i) data[i] = other.get(i);
+            else
+                std::copy(other.raw(), other.raw() + total_size, data);
             return *this;
         }
 
         auto& operator=(const PlainTensor& other) {
             if (this == &other) return *this;
             OP_ASSERT(other.raw());
-            if (data == nullptr) {
-                reShape(other);
-            } else {
-                if (total_size < other.total_size) reShape(other);
-            }
+            if (shared) release();// all the values are overwritten
+            // the storage is copied as is, so this takes the pitch of other
+            if (data == nullptr || pitch != other.pitch)
+                reShape(other.dims, DS::Range<d> {other.dims}, other.pitch);
+            dims = other.dims;
             std::copy(other.raw(), other.raw() + total_size, data);
             return *this;
         }
 
         auto& operator=(PlainTensor&& other) noexcept {
             dims = std::move(other.dims);
+            pitch = std::move(other.pitch);
             total_size = other.total_size;
-            if (data) Allocator::deallocate(data, allocated_size);
+            release();
             data = other.data;
+            pooled = other.pooled;
+            external = other.external;
+            shared = other.shared;
+            allocated_size = other.allocated_size;
             other.data = nullptr;
+            other.shared = nullptr;
+            other.allocated_size = 0;
             return *this;
         }
 
         template <typename OtherScalar>
-        void reShape(const PlainTensor<OtherScalar, d>& other) {
-            if (data) Allocator::deallocate(data, allocated_size);
-            dims = other.dims;
-            total_size = other.total_size;
-            data = Allocator::allocate(total_size);
-            allocated_size = total_size;
-        }
+        void reShape(const PlainTensor<OtherScalar, d>& other) { reShape(other.dims); }
 
         auto operator==(const PlainTensor& other) const { return raw() == other.raw(); }
 
-        void setConstant(Scalar t) { std::fill(data, data + total_size, t); }
+        void setConstant(Scalar t) {
+            // the values are all overwritten, so a shared storage is dropped instead of copied
+            if (shared) reShape(dims, DS::Range<d> {dims}, pitch);
+            std::fill(data, data + total_size, t);
+        }
 
         void setZero() { setConstant(Scalar(0)); }
 
-        auto begin() { return data; }
+        auto begin() {
+            own();
+            return data;
+        }
         auto begin() const { return data; }
 
-        auto end() { return data + total_size; }
+        auto end() { return begin() + total_size; }
         auto end() const { return data + total_size; }
 
-        auto& front() { return *data; }
+        auto& front() { return *begin(); }
         const auto& front() const { return *data; }
-        auto& back() { return data[total_size - 1]; }
+        auto& back() { return begin()[total_size - 1]; }
         const auto& back() const { return data[total_size - 1]; }
 
         auto size() const { return total_size; }
         auto getDims() const { return dims; }
 
+        /// \brief Move the elements into \p ptr & use it as the storage without owning it
+        /// \details \p ptr must hold total_size elements & outlive the tensor. The binding is dropped by
+        /// the next reshape, after which the tensor owns its storage again.
+        void bindStorage(ScalarType* ptr) {
+            if (data) std::copy(data, data + total_size, ptr);
+            release();
+            data = ptr;
+            external = true;
+            allocated_size = total_size;
+        }
+
+        bool isExternal() const { return external; }
+
     private:
+        // allocations made in a Utils::ScratchScope borrow from the scratch pool. Returns true if the
+        // allocator handed over a staged buffer with contents, see Utils::MappedAllocator
+        bool acquire(std::size_t size) {
+            pooled = Utils::ScratchScope::active();
+            external = false;
+            auto adopted = false;
+            if constexpr (requires { Allocator::isStaged(size); })
+                adopted = !pooled && Allocator::isStaged(size);
+            data = pooled ? Utils::ScratchPool<ScalarType, Allocator>::acquire(size)
+                          : Allocator::allocate(size);
+            allocated_size = size;
+            return adopted;
+        }
+
+        void release() {
+            if (!data) return;
+            if (shared) {
+                // the last tensor sharing the storage frees it
+                bool last;
+                {
+                    std::lock_guard lock(shareLock());
+                    last = shared->count.fetch_sub(1, std::memory_order_acq_rel) == 1;
+                    if (last) delete shared;
+                    std::atomic_ref(shared).store(nullptr, std::memory_order_release);
+                }
+                if (!last) {
+                    data = nullptr;
+                    allocated_size = 0;
+                    return;
+                }
+            }
+            if (external) external = false;
+            else if (pooled) Utils::ScratchPool<ScalarType, Allocator>::release(data, allocated_size);
+            else
+                Allocator::deallocate(data, allocated_size);
+            data = nullptr;
+            allocated_size = 0;
+        }
+
+        // share() & detach of the same tensor are serialized, so that no thread joins a counter that is
+        // being freed, & concurrent first writes of a loop take a single copy
+        std::mutex& shareLock() const {
+            static std::array<std::mutex, 64> locks;
+            return locks[std::hash<const void*> {}(this) % locks.size()];
+        }
+
+        // storage shared by share() is copied before the first write through this tensor
+        void own() {
+            if (std::atomic_ref(shared).load(std::memory_order_acquire)) [[unlikely]]
+                detachImpl(false);
+        }
+
+        // the copy is made before the reference is dropped, so that no sharer frees or writes the storage
+        // while it's read. A count of one can't grow meanwhile, as only this tensor refers to the counter
+        // & share() of this tensor waits for the lock
+        void detachImpl(bool parallel_copy) {
+            std::lock_guard lock(shareLock());
+            auto* count = shared;
+            if (!count) return;// detached by another thread's write meanwhile
+            if (count->count.load(std::memory_order_acquire) > 1) {
+                auto old = data;
+                auto old_pooled = pooled;
+                auto fresh = Allocator::allocate(allocated_size);
+                if (parallel_copy) {
+                    data = fresh;
+                    copyFrom(old);
+                } else {
+                    std::copy(old, old + total_size, fresh);
+                    data = fresh;
+                }
+                pooled = false;
+                if (count->count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    // the others have left meanwhile
+                    delete count;
+                    if (old_pooled) Utils::ScratchPool<ScalarType, Allocator>::release(old, allocated_size);
+                    else
+                        Allocator::deallocate(old, allocated_size);
+                }
+            } else {
+                delete count;
+            }
+            std::atomic_ref(shared).store(nullptr, std::memory_order_release);
+        }
+
+        // packed tensors of bools have no padding
+        template <typename Other>
+        static auto pitchOf(const Other& t) {
+            if constexpr (requires { t.pitch; }) return t.pitch;
+            else
+                return t.dims;
+        }
+
+        // a copy is the first touch of the new storage
+        template <typename OtherScalar>
+        void copyFrom(const OtherScalar* src) {
+            if (getGlobalParallelPlan().first_touch)
+                rangeFor(DS::Range<d> {dims}, [&](auto&& k) {
+                    auto pos = getOffset(k);
+                    data[pos] = src[pos];
+                });
+            else
+                std::copy(src, src + total_size, data);
+        }
+
         template <Meta::BracketIndexable Idx>
         auto getOffset(const Idx& index) const {
             auto pos = 0;
             for (auto i = d - 1; i >= 1; --i) {
                 pos += index[i];
-                pos *= dims[i - 1];
+                pos *= pitch[i - 1];
             }
             pos += index[0];
             return pos;
@@ -228,6 +456,7 @@ OPFLOW_MODULE_EXPORT namespace OpFlow::DS {
 
         template <typename... T>
         auto& operator()(T&&... index) {
+            own();
             return data[getOffset(std::forward<T>(index)...)];
         }
 
@@ -239,21 +468,32 @@ OPFLOW_MODULE_EXPORT namespace OpFlow::DS {
 
         template <typename T>
         auto& operator[](T&& index) {
+            own();
             return data[getOffset(std::forward<T>(index))];
         }
 
         // linear index getter
         const auto& get(const std::integral auto& idx) const { return data[idx]; }
 
-        auto& get(const std::integral auto& idx) { return data[idx]; }
+        auto& get(const std::integral auto& idx) {
+            own();
+            return data[idx];
+        }
 
-        auto raw() { return data; }
+        auto raw() {
+            own();
+            return data;
+        }
 
         auto raw() const { return data; }
 
         void swap(PlainTensor& other) {
-            OP_ASSERT(dims == other.dims);
+            OP_ASSERT(dims == other.dims && pitch == other.pitch);
             std::swap(data, other.data);
+            std::swap(pooled, other.pooled);
+            std::swap(external, other.external);
+            std::swap(shared, other.shared);
+            std::swap(allocated_size, other.allocated_size);
         }
     };
 
@@ -315,6 +555,332 @@ OPFLOW_MODULE_EXPORT namespace OpFlow::DS {
             other.val = t;
         }
     };
+
+    /// \brief Reference to one bit of a bit-packed tensor
+    /// \details Writes are atomic read-modify-writes of the containing word, so that different threads of a
+    /// rangeFor can write neighboring bits concurrently.
+    struct BitReference {
+        std::uint64_t* word;
+        std::uint64_t mask;
+
+        operator bool() const { return std::atomic_ref(*word).load(std::memory_order_relaxed) & mask; }
+
+        BitReference& operator=(bool b) {
+            if (b) std::atomic_ref(*word).fetch_or(mask, std::memory_order_relaxed);
+            else
+                std::atomic_ref(*word).fetch_and(~mask, std::memory_order_relaxed);
+            return *this;
+        }
+        BitReference& operator=(const BitReference& other) { return *this = bool(other); }
+        BitReference& operator&=(bool b) {
+            if (!b) std::atomic_ref(*word).fetch_and(~mask, std::memory_order_relaxed);
+            return *this;
+        }
+        BitReference& operator|=(bool b) {
+            if (b) std::atomic_ref(*word).fetch_or(mask, std::memory_order_relaxed);
+            return *this;
+        }
+        BitReference& operator^=(bool b) {
+            if (b) std::atomic_ref(*word).fetch_xor(mask, std::memory_order_relaxed);
+            return *this;
+        }
+        void flip() { *this ^= true; }
+    };
+
+    /// \brief Tensor of bools packed 64 to a word
+    /// \details Elements are laid out in the same order as the primary template, bit k of the storage being
+    /// bit k % 64 of word k / 64. Element access goes through BitReference; masks are combined & counted
+    /// a word at a time by the word-wise members below. The storage is always owned & dense: there is no
+    /// share/detach, pitch padding or bindStorage, so copies are deep and the field helpers probing for
+    /// these members fall back to plain copies.
+    template <int d, typename Allocator>
+    requires(d > 0) && Utils::StaticAllocatorType<bool, Allocator> struct PlainTensor<bool, d, Allocator>
+        : public Tensor<PlainTensor<bool, d, Allocator>> {
+        using word_type = std::uint64_t;
+        constexpr static int word_bits = 64;
+
+    private:
+        using WordAllocator =
+                typename Utils::internal::AllocatorTrait<Allocator>::template other_type<word_type>;
+        word_type* data = nullptr;
+        bool pooled = false;// data is borrowed from the scratch pool
+
+    public:
+        std::array<int, d> dims;
+        long long total_size = 1, allocated_size = 0;// allocated_size counts words
+
+        using Scalar = bool;
+        using value_type = Scalar;
+
+        PlainTensor() { dims.fill(0); }
+        ~PlainTensor() { release(); }
+
+        explicit PlainTensor(std::integral auto size, std::integral auto... sizes) {
+            reShape(size, sizes...);
+        }
+
+        explicit PlainTensor(const std::array<int, d>& size) { reShape(size); }
+
+        auto& reShape(std::integral auto size, std::integral auto... sizes) {
+            return reShape(std::array<int, sizeof...(sizes) + 1> {size, sizes...});
+        }
+
+        auto& reShape(const std::array<int, d>& sizes) { return reShape(sizes, DS::Range<d> {sizes}); }
+
+        auto& reShape(const std::array<int, d>& sizes, const DS::Range<d>& touch_range) {
+            release();
+            dims = sizes;
+            total_size = 1;
+            for (auto i = 0; i < d; ++i) { total_size *= dims[i]; }
+            acquire(wordCount());
+            if (getGlobalParallelPlan().first_touch)
+                rangeFor(touch_range, [&](auto&& k) { (*this)[k] = false; });
+            return *this;
+        }
+
+        auto& resize(std::integral auto size, std::integral auto... sizes) {
+            return resize(std::array<int, d> {(int) size, (int) sizes...});
+        }
+
+        auto& resize(const std::array<int, d>& sizes) {
+            PlainTensor old(std::move(*this));
+            dims = sizes;
+            total_size = 1;
+            for (auto i = 0; i < d; ++i) total_size *= sizes[i];
+            acquire(wordCount());
+            if (old.data)
+                rangeFor(DS::commonRange(DS::Range<d> {old.dims}, DS::Range<d> {sizes}),
+                         [&](auto&& k) { (*this)[k] = old[k]; });
+            return *this;
+        }
+
+        template <typename OtherScalar>
+        explicit PlainTensor(const PlainTensor<OtherScalar, d>& other)
+            : dims(other.dims), total_size(other.total_size) {
+            if (other.raw() == nullptr) return;
+            acquire(wordCount());
+            rangeFor(DS::Range<d> {dims}, [&](auto&& k) { (*this)[k] = bool(other[k]); });
+        }
+
+        PlainTensor(const PlainTensor& other) : dims(other.dims), total_size(other.total_size) {
+            if (other.raw() == nullptr) return;
+            acquire(wordCount());
+            std::copy(other.data, other.data + wordCount(), data);
+        }
+
+        PlainTensor(PlainTensor&& other) noexcept
+            : dims(std::move(other.dims)), total_size(other.total_size),
+              allocated_size(other.allocated_size) {
+            data = other.data;
+            pooled = other.pooled;
+            other.data = nullptr;
+            other.allocated_size = 0;
+        }
+
+        auto& operator=(const PlainTensor& other) {
+            if (this == &other) return *this;
+            OP_ASSERT(other.raw());
+            if (data == nullptr || allocated_size < other.wordCount()) reShape(other.dims);
+            dims = other.dims;
+            total_size = other.total_size;
+            std::copy(other.data, other.data + other.wordCount(), data);
+            return *this;
+        }
+
+        auto& operator=(PlainTensor&& other) noexcept {
+            dims = std::move(other.dims);
+            total_size = other.total_size;
+            release();
+            data = other.data;
+            pooled = other.pooled;
+            allocated_size = other.allocated_size;
+            other.data = nullptr;
+            other.allocated_size = 0;
+            return *this;
+        }
+
+        template <typename OtherScalar>
+        void reShape(const PlainTensor<OtherScalar, d>& other) { reShape(other.dims); }
+
+        auto operator==(const PlainTensor& other) const { return raw() == other.raw(); }
+
+        void setConstant(bool t) { std::fill(data, data + wordCount(), t ? ~word_type(0) : word_type(0)); }
+
+        void setZero() { setConstant(false); }
+
+        auto size() const { return total_size; }
+        auto getDims() const { return dims; }
+        long long wordCount() const { return (total_size + word_bits - 1) / word_bits; }
+
+        // word-wise ops on tensors of the same dims
+        auto& operator&=(const PlainTensor& other) {
+            OP_ASSERT(dims == other.dims);
+            for (long long w = 0; w < wordCount(); ++w) data[w] &= other.data[w];
+            return *this;
+        }
+        auto& operator|=(const PlainTensor& other) {
+            OP_ASSERT(dims == other.dims);
+            for (long long w = 0; w < wordCount(); ++w) data[w] |= other.data[w];
+            return *this;
+        }
+        auto& operator^=(const PlainTensor& other) {
+            OP_ASSERT(dims == other.dims);
+            for (long long w = 0; w < wordCount(); ++w) data[w] ^= other.data[w];
+            return *this;
+        }
+        auto& flip() {
+            for (long long w = 0; w < wordCount(); ++w) data[w] = ~data[w];
+            return *this;
+        }
+
+        /// \brief Number of true elements
+        long long count() const {
+            long long ret = 0;
+            for (long long w = 0; w < wordCount(); ++w) ret += std::popcount(data[w] & wordMask(w));
+            return ret;
+        }
+
+        /// \brief Number of true elements in \p range
+        long long count(const DS::Range<d>& range) const {
+            if (range.count() == 0) return 0;
+            return rangeReduce(range.slice(0, range.start[0]), std::plus<long long> {}, [&](auto&& k) {
+                long long ret = 0;
+                forEachWordOfRow(k, range.end[0] - range.start[0],
+                                 [&](long long w, word_type m) { ret += std::popcount(loadWord(w) & m); });
+                return ret;
+            });
+        }
+
+        bool any() const {
+            for (long long w = 0; w < wordCount(); ++w)
+                if (data[w] & wordMask(w)) return true;
+            return false;
+        }
+        bool all() const { return count() == total_size; }
+        bool none() const { return !any(); }
+
+        /// \brief Assign the elements in \p range a word at a time
+        /// \details For each word w of the storage overlapping \p range, the bits inside \p range are set to
+        /// those of \p f(w). Rows are processed in parallel; words shared by two rows are merged atomically.
+        /// \param range Range to be assigned
+        /// \param f Word generator, word_type(long long)
+        template <typename F>
+        void assignWords(const DS::Range<d>& range, F&& f) {
+            if (range.count() == 0) return;
+            rangeFor(range.slice(0, range.start[0]), [&](auto&& k) {
+                forEachWordOfRow(k, range.end[0] - range.start[0], [&](long long w, word_type m) {
+                    auto v = f(w);
+                    if (m == ~word_type(0)) data[w] = v;
+                    else {
+                        std::atomic_ref word(data[w]);
+                        auto old = word.load(std::memory_order_relaxed);
+                        while (!word.compare_exchange_weak(old, (old & ~m) | (v & m),
+                                                           std::memory_order_relaxed))
+                            ;
+                    }
+                });
+            });
+        }
+
+        /// \brief Atomically load the \p w th word, safe against concurrent writes of other elements
+        word_type loadWord(long long w) const {
+            return std::atomic_ref(const_cast<word_type&>(data[w])).load(std::memory_order_relaxed);
+        }
+
+    private:
+        void acquire(std::size_t size) {
+            pooled = Utils::ScratchScope::active();
+            data = pooled ? Utils::ScratchPool<word_type, WordAllocator>::acquire(size)
+                          : WordAllocator::allocate(size);
+            allocated_size = size;
+        }
+
+        void release() {
+            if (!data) return;
+            if (pooled) Utils::ScratchPool<word_type, WordAllocator>::release(data, allocated_size);
+            else
+                WordAllocator::deallocate(data, allocated_size);
+            data = nullptr;
+            allocated_size = 0;
+        }
+
+        // the bits of the w th word holding elements
+        word_type wordMask(long long w) const {
+            auto tail = total_size - w * word_bits;
+            return tail >= word_bits ? ~word_type(0) : (word_type(1) << tail) - 1;
+        }
+
+        // call f(w, mask) for each word w covering the row of length n starting at k
+        template <typename F>
+        void forEachWordOfRow(const auto& k, long long n, F&& f) const {
+            long long first = getOffset(k), last = first + n;
+            for (auto w = first / word_bits; w * word_bits < last; ++w) {
+                auto lo = std::max(first - w * word_bits, 0LL), hi = std::min(last - w * word_bits, 64LL);
+                auto m = hi - lo == word_bits ? ~word_type(0) : ((word_type(1) << (hi - lo)) - 1) << lo;
+                f(w, m);
+            }
+        }
+
+        template <Meta::BracketIndexable Idx>
+        long long getOffset(const Idx& index) const {
+            long long pos = 0;
+            for (auto i = d - 1; i >= 1; --i) {
+                pos += index[i];
+                pos *= dims[i - 1];
+            }
+            pos += index[0];
+            return pos;
+        }
+
+        long long getOffset(std::integral auto index) const { return index; }
+
+        template <typename... I>
+                requires(std::integral<Meta::RealType<I>>&&...)
+                && (sizeof...(I) > 1) long long getOffset(I&&... i) const {
+            return getOffset(DS::MDIndex<d> {i...});
+        }
+
+        auto bit(long long pos) const {
+            return BitReference {data + pos / word_bits, word_type(1) << (pos % word_bits)};
+        }
+
+    public:
+        template <typename... T>
+        bool operator()(T&&... index) const {
+            return bit(getOffset(std::forward<T>(index)...));
+        }
+
+        template <typename... T>
+        auto operator()(T&&... index) {
+            return bit(getOffset(std::forward<T>(index)...));
+        }
+
+        template <typename T>
+        bool operator[](T&& index) const {
+            return bit(getOffset(std::forward<T>(index)));
+        }
+
+        template <typename T>
+        auto operator[](T&& index) {
+            return bit(getOffset(std::forward<T>(index)));
+        }
+
+        bool get(const std::integral auto& idx) const { return bit(idx); }
+
+        auto get(const std::integral auto& idx) { return bit(idx); }
+
+        // the packed words
+        auto raw() { return data; }
+
+        auto raw() const { return data; }
+
+        void swap(PlainTensor& other) {
+            OP_ASSERT(dims == other.dims);
+            std::swap(data, other.data);
+            std::swap(pooled, other.pooled);
+            std::swap(allocated_size, other.allocated_size);
+        }
+    };
 }// namespace OpFlow::DS
 
 #endif//OPFLOW_PLAINTENSOR_HPP
@@ -147,5 +147,33 @@ OPFLOW_MODULE_EXPORT namespace OpFlow::DS {
         }
         return true;
     }
+
+    /// \brief Subtract box \p b from box \p a
+    /// \return At most 2d disjoint boxes covering a \ b
+    template <Meta::Numerical T, std::size_t d>
+    auto boxSubtract(const Box<T, d> &a, const Box<T, d> &b) {
+        std::vector<Box<T, d>> ret;
+        if (!boxIntersectBox(a, b)) {
+            ret.push_back(a);
+            return ret;
+        }
+        auto rest = a;
+        for (auto i = 0; i < d; ++i) {
+            // peel off the slabs of rest below & above b along dim i
+            if (rest.lo[i] < b.lo[i]) {
+                auto slab = rest;
+                slab.hi[i] = b.lo[i] - 1;
+                ret.push_back(slab);
+                rest.lo[i] = b.lo[i];
+            }
+            if (rest.hi[i] > b.hi[i]) {
+                auto slab = rest;
+                slab.lo[i] = b.hi[i] + 1;
+                ret.push_back(slab);
+                rest.hi[i] = b.hi[i];
+            }
+        }
+        return ret;
+    }
 }// namespace OpFlow::DS
 #endif//OPFLOW_BASICELEMENTS_HPP
@@ -13,42 +13,53 @@
 #ifndef OPFLOW_KDTREE_HPP
 #define OPFLOW_KDTREE_HPP
 
+#include "Core/Environment.hpp"
 #include "DataStructures/Geometry/BasicElements.hpp"
+#ifndef OPFLOW_INSIDE_MODULE
+#include <algorithm>
+#include <array>
+#include <tbb/tbb.h>
+#include <vector>
+#endif
 
 OPFLOW_MODULE_EXPORT namespace OpFlow::DS {
+    /// \brief Kd-tree over a point set, stored as flat arrays
+    /// \details The points are reordered in place so that each node's points occupy a contiguous
+    /// range of one buffer, and all nodes live in another buffer in pre-order with children referred
+    /// by index. Leaves hold buckets of up to leaf_size points. Since the node layout only depends on
+    /// the point count, subtrees are built in parallel with nth_element partitioning.
     template <typename PointType, typename BoxType>
     struct KdTree {
         constexpr static auto dim = PointType::dim;
+        constexpr static int leaf_size = 16;
 
         KdTree() = default;
 
-        ~KdTree() {
-            if (root) delete root;
-        }
-
-        explicit KdTree(const std::vector<PointType> &points) { initFromPoints(points); }
+        explicit KdTree(std::vector<PointType> points) { initFromPoints(std::move(points)); }
 
-        explicit KdTree(std::vector<PointType> &points) { initFromPoints(points); }
-
-        void initFromPoints(const std::vector<PointType> &points) {
-            auto copy = points;
-            initFromPoints(copy);
+        void initFromPoints(std::vector<PointType> points) {
+            this->points = std::move(points);
+            nodes.clear();
+            if (this->points.empty()) return;
+            nodes.resize(nodeCount(this->points.size()));
+            tbb::task_arena arena(getGlobalParallelPlan().shared_memory_workers_count);
+            arena.execute([&]() { buildSubtree(0, 0, this->points.size()); });
         }
 
-        void initFromPoints(std::vector<PointType> &points) { root = buildSubtree(points, 0); }
-
-        void traverse(auto &&func) const { traverse_impl(std::forward<decltype(func)>(func), root); }
+        void traverse(auto &&func) const {
+            for (const auto &p : points) func(p);
+        }
 
         void traverseInBox(const BoxType &box, auto &&func) const {
-            traverseInBox_impl(box, std::forward<decltype(func)>(func), root);
+            visitInBox(
+                    box,
+                    [&](const Node &n) {
+                        for (auto i = n.begin; i < n.end; ++i) func(points[i]);
+                    },
+                    [&](const PointType &p) { func(p); });
         }
 
-        auto getPoints() const {
-            std::vector<PointType> ret;
-            ret.reserve(count());
-            traverse([&](auto &&p) { ret.push_back(p); });
-            return ret;
-        }
+        auto getPoints() const { return points; }
 
         auto getPointsInBox(const BoxType &box) const {
             std::vector<PointType> ret;
@@ -56,166 +67,105 @@ OPFLOW_MODULE_EXPORT namespace OpFlow::DS {
             return ret;
         }
 
-        auto count() const { return root ? root->count : 0; }
+        auto count() const { return (int) points.size(); }
 
         auto countInBox(const BoxType &box) const {
             auto ret = 0;
-            countInBox_impl(
-                    box, [&](auto n) { ret += n->count; }, root);
+            visitInBox(
+                    box, [&](const Node &n) { ret += n.end - n.begin; }, [&](const PointType &) { ++ret; });
             return ret;
         }
 
-        auto boundingBox() const { return root ? root->boundingBox : BoxType(); }
+        auto boundingBox() const { return nodes.empty() ? BoxType() : nodes[0].boundingBox; }
 
         auto boundingBoxInBox(const BoxType &box) const {
             BoxType ret;
             int counter = 0;
-            countInBox_impl(
-                    box,
-                    [&](auto n) {
-                        if (counter++ == 0) {
-                            ret = n->boundingBox;
-                        } else {
-                            ret = boxMerge(ret, n->boundingBox);
-                        }
-                    },
-                    root);
+            auto merge = [&](const BoxType &b) {
+                if (counter++ == 0) ret = b;
+                else
+                    ret = boxMerge(ret, b);
+            };
+            visitInBox(
+                    box, [&](const Node &n) { merge(n.boundingBox); },
+                    [&](const PointType &p) { merge(BoxType {p.cord, p.cord}); });
             return ret;
         }
 
     private:
         struct Node {
-            PointType p;
-            int count, dir;
             BoxType boundingBox;
-            Node *lc = nullptr, *rc = nullptr, *pre = nullptr;
-
-            ~Node() {
-                if (lc) delete lc;
-                if (rc) delete rc;
-            }
-
-            auto isLeaf() const { return lc == nullptr && rc == nullptr; }
+            int begin = 0, end = 0;///< Range of the node's points in the point buffer
+            int rc = -1;           ///< Index of the right child. The left child always follows the node
+            [[nodiscard]] auto isLeaf() const { return rc < 0; }
         };
 
-        auto buildSubtree(std::vector<PointType> &points, int level) const {
-            // special case: 0 point
-            if (points.empty()) {
-                return (Node *) nullptr;
-            } else if (points.size() == 1) {
-                auto ret = new Node();
-                ret->p = points[0];
-                ret->count = 1;
-                ret->dir = level % dim;
-                ret->boundingBox.lo = points[0].cord;
-                ret->boundingBox.hi = points[0].cord;
-                return ret;
-            }
-            auto mod_level = level % dim;
-            auto op = [=](const auto &a, const auto &b) { return a[mod_level] < b[mod_level]; };
-            std::stable_sort(points.begin(), points.end(), op);
-            auto median = points.begin() + (points.size() - 1) / 2;
-            auto pt = median, final = median;
-            // special case:
-            //     *   *
-            //         *
-            // the maximum[mod_level] == median[mod_level]. this will cause dead loop
-            if ((*median)[mod_level] == points.back()[mod_level]) {
-                if (points.front()[mod_level] != points.back()[mod_level]) {
-                    // there exists smaller points. use the backward strategy
-                    while (pt != points.begin()) {
-                        if ((*pt)[mod_level] == (*median)[mod_level]) --pt;
-                        else
-                            break;
-                    }
-                    final = pt++;
-                } else {
-                    // all points shares the line. just take pt = end
-                    pt = points.end();
-                    final = pt - 1;
-                }
-            } else {
-                // normal case. use the forward strategy
-                while (pt != points.end()) {
-                    if ((*pt)[mod_level] == (*median)[mod_level]) ++pt;
-                    else
-                        break;
-                }
-                final = pt - 1;
-            }
+        static constexpr int parallel_grain = 4096;
 
-            std::vector<PointType> left(points.begin(), pt), right(pt, points.end());
-            // note: the containing relationship assures that the upper edges of each subzone
-            // are included and the lower edges are not. This means that the left child will
-            // always be valid (at least contains the current split point)
-            auto lc = buildSubtree(left, level + 1);
-            auto rc = buildSubtree(right, level + 1);
-            // merge meta infos from lc & rc
-            auto ret = new Node();
-            ret->p = *final;
-            ret->count = lc->count + (rc ? rc->count : 0);
-            ret->dir = mod_level;
-            ret->lc = lc;
-            ret->rc = rc;
-            ret->lc->pre = ret;
-            if (rc) ret->rc->pre = ret;
-            if (!rc) ret->boundingBox = ret->lc->boundingBox;
-            else
-                ret->boundingBox = boxMerge(ret->lc->boundingBox, ret->rc->boundingBox);
-            return ret;
+        // number of nodes of a subtree with n points
+        static int nodeCount(int n) {
+            if (n <= leaf_size) return 1;
+            return 1 + nodeCount(n / 2) + nodeCount(n - n / 2);
         }
 
-        void traverse_impl(auto &&func, const Node *n) const {
-            if (n) {
-                if (n->isLeaf()) {
-                    func(n->p);
-                    return;
+        void buildSubtree(int idx, int begin, int end) {
+            auto &n = nodes[idx];
+            n.begin = begin;
+            n.end = end;
+            n.boundingBox.lo = n.boundingBox.hi = points[begin].cord;
+            for (auto i = begin + 1; i < end; ++i) {
+                for (auto k = 0; k < dim; ++k) {
+                    n.boundingBox.lo[k] = std::min(n.boundingBox.lo[k], points[i][k]);
+                    n.boundingBox.hi[k] = std::max(n.boundingBox.hi[k], points[i][k]);
                 }
-                traverse_impl(std::forward<decltype(func)>(func), n->lc);
-                traverse_impl(std::forward<decltype(func)>(func), n->rc);
             }
-        }
-
-        void traverseInBox_impl(const BoxType &box, auto &&func, const Node *base) const {
-            if (!base) return;
-            if (base->isLeaf()) {
-                if (pointInBox(base->p, box)) { func(base->p); }
-                return;
+            if (end - begin <= leaf_size) return;
+            // split at the median of the widest dimension
+            auto split_dim = 0;
+            for (auto k = 1; k < dim; ++k)
+                if (n.boundingBox.hi[k] - n.boundingBox.lo[k]
+                    > n.boundingBox.hi[split_dim] - n.boundingBox.lo[split_dim])
+                    split_dim = k;
+            auto mid = begin + (end - begin) / 2;
+            std::nth_element(points.begin() + begin, points.begin() + mid, points.begin() + end,
+                             [&](const auto &a, const auto &b) { return a[split_dim] < b[split_dim]; });
+            auto lc = idx + 1;
+            n.rc = lc + nodeCount(mid - begin);
+            auto rc = n.rc;
+            if (end - begin > parallel_grain) {
+                tbb::parallel_invoke([&] { buildSubtree(lc, begin, mid); },
+                                     [&] { buildSubtree(rc, mid, end); });
             } else {
-                if (boxInBox(base->lc->boundingBox, box))
-                    // report the entire left tree
-                    traverse_impl(std::forward<decltype(func)>(func), base->lc);
-                else if (boxIntersectBox(base->lc->boundingBox, box))
-                    // recurse in left tree
-                    traverseInBox_impl(box, std::forward<decltype(func)>(func), base->lc);
-
-                if (!base->rc) return;
-                if (boxInBox(base->rc->boundingBox, box))
-                    // report the entire right tree
-                    traverse_impl(std::forward<decltype(func)>(func), base->rc);
-                else if (boxIntersectBox(base->rc->boundingBox, box))
-                    // recurse in right tree
-                    traverseInBox_impl(box, std::forward<decltype(func)>(func), base->rc);
+                buildSubtree(lc, begin, mid);
+                buildSubtree(rc, mid, end);
             }
         }
 
-        void countInBox_impl(const BoxType &box, auto &&counter, const Node *base) const {
-            if (!base) return;
-            if (base->isLeaf()) {
-                if (pointInBox(base->p, box)) { counter(base); }
-            } else {
-                if (boxInBox(base->lc->boundingBox, box)) counter(base->lc);
-                else if (boxIntersectBox(base->lc->boundingBox, box))
-                    countInBox_impl(box, std::forward<decltype(counter)>(counter), base->lc);
-
-                if (!base->rc) return;
-                if (boxInBox(base->rc->boundingBox, box)) counter(base->rc);
-                else if (boxIntersectBox(base->rc->boundingBox, box))
-                    countInBox_impl(box, std::forward<decltype(counter)>(counter), base->rc);
+        // visit the nodes entirely inside box & the points in box of partially covered leaves
+        void visitInBox(const BoxType &box, auto &&onNode, auto &&onPoint) const {
+            if (nodes.empty()) return;
+            // the depth is bounded by log2(INT_MAX), so is the stack
+            std::array<int, 64> stack;
+            int top = 0;
+            stack[top++] = 0;
+            while (top > 0) {
+                const auto &n = nodes[stack[--top]];
+                if (boxInBox(n.boundingBox, box)) {
+                    onNode(n);
+                } else if (boxIntersectBox(n.boundingBox, box)) {
+                    if (n.isLeaf()) {
+                        for (auto i = n.begin; i < n.end; ++i)
+                            if (pointInBox(points[i], box)) onPoint(points[i]);
+                    } else {
+                        stack[top++] = n.rc;
+                        stack[top++] = &n - nodes.data() + 1;
+                    }
+                }
             }
         }
 
-        Node *root = nullptr;
+        std::vector<PointType> points;
+        std::vector<Node> nodes;
     };
 }// namespace OpFlow::DS
 #endif//OPFLOW_KDTREE_HPP
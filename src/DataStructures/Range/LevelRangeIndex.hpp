@@ -0,0 +1,153 @@
+//  ----------------------------------------------------------------------------
+//
+//  Copyright (c) 2019 - 2026 by the OpFlow developers
+//
+//  This file is part of OpFlow.
+//
+//  OpFlow is free software and is distributed under the MPL v2.0 license.
+//  The full text of the license can be found in the file LICENSE at the top
+//  level directory of OpFlow.
+//
+//  ----------------------------------------------------------------------------
+
+#ifndef OPFLOW_LEVELRANGEINDEX_HPP
+#define OPFLOW_LEVELRANGEINDEX_HPP
+
+#include "Core/Macros.hpp"
+#include "DataStructures/Range/LevelRanges.hpp"
+#ifndef OPFLOW_INSIDE_MODULE
+#include <algorithm>
+#include <array>
+#include <vector>
+#endif
+
+OPFLOW_MODULE_EXPORT namespace OpFlow::DS {
+    /// \brief Uniform-bin spatial index over the patches (ranges) of one AMR level
+    /// \details Each range is registered in all bins it overlaps. The bin size is chosen from the
+    /// mean patch extent so that a patch touches O(1) bins, which makes building O(P) and each
+    /// overlap query proportional to the number of patches near the queried range.
+    /// \tparam d Dimension
+    template <std::size_t d>
+    struct LevelRangeIndex {
+        LevelRangeIndex() = default;
+        explicit LevelRangeIndex(const std::vector<LevelRange<d>>& ranges) { build(ranges); }
+
+        void build(const std::vector<LevelRange<d>>& ranges) {
+            items = ranges;
+            binOffsets.clear();
+            binItems.clear();
+            if (items.empty()) return;
+            // bounding box & mean extent of all ranges
+            std::array<long long, d> ext_sum;
+            ext_sum.fill(0);
+            origin = items[0].start;
+            std::array<int, d> upper = items[0].end;
+            for (const auto& r : items) {
+                for (auto i = 0; i < d; ++i) {
+                    origin[i] = std::min(origin[i], r.start[i]);
+                    // a range of zero extent still occupies the bin of its start
+                    upper[i] = std::max(upper[i], std::max(r.end[i], r.start[i] + 1));
+                    ext_sum[i] += std::max(r.end[i] - r.start[i], 1);
+                }
+            }
+            for (auto i = 0; i < d; ++i) binSize[i] = std::max<int>(1, ext_sum[i] / items.size());
+            // limit the total bin count to a small multiple of the patch count
+            const long long max_bins = 8 * (long long) items.size() + 1;
+            while (true) {
+                long long total = 1;
+                for (auto i = 0; i < d; ++i) {
+                    binCount[i] = std::max(1, (upper[i] - origin[i] + binSize[i] - 1) / binSize[i]);
+                    total *= binCount[i];
+                }
+                if (total <= max_bins) break;
+                for (auto i = 0; i < d; ++i) binSize[i] *= 2;
+            }
+            // counting sort of (bin, item) pairs into a CSR layout
+            int total_bins = 1;
+            for (auto i = 0; i < d; ++i) total_bins *= binCount[i];
+            binOffsets.assign(total_bins + 1, 0);
+            for (auto k = 0; k < items.size(); ++k)
+                forEachBin(binRangeOf(items[k]), [&](int b) { binOffsets[b + 1]++; });
+            for (auto b = 0; b < total_bins; ++b) binOffsets[b + 1] += binOffsets[b];
+            binItems.resize(binOffsets.back());
+            auto cursor = binOffsets;
+            for (auto k = 0; k < items.size(); ++k)
+                forEachBin(binRangeOf(items[k]), [&](int b) { binItems[cursor[b]++] = k; });
+        }
+
+        /// \brief Visit all indexed ranges intersecting with \p r
+        /// \details Each intersecting range is visited exactly once, in no particular order.
+        /// \param r The queried range, in the same index space as the indexed ranges
+        /// \param func Functor called with the position of each intersecting range
+        void query(const LevelRange<d>& r, auto&& func) const {
+            if (items.empty() || r.empty()) return;
+            auto br = binRangeOf(r);
+            for (auto i = 0; i < d; ++i) {
+                br.first[i] = std::max(br.first[i], 0);
+                br.second[i] = std::min(br.second[i], binCount[i] - 1);
+                if (br.first[i] > br.second[i]) return;
+            }
+            forEachBin(br, [&](int b) {
+                for (auto pos = binOffsets[b]; pos < binOffsets[b + 1]; ++pos) {
+                    auto k = binItems[pos];
+                    if (!intersectRange(items[k], r)) continue;
+                    // only report the item in the bin holding the lower corner of the intersection
+                    std::array<int, d> corner;
+                    for (auto i = 0; i < d; ++i) corner[i] = std::max(items[k].start[i], r.start[i]);
+                    if (binOf(corner) == b) func(k);
+                }
+            });
+        }
+
+        /// \brief Get the sorted positions of all indexed ranges intersecting with \p r
+        auto query(const LevelRange<d>& r) const {
+            std::vector<int> ret;
+            query(r, [&](int k) { ret.push_back(k); });
+            std::sort(ret.begin(), ret.end());
+            return ret;
+        }
+
+        [[nodiscard]] auto size() const { return items.size(); }
+
+    private:
+        using BinRange = std::pair<std::array<int, d>, std::array<int, d>>;
+
+        static int floorDiv(int a, int b) { return a >= 0 ? a / b : -((-a + b - 1) / b); }
+
+        BinRange binRangeOf(const LevelRange<d>& r) const {
+            BinRange ret;
+            for (auto i = 0; i < d; ++i) {
+                ret.first[i] = floorDiv(r.start[i] - origin[i], binSize[i]);
+                ret.second[i] = floorDiv(std::max(r.end[i] - 1, r.start[i]) - origin[i], binSize[i]);
+            }
+            return ret;
+        }
+
+        int binOf(const std::array<int, d>& p) const {
+            int ret = 0;
+            for (int i = d - 1; i >= 0; --i)
+                ret = ret * binCount[i] + std::clamp(floorDiv(p[i] - origin[i], binSize[i]), 0, binCount[i] - 1);
+            return ret;
+        }
+
+        void forEachBin(const BinRange& br, auto&& func) const {
+            std::array<int, d> b = br.first;
+            while (true) {
+                int linear = 0;
+                for (int i = d - 1; i >= 0; --i) linear = linear * binCount[i] + b[i];
+                func(linear);
+                int i = 0;
+                for (; i < d; ++i) {
+                    if (++b[i] <= br.second[i]) break;
+                    b[i] = br.first[i];
+                }
+                if (i == d) break;
+            }
+        }
+
+        std::vector<LevelRange<d>> items;
+        std::array<int, d> origin {}, binSize {}, binCount {};
+        std::vector<int> binOffsets, binItems;
+    };
+}// namespace OpFlow::DS
+#endif//OPFLOW_LEVELRANGEINDEX_HPP
@@ -160,6 +160,26 @@ OPFLOW_MODULE_EXPORT namespace OpFlow::DS {
             return ret;
         }
 
+        /// \brief Get the boundary slabs of \p width without overlapping
+        /// \details Unlike getBCRanges, the edges & corners are only covered by the first slab
+        /// containing them, so that the returned ranges can be processed concurrently.
+        auto getDisjointBCRanges(int width) const {
+            std::vector<LevelRange> ret;
+            auto inner = *this;
+            for (auto i = 0; i < d; ++i) {
+                auto lo = inner, hi = inner;
+                lo.end[i] = lo.start[i] + width;
+                hi.start[i] = hi.end[i] - width;
+                lo.reValidPace();
+                hi.reValidPace();
+                ret.push_back(lo);
+                ret.push_back(hi);
+                inner.start[i] += width;
+                inner.end[i] -= width;
+            }
+            return ret;
+        }
+
         auto getInnerRange(int width) const {
             auto ret = *this;
             for (auto i = 0; i < dim; ++i) {
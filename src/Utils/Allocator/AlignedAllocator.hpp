@@ -13,35 +13,95 @@
 #ifndef OPFLOW_ALIGNEDALLOCATOR_HPP
 #define OPFLOW_ALIGNEDALLOCATOR_HPP
 
+#include "Core/Macros.hpp"
 #include "Core/Meta.hpp"
 #include "Utils/Allocator/AllocatorTrait.hpp"
 #ifndef OPFLOW_INSIDE_MODULE
+#include <algorithm>
+#include <atomic>
 #include <cstdlib>
+#ifdef OPFLOW_HAS_MMAN_H
+#include <sys/mman.h>
+#endif
 #endif
 
 OPFLOW_MODULE_EXPORT namespace OpFlow::Utils {
-    template <typename T, std::size_t align = 64>
+    /// \brief Snapshot of the memory held by an allocator
+    struct AllocationStats {
+        std::size_t live_bytes = 0;///< bytes currently allocated
+        std::size_t peak_bytes = 0;///< maximum of live_bytes since start or the last resetPeak()
+        std::size_t live_count = 0;///< number of live buffers
+    };
+
+    namespace internal {
+        struct AllocationCounter {
+            std::atomic<std::size_t> live {0}, peak {0}, count {0};
+
+            void add(std::size_t bytes) {
+                auto now = live.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+                count.fetch_add(1, std::memory_order_relaxed);
+                auto old = peak.load(std::memory_order_relaxed);
+                while (old < now && !peak.compare_exchange_weak(old, now, std::memory_order_relaxed)) {}
+            }
+
+            void sub(std::size_t bytes) {
+                live.fetch_sub(bytes, std::memory_order_relaxed);
+                count.fetch_sub(1, std::memory_order_relaxed);
+            }
+
+            auto snapshot() const {
+                return AllocationStats {live.load(std::memory_order_relaxed),
+                                        peak.load(std::memory_order_relaxed),
+                                        count.load(std::memory_order_relaxed)};
+            }
+        };
+    }// namespace internal
+
+    /// \brief Allocator returning buffers aligned to \p align bytes
+    /// \details The request is only rounded up to a multiple of the alignment, so the footprint of a
+    /// buffer matches its logical size. With \p huge_pages, buffers larger than a huge page are aligned
+    /// to the huge page size and advised to be backed by transparent huge pages where supported.
+    /// Live & peak bytes are tracked per allocator type.
+    /// \tparam T Element type
+    /// \tparam align Alignment in bytes, a power of 2
+    /// \tparam huge_pages Advise transparent huge pages for large buffers
+    template <typename T, std::size_t align = 64, bool huge_pages = false>
     struct AlignedAllocator {
-        static auto allocate(std::size_t size) {
+        static_assert((align & (align - 1)) == 0 && align >= alignof(T),
+                      "Alignment must be a power of 2 no less than alignof(T)");
+        constexpr static std::size_t huge_page_size = 2 * 1024 * 1024;
+
+        static T* allocate(std::size_t size) {
             if constexpr (Meta::is_numerical_v<T>) {
+                auto bytes = allocationBytes(size);
+                auto alignment = bufferAlignment(bytes);
                 T* raw = reinterpret_cast<T*>(
 #ifdef _MSC_VER
-                        _aligned_malloc(align, std::max<std::size_t>(sizeof(T) * next_pow2(size), align))
+                        _aligned_malloc(bytes, alignment)
 #else
-                        aligned_alloc(align, std::max<std::size_t>(sizeof(T) * next_pow2(size), align))
+                        aligned_alloc(alignment, bytes)
 #endif
                 );
-                assert(raw);
+                if (!raw) {
+                    OP_CRITICAL("Aligned allocation of {} bytes failed", bytes);
+                    OP_ABORT;
+                }
+#if defined(OPFLOW_HAS_MMAN_H) && defined(MADV_HUGEPAGE)
+                if constexpr (huge_pages)
+                    if (alignment == huge_page_size) madvise(raw, bytes, MADV_HUGEPAGE);
+#endif
+                counter.add(bytes);
                 return raw;
             } else {
                 T* raw = new T[size];
-                assert(raw);
+                counter.add(allocationBytes(size));
                 return raw;
             }
         }
 
-        static void deallocate(T* ptr, std::size_t) {
+        static void deallocate(T* ptr, std::size_t size) {
             if (!ptr) return;
+            counter.sub(allocationBytes(size));
             if constexpr (Meta::is_numerical_v<T>)
 #ifdef _MSC_VER
                 _aligned_free(ptr);
@@ -52,25 +112,41 @@ OPFLOW_MODULE_EXPORT namespace OpFlow::Utils {
                 delete[] ptr;
         }
 
+        /// \brief Bytes reserved for a buffer of \p size elements
+        constexpr static std::size_t allocationBytes(std::size_t size) {
+            if constexpr (Meta::is_numerical_v<T>) {
+                auto alignment = bufferAlignment(sizeof(T) * size);
+                return std::max(alignment, (sizeof(T) * size + alignment - 1) / alignment * alignment);
+            } else
+                return sizeof(T) * size;
+        }
+
+        static AllocationStats getStats() { return counter.snapshot(); }
+        static void resetPeak() { counter.peak.store(counter.live.load()); }
+
     private:
-        OPFLOW_STRONG_INLINE constexpr static auto next_pow2(unsigned long long x) {
-            x--;
-            x |= x >> 1;
-            x |= x >> 2;
-            x |= x >> 4;
-            x |= x >> 8;
-            x |= x >> 16;
-            x |= x >> 32;
-            x++;
-            return x;
+        constexpr static std::size_t bufferAlignment(std::size_t bytes) {
+            if constexpr (huge_pages) return bytes >= huge_page_size ? huge_page_size : align;
+            else
+                return align;
         }
+
+        static inline internal::AllocationCounter counter;
     };
 
+    /// \brief Page aligned allocator
+    template <typename T>
+    using PageAlignedAllocator = AlignedAllocator<T, 4096>;
+
+    /// \brief Page aligned allocator backing large buffers with transparent huge pages
+    template <typename T>
+    using HugePageAllocator = AlignedAllocator<T, 4096, true>;
+
     namespace internal {
-        template <typename T, std::size_t align>
-        struct AllocatorTrait<AlignedAllocator<T, align>> {
+        template <typename T, std::size_t align, bool huge_pages>
+        struct AllocatorTrait<AlignedAllocator<T, align, huge_pages>> {
             template <typename U>
-            using other_type = AlignedAllocator<U, align>;
+            using other_type = AlignedAllocator<U, align, huge_pages>;
         };
     }// namespace internal
 }// namespace OpFlow::Utils
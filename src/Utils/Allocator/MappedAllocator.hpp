@@ -0,0 +1,122 @@
+//  ----------------------------------------------------------------------------
+//
+//  Copyright (c) 2019 - 2026 by the OpFlow developers
+//
+//  This file is part of OpFlow.
+//
+//  OpFlow is free software and is distributed under the MPL v2.0 license.
+//  The full text of the license can be found in the file LICENSE at the top
+//  level directory of OpFlow.
+//
+//  ----------------------------------------------------------------------------
+
+#ifndef OPFLOW_MAPPEDALLOCATOR_HPP
+#define OPFLOW_MAPPEDALLOCATOR_HPP
+
+#include "Core/Macros.hpp"
+#include "Utils/Allocator/AlignedAllocator.hpp"
+#include "Utils/Allocator/AllocatorTrait.hpp"
+#ifdef OPFLOW_HAS_MMAN_H
+#ifndef OPFLOW_INSIDE_MODULE
+#include <mutex>
+#include <sys/mman.h>
+#include <unordered_map>
+#endif
+#endif
+
+OPFLOW_MODULE_EXPORT namespace OpFlow::Utils {
+#ifdef OPFLOW_HAS_MMAN_H
+    namespace internal {
+        struct MappedRegion {
+            void* base = nullptr;
+            std::size_t length = 0;
+        };
+        // all live buffers adopted from mapped files, keyed by the buffer's address
+        inline std::mutex mapped_regions_mutex;
+        inline std::unordered_map<const void*, MappedRegion> mapped_regions;
+    }// namespace internal
+
+    /// \brief Allocator able to adopt memory mapped file pages as the allocated buffer
+    /// \details A reader stages a mapped region with stage(); the next allocate() of the same size on
+    /// the same thread returns the mapped buffer instead of fresh memory, and deallocate() unmaps it.
+    /// Buffers not coming from a mapping are served by AlignedAllocator.
+    template <typename T, std::size_t align = 64>
+    struct MappedAllocator {
+        static T* allocate(std::size_t size) {
+            if (staged.ptr && staged.size == size) {
+                auto ptr = staged.ptr;
+                {
+                    std::lock_guard lock(internal::mapped_regions_mutex);
+                    internal::mapped_regions[ptr] = staged.region;
+                }
+                staged = Staged {};
+                return ptr;
+            }
+            return AlignedAllocator<T, align>::allocate(size);
+        }
+
+        static void deallocate(T* ptr, std::size_t size) {
+            if (!ptr) return;
+            internal::MappedRegion region;
+            {
+                std::lock_guard lock(internal::mapped_regions_mutex);
+                auto iter = internal::mapped_regions.find(ptr);
+                if (iter != internal::mapped_regions.end()) {
+                    region = iter->second;
+                    internal::mapped_regions.erase(iter);
+                }
+            }
+            if (region.base) {
+                if (munmap(region.base, region.length) == -1)
+                    OP_CRITICAL("munmap failed for ptr = {:#x} size = {}", (std::size_t) region.base,
+                                region.length);
+            } else {
+                AlignedAllocator<T, align>::deallocate(ptr, size);
+            }
+        }
+
+        /// \brief Stage a mapped buffer for the next allocation of \p size elements on this thread
+        /// \param ptr The buffer inside the mapping
+        /// \param size Number of elements of the buffer
+        /// \param base Base address of the mapping
+        /// \param length Length in bytes of the mapping
+        static void stage(T* ptr, std::size_t size, void* base, std::size_t length) {
+            staged = Staged {ptr, size, {base, length}};
+        }
+
+        /// \brief Whether the next allocate() of \p size elements on this thread adopts the staged buffer
+        static bool isStaged(std::size_t size) { return staged.ptr && staged.size == size; }
+
+        /// \brief Drop the staged buffer
+        /// \return True if the staged buffer has been adopted by an allocation. Otherwise the
+        /// mapping is still owned by the caller.
+        static bool unstage() {
+            auto adopted = staged.ptr == nullptr;
+            staged = Staged {};
+            return adopted;
+        }
+
+        static bool isMapped(const T* ptr) {
+            std::lock_guard lock(internal::mapped_regions_mutex);
+            return internal::mapped_regions.contains(ptr);
+        }
+
+    private:
+        struct Staged {
+            T* ptr = nullptr;
+            std::size_t size = 0;
+            internal::MappedRegion region;
+        };
+        static inline thread_local Staged staged;
+    };
+
+    namespace internal {
+        template <typename T, std::size_t align>
+        struct AllocatorTrait<MappedAllocator<T, align>> {
+            template <typename U>
+            using other_type = MappedAllocator<U, align>;
+        };
+    }// namespace internal
+#endif
+}// namespace OpFlow::Utils
+#endif//OPFLOW_MAPPEDALLOCATOR_HPP
@@ -0,0 +1,132 @@
+// ----------------------------------------------------------------------------
+//
+// Copyright (c) 2019 - 2026 by the OpFlow developers
+//
+// This file is part of OpFlow.
+//
+// OpFlow is free software and is distributed under the MPL v2.0 license.
+// The full text of the license can be found in the file LICENSE at the top
+// level directory of OpFlow.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef OPFLOW_SCRATCHPOOL_HPP
+#define OPFLOW_SCRATCHPOOL_HPP
+
+#ifndef OPFLOW_INSIDE_MODULE
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#endif
+
+OPFLOW_MODULE_EXPORT namespace OpFlow::Utils {
+    /// \brief Snapshot of the activity of all scratch pools
+    struct ScratchPoolStats {
+        std::size_t hits = 0;          ///< borrows served by an idle buffer
+        std::size_t misses = 0;        ///< borrows that had to allocate a new buffer
+        std::size_t borrowed_bytes = 0;///< bytes currently lent out
+        std::size_t idle_bytes = 0;    ///< bytes held by the pools for reuse
+    };
+
+    namespace internal {
+        struct ScratchPoolCounter {
+            std::atomic<std::size_t> hits {0}, misses {0}, borrowed {0}, idle {0};
+        };
+        inline ScratchPoolCounter scratch_pool_counter;
+        inline thread_local int scratch_scope_depth = 0;
+    }// namespace internal
+
+    /// \brief Pool of buffers for temporaries
+    /// \details Buffers are binned by their exact element count, i.e., by the extents of the tensors
+    /// they back. A released buffer is kept idle until a borrow of the same size class takes it, so a
+    /// time loop creating the same temporaries every step stops allocating after its first step.
+    /// \tparam T Element type
+    /// \tparam Allocator The static allocator serving misses & freeing trimmed buffers
+    template <typename T, typename Allocator>
+    struct ScratchPool {
+        static T* acquire(std::size_t size) {
+            auto& s = store();
+            {
+                std::lock_guard lock(s.mutex);
+                auto it = s.idle.find(size);
+                if (it != s.idle.end() && !it->second.empty()) {
+                    auto ptr = it->second.back();
+                    it->second.pop_back();
+                    internal::scratch_pool_counter.hits.fetch_add(1, std::memory_order_relaxed);
+                    internal::scratch_pool_counter.idle.fetch_sub(bytes(size), std::memory_order_relaxed);
+                    internal::scratch_pool_counter.borrowed.fetch_add(bytes(size), std::memory_order_relaxed);
+                    return ptr;
+                }
+            }
+            internal::scratch_pool_counter.misses.fetch_add(1, std::memory_order_relaxed);
+            internal::scratch_pool_counter.borrowed.fetch_add(bytes(size), std::memory_order_relaxed);
+            return Allocator::allocate(size);
+        }
+
+        static void release(T* ptr, std::size_t size) {
+            if (!ptr) return;
+            auto& s = store();
+            std::lock_guard lock(s.mutex);
+            s.idle[size].push_back(ptr);
+            internal::scratch_pool_counter.borrowed.fetch_sub(bytes(size), std::memory_order_relaxed);
+            internal::scratch_pool_counter.idle.fetch_add(bytes(size), std::memory_order_relaxed);
+        }
+
+        /// \brief Free all idle buffers of this pool
+        static void trim() { store().clear(); }
+
+    private:
+        static std::size_t bytes(std::size_t size) { return size * sizeof(T); }
+
+        struct Store {
+            std::mutex mutex;
+            std::unordered_map<std::size_t, std::vector<T*>> idle;
+
+            void clear() {
+                std::lock_guard lock(mutex);
+                for (auto& [size, buffers] : idle) {
+                    for (auto ptr : buffers) Allocator::deallocate(ptr, size);
+                    internal::scratch_pool_counter.idle.fetch_sub(bytes(size) * buffers.size(),
+                                                                  std::memory_order_relaxed);
+                }
+                idle.clear();
+            }
+
+            ~Store() { clear(); }
+        };
+
+        static Store& store() {
+            static Store s;
+            return s;
+        }
+    };
+
+    /// \brief Mark the tensors allocated on this thread during its lifetime as temporaries
+    /// \details Tensors allocated inside a scope borrow their buffers from the ScratchPool of their
+    /// allocator & return them to it when they are freed, even after the scope is left.
+    struct ScratchScope {
+        ScratchScope() { ++internal::scratch_scope_depth; }
+        ~ScratchScope() { --internal::scratch_scope_depth; }
+        ScratchScope(const ScratchScope&) = delete;
+        ScratchScope& operator=(const ScratchScope&) = delete;
+
+        static bool active() { return internal::scratch_scope_depth > 0; }
+    };
+
+    /// \brief Copy of \p f whose storage is borrowed from the scratch pools
+    template <typename F>
+    auto scratchCopy(const F& f) {
+        ScratchScope scope;
+        return F(f);
+    }
+
+    inline auto getScratchPoolStats() {
+        auto& c = internal::scratch_pool_counter;
+        return ScratchPoolStats {c.hits.load(std::memory_order_relaxed),
+                                 c.misses.load(std::memory_order_relaxed),
+                                 c.borrowed.load(std::memory_order_relaxed),
+                                 c.idle.load(std::memory_order_relaxed)};
+    }
+}// namespace OpFlow::Utils
+#endif//OPFLOW_SCRATCHPOOL_HPP
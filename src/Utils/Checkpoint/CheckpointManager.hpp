@@ -0,0 +1,777 @@
+//  ----------------------------------------------------------------------------
+//
+//  Copyright (c) 2019 - 2026 by the OpFlow developers
+//
+//  This file is part of OpFlow.
+//
+//  OpFlow is free software and is distributed under the MPL v2.0 license.
+//  The full text of the license can be found in the file LICENSE at the top
+//  level directory of OpFlow.
+//
+//  ----------------------------------------------------------------------------
+
+#ifndef OPFLOW_CHECKPOINTMANAGER_HPP
+#define OPFLOW_CHECKPOINTMANAGER_HPP
+
+#include "Core/BC/DircBC.hpp"
+#include "Core/BC/NeumBC.hpp"
+#include "Core/Environment.hpp"
+#include "Core/Field/MeshBased/SemiStructured/CartAMRField.hpp"
+#include "Core/Field/MeshBased/Structured/CartesianField.hpp"
+#include "Core/Mesh/SemiStructured/CartesianAMRMesh.hpp"
+#include "Utils/Writers/Streams.hpp"
+#include "Utils/xxHash.hpp"
+#include <format>
+#ifndef OPFLOW_INSIDE_MODULE
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <tbb/tbb.h>
+#include <utility>
+#include <vector>
+#endif
+
+OPFLOW_MODULE_EXPORT namespace OpFlow::Utils {
+    /// \brief Data file layout of a checkpoint
+    enum class CheckpointIO {
+        FilePerRank,///< Each rank writes its blocks to its own data file
+        Aggregated  ///< All ranks write their blocks to one shared data file
+    };
+
+    namespace internal {
+        /// \brief Append-only byte buffer for checkpoint records
+        struct CheckpointWriter {
+            std::vector<std::byte> bytes;
+
+            template <typename T>
+            void put(const T& v) {
+                static_assert(std::is_trivially_copyable_v<T>);
+                auto* p = reinterpret_cast<const std::byte*>(&v);
+                bytes.insert(bytes.end(), p, p + sizeof(T));
+            }
+            void put(const std::string& s) {
+                put(std::uint64_t(s.size()));
+                auto* p = reinterpret_cast<const std::byte*>(s.data());
+                bytes.insert(bytes.end(), p, p + s.size());
+            }
+            void put(const std::vector<std::byte>& v) {
+                put(std::uint64_t(v.size()));
+                bytes.insert(bytes.end(), v.begin(), v.end());
+            }
+        };
+
+        /// \brief Bounds checked cursor over a checkpoint record
+        struct CheckpointReader {
+            const std::byte *cursor, *end;
+
+            explicit CheckpointReader(const std::vector<std::byte>& v)
+                : cursor(v.data()), end(v.data() + v.size()) {}
+
+            template <typename T>
+            void take(T& v) {
+                static_assert(std::is_trivially_copyable_v<T>);
+                OP_ASSERT_MSG(cursor + sizeof(T) <= end, "Checkpoint read error: Unexpected end of record");
+                std::memcpy(&v, cursor, sizeof(T));
+                cursor += sizeof(T);
+            }
+            void take(std::string& s) {
+                std::uint64_t n;
+                take(n);
+                OP_ASSERT_MSG(n <= std::uint64_t(end - cursor),
+                              "Checkpoint read error: Unexpected end of record");
+                s.assign(reinterpret_cast<const char*>(cursor), n);
+                cursor += n;
+            }
+            void take(std::vector<std::byte>& v) {
+                std::uint64_t n;
+                take(n);
+                OP_ASSERT_MSG(n <= std::uint64_t(end - cursor),
+                              "Checkpoint read error: Unexpected end of record");
+                v.assign(cursor, cursor + n);
+                cursor += n;
+            }
+            template <typename T>
+            T take() {
+                T v;
+                take(v);
+                return v;
+            }
+            [[nodiscard]] bool empty() const { return cursor == end; }
+        };
+
+        /// \brief A block of checkpoint data, the unit of incremental checkpoints
+        struct CheckpointBlock {
+            std::int64_t id = 0;           ///< Block id, unique within the entry on a rank
+            std::vector<std::byte> header; ///< Small metadata, e.g. the covered index range
+            std::vector<std::byte> data;   ///< Payload
+        };
+
+        /// \brief Index record of a saved block
+        struct CheckpointBlockRecord {
+            std::string entry;
+            std::int64_t id = 0;
+            std::vector<std::byte> header;
+            std::uint64_t hash = 0, size = 0, offset = 0;
+            int rank = 0; ///< The rank saved the block
+            int ckpt = 0; ///< The checkpoint holding the payload
+            int file = 0; ///< Data file of the payload; the rank for FilePerRank, -1 for Aggregated
+        };
+
+        using CheckpointRecords = std::vector<const CheckpointBlockRecord*>;
+        using CheckpointFetcher = std::function<std::vector<std::byte>(const CheckpointBlockRecord&)>;
+
+        /// \brief Interface of objects registered to a CheckpointManager
+        struct CheckpointEntryBase {
+            explicit CheckpointEntryBase(std::string name) : name(std::move(name)) {}
+            virtual ~CheckpointEntryBase() = default;
+            /// \brief Append the blocks of this rank
+            virtual void save(std::vector<CheckpointBlock>& blocks) const = 0;
+            /// \brief Restore from the blocks of all ranks of the checkpoint
+            /// \param records Records of the entry's blocks
+            /// \param fetch Functor reading the payload of a record
+            /// \param nproc Rank count of the checkpoint
+            virtual void load(const CheckpointRecords& records, const CheckpointFetcher& fetch, int nproc)
+                    = 0;
+            std::string name;
+        };
+
+        // constant BCs carry their value; other BCs are recorded by type & checked on restore
+        template <typename F>
+        void saveBCs(const F& f, CheckpointWriter& w) {
+            constexpr auto dim = OpFlow::internal::FieldExprTrait<F>::dim;
+            using elem_type = typename OpFlow::internal::FieldExprTrait<F>::elem_type;
+            for (auto i = 0; i < dim; ++i)
+                for (const auto* bc : {f.bc[i].start.get(), f.bc[i].end.get()}) {
+                    w.put(bc ? bc->getTypeName() : std::string());
+                    auto has_value = bc && (bc->getTypeName() == "ConstDircBC"
+                                            || bc->getTypeName() == "ConstNeumBC");
+                    w.put(std::uint8_t(has_value));
+                    if (has_value)
+                        w.put(bc->evalAt(typename OpFlow::internal::FieldExprTrait<F>::index_type()));
+                    else
+                        w.put(elem_type());
+                }
+        }
+
+        template <typename F>
+        void loadBCs(F& f, CheckpointReader& r) {
+            constexpr auto dim = OpFlow::internal::FieldExprTrait<F>::dim;
+            using elem_type = typename OpFlow::internal::FieldExprTrait<F>::elem_type;
+            for (auto i = 0; i < dim; ++i)
+                for (auto* bc : {f.bc[i].start.get(), f.bc[i].end.get()}) {
+                    auto type = r.take<std::string>();
+                    auto has_value = r.take<std::uint8_t>();
+                    auto value = r.take<elem_type>();
+                    OP_EXPECT_MSG(type == (bc ? bc->getTypeName() : std::string()),
+                                  "Checkpoint: BC type of field {} mismatch {} != {}", f.getName(), type,
+                                  bc ? bc->getTypeName() : std::string());
+                    if (has_value && bc && bc->getTypeName() == type) *bc = ConstDircBC<F>(value);
+                }
+        }
+
+        template <typename Dim>
+        void saveAMRMesh(const CartesianAMRMesh<Dim>& m, CheckpointWriter& w) {
+            constexpr auto dim = Dim::value;
+            w.put(m.refinementRatio);
+            w.put(m.buffWidth);
+            w.put(m.maxLevel);
+            w.put(m.slimThreshold);
+            w.put(m.fillRateThreshold);
+            const auto& base = m.meshes[0];
+            auto range = base.getRange();
+            for (auto i = 0; i < dim; ++i) {
+                w.put(range.start[i]);
+                w.put(range.end[i]);
+                for (auto j = range.start[i]; j < range.end[i]; ++j) w.put(double(base.x(i, j)));
+            }
+            w.put(std::uint64_t(m.ranges.size()));
+            for (const auto& level : m.ranges) {
+                w.put(std::uint64_t(level.size()));
+                for (const auto& r : level) {
+                    w.put(r.start);
+                    w.put(r.end);
+                    w.put(r.stride);
+                    w.put(r.level);
+                    w.put(r.part);
+                }
+            }
+        }
+
+        // the base mesh of m must be the one saved; the finer levels are rebuilt from it
+        template <typename Dim>
+        void loadAMRMesh(CartesianAMRMesh<Dim>& m, CheckpointReader& r) {
+            constexpr auto dim = Dim::value;
+            r.take(m.refinementRatio);
+            r.take(m.buffWidth);
+            r.take(m.maxLevel);
+            r.take(m.slimThreshold);
+            r.take(m.fillRateThreshold);
+            OP_ASSERT_MSG(!m.meshes.empty(), "Checkpoint: AMR mesh to restore has no base mesh");
+            auto base = m.meshes[0];
+            auto range = base.getRange();
+            for (auto i = 0; i < dim; ++i) {
+                auto start = r.take<int>(), end = r.take<int>();
+                OP_ASSERT_MSG(start == range.start[i] && end == range.end[i],
+                              "Checkpoint: AMR base mesh range mismatch in dim {}", i);
+                for (auto j = range.start[i]; j < range.end[i]; ++j) {
+                    auto x = r.take<double>();
+                    OP_ASSERT_MSG(x == base.x(i, j), "Checkpoint: AMR base mesh coordinate mismatch {} != {}",
+                                  x, base.x(i, j));
+                }
+            }
+            auto levels = r.take<std::uint64_t>();
+            m.meshes.assign(levels, CartesianMesh<Dim>());
+            m.meshes[0] = base;
+            m.ranges.assign(levels, {});
+            for (auto l = 0; l < levels; ++l) {
+                m.ranges[l].resize(r.take<std::uint64_t>());
+                for (auto& lr : m.ranges[l]) {
+                    r.take(lr.start);
+                    r.take(lr.end);
+                    r.take(lr.stride);
+                    r.take(lr.level);
+                    r.take(lr.part);
+                    lr.reValidPace();
+                }
+                if (l > 0 && !m.ranges[l].empty())
+                    m.meshes[l] = MeshBuilder<CartesianMesh<Dim>>()
+                                          .newMesh(base)
+                                          .refine(Math::int_pow(m.refinementRatio, l))
+                                          .build();
+            }
+            m.markers.clear();
+            m.buildRelations();
+        }
+
+        /// \brief Checkpoint entry of a CartesianField
+        /// \details The local range is saved as slabs along the slowest dim, each a block tagged with
+        /// its global index range. On restore, every rank copies the parts of all saved slabs
+        /// intersecting its local range, so the field can be restarted on any rank count.
+        template <CartesianFieldType F>
+        struct CartesianFieldCheckpoint : CheckpointEntryBase {
+            using elem_type = typename OpFlow::internal::CartesianFieldExprTrait<F>::elem_type;
+            static constexpr auto dim = OpFlow::internal::CartesianFieldExprTrait<F>::dim;
+            static constexpr std::size_t slab_bytes = 1 << 20;
+
+            explicit CartesianFieldCheckpoint(F& f) : CheckpointEntryBase(f.getName()), f(f) {}
+
+            void save(std::vector<CheckpointBlock>& blocks) const override {
+                CheckpointWriter bcs;
+                saveBCs(f, bcs);
+                blocks.push_back({0, {}, std::move(bcs.bytes)});
+                auto range = f.localRange;
+                if (range.count() <= 0) return;
+                auto plane = range.count() / (range.end[dim - 1] - range.start[dim - 1]);
+                int thickness = std::max<std::size_t>(1, slab_bytes / sizeof(elem_type) / plane);
+                std::vector<DS::Range<dim>> slabs;
+                for (auto s = range.start[dim - 1]; s < range.end[dim - 1]; s += thickness) {
+                    auto r = range;
+                    r.start[dim - 1] = s;
+                    r.end[dim - 1] = std::min(s + thickness, range.end[dim - 1]);
+                    r.reValidPace();
+                    slabs.push_back(r);
+                }
+                auto first = blocks.size();
+                blocks.resize(first + slabs.size());
+                tbb::task_arena arena(getGlobalParallelPlan().shared_memory_workers_count);
+                arena.execute([&]() {
+                    tbb::parallel_for(std::size_t(0), slabs.size(), [&](std::size_t s) {
+                        auto& b = blocks[first + s];
+                        b.id = s + 1;
+                        CheckpointWriter h;
+                        h.put(slabs[s].start);
+                        h.put(slabs[s].end);
+                        b.header = std::move(h.bytes);
+                        b.data.resize(slabs[s].count() * sizeof(elem_type));
+                        auto* ptr = reinterpret_cast<elem_type*>(b.data.data());
+                        rangeFor_s(slabs[s], [&](auto&& i) { *ptr++ = f[i]; });
+                    });
+                });
+            }
+
+            void load(const CheckpointRecords& records, const CheckpointFetcher& fetch, int) override {
+                std::vector<const CheckpointBlockRecord*> slabs;
+                for (const auto* rec : records) {
+                    if (rec->id == 0) {
+                        auto bytes = fetch(*rec);
+                        CheckpointReader r(bytes);
+                        loadBCs(f, r);
+                    } else {
+                        slabs.push_back(rec);
+                    }
+                }
+                f.detachStorage();
+                tbb::task_arena arena(getGlobalParallelPlan().shared_memory_workers_count);
+                arena.execute([&]() {
+                    tbb::parallel_for(std::size_t(0), slabs.size(), [&](std::size_t s) {
+                        CheckpointReader h(slabs[s]->header);
+                        DS::Range<dim> slab;
+                        h.take(slab.start);
+                        h.take(slab.end);
+                        slab.stride.fill(1);
+                        slab.reValidPace();
+                        auto common = DS::commonRange(slab, f.localRange);
+                        if (common.count() <= 0) return;
+                        auto bytes = fetch(*slabs[s]);
+                        OP_ASSERT_MSG(bytes.size() == slab.count() * sizeof(elem_type),
+                                      "Checkpoint: Block size of field {} mismatch", name);
+                        const auto* ptr = reinterpret_cast<const elem_type*>(bytes.data());
+                        rangeFor_s(common, [&](auto&& i) {
+                            std::size_t k = 0, stride = 1;
+                            for (auto d = 0; d < dim; ++d) {
+                                k += (i[d] - slab.start[d]) * stride;
+                                stride *= slab.end[d] - slab.start[d];
+                            }
+                            f[i] = ptr[k];
+                        });
+                    });
+                });
+                f.updatePadding();
+            }
+
+            F& f;
+        };
+
+        /// \brief Checkpoint entry of a CartAMRField, saved together with its patch hierarchy
+        /// \details AMR fields are replicated on all ranks, so the master rank saves them. On restore,
+        /// the field's mesh is rebuilt from the saved hierarchy on top of its current base mesh.
+        template <CartAMRFieldType F>
+        struct CartAMRFieldCheckpoint : CheckpointEntryBase {
+            using elem_type = typename OpFlow::internal::CartAMRFieldExprTrait<F>::elem_type;
+
+            explicit CartAMRFieldCheckpoint(F& f) : CheckpointEntryBase(f.getName()), f(f) {}
+
+            void save(std::vector<CheckpointBlock>& blocks) const override {
+                if (getWorkerId() != 0) return;
+                CheckpointWriter meta;
+                saveBCs(f, meta);
+                saveAMRMesh(f.mesh, meta);
+                blocks.push_back({0, {}, std::move(meta.bytes)});
+                std::vector<std::pair<int, int>> patches;
+                for (auto l = 0; l < f.localRanges.size(); ++l)
+                    for (auto p = 0; p < f.localRanges[l].size(); ++p) patches.emplace_back(l, p);
+                auto first = blocks.size();
+                blocks.resize(first + patches.size());
+                tbb::task_arena arena(getGlobalParallelPlan().shared_memory_workers_count);
+                arena.execute([&]() {
+                    tbb::parallel_for(std::size_t(0), patches.size(), [&](std::size_t k) {
+                        auto [l, p] = patches[k];
+                        auto& b = blocks[first + k];
+                        b.id = k + 1;
+                        CheckpointWriter h;
+                        h.put(l);
+                        h.put(p);
+                        b.header = std::move(h.bytes);
+                        b.data.resize(f.localRanges[l][p].count() * sizeof(elem_type));
+                        auto* ptr = reinterpret_cast<elem_type*>(b.data.data());
+                        rangeFor_s(f.localRanges[l][p], [&](auto&& i) { *ptr++ = f[i]; });
+                    });
+                });
+            }
+
+            void load(const CheckpointRecords& records, const CheckpointFetcher& fetch, int) override {
+                auto meta = std::find_if(records.begin(), records.end(), [](auto* r) { return r->id == 0; });
+                OP_ASSERT_MSG(meta != records.end(), "Checkpoint: Hierarchy of AMR field {} not found", name);
+                auto bytes = fetch(**meta);
+                CheckpointReader r(bytes);
+                loadBCs(f, r);
+                auto mesh = f.mesh;
+                loadAMRMesh(mesh, r);
+                f.replaceMeshBy(mesh);
+                std::vector<const CheckpointBlockRecord*> patches;
+                for (const auto* rec : records)
+                    if (rec->id != 0) patches.push_back(rec);
+                f.detachStorage();
+                tbb::task_arena arena(getGlobalParallelPlan().shared_memory_workers_count);
+                arena.execute([&]() {
+                    tbb::parallel_for(std::size_t(0), patches.size(), [&](std::size_t k) {
+                        CheckpointReader h(patches[k]->header);
+                        auto l = h.take<int>(), p = h.take<int>();
+                        OP_ASSERT_MSG(l < f.localRanges.size() && p < f.localRanges[l].size(),
+                                      "Checkpoint: Patch ({}, {}) of AMR field {} not found", l, p, name);
+                        auto data = fetch(*patches[k]);
+                        OP_ASSERT_MSG(data.size() == f.localRanges[l][p].count() * sizeof(elem_type),
+                                      "Checkpoint: Block size of field {} mismatch", name);
+                        const auto* ptr = reinterpret_cast<const elem_type*>(data.data());
+                        rangeFor_s(f.localRanges[l][p], [&](auto&& i) { f[i] = *ptr++; });
+                    });
+                });
+                f.updatePadding();
+            }
+
+            F& f;
+        };
+
+        /// \brief Checkpoint entry of a CartesianAMRMesh's patch hierarchy
+        template <typename Dim>
+        struct AMRMeshCheckpoint : CheckpointEntryBase {
+            AMRMeshCheckpoint(std::string name, CartesianAMRMesh<Dim>& m)
+                : CheckpointEntryBase(std::move(name)), m(m) {}
+
+            void save(std::vector<CheckpointBlock>& blocks) const override {
+                if (getWorkerId() != 0) return;
+                CheckpointWriter w;
+                saveAMRMesh(m, w);
+                blocks.push_back({0, {}, std::move(w.bytes)});
+            }
+
+            void load(const CheckpointRecords& records, const CheckpointFetcher& fetch, int) override {
+                OP_ASSERT_MSG(records.size() == 1, "Checkpoint: Hierarchy of AMR mesh {} not found", name);
+                auto bytes = fetch(*records[0]);
+                CheckpointReader r(bytes);
+                loadAMRMesh(m, r);
+            }
+
+            CartesianAMRMesh<Dim>& m;
+        };
+
+        /// \brief Checkpoint entry of per rank raw data, e.g. a solver's initial guess
+        /// \details The data is partitioned by rank & can't be redistributed. It's left untouched
+        /// when restarting on a different rank count.
+        template <typename T>
+        struct VectorCheckpoint : CheckpointEntryBase {
+            VectorCheckpoint(std::string name, std::vector<T>& v)
+                : CheckpointEntryBase(std::move(name)), v(v) {}
+
+            void save(std::vector<CheckpointBlock>& blocks) const override {
+                auto* p = reinterpret_cast<const std::byte*>(v.data());
+                blocks.push_back({0, {}, std::vector<std::byte>(p, p + v.size() * sizeof(T))});
+            }
+
+            void load(const CheckpointRecords& records, const CheckpointFetcher& fetch, int nproc) override {
+                if (nproc != getWorkerCount()) {
+                    OP_WARN("Checkpoint: {} is saved with {} ranks and is not restored on {} ranks", name,
+                            nproc, getWorkerCount());
+                    return;
+                }
+                for (const auto* rec : records) {
+                    if (rec->rank != getWorkerId()) continue;
+                    auto bytes = fetch(*rec);
+                    v.resize(bytes.size() / sizeof(T));
+                    std::memcpy(v.data(), bytes.data(), v.size() * sizeof(T));
+                }
+            }
+
+            std::vector<T>& v;
+        };
+    }// namespace internal
+
+    /// \brief Checkpoint & restart of registered fields, meshes & raw solver data
+    /// \details Checkpoint n is the directory {root}/ckpt_{n}:
+    /// - data_{rank}.bin (FilePerRank) or data.bin (Aggregated): the payloads of the blocks
+    /// - index_{rank}.bin: the records of the blocks saved by each rank
+    /// - meta.bin: time stamp, rank count & layout. It's written by the master rank after all ranks
+    ///   finished, so a checkpoint without it is incomplete & ignored.
+    /// In incremental mode, the blocks are hashed with xxHash64 & a block equal to the one of the last
+    /// checkpoint is not written again; its record refers to the payload in the older checkpoint, which
+    /// thus must be kept as long as newer ones refer to it.
+    /// \note Objects are restored by name, so the names of the registered objects must be unique.
+    /// Meshes & fields must be set up as when they were saved, except that Cartesian fields may be
+    /// split over a different number of ranks.
+    struct CheckpointManager {
+        explicit CheckpointManager(std::filesystem::path root) : root(std::move(root)) {}
+
+        void setIOMode(CheckpointIO m) { io = m; }
+        void setIncremental(bool o) { incremental = o; }
+
+        template <CartesianFieldType F>
+        CheckpointManager& add(F& f) {
+            return add(std::make_unique<internal::CartesianFieldCheckpoint<F>>(f));
+        }
+
+        template <CartAMRFieldType F>
+        CheckpointManager& add(F& f) {
+            return add(std::make_unique<internal::CartAMRFieldCheckpoint<F>>(f));
+        }
+
+        template <typename Dim>
+        CheckpointManager& add(const std::string& name, CartesianAMRMesh<Dim>& m) {
+            return add(std::make_unique<internal::AMRMeshCheckpoint<Dim>>(name, m));
+        }
+
+        template <typename T>
+        CheckpointManager& add(const std::string& name, std::vector<T>& v) {
+            static_assert(std::is_trivially_copyable_v<T>);
+            return add(std::make_unique<internal::VectorCheckpoint<T>>(name, v));
+        }
+
+        /// \brief Save a checkpoint of all registered objects
+        /// \return The id of the checkpoint
+        int save(const TimeStamp& t);
+
+        /// \brief Restore all registered objects from checkpoint \p id, or the latest one if negative
+        /// \return The time stamp of the checkpoint
+        TimeStamp restore(int id = -1);
+
+        /// \brief The id of the latest complete checkpoint, or -1 if there is none
+        [[nodiscard]] int latest() const {
+            int ret = -1;
+            if (!std::filesystem::exists(root)) return ret;
+            for (const auto& e : std::filesystem::directory_iterator(root)) {
+                auto name = e.path().filename().string();
+                if (!name.starts_with("ckpt_") || !std::filesystem::exists(e.path() / "meta.bin")) continue;
+                ret = std::max(ret, std::stoi(name.substr(5)));
+            }
+            return ret;
+        }
+
+        /// \brief Bytes of payload written by this rank in the last save
+        [[nodiscard]] auto getLastWrittenBytes() const { return written_bytes; }
+
+    private:
+        CheckpointManager& add(std::unique_ptr<internal::CheckpointEntryBase>&& e) {
+            for (const auto& o : entries)
+                OP_ASSERT_MSG(o->name != e->name, "Checkpoint: Object named {} registered twice", e->name);
+            entries.push_back(std::move(e));
+            return *this;
+        }
+
+        [[nodiscard]] auto dir(int id) const { return root / std::format("ckpt_{}", id); }
+        [[nodiscard]] auto dataFile(int id, int file) const {
+            return dir(id) / (file < 0 ? std::string("data.bin") : std::format("data_{}.bin", file));
+        }
+
+        static void barrier() {
+#if defined(OPFLOW_WITH_MPI) && defined(OPFLOW_DISTRIBUTE_MODEL_MPI)
+            MPI_Barrier(MPI_COMM_WORLD);
+#endif
+        }
+
+        void writeData(int id, const std::vector<const std::vector<std::byte>*>& payloads,
+                       std::uint64_t base);
+
+        static constexpr std::uint32_t magic = 0x4b434f50;// "POCK"
+        std::filesystem::path root;
+        CheckpointIO io = CheckpointIO::FilePerRank;
+        bool incremental = false;
+        int next_id = -1;
+        std::size_t written_bytes = 0;
+        std::vector<std::unique_ptr<internal::CheckpointEntryBase>> entries;
+        // records of the blocks of this rank in the last checkpoint, keyed by entry & block id
+        std::map<std::pair<std::string, std::int64_t>, internal::CheckpointBlockRecord> last;
+    };
+
+    inline int CheckpointManager::save(const TimeStamp& t) {
+        auto rank = getWorkerId(), nproc = getWorkerCount();
+        if (next_id < 0) next_id = latest() + 1;
+        auto id = next_id++;
+        if (rank == 0) std::filesystem::create_directories(dir(id));
+        barrier();
+
+        // collect & hash the blocks
+        std::vector<internal::CheckpointBlockRecord> records;
+        std::vector<std::vector<internal::CheckpointBlock>> blocks(entries.size());
+        for (auto k = 0; k < entries.size(); ++k) entries[k]->save(blocks[k]);
+        for (auto k = 0; k < entries.size(); ++k)
+            for (auto& b : blocks[k])
+                records.push_back({entries[k]->name, b.id, std::move(b.header), 0, b.data.size(), 0, rank, id,
+                                   io == CheckpointIO::Aggregated ? -1 : rank});
+        std::vector<const std::vector<std::byte>*> data;
+        for (auto& bs : blocks)
+            for (auto& b : bs) data.push_back(&b.data);
+        tbb::task_arena arena(getGlobalParallelPlan().shared_memory_workers_count);
+        arena.execute([&]() {
+            tbb::parallel_for(std::size_t(0), records.size(), [&](std::size_t k) {
+                records[k].hash = XXHash64::hash(data[k]->data(), data[k]->size(), 0);
+            });
+        });
+
+        // skip the blocks unchanged since the last checkpoint
+        std::vector<const std::vector<std::byte>*> payloads;
+        std::uint64_t offset = 0;
+        for (auto k = 0; k < records.size(); ++k) {
+            auto& rec = records[k];
+            auto iter = last.find({rec.entry, rec.id});
+            if (incremental && iter != last.end() && iter->second.hash == rec.hash
+                && iter->second.size == rec.size && iter->second.header == rec.header) {
+                rec.ckpt = iter->second.ckpt;
+                rec.file = iter->second.file;
+                rec.offset = iter->second.offset;
+            } else {
+                rec.offset = offset;
+                offset += rec.size;
+                payloads.push_back(data[k]);
+            }
+        }
+        std::uint64_t base = 0;
+#if defined(OPFLOW_WITH_MPI) && defined(OPFLOW_DISTRIBUTE_MODEL_MPI)
+        if (io == CheckpointIO::Aggregated) {
+            MPI_Exscan(&offset, &base, 1, MPI_UINT64_T, MPI_SUM, MPI_COMM_WORLD);
+            if (rank == 0) base = 0;
+        }
+#endif
+        for (auto& rec : records)
+            if (rec.ckpt == id) rec.offset += base;
+        writeData(id, payloads, base);
+        written_bytes = offset;
+
+        // index of this rank
+        internal::CheckpointWriter index;
+        index.put(std::uint64_t(records.size()));
+        for (const auto& rec : records) {
+            index.put(rec.entry);
+            index.put(rec.id);
+            index.put(rec.header);
+            index.put(rec.hash);
+            index.put(rec.size);
+            index.put(rec.offset);
+            index.put(rec.rank);
+            index.put(rec.ckpt);
+            index.put(rec.file);
+        }
+        {
+            std::unique_ptr<std::FILE, internal::FileCloser> file(
+                    std::fopen((dir(id) / std::format("index_{}.bin", rank)).c_str(), "wb"));
+            OP_ASSERT_MSG(file, "Checkpoint: Cannot write index of checkpoint {}", id);
+            std::fwrite(index.bytes.data(), 1, index.bytes.size(), file.get());
+        }
+
+        // commit
+        barrier();
+        if (rank == 0) {
+            internal::CheckpointWriter meta;
+            meta.put(magic);
+            meta.put(id);
+            meta.put(t.time);
+            meta.put(std::uint8_t(t.step.has_value()));
+            meta.put(t.step.value_or(0));
+            meta.put(nproc);
+            meta.put(int(io));
+            auto tmp = dir(id) / "meta.bin.tmp";
+            {
+                std::unique_ptr<std::FILE, internal::FileCloser> file(std::fopen(tmp.c_str(), "wb"));
+                OP_ASSERT_MSG(file, "Checkpoint: Cannot write meta of checkpoint {}", id);
+                std::fwrite(meta.bytes.data(), 1, meta.bytes.size(), file.get());
+            }
+            std::filesystem::rename(tmp, dir(id) / "meta.bin");
+        }
+        barrier();
+
+        last.clear();
+        for (auto& rec : records) last.emplace(std::make_pair(rec.entry, rec.id), std::move(rec));
+        return id;
+    }
+
+    inline void CheckpointManager::writeData(int id,
+                                             const std::vector<const std::vector<std::byte>*>& payloads,
+                                             std::uint64_t base) {
+#if defined(OPFLOW_WITH_MPI) && defined(OPFLOW_DISTRIBUTE_MODEL_MPI)
+        if (io == CheckpointIO::Aggregated) {
+            std::vector<std::byte> buf;
+            for (const auto* p : payloads) buf.insert(buf.end(), p->begin(), p->end());
+            MPI_File fh;
+            MPI_File_open(MPI_COMM_WORLD, dataFile(id, -1).c_str(), MPI_MODE_CREATE | MPI_MODE_WRONLY,
+                          MPI_INFO_NULL, &fh);
+            // MPI counts are int, so write in pieces of at most 1 GiB
+            constexpr std::uint64_t max_piece = 1 << 30;
+            std::uint64_t pieces = (buf.size() + max_piece - 1) / max_piece, max_pieces;
+            MPI_Allreduce(&pieces, &max_pieces, 1, MPI_UINT64_T, MPI_MAX, MPI_COMM_WORLD);
+            for (std::uint64_t k = 0; k < max_pieces; ++k) {
+                auto begin = std::min<std::uint64_t>(k * max_piece, buf.size());
+                auto n = std::min<std::uint64_t>(max_piece, buf.size() - begin);
+                MPI_File_write_at_all(fh, base + begin, buf.data() + begin, n, MPI_BYTE, MPI_STATUS_IGNORE);
+            }
+            MPI_File_close(&fh);
+            return;
+        }
+#endif
+        auto file_id = io == CheckpointIO::Aggregated ? -1 : getWorkerId();
+        std::unique_ptr<std::FILE, internal::FileCloser> file(
+                std::fopen(dataFile(id, file_id).c_str(), "wb"));
+        OP_ASSERT_MSG(file, "Checkpoint: Cannot write data of checkpoint {}", id);
+        for (const auto* p : payloads) std::fwrite(p->data(), 1, p->size(), file.get());
+    }
+
+    inline TimeStamp CheckpointManager::restore(int id) {
+        if (id < 0) id = latest();
+        OP_ASSERT_MSG(id >= 0, "Checkpoint: No checkpoint found in {}", root.string());
+        auto read_file = [](const std::filesystem::path& p) {
+            std::unique_ptr<std::FILE, internal::FileCloser> file(std::fopen(p.c_str(), "rb"));
+            if (!file) {
+                OP_CRITICAL("Checkpoint: Cannot open {}", p.string());
+                OP_ABORT;
+            }
+            std::vector<std::byte> ret(std::filesystem::file_size(p));
+            auto n = std::fread(ret.data(), 1, ret.size(), file.get());
+            OP_ASSERT_MSG(n == ret.size(), "Checkpoint: {} is truncated", p.string());
+            return ret;
+        };
+
+        auto meta_bytes = read_file(dir(id) / "meta.bin");
+        internal::CheckpointReader meta(meta_bytes);
+        OP_ASSERT_MSG(meta.take<std::uint32_t>() == magic, "Checkpoint: {} is not a checkpoint",
+                      dir(id).string());
+        OP_ASSERT_MSG(meta.take<int>() == id, "Checkpoint: Id of checkpoint {} mismatch", id);
+        TimeStamp t(meta.take<double>());
+        auto has_step = meta.take<std::uint8_t>();
+        auto step = meta.take<int>();
+        if (has_step) t.step = step;
+        auto nproc = meta.take<int>();
+        meta.take<int>();
+
+        // the records of all ranks
+        std::vector<internal::CheckpointBlockRecord> records;
+        for (auto r = 0; r < nproc; ++r) {
+            auto bytes = read_file(dir(id) / std::format("index_{}.bin", r));
+            internal::CheckpointReader index(bytes);
+            auto n = index.take<std::uint64_t>();
+            for (std::uint64_t k = 0; k < n; ++k) {
+                auto& rec = records.emplace_back();
+                index.take(rec.entry);
+                index.take(rec.id);
+                index.take(rec.header);
+                index.take(rec.hash);
+                index.take(rec.size);
+                index.take(rec.offset);
+                index.take(rec.rank);
+                index.take(rec.ckpt);
+                index.take(rec.file);
+            }
+        }
+
+        // payloads are read with positioned reads, so the fetcher is safe to call concurrently
+        internal::CheckpointFetcher fetch = [this](const internal::CheckpointBlockRecord& rec) {
+            auto path = dataFile(rec.ckpt, rec.file);
+            std::unique_ptr<std::FILE, internal::FileCloser> file(std::fopen(path.c_str(), "rb"));
+            if (!file) {
+                OP_CRITICAL("Checkpoint: Cannot open {}", path.string());
+                OP_ABORT;
+            }
+            std::vector<std::byte> ret(rec.size);
+            std::fseek(file.get(), rec.offset, SEEK_SET);
+            auto n = std::fread(ret.data(), 1, ret.size(), file.get());
+            OP_ASSERT_MSG(n == ret.size(), "Checkpoint: Block {} of {} is truncated", rec.id, rec.entry);
+            OP_ASSERT_MSG(XXHash64::hash(ret.data(), ret.size(), 0) == rec.hash,
+                          "Checkpoint: Block {} of {} is corrupted", rec.id, rec.entry);
+            return ret;
+        };
+        for (auto& e : entries) {
+            internal::CheckpointRecords recs;
+            for (const auto& rec : records)
+                if (rec.entry == e->name) recs.push_back(&rec);
+            if (recs.empty()) {
+                OP_WARN("Checkpoint: {} not found in checkpoint {}", e->name, id);
+                continue;
+            }
+            e->load(recs, fetch, nproc);
+        }
+
+        // later incremental checkpoints continue from the restored one if the ranks are the same
+        last.clear();
+        if (nproc == getWorkerCount())
+            for (auto& rec : records)
+                if (rec.rank == getWorkerId())
+                    last.emplace(std::make_pair(rec.entry, rec.id), std::move(rec));
+        next_id = latest() + 1;
+        return t;
+    }
+}// namespace OpFlow::Utils
+
+#endif//OPFLOW_CHECKPOINTMANAGER_HPP
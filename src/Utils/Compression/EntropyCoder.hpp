@@ -0,0 +1,183 @@
+//  ----------------------------------------------------------------------------
+//
+//  Copyright (c) 2019 - 2026 by the OpFlow developers
+//
+//  This file is part of OpFlow.
+//
+//  OpFlow is free software and is distributed under the MPL v2.0 license.
+//  The full text of the license can be found in the file LICENSE at the top
+//  level directory of OpFlow.
+//
+//  ----------------------------------------------------------------------------
+
+#ifndef OPFLOW_ENTROPYCODER_HPP
+#define OPFLOW_ENTROPYCODER_HPP
+
+#include "Core/Macros.hpp"
+#ifndef OPFLOW_INSIDE_MODULE
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#endif
+
+OPFLOW_MODULE_EXPORT namespace OpFlow::Utils {
+    /// \brief Transpose \p n elements of \p size bytes into \p size planes of \p n bytes
+    /// \details Plane b holds the b-th byte of every element. The sign & exponent bytes of smooth
+    /// floating point data vary slowly and end up in their own planes, where they compress well.
+    template <std::size_t size>
+    void byteShuffle(const std::uint8_t* in, std::size_t n, std::uint8_t* out) {
+        for (std::size_t i = 0; i < n; ++i)
+            for (std::size_t b = 0; b < size; ++b) out[b * n + i] = in[i * size + b];
+    }
+
+    /// \brief Inverse of byteShuffle
+    template <std::size_t size>
+    void byteUnshuffle(const std::uint8_t* in, std::size_t n, std::uint8_t* out) {
+        for (std::size_t i = 0; i < n; ++i)
+            for (std::size_t b = 0; b < size; ++b) out[i * size + b] = in[b * n + i];
+    }
+
+    /// \brief Order-0 static range asymmetric numeral system (rANS) coder for byte streams
+    /// \details Each encoded block starts with a mode byte. A block of a single repeated byte is stored
+    /// as that byte; a block that doesn't shrink under entropy coding is stored raw. Otherwise the
+    /// normalized symbol frequencies are followed by the payload size & the rANS payload.
+    struct RANSCoder {
+        static constexpr int prob_bits = 12;
+        static constexpr std::uint32_t prob_scale = 1u << prob_bits;
+        static constexpr std::uint32_t rans_l = 1u << 23;
+
+        enum Mode : std::uint8_t { Raw = 0, Constant = 1, Entropy = 2 };
+
+        /// \brief Encode \p n bytes & append the block to \p out
+        static void encode(const std::uint8_t* in, std::size_t n, std::vector<std::uint8_t>& out) {
+            if (n == 0) return;
+            std::array<std::uint64_t, 256> count {};
+            for (std::size_t i = 0; i < n; ++i) count[in[i]]++;
+            if (count[in[0]] == n) {
+                out.push_back(Constant);
+                out.push_back(in[0]);
+                return;
+            }
+            auto freq = normalize(count, n);
+            std::array<std::uint32_t, 256> cum {};
+            for (auto s = 1; s < 256; ++s) cum[s] = cum[s - 1] + freq[s - 1];
+
+            // symbols are encoded backwards so that the decoder runs forwards
+            std::vector<std::uint8_t> buf(n + n / 2 + 16);
+            auto* end = buf.data() + buf.size();
+            auto* ptr = end;
+            std::uint32_t x = rans_l;
+            for (auto i = n; i-- > 0;) {
+                auto s = in[i];
+                std::uint32_t f = freq[s];
+                std::uint32_t x_max = ((rans_l >> prob_bits) << 8) * f;
+                while (x >= x_max) {
+                    *--ptr = x & 0xff;
+                    x >>= 8;
+                }
+                x = ((x / f) << prob_bits) + (x % f) + cum[s];
+            }
+            ptr -= 4;
+            for (auto k = 0; k < 4; ++k) ptr[k] = (x >> (8 * k)) & 0xff;
+            std::uint64_t payload = end - ptr;
+
+            if (sizeof(std::uint16_t) * 256 + sizeof(payload) + payload >= n) {
+                out.push_back(Raw);
+                out.insert(out.end(), in, in + n);
+                return;
+            }
+            out.push_back(Entropy);
+            for (auto f : freq) {
+                out.push_back(f & 0xff);
+                out.push_back(f >> 8);
+            }
+            auto pos = out.size();
+            out.resize(pos + sizeof(payload));
+            std::memcpy(out.data() + pos, &payload, sizeof(payload));
+            out.insert(out.end(), ptr, end);
+        }
+
+        /// \brief Decode a block of \p n bytes from [in, end)
+        /// \return Pointer past the consumed block
+        static const std::uint8_t* decode(const std::uint8_t* in, const std::uint8_t* end, std::uint8_t* out,
+                                          std::size_t n) {
+            if (n == 0) return in;
+            OP_ASSERT_MSG(in < end, "RANSCoder: Unexpected end of block");
+            auto mode = *in++;
+            if (mode == Constant) {
+                OP_ASSERT_MSG(in < end, "RANSCoder: Unexpected end of block");
+                std::memset(out, *in, n);
+                return in + 1;
+            } else if (mode == Raw) {
+                OP_ASSERT_MSG(end - in >= (std::ptrdiff_t) n, "RANSCoder: Unexpected end of block");
+                std::memcpy(out, in, n);
+                return in + n;
+            }
+            OP_ASSERT_MSG(mode == Entropy, "RANSCoder: Unknown block mode {}", (int) mode);
+            std::uint64_t payload;
+            OP_ASSERT_MSG(end - in >= (std::ptrdiff_t) (512 + sizeof(payload)),
+                          "RANSCoder: Unexpected end of block");
+            std::array<std::uint32_t, 256> freq, cum;
+            std::uint32_t total = 0;
+            for (auto s = 0; s < 256; ++s) {
+                freq[s] = in[2 * s] | (in[2 * s + 1] << 8);
+                cum[s] = total;
+                total += freq[s];
+            }
+            OP_ASSERT_MSG(total == prob_scale, "RANSCoder: Corrupted frequency table");
+            in += 512;
+            std::memcpy(&payload, in, sizeof(payload));
+            in += sizeof(payload);
+            OP_ASSERT_MSG(payload >= 4 && (std::uint64_t) (end - in) >= payload,
+                          "RANSCoder: Unexpected end of block");
+            std::array<std::uint8_t, prob_scale> sym;
+            for (auto s = 0; s < 256; ++s) std::fill_n(sym.begin() + cum[s], freq[s], s);
+
+            const auto* ptr = in;
+            const auto* pend = in + payload;
+            std::uint32_t x = 0;
+            for (auto k = 0; k < 4; ++k) x |= std::uint32_t(*ptr++) << (8 * k);
+            for (std::size_t i = 0; i < n; ++i) {
+                auto slot = x & (prob_scale - 1);
+                auto s = sym[slot];
+                out[i] = s;
+                x = freq[s] * (x >> prob_bits) + slot - cum[s];
+                while (x < rans_l) {
+                    OP_ASSERT_MSG(ptr < pend, "RANSCoder: Corrupted payload");
+                    x = (x << 8) | *ptr++;
+                }
+            }
+            return pend;
+        }
+
+    private:
+        // scale the counts to frequencies summing up to prob_scale, keeping every present symbol
+        static std::array<std::uint32_t, 256> normalize(const std::array<std::uint64_t, 256>& count,
+                                                        std::size_t n) {
+            std::array<std::uint32_t, 256> freq {};
+            std::uint32_t sum = 0;
+            for (auto s = 0; s < 256; ++s) {
+                if (count[s] == 0) continue;
+                freq[s] = std::max<std::uint64_t>(1, count[s] * prob_scale / n);
+                sum += freq[s];
+            }
+            while (sum != prob_scale) {
+                auto s = std::max_element(freq.begin(), freq.end()) - freq.begin();
+                if (sum < prob_scale) {
+                    freq[s] += prob_scale - sum;
+                    sum = prob_scale;
+                } else {
+                    auto d = std::min(sum - prob_scale, freq[s] - 1);
+                    freq[s] -= d;
+                    sum -= d;
+                }
+            }
+            return freq;
+        }
+    };
+}// namespace OpFlow::Utils
+
+#endif//OPFLOW_ENTROPYCODER_HPP
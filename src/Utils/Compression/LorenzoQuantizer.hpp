@@ -0,0 +1,133 @@
+//  ----------------------------------------------------------------------------
+//
+//  Copyright (c) 2019 - 2026 by the OpFlow developers
+//
+//  This file is part of OpFlow.
+//
+//  OpFlow is free software and is distributed under the MPL v2.0 license.
+//  The full text of the license can be found in the file LICENSE at the top
+//  level directory of OpFlow.
+//
+//  ----------------------------------------------------------------------------
+
+#ifndef OPFLOW_LORENZOQUANTIZER_HPP
+#define OPFLOW_LORENZOQUANTIZER_HPP
+
+#include "Core/Macros.hpp"
+#ifndef OPFLOW_INSIDE_MODULE
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#endif
+
+OPFLOW_MODULE_EXPORT namespace OpFlow::Utils {
+    /// \brief Error bounded quantizer with Lorenzo prediction
+    /// \details Each value is predicted from its already reconstructed lower neighbors along every
+    /// direction of a dim-0-fastest block (the Lorenzo predictor, exact for multi-linear data), and the
+    /// prediction error is quantized to a multiple of 2 * eb. The reconstructed value thus differs from
+    /// the original by at most eb. Values that can't be quantized within the code range (or aren't
+    /// finite) are escaped with code 0 and stored verbatim.
+    /// \tparam T Floating point element type
+    /// \tparam dim Dimension of the block
+    template <std::floating_point T, int dim>
+    struct LorenzoQuantizer {
+        static constexpr long radius = 32768;
+
+        /// \param ext Extends of the block
+        /// \param eb Absolute error bound
+        LorenzoQuantizer(const std::array<int, dim>& ext, double eb) : ext(ext), step(2 * eb), eb(eb) {
+            std::ptrdiff_t stride = 1;
+            std::array<std::ptrdiff_t, dim> strides;
+            for (auto k = 0; k < dim; ++k) {
+                strides[k] = stride;
+                stride *= ext[k];
+            }
+            count = stride;
+            for (auto mask = 1; mask < (1 << dim); ++mask) {
+                offset[mask] = 0;
+                sign[mask] = -1;
+                for (auto k = 0; k < dim; ++k)
+                    if (mask & (1 << k)) {
+                        offset[mask] += strides[k];
+                        sign[mask] = -sign[mask];
+                    }
+            }
+        }
+
+        [[nodiscard]] auto size() const { return count; }
+
+        /// \brief Quantize the block \p in to \p codes, appending the escaped values to \p escapes
+        /// \param recon Scratch of the block's size receiving the reconstructed values
+        void quantize(const T* in, std::uint16_t* codes, std::vector<T>& escapes, T* recon) const {
+            traverse([&](std::ptrdiff_t i, int valid) {
+                double v = in[i];
+                double pred = predict(recon, i, valid);
+                double diff = (v - pred) / step;
+                if (std::isfinite(v) && std::abs(diff) < radius - 1) {
+                    long q = std::lround(diff);
+                    T r = reconstruct(pred, q);
+                    if (std::abs(double(r) - v) <= eb) {
+                        codes[i] = q + radius;
+                        recon[i] = r;
+                        return;
+                    }
+                }
+                codes[i] = 0;
+                escapes.push_back(in[i]);
+                recon[i] = in[i];
+            });
+        }
+
+        /// \brief Reconstruct the block from \p codes & the \p n_escapes escaped values
+        void dequantize(const std::uint16_t* codes, const T* escapes, std::size_t n_escapes, T* out) const {
+            std::size_t e = 0;
+            traverse([&](std::ptrdiff_t i, int valid) {
+                if (codes[i] == 0) {
+                    OP_ASSERT_MSG(e < n_escapes, "LorenzoQuantizer: Escaped values exhausted");
+                    out[i] = escapes[e++];
+                } else {
+                    out[i] = reconstruct(predict(out, i, valid), long(codes[i]) - radius);
+                }
+            });
+        }
+
+    private:
+        // visit the block in storage order; valid marks the directions with a lower neighbor
+        void traverse(auto&& func) const {
+            if (count == 0) return;
+            std::array<int, dim> c {};
+            int valid = 0;
+            for (std::ptrdiff_t i = 0; i < count; ++i) {
+                func(i, valid);
+                for (auto k = 0; k < dim; ++k) {
+                    if (++c[k] < ext[k]) {
+                        valid |= 1 << k;
+                        break;
+                    }
+                    c[k] = 0;
+                    valid &= ~(1 << k);
+                }
+            }
+        }
+
+        double predict(const T* r, std::ptrdiff_t i, int valid) const {
+            double pred = 0;
+            for (auto mask = 1; mask < (1 << dim); ++mask)
+                if ((mask & valid) == mask) pred += sign[mask] * double(r[i - offset[mask]]);
+            return pred;
+        }
+
+        T reconstruct(double pred, long q) const { return T(pred + step * double(q)); }
+
+        std::array<int, dim> ext;
+        std::array<std::ptrdiff_t, 1 << dim> offset {};
+        std::array<int, 1 << dim> sign {};
+        std::ptrdiff_t count = 0;
+        double step, eb;
+    };
+}// namespace OpFlow::Utils
+
+#endif//OPFLOW_LORENZOQUANTIZER_HPP
@@ -0,0 +1,115 @@
+// ----------------------------------------------------------------------------
+//
+// Copyright (c) 2019 - 2026 by the OpFlow developers
+//
+// This file is part of OpFlow.
+//
+// OpFlow is free software and is distributed under the MPL v2.0 license.
+// The full text of the license can be found in the file LICENSE at the top
+// level directory of OpFlow.
+//
+// ----------------------------------------------------------------------------
+
+#ifndef OPFLOW_ASYNCWRITER_HPP
+#define OPFLOW_ASYNCWRITER_HPP
+
+#include "Core/Macros.hpp"
+#ifndef OPFLOW_INSIDE_MODULE
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#endif
+
+OPFLOW_MODULE_EXPORT namespace OpFlow::Utils {
+    /// \brief A dedicated I/O thread executing write tasks in submission order
+    /// \details The number of outstanding (queued or running) tasks is bounded by the capacity, so
+    /// that the producer can reuse a staging buffer once wait(capacity - 1) returns. An exception
+    /// thrown by a task is rethrown to the producer by the next call to wait(), submit() or flush().
+    struct AsyncWriter {
+        explicit AsyncWriter(std::size_t capacity = 2) : capacity(std::max<std::size_t>(capacity, 1)) {
+            worker = std::thread([this] { run(); });
+        }
+
+        AsyncWriter(const AsyncWriter&) = delete;
+        AsyncWriter& operator=(const AsyncWriter&) = delete;
+
+        ~AsyncWriter() {
+            {
+                std::unique_lock lock(mutex);
+                done_cv.wait(lock, [&] { return outstanding == 0; });
+                stop = true;
+            }
+            task_cv.notify_one();
+            worker.join();
+        }
+
+        /// \brief Enqueue a task. Blocks while the queue is full
+        void submit(std::function<void()> task) {
+            {
+                std::unique_lock lock(mutex);
+                done_cv.wait(lock, [&] { return outstanding < capacity; });
+                rethrow();
+                tasks.push_back(std::move(task));
+                outstanding++;
+            }
+            task_cv.notify_one();
+        }
+
+        /// \brief Block until at most \p n tasks are outstanding
+        void wait(std::size_t n) {
+            std::unique_lock lock(mutex);
+            done_cv.wait(lock, [&] { return outstanding <= n; });
+            rethrow();
+        }
+
+        /// \brief Block until all submitted tasks are finished
+        void flush() { wait(0); }
+
+        [[nodiscard]] auto getCapacity() const { return capacity; }
+
+    private:
+        void run() {
+            while (true) {
+                std::function<void()> task;
+                {
+                    std::unique_lock lock(mutex);
+                    task_cv.wait(lock, [&] { return stop || !tasks.empty(); });
+                    if (tasks.empty()) return;
+                    task = std::move(tasks.front());
+                    tasks.pop_front();
+                }
+                try {
+                    task();
+                } catch (...) {
+                    std::lock_guard lock(mutex);
+                    if (!error) error = std::current_exception();
+                }
+                {
+                    std::lock_guard lock(mutex);
+                    outstanding--;
+                }
+                done_cv.notify_all();
+            }
+        }
+
+        // must be called with the mutex held
+        void rethrow() {
+            if (error) std::rethrow_exception(std::exchange(error, nullptr));
+        }
+
+        std::size_t capacity, outstanding = 0;
+        std::deque<std::function<void()>> tasks;
+        std::mutex mutex;
+        std::condition_variable task_cv, done_cv;
+        std::exception_ptr error;
+        bool stop = false;
+        std::thread worker;
+    };
+}// namespace OpFlow::Utils
+
+#endif//OPFLOW_ASYNCWRITER_HPP
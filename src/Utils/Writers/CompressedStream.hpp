@@ -0,0 +1,450 @@
+//  ----------------------------------------------------------------------------
+//
+//  Copyright (c) 2019 - 2026 by the OpFlow developers
+//
+//  This file is part of OpFlow.
+//
+//  OpFlow is free software and is distributed under the MPL v2.0 license.
+//  The full text of the license can be found in the file LICENSE at the top
+//  level directory of OpFlow.
+//
+//  ----------------------------------------------------------------------------
+
+#ifndef OPFLOW_COMPRESSEDSTREAM_HPP
+#define OPFLOW_COMPRESSEDSTREAM_HPP
+
+#include "Core/Environment.hpp"
+#include "Core/Field/MeshBased/Structured/CartesianFieldExprTrait.hpp"
+#include "Utils/Compression/EntropyCoder.hpp"
+#include "Utils/Compression/LorenzoQuantizer.hpp"
+#include "Utils/Writers/FieldStream.hpp"
+#include <format>
+#ifndef OPFLOW_INSIDE_MODULE
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <tbb/tbb.h>
+#include <unordered_map>
+#include <vector>
+#endif
+
+OPFLOW_MODULE_EXPORT namespace OpFlow::Utils {
+    struct CompressedStream;
+
+    namespace internal {
+        template <>
+        struct StreamTrait<CompressedStream> {
+            static constexpr auto mode_flag = StreamIn | StreamOut | StreamBinary;
+        };
+    }// namespace internal
+
+    /// \brief Compressed field snapshot stream
+    /// \details Each time stamp is dumped to its own file {stem}_{time}.opz (or {stem}_{step}.opz when
+    /// numbered by step) holding one record per field. The local range of a field is cut into slabs
+    /// along the slowest dim, which are compressed & decompressed in parallel:
+    /// - Lossless (default): the slab is byte shuffled & every byte plane is rANS coded.
+    /// - Lossy: with a positive absolute tolerance set for a floating point field, the slab is
+    ///   quantized with Lorenzo prediction so that every value is reconstructed within the tolerance,
+    ///   and the quantization codes are shuffled & rANS coded.
+    struct CompressedStream : FieldStream<CompressedStream> {
+        CompressedStream() = default;
+        explicit CompressedStream(const std::filesystem::path& path, unsigned int mode = StreamOut)
+            : path(path), mode(mode) {}
+
+        // time info
+        auto& operator<<(const TimeStamp& t) {
+            file.reset();
+            time = t;
+            if (numberingType == NumberingType::ByStep)
+                OP_ASSERT_MSG(time.step, "CompressedStream: Must provide step number to postfix by step");
+            return *this;
+        }
+        auto& moveToTime(const TimeStamp& t) {
+            OP_ASSERT_MSG(mode & StreamIn,
+                          "CompressedStream error: moveToTime can only be used under read mode");
+            file.reset();
+            time = t;
+            return *this;
+        }
+
+        void fixedMeshImpl() { fixed_mesh = true; }
+        // every time stamp is dumped to a separate file anyway
+        void dumpToSeparateFileImpl() {}
+        void setNumberingTypeImpl(NumberingType type) { numberingType = type; }
+
+        /// \brief Set the absolute error tolerance of all fields. Zero means lossless
+        void setTolerance(double tol) { default_tolerance = tol; }
+        /// \brief Set the absolute error tolerance of the field named \p name
+        void setTolerance(const std::string& name, double tol) { tolerances[name] = tol; }
+
+        /// \brief Ratio of the raw size to the compressed size of all field data written so far
+        [[nodiscard]] double getCompressionRatio() const {
+            return compressed_bytes ? double(raw_bytes) / compressed_bytes : 1.0;
+        }
+
+        // field writers
+        template <CartesianFieldExprType T>
+        CompressedStream& operator<<(const T& f);
+
+        template <CartesianFieldExprType... Ts>
+        CompressedStream& dumpMultiple(const Ts&... fs) {
+            return (*this << ... << fs);
+        }
+
+        // field readers
+        template <CartesianFieldType T>
+        CompressedStream& operator>>(T& f);
+
+        std::string static commonSuffix() { return ".opz"; }
+
+    private:
+        std::string fileName() const {
+            static int nproc = 1, rank = 0;
+            if (!getGlobalParallelPlan().singleNodeMode()) {
+                nproc = getGlobalParallelPlan().distributed_workers_count;
+                rank = getWorkerId();
+            }
+            auto stem = path;
+            stem.replace_extension();
+            auto ret = stem.string();
+            if (numberingType == NumberingType::ByTime) ret += std::format("_{:.6f}", time.time);
+            else
+                ret += std::format("_{}", time.step.value());
+            if (nproc > 1) ret += std::format("_{}", rank);
+            return ret + commonSuffix();
+        }
+
+        // split the slowest dim of range into slabs of about slab_bytes each
+        template <typename E>
+        static auto makeSlabs(const auto& range) {
+            constexpr auto dim = std::remove_cvref_t<decltype(range)>::dim;
+            std::vector<std::remove_cvref_t<decltype(range)>> slabs;
+            if (range.count() <= 0) return slabs;
+            auto plane = range.count() / (range.end[dim - 1] - range.start[dim - 1]);
+            int thickness = std::max<std::size_t>(1, slab_bytes / sizeof(E) / plane);
+            for (auto s = range.start[dim - 1]; s < range.end[dim - 1]; s += thickness) {
+                auto r = range;
+                r.start[dim - 1] = s;
+                r.end[dim - 1] = std::min(s + thickness, range.end[dim - 1]);
+                r.reValidPace();
+                slabs.push_back(r);
+            }
+            return slabs;
+        }
+
+        template <typename E, int dim>
+        static void compress(const E* in, const std::array<int, dim>& ext, double tol,
+                             std::vector<std::uint8_t>& out) {
+            std::size_t n = 1;
+            for (auto e : ext) n *= e;
+            if constexpr (std::floating_point<E>) {
+                if (tol > 0) {
+                    LorenzoQuantizer<E, dim> quantizer(ext, tol);
+                    std::vector<std::uint16_t> codes(n);
+                    std::vector<E> escapes, recon(n);
+                    quantizer.quantize(in, codes.data(), escapes, recon.data());
+                    std::uint64_t n_escapes = escapes.size();
+                    out.insert(out.end(), reinterpret_cast<std::uint8_t*>(&n_escapes),
+                               reinterpret_cast<std::uint8_t*>(&n_escapes + 1));
+                    std::vector<std::uint8_t> planes(n * sizeof(std::uint16_t));
+                    byteShuffle<sizeof(std::uint16_t)>(reinterpret_cast<const std::uint8_t*>(codes.data()), n,
+                                                       planes.data());
+                    for (std::size_t b = 0; b < sizeof(std::uint16_t); ++b)
+                        RANSCoder::encode(planes.data() + b * n, n, out);
+                    out.insert(out.end(), reinterpret_cast<std::uint8_t*>(escapes.data()),
+                               reinterpret_cast<std::uint8_t*>(escapes.data() + escapes.size()));
+                    return;
+                }
+            }
+            std::vector<std::uint8_t> planes(n * sizeof(E));
+            byteShuffle<sizeof(E)>(reinterpret_cast<const std::uint8_t*>(in), n, planes.data());
+            for (std::size_t b = 0; b < sizeof(E); ++b) RANSCoder::encode(planes.data() + b * n, n, out);
+        }
+
+        template <typename E, int dim>
+        static void decompress(const std::uint8_t* in, const std::uint8_t* end,
+                               const std::array<int, dim>& ext, bool lossy, double tol, E* out) {
+            std::size_t n = 1;
+            for (auto e : ext) n *= e;
+            if constexpr (std::floating_point<E>) {
+                if (lossy) {
+                    std::uint64_t n_escapes;
+                    OP_ASSERT_MSG(end - in >= (std::ptrdiff_t) sizeof(n_escapes),
+                                  "CompressedStream: Unexpected end of slab");
+                    std::memcpy(&n_escapes, in, sizeof(n_escapes));
+                    in += sizeof(n_escapes);
+                    std::vector<std::uint8_t> planes(n * sizeof(std::uint16_t));
+                    for (std::size_t b = 0; b < sizeof(std::uint16_t); ++b)
+                        in = RANSCoder::decode(in, end, planes.data() + b * n, n);
+                    std::vector<std::uint16_t> codes(n);
+                    byteUnshuffle<sizeof(std::uint16_t)>(planes.data(), n,
+                                                         reinterpret_cast<std::uint8_t*>(codes.data()));
+                    OP_ASSERT_MSG((std::uint64_t) (end - in) >= n_escapes * sizeof(E),
+                                  "CompressedStream: Unexpected end of slab");
+                    std::vector<E> escapes(n_escapes);
+                    std::memcpy(escapes.data(), in, n_escapes * sizeof(E));
+                    LorenzoQuantizer<E, dim>(ext, tol).dequantize(codes.data(), escapes.data(), n_escapes,
+                                                                  out);
+                    return;
+                }
+            }
+            OP_ASSERT_MSG(!lossy, "CompressedStream: Lossy record of a non floating point field");
+            std::vector<std::uint8_t> planes(n * sizeof(E));
+            for (std::size_t b = 0; b < sizeof(E); ++b)
+                in = RANSCoder::decode(in, end, planes.data() + b * n, n);
+            byteUnshuffle<sizeof(E)>(planes.data(), n, reinterpret_cast<std::uint8_t*>(out));
+        }
+
+        std::filesystem::path path;
+        TimeStamp time {};
+        unsigned int mode = StreamOut;
+        NumberingType numberingType = NumberingType::ByTime;
+        bool fixed_mesh = false, mesh_written = false;
+        double default_tolerance = 0;
+        std::unordered_map<std::string, double> tolerances;
+        std::size_t raw_bytes = 0, compressed_bytes = 0;
+        std::unique_ptr<std::FILE, internal::FileCloser> file;
+        bool reading = false;
+        static constexpr std::size_t slab_bytes = 1 << 20;
+        static constexpr std::uint32_t magic = 0x5a46504f;// "OPFZ"
+    };
+
+    /// \brief Stream operator for CartesianField
+    /// \note
+    /// The structure of a compressed file:
+    /// <uint32>        magic "OPFZ"
+    /// records:
+    /// <uint64>        bytes of the record after this entry
+    /// <int>           name length & <char * len> field name
+    /// <int>           field dim
+    /// <int>           element size
+    /// <uint8>         lossy flag
+    /// <double>        tolerance
+    /// <double>        time stamp
+    /// <dim * 2 * int> mesh range
+    /// <uint8>         mesh coordinates flag & <n1 ... nd * double> mesh coordinates if set
+    /// <dim * 2 * int> field global range
+    /// <dim * 2 * int> field local range
+    /// <uint64>        slab count
+    /// <uint64 * n>    compressed bytes of each slab
+    /// <...>           compressed slabs
+    /// \tparam T Input field type
+    /// \param f Input field
+    /// \return The stream
+    template <CartesianFieldExprType T>
+    CompressedStream& CompressedStream::operator<<(const T& f) {
+        constexpr auto dim = OpFlow::internal::CartesianFieldExprTrait<T>::dim;
+        using elem_type = typename OpFlow::internal::CartesianFieldExprTrait<T>::elem_type;
+        static_assert(std::is_trivially_copyable_v<elem_type>);
+
+        if (file && reading) file.reset();
+        if (!file) {
+            file.reset(std::fopen(fileName().c_str(), "wb"));
+            reading = false;
+            OP_ASSERT_MSG(file, "CompressedStream: Cannot open file {}", fileName());
+            std::fwrite(&magic, sizeof(magic), 1, file.get());
+        }
+        f.prepare();
+        auto name = f.getName();
+        double tol = tolerances.contains(name) ? tolerances[name] : default_tolerance;
+        std::uint8_t lossy = std::floating_point<elem_type> && tol > 0;
+
+        std::vector<std::uint8_t> header;
+        auto put = [&](const auto& v) {
+            auto* p = reinterpret_cast<const std::uint8_t*>(&v);
+            header.insert(header.end(), p, p + sizeof(v));
+        };
+        put(int(name.size()));
+        header.insert(header.end(), name.begin(), name.end());
+        put(int(dim));
+        put(int(sizeof(elem_type)));
+        put(lossy);
+        put(tol);
+        put(time.time);
+        auto& mesh = f.getMesh();
+        auto mesh_range = mesh.getRange();
+        for (auto i = 0; i < dim; ++i) {
+            put(mesh_range.start[i]);
+            put(mesh_range.end[i]);
+        }
+        std::uint8_t with_coords = !(fixed_mesh && mesh_written);
+        put(with_coords);
+        if (with_coords)
+            for (auto i = 0; i < dim; ++i)
+                for (auto j = mesh_range.start[i]; j < mesh_range.end[i]; ++j) put(double(mesh.x(i, j)));
+        mesh_written = true;
+        for (auto i = 0; i < dim; ++i) {
+            put(f.accessibleRange.start[i]);
+            put(f.accessibleRange.end[i]);
+        }
+        for (auto i = 0; i < dim; ++i) {
+            put(f.localRange.start[i]);
+            put(f.localRange.end[i]);
+        }
+
+        // gather & compress the slabs in parallel
+        auto slabs = makeSlabs<elem_type>(f.localRange);
+        std::vector<std::vector<std::uint8_t>> out(slabs.size());
+        tbb::task_arena arena(getGlobalParallelPlan().shared_memory_workers_count);
+        arena.execute([&]() {
+            tbb::parallel_for(std::size_t(0), slabs.size(), [&](std::size_t s) {
+                std::vector<elem_type> buf(slabs[s].count());
+                std::size_t k = 0;
+                rangeFor_s(slabs[s], [&](auto&& i) { buf[k++] = f.evalAt(i); });
+                std::array<int, dim> ext;
+                for (auto i = 0; i < dim; ++i) ext[i] = slabs[s].end[i] - slabs[s].start[i];
+                compress<elem_type, dim>(buf.data(), ext, tol, out[s]);
+            });
+        });
+        put(std::uint64_t(slabs.size()));
+        std::uint64_t payload = 0;
+        for (const auto& o : out) {
+            put(std::uint64_t(o.size()));
+            payload += o.size();
+        }
+
+        std::uint64_t record_bytes = header.size() + payload;
+        std::fwrite(&record_bytes, sizeof(record_bytes), 1, file.get());
+        std::fwrite(header.data(), 1, header.size(), file.get());
+        for (const auto& o : out) std::fwrite(o.data(), 1, o.size(), file.get());
+        std::fflush(file.get());
+        raw_bytes += f.localRange.count() * sizeof(elem_type);
+        compressed_bytes += payload;
+        return *this;
+    }
+
+    template <CartesianFieldType T>
+    CompressedStream& CompressedStream::operator>>(T& f) {
+        constexpr auto dim = OpFlow::internal::CartesianFieldExprTrait<T>::dim;
+        using elem_type = typename OpFlow::internal::CartesianFieldExprTrait<T>::elem_type;
+
+        auto filename = fileName();
+        if (file && !reading) file.reset();
+        if (!file) {
+            file.reset(std::fopen(filename.c_str(), "rb"));
+            reading = true;
+            OP_ASSERT_MSG(file, "Field read error: Cannot open file {}", filename);
+        }
+        std::fseek(file.get(), 0, SEEK_SET);
+        std::uint32_t f_magic = 0;
+        std::fread(&f_magic, sizeof(f_magic), 1, file.get());
+        OP_ASSERT_MSG(f_magic == magic, "Field read error: {} is not a compressed field file", filename);
+
+        // find the record of the field
+        std::vector<std::uint8_t> record;
+        while (true) {
+            std::uint64_t record_bytes;
+            int name_len = 0;
+            if (std::fread(&record_bytes, sizeof(record_bytes), 1, file.get()) != 1
+                || std::fread(&name_len, sizeof(int), 1, file.get()) != 1) {
+                OP_CRITICAL("Field read error: Field {} not found in file {}", f.getName(), filename);
+                OP_ABORT;
+            }
+            OP_ASSERT_MSG(name_len >= 0 && name_len + sizeof(int) <= record_bytes,
+                          "Field read error: Invalid name length {}", name_len);
+            std::string name(name_len, '\0');
+            auto read_bytes = std::fread(name.data(), 1, name_len, file.get());
+            auto rest = record_bytes - sizeof(int) - name_len;
+            if (name != f.getName()) {
+                std::fseek(file.get(), rest, SEEK_CUR);
+                continue;
+            }
+            record.resize(rest);
+            read_bytes += std::fread(record.data(), 1, rest, file.get());
+            OP_ASSERT_MSG(read_bytes == name_len + rest,
+                          "Field read error: Record of field {} is truncated in file {}", name, filename);
+            break;
+        }
+
+        // bounds checked cursor over the record
+        const auto* cursor = record.data();
+        const auto* record_end = cursor + record.size();
+        auto take = [&](auto& v) {
+            OP_ASSERT_MSG(cursor + sizeof(v) <= record_end, "Field read error: Unexpected end of record");
+            std::memcpy(&v, cursor, sizeof(v));
+            cursor += sizeof(v);
+        };
+        int f_dim, elem_size;
+        take(f_dim);
+        OP_ASSERT_MSG(f_dim == dim, "Field read error: Dim mismatch {} != {}", f_dim, dim);
+        take(elem_size);
+        OP_ASSERT_MSG(elem_size == sizeof(elem_type), "Field read error: Element size mismatch {} != {}",
+                      elem_size, sizeof(elem_type));
+        std::uint8_t lossy;
+        double tol, t;
+        take(lossy);
+        take(tol);
+        take(t);
+        auto m_range = f.mesh.getRange();
+        for (auto i = 0; i < dim; ++i) {
+            take(m_range.start[i]);
+            take(m_range.end[i]);
+        }
+        OP_ASSERT_MSG(m_range == f.mesh.getRange(), "Field read error: Mesh range mismatch {} != {}",
+                      m_range.toString(), f.mesh.getRange().toString());
+        std::uint8_t with_coords;
+        take(with_coords);
+        if (with_coords)
+            for (auto i = 0; i < dim; ++i)
+                for (auto j = m_range.start[i]; j < m_range.end[i]; ++j) {
+                    double x;
+                    take(x);
+                    OP_ASSERT_MSG(x == f.mesh.x(i, j),
+                                  "Field read error: Mesh coordinate mismatch at x[{}][{}] {} != {}", i, j, x,
+                                  f.mesh.x(i, j));
+                }
+        auto f_range = f.accessibleRange;
+        for (auto i = 0; i < dim; ++i) {
+            take(f_range.start[i]);
+            take(f_range.end[i]);
+        }
+        OP_ASSERT_MSG(f_range == f.accessibleRange,
+                      "Field read error: Field accessible range mismatch {} != {}", f_range.toString(),
+                      f.accessibleRange.toString());
+        for (auto i = 0; i < dim; ++i) {
+            take(f_range.start[i]);
+            take(f_range.end[i]);
+        }
+        OP_ASSERT_MSG(f_range == f.localRange, "Field read error: Field local range mismatch {} != {}",
+                      f_range.toString(), f.localRange.toString());
+
+        auto slabs = makeSlabs<elem_type>(f.localRange);
+        std::uint64_t n_slabs;
+        take(n_slabs);
+        OP_ASSERT_MSG(n_slabs == slabs.size(), "Field read error: Slab count mismatch {} != {}", n_slabs,
+                      slabs.size());
+        std::vector<const std::uint8_t*> begins(n_slabs + 1);
+        std::vector<std::uint64_t> sizes(n_slabs);
+        for (auto& s : sizes) take(s);
+        begins[0] = cursor;
+        for (std::size_t s = 0; s < n_slabs; ++s) {
+            OP_ASSERT_MSG(sizes[s] <= (std::uint64_t) (record_end - begins[s]),
+                          "Field read error: Unexpected end of record");
+            begins[s + 1] = begins[s] + sizes[s];
+        }
+
+        // decompress & scatter the slabs in parallel
+        f.detachStorage();
+        tbb::task_arena arena(getGlobalParallelPlan().shared_memory_workers_count);
+        arena.execute([&]() {
+            tbb::parallel_for(std::size_t(0), slabs.size(), [&](std::size_t s) {
+                std::vector<elem_type> buf(slabs[s].count());
+                std::array<int, dim> ext;
+                for (auto i = 0; i < dim; ++i) ext[i] = slabs[s].end[i] - slabs[s].start[i];
+                decompress<elem_type, dim>(begins[s], begins[s + 1], ext, lossy, tol, buf.data());
+                std::size_t k = 0;
+                rangeFor_s(slabs[s], [&](auto&& i) { f[i] = buf[k++]; });
+            });
+        });
+        f.updatePadding();
+        return *this;
+    }
+}// namespace OpFlow::Utils
+
+#endif//OPFLOW_COMPRESSEDSTREAM_HPP
@@ -0,0 +1,316 @@
+//  ----------------------------------------------------------------------------
+//
+//  Copyright (c) 2019 - 2026 by the OpFlow developers
+//
+//  This file is part of OpFlow.
+//
+//  OpFlow is free software and is distributed under the MPL v2.0 license.
+//  The full text of the license can be found in the file LICENSE at the top
+//  level directory of OpFlow.
+//
+//  ----------------------------------------------------------------------------
+
+#ifndef OPFLOW_EXTRACTORS_HPP
+#define OPFLOW_EXTRACTORS_HPP
+
+#include "Core/Environment.hpp"
+#include "Core/Field/MeshBased/Structured/CartesianField.hpp"
+#include "Core/Field/MeshBased/Structured/CartesianFieldExprTrait.hpp"
+#include "Core/Mesh/Structured/CartesianMesh.hpp"
+#include "Math/Interpolator/Interpolator.hpp"
+#include "Utils/Writers/Streams.hpp"
+#include <format>
+#ifndef OPFLOW_INSIDE_MODULE
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+#endif
+
+OPFLOW_MODULE_EXPORT namespace OpFlow::Utils {
+    namespace internal {
+        /// \brief Gather the values sampled by each rank to the master rank
+        /// \param box The local box in the sample index space
+        /// \param values The local values in the order of rangeFor_s over \p box
+        /// \param func Functor called on the master rank with each rank's box & values
+        template <typename T, std::size_t d>
+        void gatherSamples(const DS::Range<d>& box, const std::vector<T>& values, auto&& func) {
+#if defined(OPFLOW_WITH_MPI) && defined(OPFLOW_DISTRIBUTE_MODEL_MPI)
+            if (!getGlobalParallelPlan().singleNodeMode()) {
+                auto nproc = getWorkerCount(), rank = getWorkerId();
+                std::array<int, 2 * d> local;
+                std::copy(box.start.begin(), box.start.end(), local.begin());
+                std::copy(box.end.begin(), box.end.end(), local.begin() + d);
+                std::vector<int> boxes(rank == 0 ? 2 * d * nproc : 0), counts(nproc), displs(nproc);
+                MPI_Gather(local.data(), 2 * d, MPI_INT, boxes.data(), 2 * d, MPI_INT, 0, MPI_COMM_WORLD);
+                std::vector<T> all;
+                if (rank == 0) {
+                    std::size_t total = 0;
+                    for (auto r = 0; r < nproc; ++r) {
+                        DS::Range<d> b;
+                        std::copy_n(boxes.begin() + 2 * d * r, d, b.start.begin());
+                        std::copy_n(boxes.begin() + 2 * d * r + d, d, b.end.begin());
+                        displs[r] = total * sizeof(T);
+                        counts[r] = b.count() * sizeof(T);
+                        total += b.count();
+                    }
+                    all.resize(total);
+                }
+                MPI_Gatherv(values.data(), values.size() * sizeof(T), MPI_BYTE, all.data(), counts.data(),
+                            displs.data(), MPI_BYTE, 0, MPI_COMM_WORLD);
+                if (rank != 0) return;
+                for (auto r = 0; r < nproc; ++r) {
+                    DS::Range<d> b;
+                    std::copy_n(boxes.begin() + 2 * d * r, d, b.start.begin());
+                    std::copy_n(boxes.begin() + 2 * d * r + d, d, b.end.begin());
+                    func(b, all.data() + displs[r] / sizeof(T));
+                }
+                return;
+            }
+#endif
+            func(box, values.data());
+        }
+    }// namespace internal
+
+    /// \brief In-situ extraction of a strided sub-block of a Cartesian field expression
+    /// \details The samples are the points start + j * stride of the expression's accessible range,
+    /// optionally restricted to the plane at index pos normal to dim k. The expression is evaluated
+    /// only at the samples & only when extract() is called, each rank evaluating the samples within
+    /// its local range. The samples are then gathered into a small field on the master rank, whose
+    /// mesh nodes are the sample points, so that it can be written with any field stream.
+    /// \note The extractor refers to the expression, which must outlive it.
+    /// \note extract() is collective. Only the master rank's result holds the samples.
+    template <CartesianFieldExprType E>
+    struct FieldExtractor {
+        using elem_type = typename OpFlow::internal::CartesianFieldExprTrait<E>::elem_type;
+        static constexpr auto dim = OpFlow::internal::CartesianFieldExprTrait<E>::dim;
+        using mesh_type = CartesianMesh<Meta::int_<dim>>;
+        using field_type = CartesianField<elem_type, mesh_type>;
+
+        FieldExtractor(const E& f, const std::array<int, dim>& stride) : f(&f), stride(stride) {
+            for (auto s : stride) OP_ASSERT_MSG(s >= 1, "FieldExtractor: Invalid stride {}", s);
+        }
+
+        /// \brief Restrict the samples to the plane at index \p pos normal to dim \p k
+        auto& setSlice(int k, int pos) {
+            OP_ASSERT_MSG(0 <= k && k < dim, "FieldExtractor: Invalid slice dim {}", k);
+            slice_dim = k;
+            slice_pos = pos;
+            return *this;
+        }
+
+        /// \brief Set the name of the extracted field. Defaults to the name of the expression
+        auto& setName(const std::string& n) {
+            name = n;
+            return *this;
+        }
+
+        /// \brief The range of the samples in the index space of the expression
+        [[nodiscard]] auto getSampleRange() const {
+            f->prepare();
+            auto r = f->accessibleRange;
+            r.stride = stride;
+            if (slice_dim >= 0) {
+                OP_ASSERT_MSG(r.start[slice_dim] <= slice_pos && slice_pos < r.end[slice_dim],
+                              "FieldExtractor: Slice {} out of range {}", slice_pos, r.toString());
+                r = r.slice(slice_dim, slice_pos);
+                r.stride[slice_dim] = 1;
+            }
+            r.reValidPace();
+            return r;
+        }
+
+        /// \brief Evaluate the samples & gather them into a field on the master rank
+        [[nodiscard]] field_type extract() const {
+            auto r = getSampleRange();
+            // samples per dim & the local box in the sample index space
+            std::array<int, dim> n;
+            DS::Range<dim> box;
+            const auto& local = f->localRange;
+            auto ceil_div = [](int a, int b) { return a > 0 ? (a + b - 1) / b : 0; };
+            for (auto k = 0; k < dim; ++k) {
+                n[k] = ceil_div(r.end[k] - r.start[k], r.stride[k]);
+                box.start[k] = std::min(n[k], ceil_div(local.start[k] - r.start[k], r.stride[k]));
+                box.end[k] = std::max(box.start[k],
+                                      std::min(n[k], ceil_div(local.end[k] - r.start[k], r.stride[k])));
+            }
+            box.reValidPace();
+            std::vector<elem_type> values(box.count());
+            if (!values.empty()) {
+                rangeFor(box, [&](auto&& j) {
+                    std::size_t pos = 0, s = 1;
+                    DS::MDIndex<dim> i;
+                    for (auto k = 0; k < dim; ++k) {
+                        pos += (j[k] - box.start[k]) * s;
+                        s *= box.end[k] - box.start[k];
+                        i[k] = r.start[k] + j[k] * r.stride[k];
+                    }
+                    values[pos] = f->evalAt(i);
+                });
+            }
+
+            // the mesh nodes are the sample points
+            const auto& m = f->getMesh();
+            const auto& loc = f->loc;
+            auto builder = MeshBuilder<mesh_type>();
+            builder.newMesh(n).setStart(std::array<int, dim> {}).setPadWidth(0);
+            for (auto k = 0; k < dim; ++k)
+                builder.setMeshOfDim(k, [&](Index j) {
+                    auto i = r.start[k] + j * r.stride[k];
+                    return loc[k] == LocOnMesh::Corner ? m.x(k, i) : Math::mid(m.x(k, i), m.x(k, i + 1));
+                });
+            auto ret = ExprBuilder<field_type>()
+                               .setName(name.empty() ? f->getName() : name)
+                               .setMesh(builder.build())
+                               .setLoc(LocOnMesh::Corner)
+                               .build();
+            internal::gatherSamples(box, values, [&](const DS::Range<dim>& b, const elem_type* p) {
+                rangeFor_s(b, [&](auto&& j) { ret[j] = *p++; });
+            });
+            return ret;
+        }
+
+    private:
+        const E* f;
+        std::array<int, dim> stride;
+        int slice_dim = -1, slice_pos = 0;
+        std::string name;
+    };
+
+    /// \brief Extract the plane at index \p pos normal to dim \p k of \p f
+    template <CartesianFieldExprType E>
+    auto makeSlice(const E& f, int k, int pos) {
+        std::array<int, OpFlow::internal::CartesianFieldExprTrait<E>::dim> stride;
+        stride.fill(1);
+        return std::move(FieldExtractor<E>(f, stride).setSlice(k, pos));
+    }
+
+    /// \brief Extract every \p stride -th point of \p f along each dim
+    template <CartesianFieldExprType E>
+    auto makeDownsample(const E& f, int stride) {
+        std::array<int, OpFlow::internal::CartesianFieldExprTrait<E>::dim> s;
+        s.fill(stride);
+        return FieldExtractor<E>(f, s);
+    }
+
+    /// \brief Extract every stride[k]-th point of \p f along dim k
+    template <CartesianFieldExprType E, std::size_t d>
+    auto makeDownsample(const E& f, const std::array<int, d>& stride) {
+        return FieldExtractor<E>(f, stride);
+    }
+
+    /// \brief Multi-linear interpolation of a Cartesian field expression at a set of probe points
+    /// \details The interpolation stencil of each probe is located on first use. Each rank
+    /// interpolates with the stencil points within its local range only (the others taken as zero);
+    /// since the interpolation is linear in the values, the probe value is the sum of the ranks'
+    /// partial values, which is formed on the master rank. Probes outside of the accessible range
+    /// are extrapolated from its nearest cell.
+    /// \note The probe set refers to the expression, which must outlive it.
+    template <CartesianFieldExprType E>
+    struct ProbeSet {
+        using elem_type = typename OpFlow::internal::CartesianFieldExprTrait<E>::elem_type;
+        static constexpr auto dim = OpFlow::internal::CartesianFieldExprTrait<E>::dim;
+        using point_type = std::array<Real, dim>;
+        static_assert(dim <= 3, "ProbeSet: Only 1D, 2D & 3D fields are supported");
+
+        ProbeSet(const E& f, std::vector<point_type> points) : f(&f), points(std::move(points)) {}
+
+        [[nodiscard]] const auto& getPoints() const { return points; }
+
+        /// \brief Interpolate the probes. Collective; only the master rank's result is valid
+        [[nodiscard]] std::vector<elem_type> sample() const {
+            f->prepare();
+            if (stencils.size() != points.size()) locate();
+            const auto& local = f->localRange;
+            std::vector<elem_type> partial(points.size());
+            for (auto p = 0; p < points.size(); ++p) {
+                const auto& s = stencils[p];
+                auto at = [&](int corner) {
+                    DS::MDIndex<dim> i;
+                    for (auto k = 0; k < dim; ++k) {
+                        i[k] = s.lower[k] + ((corner >> k) & 1);
+                        if (i[k] < local.start[k] || i[k] >= local.end[k]) return elem_type(0);
+                    }
+                    return elem_type(f->evalAt(i));
+                };
+                if constexpr (dim == 1)
+                    partial[p] = Math::Interpolator1D::intp(s.x1[0], at(0), s.x2[0], at(1), points[p][0]);
+                else if constexpr (dim == 2)
+                    partial[p] = Math::Interpolator2D::biLinearIntp(s.x1[0], s.x2[0], s.x1[1], s.x2[1], at(0),
+                                                                    at(1), at(2), at(3), points[p][0],
+                                                                    points[p][1]);
+                else
+                    partial[p] = Math::Interpolator3D::triLinearIntp(
+                            s.x1[0], s.x2[0], s.x1[1], s.x2[1], s.x1[2], s.x2[2], at(0), at(4), at(2), at(6),
+                            at(1), at(5), at(3), at(7), points[p][0], points[p][1], points[p][2]);
+            }
+            std::vector<elem_type> ret(points.size());
+            DS::Range<1> box(std::array {0}, std::array {int(points.size())});
+            internal::gatherSamples(box, partial, [&](const DS::Range<1>&, const elem_type* v) {
+                for (auto p = 0; p < ret.size(); ++p) ret[p] += v[p];
+            });
+            return ret;
+        }
+
+        /// \brief Append the probes' values at time \p t as a row of the ASCII table at \p path
+        /// \details The table starts with a header listing the probe points, followed by one row per
+        /// call holding the time & the value of each probe. Only the master rank writes.
+        void dump(const std::string& path, const TimeStamp& t) const {
+            auto values = sample();
+            if (getWorkerId() != 0) return;
+            auto exists = std::filesystem::exists(path);
+            std::unique_ptr<std::FILE, internal::FileCloser> file(std::fopen(path.c_str(), "a"));
+            OP_ASSERT_MSG(file, "ProbeSet: Cannot open {}", path);
+            std::string out;
+            if (!exists) {
+                out += std::format("# Probes of {}\n", f->getName());
+                for (auto p = 0; p < points.size(); ++p) {
+                    out += std::format("# {}:", p);
+                    for (auto x : points[p]) out += std::format(" {}", x);
+                    out += '\n';
+                }
+            }
+            out += std::format("{}", t.time);
+            for (const auto& v : values) out += std::format(" {}", v);
+            out += '\n';
+            std::fwrite(out.data(), 1, out.size(), file.get());
+        }
+
+    private:
+        struct Stencil {
+            std::array<int, dim> lower;
+            std::array<Real, dim> x1, x2;
+        };
+
+        // find for each probe the cell of sample points containing it, by binary search per dim
+        void locate() const {
+            const auto& m = f->getMesh();
+            const auto& loc = f->loc;
+            const auto& r = f->accessibleRange;
+            stencils.resize(points.size());
+            for (auto k = 0; k < dim; ++k) {
+                std::vector<Real> x(r.end[k] - r.start[k]);
+                for (auto i = r.start[k]; i < r.end[k]; ++i)
+                    x[i - r.start[k]] = loc[k] == LocOnMesh::Corner ? m.x(k, i)
+                                                                    : Math::mid(m.x(k, i), m.x(k, i + 1));
+                OP_ASSERT_MSG(x.size() >= 2, "ProbeSet: Too few points along dim {} to interpolate", k);
+                for (auto p = 0; p < points.size(); ++p) {
+                    auto pos = std::upper_bound(x.begin(), x.end(), points[p][k]) - x.begin() - 1;
+                    pos = std::clamp<long>(pos, 0, x.size() - 2);
+                    stencils[p].lower[k] = r.start[k] + pos;
+                    stencils[p].x1[k] = x[pos];
+                    stencils[p].x2[k] = x[pos + 1];
+                }
+            }
+        }
+
+        const E* f;
+        std::vector<point_type> points;
+        mutable std::vector<Stencil> stencils;
+    };
+}// namespace OpFlow::Utils
+
+#endif//OPFLOW_EXTRACTORS_HPP
@@ -18,11 +18,15 @@
 #include "Utils/Writers/FieldStream.hpp"
 #include <format>
 #ifndef OPFLOW_INSIDE_MODULE
+#include <algorithm>
+#include <cstddef>
 #include <cstdlib>
 #include <filesystem>
 #include <fstream>
 #include <string>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 #endif
 #ifdef OPFLOW_WITH_HDF5
 #ifndef OPFLOW_INSIDE_MODULE
@@ -40,6 +44,19 @@ OPFLOW_MODULE_EXPORT namespace OpFlow::Utils {
         };
     }// namespace internal
 
+    /// \brief Filters applied to chunked HDF5 datasets
+    enum class H5Filter { None, Deflate, SZip };
+
+    /// \brief HDF5 field stream
+    /// \note
+    /// Two file layouts are supported:
+    /// - Grouped (default): each time stamp is a group /T={time} holding the datasets {name} and the
+    ///   mesh coordinates {name}_x{i}. Unchanged mesh coordinates are hard linked to the ones of the
+    ///   previous step instead of being written again.
+    /// - Time series (setTimeSeries(true)): each field is a dataset /{name} with an extendible leading
+    ///   time dimension, appended at every dump. The time stamps are kept in /{name}_time and the mesh
+    ///   coordinates are written once to /{name}_x{i}.
+    /// The reader detects the layout of the file.
     struct H5Stream : FieldStream<H5Stream> {
         H5Stream() = default;
         H5Stream(const H5Stream&) = delete;
@@ -49,8 +66,11 @@ OPFLOW_MODULE_EXPORT namespace OpFlow::Utils {
               file(other.file), current_group(other.current_group),
 #endif
               time(other.time), first_run(other.first_run), file_inited(other.file_inited),
-              group_inited(other.group_inited), fixed_mesh(other.fixed_mesh), write_mesh(other.write_mesh),
-              mode(other.mode), separate_file(other.separate_file)
+              group_inited(other.group_inited), fixed_mesh(other.fixed_mesh),
+              separate_file(other.separate_file), time_series(other.time_series), chunked(other.chunked),
+              collective(other.collective), filter(other.filter), filter_level(other.filter_level),
+              aggregators(other.aggregators), cb_buffer_size(other.cb_buffer_size), mode(other.mode),
+              buffer(std::move(other.buffer)), mesh_cache(std::move(other.mesh_cache))
 #ifdef OPFLOW_WITH_MPI
               ,
               mpi_comm(other.mpi_comm)
@@ -80,9 +100,25 @@ OPFLOW_MODULE_EXPORT namespace OpFlow::Utils {
                 filename += ext;
             }
 #if defined(OPFLOW_WITH_MPI) && defined(OPFLOW_DISTRIBUTE_MODEL_MPI)
-            MPI_Info info = MPI_INFO_NULL;
+            // collective buffering hints for the MPI-IO layer
+            MPI_Info info;
+            MPI_Info_create(&info);
+            if (aggregators > 0) {
+                MPI_Info_set(info, "cb_nodes", std::to_string(aggregators).c_str());
+                MPI_Info_set(info, "romio_cb_write", "enable");
+                MPI_Info_set(info, "romio_cb_read", "enable");
+            }
+            if (cb_buffer_size > 0)
+                MPI_Info_set(info, "cb_buffer_size", std::to_string(cb_buffer_size).c_str());
             auto fapl_id = H5Pcreate(H5P_FILE_ACCESS);
             H5Pset_fapl_mpio(fapl_id, mpi_comm, info);
+#if H5_VERSION_GE(1, 10, 0)
+            if (collective) {
+                H5Pset_all_coll_metadata_ops(fapl_id, true);
+                H5Pset_coll_metadata_write(fapl_id, true);
+            }
+#endif
+            MPI_Info_free(&info);
             auto fcpl_id = H5P_DEFAULT;
 #else
             auto fcpl_id = H5P_DEFAULT;
@@ -94,6 +130,7 @@ OPFLOW_MODULE_EXPORT namespace OpFlow::Utils {
             OP_ASSERT_MSG(file >= 0, "HDF5Stream: cannot open file {}", filename);
             H5Pclose(fapl_id);
             file_inited = true;
+            mesh_cache.clear();
 #else
             OP_MPI_MASTER_WARN("H5Stream not enabled.");
 #endif
@@ -131,6 +168,7 @@ OPFLOW_MODULE_EXPORT namespace OpFlow::Utils {
                 close();
                 open();
             }
+            if (time_series) return *this;
             // create a new group
             if (!first_run) {
                 H5Gclose(current_group);
@@ -160,6 +198,41 @@ OPFLOW_MODULE_EXPORT namespace OpFlow::Utils {
 
         void setNumberingTypeImpl(NumberingType type) { numberingType = type; }
 
+        /// \brief Append each dump to an extendible time series dataset per field
+        void setTimeSeries(bool o) {
+            OP_ASSERT_MSG(!group_inited, "H5Stream error: Layout must be set before the first dump");
+            time_series = o;
+        }
+
+        /// \brief Create chunked datasets
+        /// \details Chunks follow the smallest subdomain of the ranks, so that a chunk crosses at most one
+        /// rank boundary per dimension, and are halved along their longest extent until they're at most
+        /// max_chunk_bytes large.
+        void setChunked(bool o) { chunked = o; }
+
+        /// \brief Compress the datasets with \p f. Implies chunked datasets
+        /// \param level The deflate level in [1, 9]; ignored for other filters
+        void setCompression(H5Filter f, int level = 4) {
+            filter = f;
+            filter_level = level;
+            if (f != H5Filter::None) chunked = true;
+        }
+
+        /// \brief Use collective (default) or independent MPI-IO transfers
+        void setCollective(bool o) { collective = o; }
+
+        /// \brief Set the number of MPI-IO aggregators & the collective buffer size in bytes
+        /// \details The hints take effect when the file is (re)opened; if nothing has been written to
+        /// the current file yet, it's reopened immediately.
+        void setAggregators(int n, std::size_t buffer_size = 0) {
+            aggregators = n;
+            cb_buffer_size = buffer_size;
+            if (file_inited && (mode & StreamOut) && first_run && mesh_cache.empty()) {
+                close();
+                open();
+            }
+        }
+
 #if defined(OPFLOW_WITH_MPI) && defined(OPFLOW_DISTRIBUTE_MODEL_MPI)
         void setMPIComm(MPI_Comm comm) { mpi_comm = comm; }
 #endif
@@ -180,16 +253,116 @@ OPFLOW_MODULE_EXPORT namespace OpFlow::Utils {
         std::string static commonSuffix() { return ".h5"; }
 
     private:
+#ifdef OPFLOW_WITH_HDF5
+        template <typename T>
+        static hid_t h5Type() {
+            hid_t datatype;
+            if constexpr (std::is_same_v<T, int>) datatype = H5Tcopy(H5T_NATIVE_INT);
+            else if constexpr (std::is_same_v<T, float>)
+                datatype = H5Tcopy(H5T_NATIVE_FLOAT);
+            else if constexpr (std::is_same_v<T, double>)
+                datatype = H5Tcopy(H5T_NATIVE_DOUBLE);
+            else
+                OP_CRITICAL("H5Stream fatal error: Field's element type not supported.");
+            H5Tset_order(datatype, H5T_ORDER_LE);
+            return datatype;
+        }
+
+        // dataset creation property list of a rank-n dataset with chunk extends
+        hid_t createDCPL(int n, const hsize_t* chunk) const {
+            auto dcpl = H5Pcreate(H5P_DATASET_CREATE);
+            // every element is written, so skip writing the fill value
+            H5Pset_fill_time(dcpl, H5D_FILL_TIME_NEVER);
+            if (chunk) {
+                if (H5Pset_chunk(dcpl, n, chunk) < 0) {
+                    OP_CRITICAL("H5Stream: cannot set chunk extends {}",
+                                Serializer::serialize(std::vector<hsize_t>(chunk, chunk + n)));
+                    OP_ABORT;
+                }
+                if (filter == H5Filter::Deflate) {
+                    H5Pset_shuffle(dcpl);
+                    H5Pset_deflate(dcpl, filter_level);
+                } else if (filter == H5Filter::SZip) {
+                    if (H5Zfilter_avail(H5Z_FILTER_SZIP) > 0) H5Pset_szip(dcpl, H5_SZIP_NN_OPTION_MASK, 16);
+                    else
+                        OP_WARN("H5Stream: szip filter not available. Data is written uncompressed.");
+                }
+            }
+            return dcpl;
+        }
+
+        hid_t createXferPlist() const {
+            auto plist_id = H5Pcreate(H5P_DATASET_XFER);
+#if defined(OPFLOW_WITH_MPI) && defined(OPFLOW_DISTRIBUTE_MODEL_MPI)
+            H5Pset_dxpl_mpio(plist_id, collective ? H5FD_MPIO_COLLECTIVE : H5FD_MPIO_INDEPENDENT);
+#endif
+            return plist_id;
+        }
+
+        // write the coordinates x to path, or hard link them to the last written identical ones
+        void writeMesh(const std::string& key, const std::string& name, const std::vector<double>& x) {
+            auto iter = mesh_cache.find(key);
+            if (iter != mesh_cache.end() && iter->second.second == x) {
+                if (iter->second.first != name)
+                    H5Lcreate_hard(file, iter->second.first.c_str(), file, name.c_str(), H5P_DEFAULT,
+                                   H5P_DEFAULT);
+                return;
+            }
+            hsize_t size = x.size();
+            auto dataspace = H5Screate_simple(1, &size, NULL);
+            auto dataset = H5Dcreate(file, name.c_str(), H5T_NATIVE_DOUBLE, dataspace, H5P_DEFAULT,
+                                     H5P_DEFAULT, H5P_DEFAULT);
+            H5Dwrite(dataset, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, x.data());
+            H5Dclose(dataset);
+            H5Sclose(dataspace);
+            mesh_cache[key] = {name, x};
+        }
+
+        // find the index of the current time in a time series
+        hsize_t findTimeIndex(const std::string& name) {
+            auto dataset = H5Dopen(file, std::format("/{}_time", name).c_str(), H5P_DEFAULT);
+            OP_ASSERT_MSG(dataset >= 0, "HDF5Stream: cannot open time series of {}", name);
+            auto space = H5Dget_space(dataset);
+            hsize_t nt;
+            H5Sget_simple_extent_dims(space, &nt, NULL);
+            std::vector<double> times(nt);
+            H5Dread(dataset, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, times.data());
+            H5Sclose(space);
+            H5Dclose(dataset);
+            // match as the group names do
+            auto target = std::format("{}", time.time);
+            auto iter = std::find_if(times.begin(), times.end(),
+                                     [&](double t) { return std::format("{}", t) == target; });
+            OP_ASSERT_MSG(iter != times.end(), "HDF5Stream: time {} not found in time series of {}", target,
+                          name);
+            return iter - times.begin();
+        }
+#endif
+
+        template <typename T>
+        auto* getBuffer(std::size_t n) {
+            if (buffer.size() < n * sizeof(T)) buffer.resize(n * sizeof(T));
+            return reinterpret_cast<T*>(buffer.data());
+        }
+
         std::string path;
 #ifdef OPFLOW_WITH_HDF5
         hid_t file, current_group;
 #endif
         TimeStamp time {0};
         bool first_run = true, file_inited = false, group_inited = false, fixed_mesh = false,
-             write_mesh = true, separate_file = false;
+             separate_file = false, time_series = false, chunked = false, collective = true;
+        static constexpr std::size_t max_chunk_bytes = 4 << 20;
+        H5Filter filter = H5Filter::None;
+        int filter_level = 4, aggregators = 0;
+        std::size_t cb_buffer_size = 0;
         NumberingType numberingType = NumberingType::ByTime;
         int dump_count = 0;
         unsigned int mode;
+        // transposition buffer, reused across dumps
+        std::vector<std::byte> buffer;
+        // last written mesh coordinates of each field & dim, with their dataset paths
+        std::unordered_map<std::string, std::pair<std::string, std::vector<double>>> mesh_cache;
 #ifdef OPFLOW_WITH_MPI
         MPI_Comm mpi_comm = MPI_COMM_WORLD;
 #endif
@@ -200,95 +373,161 @@ OPFLOW_MODULE_EXPORT namespace OpFlow::Utils {
 #ifdef OPFLOW_WITH_HDF5
         constexpr auto dim = OpFlow::internal::ExprTrait<T>::dim;
         using elem_type = typename OpFlow::internal::ExprTrait<T>::elem_type;
+        static_assert(Meta::Numerical<elem_type>);
 
-        if (!group_inited) *this << TimeStamp(0);
+        if (!time_series && !group_inited) *this << TimeStamp(0);
         f.prepare();
 
-        // write mesh (only the master worker does this)
-        if (write_mesh) {
-            std::string mesh_name[dim];
-            for (auto i = 0; i < dim; ++i)
-                mesh_name[i] = std::format("/T={}/{}_x{}", time.time, f.getName(), i);
-            std::vector<double> x_buffer;
-            for (auto i = 0; i < dim; ++i) {
-                // write each dim's mesh vector
-                x_buffer.resize(f.accessibleRange.end[i] - f.accessibleRange.start[i]);
-                auto iter = x_buffer.begin();
-                for (auto j = f.accessibleRange.start[i]; j < f.accessibleRange.end[i]; ++j, ++iter) {
-                    if (f.loc[i] == LocOnMesh::Corner) {
-                        *iter = f.getMesh().x(i, j);
-                    } else {
-                        *iter = (f.getMesh().x(i, j) + f.getMesh().x(i, j + 1)) / 2.;
-                    }
+        // write mesh
+        for (auto i = 0; i < dim; ++i) {
+            auto key = std::format("{}_x{}", f.getName(), i);
+            if ((fixed_mesh || time_series) && mesh_cache.contains(key)) continue;
+            std::vector<double> x(f.accessibleRange.end[i] - f.accessibleRange.start[i]);
+            auto iter = x.begin();
+            for (auto j = f.accessibleRange.start[i]; j < f.accessibleRange.end[i]; ++j, ++iter) {
+                if (f.loc[i] == LocOnMesh::Corner) {
+                    *iter = f.getMesh().x(i, j);
+                } else {
+                    *iter = (f.getMesh().x(i, j) + f.getMesh().x(i, j + 1)) / 2.;
                 }
-                hsize_t size = x_buffer.size();
-                auto dataspace = H5Screate_simple(1, &size, NULL);
-                auto dataset = H5Dcreate(file, mesh_name[i].c_str(), H5T_NATIVE_DOUBLE, dataspace,
-                                         H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
-                H5Dwrite(dataset, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, x_buffer.data());
-                H5Dclose(dataset);
-                H5Sclose(dataspace);
-                if (fixed_mesh) write_mesh = false;
             }
+            writeMesh(key, time_series ? "/" + key : std::format("/T={}/{}", time.time, key), x);
         }
         // write field
         {
-            // calculate the dim info of the data set
+            // calculate the dim info of the data set. The leading dim is time in time series mode
+            // and has extend 1 for the slab of this dump
+            constexpr int rank = dim + 1;
             auto extends = f.localRange.getExtends();
-            auto inv_ext = extends;
             auto global_extends = f.accessibleRange.getExtends();
-            hsize_t h_extends[dim], h_global_extends[dim];
+            hsize_t h_extends[rank], h_global_extends[rank], h_max_extends[rank], h_chunk[rank],
+                    h_offset[rank];
+            h_extends[0] = h_global_extends[0] = h_chunk[0] = 1;
+            h_max_extends[0] = H5S_UNLIMITED;
+            h_offset[0] = 0;
             for (auto i = 0; i < dim; ++i) {
-                // column-major to row-major transpose
-                inv_ext[i] = extends[dim - i - 1];
-                h_extends[i] = extends[i];
-                h_global_extends[i] = global_extends[i];
+                h_extends[i + 1] = extends[i];
+                h_global_extends[i + 1] = h_max_extends[i + 1] = global_extends[i];
+                h_offset[i + 1] = f.localRange.start[i] - f.accessibleRange.start[i];
+                // chunks follow the ranks' local extents. The dataset is created collectively, so the
+                // chunk must be the same on all ranks: take the smallest subdomain of the split map
+                h_chunk[i + 1] = extends[i];
+                for (const auto& r : f.getSplitMap())
+                    if (r.end[i] > r.start[i])
+                        h_chunk[i + 1] = std::min<hsize_t>(h_chunk[i + 1], r.end[i] - r.start[i]);
+                h_chunk[i + 1] = std::clamp<hsize_t>(h_chunk[i + 1], 1, global_extends[i]);
+            }
+            // cap the chunk size, so that the filters & the chunk cache work on bounded buffers
+            auto chunk_bytes = [&] {
+                std::size_t b = sizeof(elem_type);
+                for (auto i = 1; i < rank; ++i) b *= h_chunk[i];
+                return b;
+            };
+            while (chunk_bytes() > max_chunk_bytes) {
+                auto longest = std::max_element(h_chunk + 1, h_chunk + rank);
+                *longest = (*longest + 1) / 2;
             }
-            DS::PlainTensor<elem_type, dim> buffer(inv_ext);
-            DS::MDIndex<dim> _offset;
-            for (auto i = 0; i < dim; ++i) _offset[i] = f.localRange.start[i];
+
+            // transpose column-major to row-major into the persistent buffer
+            auto* buf = getBuffer<elem_type>(f.localRange.count());
             rangeFor(f.localRange, [&](auto&& i) {
-                auto idx = i - _offset;
-                buffer[idx.flip()] = f.evalAt(i);
+                std::size_t offset = 0;
+                for (auto k = 0; k < dim; ++k) offset = offset * extends[k] + (i[k] - f.localRange.start[k]);
+                buf[offset] = f.evalAt(i);
             });
-            auto dataspace = H5Screate_simple(OpFlow::internal::ExprTrait<T>::dim, h_global_extends, NULL);
-            static_assert(Meta::Numerical<typename OpFlow::internal::ExprTrait<T>::elem_type>);
-            hid_t datatype;
 
-            if constexpr (std::is_same_v<elem_type, int>) datatype = H5Tcopy(H5T_NATIVE_INT);
-            else if constexpr (std::is_same_v<elem_type, float>)
-                datatype = H5Tcopy(H5T_NATIVE_FLOAT);
-            else if constexpr (std::is_same_v<elem_type, double>)
-                datatype = H5Tcopy(H5T_NATIVE_DOUBLE);
-            else
-                OP_CRITICAL("H5Stream fatal error: Field's element type not supported.");
-            H5Tset_order(datatype, H5T_ORDER_LE);
-
-            // create a new data set
-            std::string dataset_name = std::format("/T={}/{}", time.time, f.getName());
-            auto dataset = H5Dcreate(file, dataset_name.c_str(), datatype, dataspace, H5P_DEFAULT,
-                                     H5P_DEFAULT, H5P_DEFAULT);
-#if defined(OPFLOW_WITH_MPI) && defined(OPFLOW_DISTRIBUTE_MODEL_MPI)
+            auto datatype = h5Type<elem_type>();
+            hid_t dataset;
+            if (time_series) {
+                // append a slab to the time series
+                auto dataset_name = std::format("/{}", f.getName());
+                if (H5Lexists(file, dataset_name.c_str(), H5P_DEFAULT) > 0) {
+                    dataset = H5Dopen(file, dataset_name.c_str(), H5P_DEFAULT);
+                    auto space = H5Dget_space(dataset);
+                    H5Sget_simple_extent_dims(space, h_global_extends, NULL);
+                    H5Sclose(space);
+                    h_offset[0] = h_global_extends[0];
+                    h_global_extends[0]++;
+                    H5Dset_extent(dataset, h_global_extends);
+                } else {
+                    auto dataspace = H5Screate_simple(rank, h_global_extends, h_max_extends);
+                    auto dcpl = createDCPL(rank, h_chunk);
+                    dataset = H5Dcreate(file, dataset_name.c_str(), datatype, dataspace, H5P_DEFAULT, dcpl,
+                                        H5P_DEFAULT);
+                    if (dataset < 0) {
+                        OP_CRITICAL("H5Stream: cannot create data set {}", dataset_name);
+                        OP_ABORT;
+                    }
+                    H5Pclose(dcpl);
+                    H5Sclose(dataspace);
+                }
+                // append the time stamp
+                auto time_name = std::format("/{}_time", f.getName());
+                hid_t time_set;
+                hsize_t nt = h_offset[0] + 1, t_max = H5S_UNLIMITED, t_chunk = 64, t_offset = h_offset[0],
+                        t_count = 1;
+                if (nt > 1) {
+                    time_set = H5Dopen(file, time_name.c_str(), H5P_DEFAULT);
+                    H5Dset_extent(time_set, &nt);
+                } else {
+                    auto dataspace = H5Screate_simple(1, &nt, &t_max);
+                    auto dcpl = H5Pcreate(H5P_DATASET_CREATE);
+                    if (H5Pset_chunk(dcpl, 1, &t_chunk) < 0) {
+                        OP_CRITICAL("H5Stream: cannot set chunk extends of data set {}", time_name);
+                        OP_ABORT;
+                    }
+                    time_set = H5Dcreate(file, time_name.c_str(), H5T_NATIVE_DOUBLE, dataspace, H5P_DEFAULT,
+                                         dcpl, H5P_DEFAULT);
+                    if (time_set < 0) {
+                        OP_CRITICAL("H5Stream: cannot create data set {}", time_name);
+                        OP_ABORT;
+                    }
+                    H5Pclose(dcpl);
+                    H5Sclose(dataspace);
+                }
+                auto t_file_space = H5Dget_space(time_set);
+                H5Sselect_hyperslab(t_file_space, H5S_SELECT_SET, &t_offset, NULL, &t_count, NULL);
+                auto t_mem_space = H5Screate_simple(1, &t_count, NULL);
+                auto t_plist = createXferPlist();
+                double t = time.time;
+                if (H5Dwrite(time_set, H5T_NATIVE_DOUBLE, t_mem_space, t_file_space, t_plist, &t) < 0) {
+                    OP_CRITICAL("H5Stream: cannot write data set {}", time_name);
+                    OP_ABORT;
+                }
+                H5Pclose(t_plist);
+                H5Sclose(t_mem_space);
+                H5Sclose(t_file_space);
+                H5Dclose(time_set);
+            } else {
+                // create a new data set
+                auto dataset_name = std::format("/T={}/{}", time.time, f.getName());
+                auto dataspace = H5Screate_simple(dim, h_global_extends + 1, NULL);
+                auto dcpl = createDCPL(dim, chunked ? h_chunk + 1 : nullptr);
+                dataset = H5Dcreate(file, dataset_name.c_str(), datatype, dataspace, H5P_DEFAULT, dcpl,
+                                    H5P_DEFAULT);
+                if (dataset < 0) {
+                    OP_CRITICAL("H5Stream: cannot create data set {}", dataset_name);
+                    OP_ABORT;
+                }
+                H5Pclose(dcpl);
+                H5Sclose(dataspace);
+            }
             // write data by hyperslab
-            auto mem_space = H5Screate_simple(OpFlow::internal::ExprTrait<T>::dim, h_extends, NULL);
+            auto off = time_series ? 0 : 1;
+            auto mem_space = H5Screate_simple(rank - off, h_extends + off, NULL);
             auto file_space = H5Dget_space(dataset);
-            hsize_t offset[dim];
-            for (auto i = 0; i < dim; ++i) offset[i] = f.localRange.start[i];
-            H5Sselect_hyperslab(file_space, H5S_SELECT_SET, offset, NULL, h_extends, NULL);
-            auto plist_id = H5Pcreate(H5P_DATASET_XFER);
-            H5Pset_dxpl_mpio(plist_id, H5FD_MPIO_INDEPENDENT);
-            H5Dwrite(dataset, datatype, mem_space, file_space, plist_id, buffer.raw());
+            H5Sselect_hyperslab(file_space, H5S_SELECT_SET, h_offset + off, NULL, h_extends + off, NULL);
+            auto plist_id = createXferPlist();
+            if (H5Dwrite(dataset, datatype, mem_space, file_space, plist_id, buf) < 0) {
+                OP_CRITICAL("H5Stream: cannot write data set of field {}", f.getName());
+                OP_ABORT;
+            }
+            // close everything
             H5Sclose(mem_space);
             H5Sclose(file_space);
             H5Pclose(plist_id);
             H5Tclose(datatype);
-#else
-            // write data
-            H5Dwrite(dataset, datatype, H5S_ALL, H5S_ALL, H5P_DEFAULT, buffer.raw());
-#endif
-            // close everything
             H5Dclose(dataset);
-            H5Sclose(dataspace);
         }
 #else
         OP_MPI_MASTER_WARN("H5Stream not enabled.");
@@ -302,66 +541,55 @@ OPFLOW_MODULE_EXPORT namespace OpFlow::Utils {
 #ifdef OPFLOW_WITH_HDF5
         constexpr auto dim = OpFlow::internal::ExprTrait<T>::dim;
         using elem_type = typename OpFlow::internal::ExprTrait<T>::elem_type;
+        static_assert(Meta::Numerical<elem_type>);
 
         // calculate the dim info of the data set
+        constexpr int rank = dim + 1;
         auto extends = f.localRange.getExtends();
-        auto inv_ext = extends;
-        auto global_extends = f.accessibleRange.getExtends();
-        hsize_t h_extends[dim], h_global_extends[dim];
+        hsize_t h_extends[rank], h_offset[rank];
+        h_extends[0] = 1;
+        h_offset[0] = 0;
         for (auto i = 0; i < dim; ++i) {
-            // column-major to row-major transpose
-            inv_ext[i] = extends[dim - i - 1];
-            h_extends[i] = extends[i];
-            h_global_extends[i] = global_extends[i];
+            h_extends[i + 1] = extends[i];
+            h_offset[i + 1] = f.localRange.start[i] - f.accessibleRange.start[i];
         }
-        DS::PlainTensor<elem_type, dim> buffer(inv_ext);
-        DS::MDIndex<dim> _offset;
-        for (auto i = 0; i < dim; ++i) _offset[i] = f.localRange.start[i];
-        auto dataspace = H5Screate_simple(OpFlow::internal::ExprTrait<T>::dim, h_global_extends, NULL);
-        static_assert(Meta::Numerical<typename OpFlow::internal::ExprTrait<T>::elem_type>);
-        hid_t datatype;
-
-        if constexpr (std::is_same_v<elem_type, int>) datatype = H5Tcopy(H5T_NATIVE_INT);
-        else if constexpr (std::is_same_v<elem_type, float>)
-            datatype = H5Tcopy(H5T_NATIVE_FLOAT);
-        else if constexpr (std::is_same_v<elem_type, double>)
-            datatype = H5Tcopy(H5T_NATIVE_DOUBLE);
-        else
-            OP_CRITICAL("H5Stream fatal error: Field's element type not supported.");
-        H5Tset_order(datatype, H5T_ORDER_LE);
+        auto datatype = h5Type<elem_type>();
 
         // open the dataset
         std::string dataset_name = std::format("/T={}/{}", time.time, f.getName());
+        auto off = 1;
+        if (H5Lexists(file, std::format("/T={}", time.time).c_str(), H5P_DEFAULT) <= 0
+            && H5Lexists(file, std::format("/{}_time", f.getName()).c_str(), H5P_DEFAULT) > 0) {
+            // time series layout
+            dataset_name = std::format("/{}", f.getName());
+            h_offset[0] = findTimeIndex(f.getName());
+            off = 0;
+        }
         auto dataset = H5Dopen(file, dataset_name.c_str(), H5P_DEFAULT);
         OP_ASSERT_MSG(dataset >= 0, "HDF5Stream: cannot open data set with name {}", dataset_name);
-#if defined(OPFLOW_WITH_MPI) && defined(OPFLOW_DISTRIBUTE_MODEL_MPI)
         // read data by hyperslab
-        auto mem_space = H5Screate_simple(OpFlow::internal::ExprTrait<T>::dim, h_extends, NULL);
+        auto mem_space = H5Screate_simple(rank - off, h_extends + off, NULL);
         OP_ASSERT_MSG(mem_space >= 0, "HDF5Stream: cannot create mem space with extends {}",
-                      Serializer::serialize(h_extends));
+                      Serializer::serialize(extends));
         auto file_space = H5Dget_space(dataset);
         OP_ASSERT_MSG(file_space >= 0, "HDF5Stream: cannot get space with dataset {}", dataset_name);
-        hsize_t offset[dim];
-        for (auto i = 0; i < dim; ++i) offset[i] = f.localRange.start[i];
-        OP_ASSERT(H5Sselect_hyperslab(file_space, H5S_SELECT_SET, offset, NULL, h_extends, NULL) >= 0);
-        auto plist_id = H5Pcreate(H5P_DATASET_XFER);
-        H5Pset_dxpl_mpio(plist_id, H5FD_MPIO_INDEPENDENT);
-        OP_ASSERT(H5Dread(dataset, datatype, mem_space, file_space, plist_id, buffer.raw()) >= 0);
+        OP_ASSERT(H5Sselect_hyperslab(file_space, H5S_SELECT_SET, h_offset + off, NULL, h_extends + off, NULL)
+                  >= 0);
+        auto plist_id = createXferPlist();
+        auto* buf = getBuffer<elem_type>(f.localRange.count());
+        OP_ASSERT(H5Dread(dataset, datatype, mem_space, file_space, plist_id, buf) >= 0);
         H5Sclose(mem_space);
         H5Sclose(file_space);
         H5Pclose(plist_id);
-#else
-        // read data
-        H5Dread(dataset, datatype, H5S_ALL, H5S_ALL, H5P_DEFAULT, buffer.raw());
-#endif
+        H5Tclose(datatype);
+        H5Dclose(dataset);
         // copy data from buffer to field
+        f.detachStorage();
         rangeFor(f.localRange, [&](auto&& i) {
-            auto idx = i - _offset;
-            f[i] = buffer[idx.flip()];
+            std::size_t offset = 0;
+            for (auto k = 0; k < dim; ++k) offset = offset * extends[k] + (i[k] - f.localRange.start[k]);
+            f[i] = buf[offset];
         });
-        // close everything
-        H5Dclose(dataset);
-        H5Sclose(dataspace);
         f.updatePadding();
 #else
         OP_MPI_MASTER_WARN("H5Stream not enabled.");
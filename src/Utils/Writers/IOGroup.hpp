@@ -13,10 +13,17 @@
 #ifndef OPFLOW_IOGROUP_HPP
 #define OPFLOW_IOGROUP_HPP
 
+#include "Core/Field/MeshBased/Structured/CartesianField.hpp"
 #include "Utils/RandomStringGenerator.hpp"
+#include "Utils/Writers/AsyncWriter.hpp"
 #include "Utils/Writers/Streams.hpp"
 #ifndef OPFLOW_INSIDE_MODULE
+#include <exception>
+#include <memory>
+#include <optional>
 #include <tuple>
+#include <variant>
+#include <vector>
 #endif
 
 OPFLOW_MODULE_EXPORT namespace OpFlow::Utils {
@@ -28,8 +35,57 @@ OPFLOW_MODULE_EXPORT namespace OpFlow::Utils {
         virtual void fixedMesh() {}
         virtual void dumpToSeparateFile() {}
         virtual void setNumberingType(NumberingType type) = 0;
+        virtual void setAsync(bool o, int depth = 2) {}
+        virtual void flush() {}
     };
 
+    namespace internal {
+        /// \brief The type holding a copy of an output expression's values
+        /// \details Concrete fields are snapshotted by copy, which shares the storage until the field is
+        /// written next; Cartesian expressions are evaluated into a CartesianField of the same element &
+        /// mesh type. Other expressions can't be snapshotted.
+        template <typename E>
+        struct IOSnapshotTrait {
+            using type = std::monostate;
+            static constexpr bool supported = false;
+        };
+
+        template <typename E>
+        requires(Meta::RealType<E>::isConcrete() && std::copy_constructible<Meta::RealType<E>>) struct
+                IOSnapshotTrait<E> {
+            using type = Meta::RealType<E>;
+            static constexpr bool supported = true;
+        };
+
+        template <CartesianFieldExprType E>
+        requires(!Meta::RealType<E>::isConcrete()) struct IOSnapshotTrait<E> {
+            using type = CartesianField<typename OpFlow::internal::ExprTrait<E>::elem_type,
+                                        typename OpFlow::internal::ExprTrait<E>::mesh_type>;
+            static constexpr bool supported = true;
+        };
+
+        template <typename S, typename E>
+        void takeIOSnapshot(std::optional<S>& snap, E& e) {
+            if constexpr (CartesianFieldType<S> && !Meta::RealType<E>::isConcrete()) {
+                bool first = !snap;
+                if (first) {
+                    // set up the field's props & storage by the first assignment
+                    snap.emplace();
+                    *snap = e;
+                }
+                // reuse the storage; fill the whole local range including the boundaries. The first
+                // assignment has filled the assignable range already, which is not evaluated twice
+                snap->detachStorage();
+                auto filled = DS::commonRange(snap->assignableRange, snap->localRange);
+                rangeFor(snap->localRange, [&](auto&& i) {
+                    if (!first || !DS::inRange(filled, i)) (*snap)[i] = e.evalAt(i);
+                });
+            } else {
+                snap.emplace(e);
+            }
+        }
+    }// namespace internal
+
     template <typename Stream, typename... Exprs>
     struct IOGroup : public virtual IOGroupInterface {
 
@@ -39,6 +95,15 @@ OPFLOW_MODULE_EXPORT namespace OpFlow::Utils {
         explicit IOGroup(const std::string& root, unsigned int mode, auto&&... es)
             : root(root), mode(mode), exprs(OP_PERFECT_FOWD(es)...) {}
 
+        ~IOGroup() override {
+            // a failed pending write must not escape the destructor
+            try {
+                if (writer) writer->flush();
+            } catch (const std::exception& e) {
+                OP_ERROR("IOGroup: pending async dump failed: {}", e.what());
+            } catch (...) { OP_ERROR("IOGroup: pending async dump failed with an unknown error"); }
+        }
+
         void init() {
             if (inited) return;
             if (allInOne && sizeof...(Exprs) > 1) {
@@ -83,11 +148,28 @@ OPFLOW_MODULE_EXPORT namespace OpFlow::Utils {
                 OP_CRITICAL("IOGroup: stream does not support set numbering type.");
                 OP_ABORT;
             }
+            if (async) {
+                writer = std::make_shared<AsyncWriter>(depth);
+                slots.resize(depth);
+            }
             inited = true;
         }
 
         void dump(const TimeStamp& t) override {
             if (!inited) init();
+            if constexpr (WStreamType<Stream> && async_supported) {
+                if (async) {
+                    // wait until the oldest staging slot has been written out, then refill it
+                    writer->wait(slots.size() - 1);
+                    auto& slot = slots[next_slot];
+                    next_slot = (next_slot + 1) % slots.size();
+                    Meta::static_for<sizeof...(Exprs)>([&]<int k>(Meta::int_<k>) {
+                        internal::takeIOSnapshot(std::get<k>(slot), std::get<k>(exprs));
+                    });
+                    writer->submit([this, &slot, t] { write(t, slot); });
+                    return;
+                }
+            }
             if constexpr (WStreamType<Stream>) {
                 if (allInOne) {
                     streams.back() << t;
@@ -107,6 +189,7 @@ OPFLOW_MODULE_EXPORT namespace OpFlow::Utils {
 
         void read(const TimeStamp& t) override {
             if (!inited) init();
+            flush();
             if constexpr (RStreamType<Stream>)
                 Meta::static_for<sizeof...(Exprs)>([&]<int k>(Meta::int_<k>) {
                     // there may be temporal expressions for output
@@ -127,6 +210,27 @@ OPFLOW_MODULE_EXPORT namespace OpFlow::Utils {
 
         void setNumberingType(NumberingType type) override { numberingType = type; }
 
+        /// \brief Write in a background I/O thread
+        /// \details Each dump() copies the expressions' values into one of \p depth staging slots and
+        /// returns; the formatting & writing is done by a dedicated thread. dump() only blocks when all
+        /// slots are still pending. The group must not be moved while writes are pending.
+        /// \param o Enable async mode. Must be set before the first dump
+        /// \param depth Number of staging slots, i.e., the maximum number of pending dumps
+        void setAsync(bool o, int depth = 2) override {
+            OP_ASSERT_MSG(!inited, "IOGroup: async mode must be set before the first dump.");
+            if (o && !async_supported) {
+                OP_CRITICAL("IOGroup: expressions cannot be snapshotted for async output.");
+                OP_ABORT;
+            }
+            async = o;
+            this->depth = std::max(depth, 1);
+        }
+
+        /// \brief Block until all pending async dumps are written
+        void flush() override {
+            if (writer) writer->flush();
+        }
+
         std::tuple<typename std::conditional_t<
                 RStreamType<Stream>,
                 typename std::conditional_t<Exprs::isConcrete(), Meta::RealType<Exprs>&,
@@ -140,6 +244,25 @@ OPFLOW_MODULE_EXPORT namespace OpFlow::Utils {
         unsigned int mode;
         NumberingType numberingType = NumberingType::ByTime;
         bool inited = false;
+
+    private:
+        constexpr static bool async_supported = (internal::IOSnapshotTrait<Exprs>::supported && ...);
+        using Slot = std::tuple<std::optional<typename internal::IOSnapshotTrait<Exprs>::type>...>;
+
+        void write(const TimeStamp& t, Slot& slot) {
+            if (allInOne) {
+                streams.back() << t;
+                std::apply([&](auto&... s) { streams.back().dumpMultiple(*s...); }, slot);
+            } else {
+                Meta::static_for<sizeof...(Exprs)>(
+                        [&]<int k>(Meta::int_<k>) { streams[k] << t << *std::get<k>(slot); });
+            }
+        }
+
+        bool async = false;
+        int depth = 2, next_slot = 0;
+        std::vector<Slot> slots;
+        std::shared_ptr<AsyncWriter> writer;
     };
 
     template <typename Stream, ExprType... Exprs>
@@ -0,0 +1,217 @@
+//  ----------------------------------------------------------------------------
+//
+//  Copyright (c) 2019 - 2026 by the OpFlow developers
+//
+//  This file is part of OpFlow.
+//
+//  OpFlow is free software and is distributed under the MPL v2.0 license.
+//  The full text of the license can be found in the file LICENSE at the top
+//  level directory of OpFlow.
+//
+//  ----------------------------------------------------------------------------
+
+#ifndef OPFLOW_MAPPEDRAWBINARYSTREAM_HPP
+#define OPFLOW_MAPPEDRAWBINARYSTREAM_HPP
+
+#include "Core/Environment.hpp"
+#include "Core/Field/MeshBased/Structured/CartesianField.hpp"
+#include "Utils/Allocator/MappedAllocator.hpp"
+#include "Utils/Writers/FieldStream.hpp"
+#include "Utils/Writers/RawBinaryStream.hpp"
+#include <format>
+#ifdef OPFLOW_HAS_MMAN_H
+#ifndef OPFLOW_INSIDE_MODULE
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <tbb/tbb.h>
+#include <unistd.h>
+#include <vector>
+#endif
+#endif
+
+OPFLOW_MODULE_EXPORT namespace OpFlow::Utils {
+#ifdef OPFLOW_HAS_MMAN_H
+    struct MappedRawBinaryIStream;
+
+    namespace internal {
+        template <>
+        struct StreamTrait<MappedRawBinaryIStream> {
+            static constexpr auto mode_flag = StreamIn | StreamBinary;
+        };
+
+        template <typename F>
+        struct MappedStorageTrait : std::false_type {};
+        template <typename D, typename M, int d, std::size_t align>
+        struct MappedStorageTrait<CartesianField<D, M, DS::PlainTensor<D, d, MappedAllocator<D, align>>>>
+            : std::true_type {
+            using allocator = MappedAllocator<D, align>;
+        };
+    }// namespace internal
+
+    /// \brief Memory mapped reader of the .cart files written by RawBinaryOStream
+    /// \details The file is mapped privately and the header is validated against the field as
+    /// RawBinaryIStream does. If the field's storage uses MappedAllocator, has no padding and the data
+    /// segment is suitably aligned, the mapped pages are adopted as the field's storage without any copy;
+    /// the pages are only read in on first touch and writes stay private to the process. Otherwise the
+    /// data segment is copied into the field with a parallel memcpy.
+    struct MappedRawBinaryIStream : FieldStream<MappedRawBinaryIStream> {
+        MappedRawBinaryIStream() = default;
+        explicit MappedRawBinaryIStream(const std::filesystem::path& path) : path(path.parent_path()) {}
+
+        void setCounterTo(int c) { count = c; }
+
+        // field readers
+        template <CartesianFieldType T>
+        MappedRawBinaryIStream& operator>>(T& f);
+
+    private:
+        std::filesystem::path path;
+        int count = 0;
+        static constexpr std::size_t copy_grain = 1 << 20;
+    };
+
+    template <CartesianFieldType T>
+    MappedRawBinaryIStream& MappedRawBinaryIStream::operator>>(T& f) {
+        static int nproc = 1, rank = 0;
+        constexpr auto dim = OpFlow::internal::CartesianFieldExprTrait<T>::dim;
+        using elem_type = typename OpFlow::internal::CartesianFieldExprTrait<T>::elem_type;
+
+        if (!getGlobalParallelPlan().singleNodeMode()) {
+            nproc = getGlobalParallelPlan().distributed_workers_count;
+            rank = getWorkerId();
+        }
+        std::string root;
+        if (nproc > 1) root = std::format("{}/{}_{}_{}.cart", path.string(), f.getName(), count, rank);
+        else
+            root = std::format("{}/{}_{}.cart", path.string(), f.getName(), count);
+
+        int fd = open(root.c_str(), O_RDONLY);
+        OP_ASSERT_MSG(fd != -1, "Field read error: Cannot open file {}", root);
+        struct stat st;
+        fstat(fd, &st);
+        std::size_t length = st.st_size;
+        OP_ASSERT_MSG(length > 0, "Field read error: Empty file {}", root);
+        auto* base = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        close(fd);
+        OP_ASSERT_MSG(base != MAP_FAILED, "Field read error: mmap failed for file {}", root);
+
+        // bounds checked cursor over the header
+        const auto* cursor = static_cast<const std::byte*>(base);
+        const auto* file_end = cursor + length;
+        auto take = [&](void* dst, std::size_t n) {
+            OP_ASSERT_MSG(cursor + n <= file_end, "Field read error: Unexpected end of file {}", root);
+            std::memcpy(dst, cursor, n);
+            cursor += n;
+        };
+
+        // check meta infos are match
+        int name_len;
+        take(&name_len, sizeof(int));
+        OP_ASSERT_MSG(name_len >= 0, "Field read error: Invalid name length {}", name_len);
+        std::string name(name_len, '\0');
+        take(name.data(), name_len);
+        OP_EXPECT_MSG(name == f.getName(), "Field's name {} in file is different from dst field {}", name,
+                      f.getName());
+        int f_dim;
+        take(&f_dim, sizeof(int));
+        OP_ASSERT_MSG(f_dim == dim, "Field read error: Dim mismatch {} != {}", f_dim, dim);
+        int f_nproc;
+        take(&f_nproc, sizeof(int));
+        OP_ASSERT_MSG(f_nproc == nproc, "Field read error: data set nproc mismatch {} != {}", f_nproc, nproc);
+
+        // zone info
+        double t;
+        take(&t, sizeof(double));
+        auto m_range = f.mesh.getRange();
+        for (auto i = 0; i < dim; ++i) {
+            take(&m_range.start[i], sizeof(m_range.start[i]));
+            take(&m_range.end[i], sizeof(m_range.end[i]));
+        }
+        OP_ASSERT_MSG(m_range == f.mesh.getRange(), "Field read error: Mesh range mismatch {} != {}",
+                      m_range.toString(), f.mesh.getRange().toString());
+        std::vector<Real> x;
+        for (auto i = 0; i < dim; ++i) {
+            x.resize(m_range.end[i] - m_range.start[i]);
+            take(x.data(), sizeof(Real) * x.size());
+            for (auto j = m_range.start[i]; j < m_range.end[i]; ++j) {
+                OP_ASSERT_MSG(x[j - m_range.start[i]] == f.mesh.x(i, j),
+                              "Field read error: Mesh coordinate mismatch at x[{}][{}] {} != {}", i, j,
+                              x[j - m_range.start[i]], f.mesh.x(i, j));
+            }
+        }
+        auto f_range = f.accessibleRange;
+        for (auto i = 0; i < dim; ++i) {
+            take(&f_range.start[i], sizeof(f_range.start[i]));
+            take(&f_range.end[i], sizeof(f_range.end[i]));
+        }
+        OP_ASSERT_MSG(f_range == f.accessibleRange,
+                      "Field read error: Field accessible range mismatch {} != {}", f_range.toString(),
+                      f.accessibleRange.toString());
+        for (auto i = 0; i < dim; ++i) {
+            take(&f_range.start[i], sizeof(f_range.start[i]));
+            take(&f_range.end[i], sizeof(f_range.end[i]));
+        }
+        OP_ASSERT_MSG(f_range == f.localRange, "Field read error: Field local range mismatch {} != {}",
+                      f_range.toString(), f.localRange.toString());
+        std::size_t n_elem = f.localRange.count();
+        OP_ASSERT_MSG(cursor + n_elem * sizeof(elem_type) <= file_end,
+                      "Field read error: Data segment of file {} is truncated", root);
+
+        auto* src = const_cast<std::byte*>(cursor);
+        bool adopted = false;
+        if constexpr (internal::MappedStorageTrait<T>::value) {
+            using Alloc = typename internal::MappedStorageTrait<T>::allocator;
+            if (f.padding == 0 && reinterpret_cast<std::uintptr_t>(src) % alignof(elem_type) == 0) {
+                // hand the mapping over to the allocator; it's unmapped when the storage is released
+                Alloc::stage(reinterpret_cast<elem_type*>(src), n_elem, base, length);
+                f.reallocStorage();
+                adopted = Alloc::unstage();
+            }
+        }
+        if (!adopted) {
+            f.detachStorage();
+            if constexpr (!internal::AddressableStorage<T>) {
+                // packed storage is copied through the staging buffer of forEachStorageRun
+                internal::forEachStorageRun(f, f.localRange, [&](auto* ptr, std::size_t n) {
+                    std::memcpy(ptr, src, n * sizeof(*ptr));
+                    src += n * sizeof(*ptr);
+                });
+            } else {
+                // collect the storage runs & copy them in chunks of copy_grain bytes
+                std::vector<std::pair<elem_type*, std::size_t>> runs;
+                internal::forEachStorageRun(f, f.localRange,
+                                            [&](auto* ptr, std::size_t n) { runs.emplace_back(ptr, n); });
+                struct Chunk {
+                    std::byte* dst;
+                    const std::byte* src;
+                    std::size_t bytes;
+                };
+                std::vector<Chunk> chunks;
+                for (auto [ptr, n] : runs) {
+                    auto bytes = n * sizeof(elem_type);
+                    auto* dst = reinterpret_cast<std::byte*>(ptr);
+                    for (std::size_t k = 0; k < bytes; k += copy_grain)
+                        chunks.push_back(Chunk {dst + k, src + k, std::min(copy_grain, bytes - k)});
+                    src += bytes;
+                }
+                tbb::task_arena arena(getGlobalParallelPlan().shared_memory_workers_count);
+                arena.execute([&]() {
+                    tbb::parallel_for(std::size_t(0), chunks.size(), [&](std::size_t i) {
+                        std::memcpy(chunks[i].dst, chunks[i].src, chunks[i].bytes);
+                    });
+                });
+            }
+            munmap(base, length);
+        }
+        f.updatePadding();
+        count++;
+        return *this;
+    }
+#endif
+}// namespace OpFlow::Utils
+
+#endif//OPFLOW_MAPPEDRAWBINARYSTREAM_HPP
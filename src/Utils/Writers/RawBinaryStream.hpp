@@ -18,10 +18,14 @@
 #include "Utils/Writers/FieldStream.hpp"
 #include <format>
 #ifndef OPFLOW_INSIDE_MODULE
+#include <cstddef>
 #include <cstdlib>
 #include <filesystem>
 #include <fstream>
+#include <memory>
 #include <string>
+#include <type_traits>
+#include <vector>
 #endif
 
 OPFLOW_MODULE_EXPORT namespace OpFlow::Utils {
@@ -37,6 +41,51 @@ OPFLOW_MODULE_EXPORT namespace OpFlow::Utils {
         struct StreamTrait<RawBinaryIStream> {
             static constexpr auto mode_flag = StreamIn | StreamBinary;
         };
+
+        /// \brief Whether the elements of field \p F are addressable, i.e., its storage isn't packed
+        template <typename F>
+        concept AddressableStorage = requires(F& f) {
+            requires std::is_lvalue_reference_v<decltype(f[f.localRange.first()])>;
+        };
+
+        /// \brief Visit the contiguous runs of a field's storage covering \p range
+        /// \details Rows along dim 0 are contiguous in PlainTensor storage. Consecutive rows are merged
+        /// into one run when no padding lies between them, so an unpadded slab is a single run.
+        /// Runs are visited in the order of rangeFor_s over \p range. Packed storage, e.g., of bools,
+        /// is staged through a buffer of elements visited as one run, filled from a const \p f & written
+        /// back to a non-const one. The pointers are only valid within func.
+        /// \param func Functor called as func(ptr, n) for each run of n elements starting at ptr
+        void forEachStorageRun(auto& f, const auto& range, auto&& func) {
+            auto row_len = range.end[0] - range.start[0];
+            if (range.count() <= 0 || row_len <= 0) return;
+            using F = std::remove_reference_t<decltype(f)>;
+            if constexpr (!AddressableStorage<F>) {
+                using elem_type = typename OpFlow::internal::CartesianFieldExprTrait<
+                        std::remove_const_t<F>>::elem_type;
+                auto buf = std::make_unique<elem_type[]>(range.count());
+                std::size_t k = 0;
+                if constexpr (std::is_const_v<F>) rangeFor_s(range, [&](auto&& i) { buf[k++] = f[i]; });
+                func(buf.get(), (std::size_t) range.count());
+                if constexpr (!std::is_const_v<F>) rangeFor_s(range, [&](auto&& i) { f[i] = buf[k++]; });
+            } else {
+                auto rows = range;
+                rows.end[0] = rows.start[0] + 1;
+                rows.reValidPace();
+                decltype(&f[range.first()]) run = nullptr;
+                std::size_t run_len = 0;
+                rangeFor_s(rows, [&](auto&& i) {
+                    auto ptr = &f[i];
+                    if (run && ptr == run + run_len) {
+                        run_len += row_len;
+                    } else {
+                        if (run) func(run, run_len);
+                        run = ptr;
+                        run_len = row_len;
+                    }
+                });
+                func(run, run_len);
+            }
+        }
     }// namespace internal
 
     struct RawBinaryOStream : FieldStream<RawBinaryOStream> {
@@ -59,6 +108,9 @@ OPFLOW_MODULE_EXPORT namespace OpFlow::Utils {
         std::filesystem::path path;
         TimeStamp time {};
         int count = 0;
+        static constexpr std::size_t buffer_size = 1 << 20;
+        // staging buffer for evaluating expressions, reused across writes
+        std::vector<std::byte> buffer;
     };
 
     struct RawBinaryIStream : FieldStream<RawBinaryIStream> {
@@ -127,10 +179,10 @@ OPFLOW_MODULE_EXPORT namespace OpFlow::Utils {
             fwrite(&mesh_range.end[i], sizeof(mesh_range.end[i]), 1, data);
         }
         for (auto i = 0; i < dim; ++i) {
-            for (auto j = mesh_range.start[i]; j < mesh_range.end[i]; ++j) {
-                auto x = mesh.x(i, j);
-                fwrite(&x, sizeof(x), 1, data);
-            }
+            std::vector<Meta::RealType<decltype(mesh.x(i, mesh_range.start[i]))>> x;
+            x.reserve(mesh_range.end[i] - mesh_range.start[i]);
+            for (auto j = mesh_range.start[i]; j < mesh_range.end[i]; ++j) x.push_back(mesh.x(i, j));
+            fwrite(x.data(), sizeof(x[0]), x.size(), data);
         }
         for (auto i = 0; i < dim; ++i) {
             fwrite(&f.accessibleRange.start[i], sizeof(f.accessibleRange.start[i]), 1, data);
@@ -140,10 +192,28 @@ OPFLOW_MODULE_EXPORT namespace OpFlow::Utils {
             fwrite(&f.localRange.start[i], sizeof(f.localRange.start[i]), 1, data);
             fwrite(&f.localRange.end[i], sizeof(f.localRange.end[i]), 1, data);
         }
-        rangeFor_s(f.localRange, [&](auto&& i) {
-            auto x = f.evalSafeAt(i);
-            fwrite(&x, sizeof(x), 1, data);
-        });
+        if constexpr (CartesianFieldType<T>) {
+            // write straight from the field's storage
+            internal::forEachStorageRun(f, f.localRange, [&](auto* ptr, std::size_t n) {
+                fwrite(ptr, sizeof(*ptr), n, data);
+            });
+        } else {
+            // evaluate the expression into the staging buffer chunk by chunk
+            using elem_type = Meta::RealType<decltype(f.evalAt(f.localRange.first()))>;
+            const std::size_t cap = std::max<std::size_t>(
+                    buffer_size / sizeof(elem_type), f.localRange.end[0] - f.localRange.start[0]);
+            if (buffer.size() < cap * sizeof(elem_type)) buffer.resize(cap * sizeof(elem_type));
+            auto* buf = reinterpret_cast<elem_type*>(buffer.data());
+            std::size_t n = 0;
+            rangeFor_s(f.localRange, [&](auto&& i) {
+                buf[n++] = f.evalAt(i);
+                if (n == cap) {
+                    fwrite(buf, sizeof(elem_type), n, data);
+                    n = 0;
+                }
+            });
+            if (n > 0) fwrite(buf, sizeof(elem_type), n, data);
+        }
         fclose(data);
         count++;
         return *this;
@@ -193,13 +263,14 @@ OPFLOW_MODULE_EXPORT namespace OpFlow::Utils {
         }
         OP_ASSERT_MSG(m_range == f.mesh.getRange(), "Field read error: Mesh range mismatch {} != {}",
                       m_range.toString(), f.mesh.getRange().toString());
-        Real dummy;
+        std::vector<Real> x;
         for (auto i = 0; i < dim; ++i) {
+            x.resize(m_range.end[i] - m_range.start[i]);
+            fread(x.data(), sizeof(Real), x.size(), data);
             for (auto j = m_range.start[i]; j < m_range.end[i]; ++j) {
-                fread(&dummy, sizeof(dummy), 1, data);
-                OP_ASSERT_MSG(dummy == f.mesh.x(i, j),
-                              "Field read error: Mesh coordinate mismatch at x[{}][{}] {} != {}", i, j, dummy,
-                              f.mesh.x(i, j));
+                OP_ASSERT_MSG(x[j - m_range.start[i]] == f.mesh.x(i, j),
+                              "Field read error: Mesh coordinate mismatch at x[{}][{}] {} != {}", i, j,
+                              x[j - m_range.start[i]], f.mesh.x(i, j));
             }
         }
         auto f_range = f.accessibleRange;
@@ -216,7 +287,9 @@ OPFLOW_MODULE_EXPORT namespace OpFlow::Utils {
         }
         OP_ASSERT_MSG(f_range == f.localRange, "Field read error: Field local range mismatch {} != {}",
                       f_range.toString(), f.localRange.toString());
-        rangeFor_s(f.localRange, [&](auto&& i) { fread(&f[i], sizeof(f[i]), 1, data); });
+        f.detachStorage();
+        internal::forEachStorageRun(f, f.localRange,
+                                    [&](auto* ptr, std::size_t n) { fread(ptr, sizeof(*ptr), n, data); });
         fclose(data);
         f.updatePadding();
         count++;
@@ -18,6 +18,7 @@
 #include "Core/Macros.hpp"
 #include "StreamTrait.hpp"
 #ifndef OPFLOW_INSIDE_MODULE
+#include <cstdio>
 #include <fstream>
 #include <functional>
 #include <iomanip>
@@ -44,6 +45,11 @@ OPFLOW_MODULE_EXPORT namespace OpFlow::Utils {
     };
 
     namespace internal {
+        /// \brief Deleter closing a C file handle owned by a std::unique_ptr
+        struct FileCloser {
+            void operator()(std::FILE* f) const { std::fclose(f); }
+        };
+
         template <typename Derived, bool in, bool out>
         struct StreamImpl;
 
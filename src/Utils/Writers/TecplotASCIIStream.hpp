@@ -17,9 +17,14 @@
 #include "Utils/Writers/FieldStream.hpp"
 #include <format>
 #ifndef OPFLOW_INSIDE_MODULE
+#include <algorithm>
+#include <charconv>
 #include <filesystem>
 #include <fstream>
+#include <memory>
 #include <string>
+#include <tbb/tbb.h>
+#include <vector>
 #endif
 
 OPFLOW_MODULE_EXPORT namespace OpFlow::Utils {
@@ -31,11 +36,15 @@ OPFLOW_MODULE_EXPORT namespace OpFlow::Utils {
             static constexpr auto mode_flag = StreamOut | StreamASCII;
         };
     }// namespace internal
+
+    /// \brief Tecplot ASCII stream
+    /// \details Values are formatted with std::to_chars in parallel over slabs of the output range, and
+    /// the formatted slabs are written in order with large writes. With setBinary(true) the same pipeline
+    /// gathers raw values instead and each dump is written to a Tecplot binary (.plt, v112) file named
+    /// like the separate file output.
     struct TecplotASCIIStream : FieldStream<TecplotASCIIStream> {
         TecplotASCIIStream() = default;
-        explicit TecplotASCIIStream(const std::string& path) : path(path) {
-            of.open(path, std::ofstream::out | std::ofstream::ate);
-        }
+        explicit TecplotASCIIStream(const std::string& path) : path(path) {}
 
         // settings
         auto& operator<<(const TimeStamp& t) {
@@ -56,15 +65,24 @@ OPFLOW_MODULE_EXPORT namespace OpFlow::Utils {
 
         void setNumberingTypeImpl(NumberingType type) { numberingType = type; }
 
+        /// \brief Write each dump to a Tecplot binary .plt file instead
+        void setBinary(bool o) { binary = o; }
+
         void reOpen(const std::string& new_path) {
             of.close();
             of.open(new_path, std::ofstream::out | std::ofstream::ate);
         }
 
+
         template <CartesianFieldExprType T>
         auto& operator<<(const T& f) {
             constexpr auto dim = OpFlow::internal::CartesianFieldExprTrait<T>::dim;
             f.prepare();
+            if (binary) {
+                dumpBinary(f.localRange, f.getMesh(), f.loc, std::format("Solution of {} ", f.getName()),
+                           std::vector<std::string> {f.getName()}, f);
+                return *this;
+            }
             if (separate_file) {
                 // add time stamp between filename and extension
                 std::string filename = path;
@@ -75,14 +93,15 @@ OPFLOW_MODULE_EXPORT namespace OpFlow::Utils {
                     filename += std::format("_{}", time.step.value());
                 filename += ext;
                 reOpen(filename);
-            }
+            } else
+                openOnce();
             if (of.tellp() == 0) {
-                of << std::format("TITLE = \"Solution of {} \"\n", f.name);
-                if constexpr (dim == 1) of << std::format("VARIABLES = {}, \"{}\"\n", R"("X")", f.name);
+                of << std::format("TITLE = \"Solution of {} \"\n", f.getName());
+                if constexpr (dim == 1) of << std::format("VARIABLES = {}, \"{}\"\n", R"("X")", f.getName());
                 else if constexpr (dim == 2)
-                    of << std::format("VARIABLES = {}, \"{}\"\n", R"("X", "Y")", f.name);
+                    of << std::format("VARIABLES = {}, \"{}\"\n", R"("X", "Y")", f.getName());
                 else if constexpr (dim == 3)
-                    of << std::format("VARIABLES = {}, \"{}\"\n", R"("X", "Y", "Z")", f.name);
+                    of << std::format("VARIABLES = {}, \"{}\"\n", R"("X", "Y", "Z")", f.getName());
             }
             of << "ZONE\n";
             of << "ZONETYPE = ORDERED DATAPACKING = BLOCK\n";
@@ -95,7 +114,6 @@ OPFLOW_MODULE_EXPORT namespace OpFlow::Utils {
                 of << std::format("I = {} J = {} K = {}\n", f.localRange.end[0] - f.localRange.start[0],
                                   f.localRange.end[1] - f.localRange.start[1],
                                   f.localRange.end[2] - f.localRange.start[2]);
-            of << std::scientific << std::setprecision(10);
             of << std::format("SOLUTIONTIME = {}\n", time.time);
             if (!writeMesh) {
                 if constexpr (dim == 1) of << "VARSHARELIST=([1]=1)\n";
@@ -104,16 +122,10 @@ OPFLOW_MODULE_EXPORT namespace OpFlow::Utils {
             } else {
                 auto m = f.getMesh();
                 const auto& loc = f.loc;
-                for (auto k = 0; k < dim; ++k) {
-                    if (loc[k] == LocOnMesh::Corner)
-                        rangeFor_s(f.localRange, [&](auto&& i) { of << m.x(k, i) << "\n"; });
-                    else
-                        rangeFor_s(f.localRange, [&](auto&& i) {
-                            of << Math::mid(m.x(k, i[k]), m.x(k, i[k] + 1)) << "\n";
-                        });
-                }
+                for (auto k = 0; k < dim; ++k)
+                    writeColumn(f.localRange, [&](auto&& i) { return coordinate(m, loc, k, i); });
             }
-            rangeFor_s(f.localRange, [&](auto&& i) { of << f.evalAt(i) << "\n"; });
+            writeColumn(f.localRange, [&](auto&& i) { return f.evalAt(i); });
 
             of.flush();
             if (!separate_file) writeMesh = fixed_mesh;
@@ -130,6 +142,8 @@ OPFLOW_MODULE_EXPORT namespace OpFlow::Utils {
                 auto fs_tuple = std::make_tuple(&fs...);
                 constexpr auto dim = OpFlow::internal::CartesianFieldExprTrait<Meta::firstOf_t<Ts...>>::dim;
                 (fs.prepare(), ...);
+                auto range = dumpLogicalRange ? maxCommonRange(std::vector {fs.logicalRange...})
+                                              : maxCommonRange(std::vector {fs.localRange...});
                 auto getName = [&](auto&& f) {
                     static int count = 0;
                     std::string name = f.getName();
@@ -139,6 +153,11 @@ OPFLOW_MODULE_EXPORT namespace OpFlow::Utils {
                     std::replace(name.begin(), name.end(), ',', '_');
                     return name;
                 };
+                if (binary) {
+                    dumpBinary(range, std::get<0>(fs_tuple)->getMesh(), std::get<0>(fs_tuple)->loc,
+                               "Solution of AllInOne", std::vector<std::string> {getName(fs)...}, fs...);
+                    return *this;
+                }
                 if (separate_file) {
                     // add time stamp between filename and extension
                     std::string filename = path;
@@ -149,7 +168,8 @@ OPFLOW_MODULE_EXPORT namespace OpFlow::Utils {
                         filename += std::format("_{}", time.step.value());
                     filename += ext;
                     reOpen(filename);
-                }
+                } else
+                    openOnce();
                 if (of.tellp() == 0) {
                     of << std::format("TITLE = \"Solution of AllInOne\"\n");
                     if constexpr (dim == 1)
@@ -167,8 +187,6 @@ OPFLOW_MODULE_EXPORT namespace OpFlow::Utils {
                 }
                 of << "ZONE\n";
                 of << "ZONETYPE = ORDERED DATAPACKING = BLOCK\n";
-                auto range = dumpLogicalRange ? maxCommonRange(std::vector {fs.logicalRange...})
-                                              : maxCommonRange(std::vector {fs.localRange...});
 
                 if constexpr (dim == 1) of << std::format("I = {}\n", range.end[0] - range.start[0]);
                 else if constexpr (dim == 2)
@@ -177,7 +195,6 @@ OPFLOW_MODULE_EXPORT namespace OpFlow::Utils {
                 else if constexpr (dim == 3)
                     of << std::format("I = {} J = {} K = {}\n", range.end[0] - range.start[0],
                                       range.end[1] - range.start[1], range.end[2] - range.start[2]);
-                of << std::scientific << std::setprecision(10);
                 of << std::format("SOLUTIONTIME = {}\n", time.time);
                 if (!writeMesh) {
                     if constexpr (dim == 1) of << "VARSHARELIST=([1]=1)\n";
@@ -186,17 +203,11 @@ OPFLOW_MODULE_EXPORT namespace OpFlow::Utils {
                 } else {
                     auto m = std::get<0>(fs_tuple)->getMesh();
                     const auto& loc = std::get<0>(fs_tuple)->loc;
-                    for (auto k = 0; k < dim; ++k) {
-                        if (loc[k] == LocOnMesh::Corner)
-                            rangeFor_s(range, [&](auto&& i) { of << m.x(k, i) << "\n"; });
-                        else
-                            rangeFor_s(range, [&](auto&& i) {
-                                of << Math::mid(m.x(k, i[k]), m.x(k, i[k] + 1)) << "\n";
-                            });
-                    }
+                    for (auto k = 0; k < dim; ++k)
+                        writeColumn(range, [&](auto&& i) { return coordinate(m, loc, k, i); });
                 }
                 Meta::static_for<sizeof...(fs)>([&]<int k>(Meta::int_<k>) {
-                    rangeFor_s(range, [&](auto&& i) { of << std::get<k>(fs_tuple)->evalAt(i) << "\n"; });
+                    writeColumn(range, [&](auto&& i) { return std::get<k>(fs_tuple)->evalAt(i); });
                 });
 
                 of.flush();
@@ -207,11 +218,177 @@ OPFLOW_MODULE_EXPORT namespace OpFlow::Utils {
         }
 
     private:
+        // the file at path is only created by the first ASCII dump, so binary output leaves no file there
+        void openOnce() {
+            if (!opened) reOpen(path);
+            opened = true;
+        }
+
+        static auto coordinate(const auto& m, const auto& loc, int k, const auto& i) {
+            return loc[k] == LocOnMesh::Corner ? m.x(k, i[k]) : Math::mid(m.x(k, i[k]), m.x(k, i[k] + 1));
+        }
+
+        // split range into slabs along the slowest dim, each of about slab_points points. Slabs are
+        // contiguous pieces of the output order of rangeFor_s
+        template <std::size_t d>
+        static auto getSlabs(const DS::Range<d>& range) {
+            std::vector<DS::Range<d>> slabs;
+            constexpr auto last = d - 1;
+            auto extent = range.end[last] - range.start[last];
+            if (range.count() <= 0 || extent <= 0) return slabs;
+            auto width = std::max<long long>(1, slab_points / (range.count() / extent));
+            for (auto s = range.start[last]; s < range.end[last]; s += width) {
+                auto slab = range;
+                slab.start[last] = s;
+                slab.end[last] = std::min<long long>(s + width, range.end[last]);
+                slab.reValidPace();
+                slabs.push_back(slab);
+            }
+            return slabs;
+        }
+
+        template <typename T>
+        static char* formatValue(char* first, char* last, T v) {
+            if constexpr (std::floating_point<T>)
+                return std::to_chars(first, last, v, std::chars_format::scientific, 10).ptr;
+            else if constexpr (std::same_as<T, bool>)
+                return std::to_chars(first, last, (int) v).ptr;
+            else
+                return std::to_chars(first, last, v).ptr;
+        }
+
+        // format valueAt(i) for i in range one per line
+        template <std::size_t d>
+        void writeColumn(const DS::Range<d>& range, auto&& valueAt) {
+            auto slabs = getSlabs(range);
+            tbb::task_arena arena(getGlobalParallelPlan().shared_memory_workers_count);
+            const auto batch = std::max<std::size_t>(4 * arena.max_concurrency(), 1);
+            if (chunks.size() < std::min(batch, slabs.size())) chunks.resize(std::min(batch, slabs.size()));
+            // format a batch of slabs in parallel, then write them in order
+            for (std::size_t b = 0; b < slabs.size(); b += batch) {
+                auto n = std::min(batch, slabs.size() - b);
+                arena.execute([&]() {
+                    tbb::parallel_for(std::size_t(0), n, [&](std::size_t s) {
+                        auto& chunk = chunks[s];
+                        std::size_t cap = slabs[b + s].count() * max_chars;
+                        if (chunk.cap < cap) {
+                            chunk.data = std::make_unique<char[]>(cap);
+                            chunk.cap = cap;
+                        }
+                        char *p = chunk.data.get(), *end = p + cap;
+                        rangeFor_s(slabs[b + s], [&](auto&& i) {
+                            p = formatValue(p, end, valueAt(i));
+                            *p++ = '\n';
+                        });
+                        chunk.size = p - chunk.data.get();
+                    });
+                });
+                for (std::size_t s = 0; s < n; ++s) of.write(chunks[s].data.get(), chunks[s].size);
+            }
+        }
+
+        // gather valueAt(i) for i in range into out in the order of rangeFor_s
+        template <typename T, std::size_t d>
+        static void gatherColumn(const DS::Range<d>& range, auto&& valueAt, T* out) {
+            auto slabs = getSlabs(range);
+            tbb::task_arena arena(getGlobalParallelPlan().shared_memory_workers_count);
+            arena.execute([&]() {
+                // points per unit of the slowest dim
+                auto stride = range.count() / (range.end[d - 1] - range.start[d - 1]);
+                tbb::parallel_for(std::size_t(0), slabs.size(), [&](std::size_t s) {
+                    auto* p = out + (slabs[s].start[d - 1] - range.start[d - 1]) * stride;
+                    rangeFor_s(slabs[s], [&](auto&& i) { *p++ = valueAt(i); });
+                });
+            });
+        }
+
+        /// \brief Write the zone of fs over range to a Tecplot binary (v112) file
+        template <std::size_t d, typename... Fs>
+        void dumpBinary(const DS::Range<d>& range, const auto& m, const auto& loc, const std::string& title,
+                        const std::vector<std::string>& names, const Fs&... fs) {
+            std::string filename = path;
+            std::string ext = std::filesystem::path(path).extension();
+            filename.erase(filename.end() - ext.size(), filename.end());
+            if (numberingType == NumberingType::ByTime) filename += std::format("_{:.6f}", time.time);
+            else {
+                OP_ASSERT_MSG(time.step, "TecplotASCIIStream: Must provide step number to postfix by step");
+                filename += std::format("_{}", time.step.value());
+            }
+            filename += ".plt";
+            std::ofstream os(filename, std::ofstream::out | std::ofstream::binary);
+            auto i32 = [&](int v) { os.write(reinterpret_cast<const char*>(&v), sizeof(v)); };
+            auto f32 = [&](float v) { os.write(reinterpret_cast<const char*>(&v), sizeof(v)); };
+            auto f64 = [&](double v) { os.write(reinterpret_cast<const char*>(&v), sizeof(v)); };
+            auto str = [&](const std::string& s) {
+                for (char c : s) i32(c);
+                i32(0);
+            };
+            constexpr const char* axis[] = {"X", "Y", "Z"};
+            constexpr auto n_vars = d + sizeof...(Fs);
+
+            // gather the columns; all variables are stored as double
+            const std::size_t n = range.count();
+            std::vector<double> columns(n_vars * n);
+            for (auto k = 0; k < d; ++k)
+                gatherColumn(range, [&](auto&& i) { return (double) coordinate(m, loc, k, i); },
+                             columns.data() + k * n);
+            {
+                auto k = d;
+                (gatherColumn(
+                         range, [&](auto&& i) { return (double) fs.evalAt(i); }, columns.data() + k++ * n),
+                 ...);
+            }
+
+            // header section
+            os.write("#!TDV112", 8);
+            i32(1);// byte order
+            i32(0);// file type: full
+            str(title);
+            i32(n_vars);
+            for (auto k = 0; k < d; ++k) str(axis[k]);
+            for (const auto& name : names) str(name);
+            f32(299.f);// zone marker
+            str("ZONE 001");
+            i32(-1);// parent zone
+            i32(1); // strand id
+            f64(time.time);
+            i32(-1);// zone color
+            i32(0); // zone type: ordered
+            i32(0); // var location: nodal
+            i32(0); // raw face neighbors
+            i32(0); // user defined face neighbor connections
+            for (auto k = 0; k < 3; ++k) i32(k < d ? range.end[k] - range.start[k] : 1);
+            i32(0);      // no aux data
+            f32(357.f);// end of header marker
+
+            // data section
+            f32(299.f);
+            for (auto k = 0; k < n_vars; ++k) i32(2);// double
+            i32(0);                                 // no passive variables
+            i32(0);                                 // no variable sharing
+            i32(-1);                                // no connectivity sharing
+            for (auto k = 0; k < n_vars; ++k) {
+                auto [min, max] = std::minmax_element(columns.begin() + k * n, columns.begin() + (k + 1) * n);
+                f64(n > 0 ? *min : 0.);
+                f64(n > 0 ? *max : 0.);
+            }
+            os.write(reinterpret_cast<const char*>(columns.data()), columns.size() * sizeof(double));
+        }
+
+        static constexpr std::size_t slab_points = 1 << 16, max_chars = 32;
+        struct Chunk {
+            std::unique_ptr<char[]> data;
+            std::size_t cap = 0, size = 0;
+        };
+
         std::string path;
         std::ofstream of;
         TimeStamp time {};
-        bool writeMesh = true, fixed_mesh = true, dumpLogicalRange = false, separate_file = false;
+        bool writeMesh = true, fixed_mesh = true, dumpLogicalRange = false, separate_file = false,
+             binary = false, opened = false;
         NumberingType numberingType = NumberingType::ByTime;
+        // per slab formatting buffers, reused across dumps
+        std::vector<Chunk> chunks;
     };
 }// namespace OpFlow::Utils
 #endif//OPFLOW_TECPLOTASCIISTREAM_HPP
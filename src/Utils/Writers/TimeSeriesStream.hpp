@@ -0,0 +1,602 @@
+//  ----------------------------------------------------------------------------
+//
+//  Copyright (c) 2019 - 2026 by the OpFlow developers
+//
+//  This file is part of OpFlow.
+//
+//  OpFlow is free software and is distributed under the MPL v2.0 license.
+//  The full text of the license can be found in the file LICENSE at the top
+//  level directory of OpFlow.
+//
+//  ----------------------------------------------------------------------------
+
+#ifndef OPFLOW_TIMESERIESSTREAM_HPP
+#define OPFLOW_TIMESERIESSTREAM_HPP
+
+#include "Core/Environment.hpp"
+#include "Core/Field/MeshBased/Structured/CartesianFieldExprTrait.hpp"
+#include "Utils/Writers/FieldStream.hpp"
+#include "Utils/Writers/RawBinaryStream.hpp"
+#include <format>
+#ifndef OPFLOW_INSIDE_MODULE
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#endif
+
+OPFLOW_MODULE_EXPORT namespace OpFlow::Utils {
+    struct TimeSeriesStream;
+
+    namespace internal {
+        template <>
+        struct StreamTrait<TimeSeriesStream> {
+            static constexpr auto mode_flag = StreamIn | StreamOut | StreamBinary;
+        };
+    }// namespace internal
+
+    /// \brief Log structured time series stream appending all dumps to one file
+    /// \details Every dumped field is appended as a record to the data file {stem}.opts, and an entry
+    /// keyed by the field's name, time & step pointing to the record is appended to the index file
+    /// {stem}.opts.idx. The data is flushed before the index entry is written, so the index never refers
+    /// to incomplete records. Records are read back at random with moveToTime() & operator>>.
+    /// With multiple ranks, either each rank appends to its own pair of files {stem}_{rank}.opts[.idx]
+    /// (default), or, with setAggregated(true) & MPI, all ranks append their records collectively to one
+    /// data file and the master rank keeps one index holding the offsets of all ranks.
+    /// \note A step or time is looked up exactly as it was written. If a field was dumped several times
+    /// at the same step or time, e.g. after a restart, the last record wins.
+    struct TimeSeriesStream : FieldStream<TimeSeriesStream> {
+        TimeSeriesStream() = default;
+        explicit TimeSeriesStream(const std::filesystem::path& path, unsigned int mode = StreamOut)
+            : path(path), mode(mode) {}
+
+        // time info
+        auto& operator<<(const TimeStamp& t) {
+            time = t;
+            if (numberingType == NumberingType::ByStep)
+                OP_ASSERT_MSG(time.step, "TimeSeriesStream: Must provide step number to postfix by step");
+            return *this;
+        }
+        auto& moveToTime(const TimeStamp& t) {
+            OP_ASSERT_MSG(mode & StreamIn,
+                          "TimeSeriesStream error: moveToTime can only be used under read mode");
+            time = t;
+            return *this;
+        }
+
+        void fixedMeshImpl() { fixed_mesh = true; }
+        // appending to one file is the point of this stream
+        void dumpToSeparateFileImpl() {}
+        void setNumberingTypeImpl(NumberingType type) { numberingType = type; }
+
+        /// \brief Append to the existing files instead of truncating them on the first dump
+        /// \details Records after the last indexed one, e.g. left by a crash, are discarded.
+        void setAppend(bool o) { append = o; }
+        /// \brief Write all ranks' records to one shared data file. Must be set before the first dump
+        void setAggregated(bool o) {
+            OP_ASSERT_MSG(!data, "TimeSeriesStream: Aggregated mode must be set before the first dump");
+            aggregated = o;
+        }
+
+        /// \brief Time stamps of all records of the field named \p name, in the order written
+        [[nodiscard]] std::vector<TimeStamp> getTimeStamps(const std::string& name) {
+            open();
+            std::vector<TimeStamp> ret;
+            for (const auto& e : entries)
+                if (e.name == name)
+                    ret.push_back(e.step >= 0 ? TimeStamp(e.time, e.step) : TimeStamp(e.time));
+            return ret;
+        }
+
+        // field writers
+        template <CartesianFieldExprType T>
+        TimeSeriesStream& operator<<(const T& f);
+
+        template <CartesianFieldExprType... Ts>
+        TimeSeriesStream& dumpMultiple(const Ts&... fs) {
+            return (*this << ... << fs);
+        }
+
+        // field readers
+        template <CartesianFieldType T>
+        TimeSeriesStream& operator>>(T& f);
+
+        std::string static commonSuffix() { return ".opts"; }
+
+    private:
+        struct Entry {
+            std::string name;
+            double time;
+            int step;
+            // offset & bytes of the record of each rank
+            std::vector<std::pair<std::uint64_t, std::uint64_t>> parts;
+        };
+
+        [[nodiscard]] bool isAggregated() const {
+#if defined(OPFLOW_WITH_MPI) && defined(OPFLOW_DISTRIBUTE_MODEL_MPI)
+            return aggregated && nproc > 1;
+#else
+            return false;
+#endif
+        }
+
+        [[nodiscard]] std::string fileName() const {
+            auto stem = path;
+            stem.replace_extension();
+            auto ret = stem.string();
+            if (nproc > 1 && !isAggregated()) ret += std::format("_{}", rank);
+            return ret + commonSuffix();
+        }
+
+        // open the files & load the index on first use
+        void open();
+        [[nodiscard]] bool isOpen() const {
+#if defined(OPFLOW_WITH_MPI) && defined(OPFLOW_DISTRIBUTE_MODEL_MPI)
+            return shared.fh != MPI_FILE_NULL;
+#else
+            return false;
+#endif
+        }
+        // load the index from its bytes; returns the bytes of the valid entries
+        std::size_t loadIndex(const std::vector<std::byte>& bytes);
+        void rebuildIndex();
+        void appendIndex(const Entry& e);
+        // position of the record of the field at the current time, or nullptr
+        const Entry* find(const std::string& name) const;
+
+        std::filesystem::path path;
+        TimeStamp time {};
+        unsigned int mode = StreamOut;
+        NumberingType numberingType = NumberingType::ByTime;
+        bool fixed_mesh = false, append = false, aggregated = false;
+        int nproc = 1, rank = 0;
+        std::unique_ptr<std::FILE, internal::FileCloser> data, index;
+#if defined(OPFLOW_WITH_MPI) && defined(OPFLOW_DISTRIBUTE_MODEL_MPI)
+        // collectively opened shared data file, closed on destruction
+        struct SharedFile {
+            MPI_File fh = MPI_FILE_NULL;
+            SharedFile() = default;
+            SharedFile(SharedFile&& o) noexcept : fh(std::exchange(o.fh, MPI_FILE_NULL)) {}
+            SharedFile& operator=(SharedFile&& o) noexcept {
+                std::swap(fh, o.fh);
+                return *this;
+            }
+            ~SharedFile() {
+                if (fh != MPI_FILE_NULL) MPI_File_close(&fh);
+            }
+        } shared;
+#endif
+        std::uint64_t end = 0;// end of the last indexed record
+        std::vector<Entry> entries;
+        // entry of each field keyed by time & by step
+        std::unordered_map<std::string, std::map<double, std::size_t>> by_time;
+        std::unordered_map<std::string, std::map<int, std::size_t>> by_step;
+        std::unordered_map<std::string, bool> mesh_written;
+        static constexpr std::size_t buffer_size = 1 << 20;
+        // staging buffer of a record, reused across writes
+        std::vector<std::byte> buffer;
+        static constexpr std::uint32_t magic = 0x53545046;// "FPTS"
+    };
+
+    inline void TimeSeriesStream::open() {
+        if (data || isOpen()) return;
+        if (!getGlobalParallelPlan().singleNodeMode()) {
+            nproc = getGlobalParallelPlan().distributed_workers_count;
+            rank = getWorkerId();
+        }
+        auto name = fileName();
+        auto idx_name = name + ".idx";
+        bool fresh = (mode & StreamOut) && !append;
+        // with a shared data file only the master rank touches the files; the others get its index
+        std::vector<std::byte> index_bytes;
+        if (!isAggregated() || rank == 0) {
+            if (!fresh && !std::filesystem::exists(name)) {
+                if (!(mode & StreamOut)) {
+                    OP_CRITICAL("TimeSeriesStream: Cannot open {}", name);
+                    OP_ABORT;
+                }
+                fresh = true;
+            }
+            if (fresh) {
+                data.reset(std::fopen(name.c_str(), "w+b"));
+                index.reset(std::fopen(idx_name.c_str(), "w+b"));
+                OP_ASSERT_MSG(data && index, "TimeSeriesStream: Cannot open {}", name);
+                std::fwrite(&magic, sizeof(magic), 1, data.get());
+                std::fwrite(&magic, sizeof(magic), 1, index.get());
+                std::fwrite(&nproc, sizeof(nproc), 1, index.get());
+                std::fflush(data.get());
+                std::fflush(index.get());
+                end = sizeof(magic);
+            } else {
+                data.reset(std::fopen(name.c_str(), mode & StreamOut ? "r+b" : "rb"));
+                OP_ASSERT_MSG(data, "TimeSeriesStream: Cannot open {}", name);
+                if (std::filesystem::exists(idx_name)) {
+                    index_bytes.resize(std::filesystem::file_size(idx_name));
+                    std::unique_ptr<std::FILE, internal::FileCloser> file(std::fopen(idx_name.c_str(), "rb"));
+                    OP_ASSERT_MSG(file, "TimeSeriesStream: Cannot open {}", idx_name);
+                    auto n = std::fread(index_bytes.data(), 1, index_bytes.size(), file.get());
+                    index_bytes.resize(n);
+                    auto valid = loadIndex(index_bytes);
+                    if (mode & StreamOut) {
+                        // drop a partially written trailing entry & the records after the last entry
+                        file.reset();
+                        std::filesystem::resize_file(idx_name, valid);
+                        if (!isAggregated()) std::filesystem::resize_file(name, end);
+                        index.reset(std::fopen(idx_name.c_str(), "r+b"));
+                    }
+                } else {
+                    OP_ASSERT_MSG(!isAggregated(), "TimeSeriesStream: Index {} of shared file is missing",
+                                  idx_name);
+                    OP_WARN("TimeSeriesStream: Index {} is missing. Rebuild it from the data", idx_name);
+                    rebuildIndex();
+                }
+            }
+        }
+#if defined(OPFLOW_WITH_MPI) && defined(OPFLOW_DISTRIBUTE_MODEL_MPI)
+        if (isAggregated()) {
+            std::uint64_t n = index_bytes.size();
+            MPI_Bcast(&n, 1, MPI_UINT64_T, 0, MPI_COMM_WORLD);
+            index_bytes.resize(n);
+            MPI_Bcast(index_bytes.data(), n, MPI_BYTE, 0, MPI_COMM_WORLD);
+            if (rank != 0) {
+                if (n > 0) loadIndex(index_bytes);
+                else
+                    end = sizeof(magic);
+            }
+            // the data file is accessed collectively from now on
+            data.reset();
+            MPI_Barrier(MPI_COMM_WORLD);
+            MPI_File_open(MPI_COMM_WORLD, name.c_str(),
+                          mode & StreamOut ? MPI_MODE_RDWR | MPI_MODE_CREATE : MPI_MODE_RDONLY, MPI_INFO_NULL,
+                          &shared.fh);
+        }
+#endif
+    }
+
+    /// \note
+    /// The structure of the index file:
+    /// <uint32>        magic "FPTS"
+    /// <int>           number of ranks of the records
+    /// entries:
+    /// <int>           name length & <char * len> field name
+    /// <double>        time stamp
+    /// <int>           step, or -1 if not set
+    /// <int>           number of parts (1, or the number of ranks for a shared data file)
+    /// <parts * 2 * uint64> offset & bytes of the record of each part
+    inline std::size_t TimeSeriesStream::loadIndex(const std::vector<std::byte>& bytes) {
+        const auto* cursor = bytes.data();
+        const auto* bytes_end = cursor + bytes.size();
+        auto take = [&](void* v, std::size_t n) {
+            if (n > std::size_t(bytes_end - cursor)) return false;
+            std::memcpy(v, cursor, n);
+            cursor += n;
+            return true;
+        };
+        std::uint32_t f_magic = 0;
+        int f_nproc = 0;
+        if (!take(&f_magic, sizeof(f_magic)) || f_magic != magic || !take(&f_nproc, sizeof(f_nproc))) {
+            OP_CRITICAL("TimeSeriesStream: {}.idx is not a time series index", fileName());
+            OP_ABORT;
+        }
+        OP_ASSERT_MSG(!isAggregated() || f_nproc == nproc,
+                      "TimeSeriesStream: Shared file written by {} ranks is read by {} ranks", f_nproc,
+                      nproc);
+        entries.clear();
+        by_time.clear();
+        by_step.clear();
+        end = sizeof(magic);
+        auto valid = std::size_t(cursor - bytes.data());
+        while (true) {
+            Entry e;
+            int len, n_parts;
+            if (!take(&len, sizeof(len)) || len < 0 || len > bytes_end - cursor) break;
+            e.name.resize(len);
+            if (!take(e.name.data(), len) || !take(&e.time, sizeof(double)) || !take(&e.step, sizeof(int))
+                || !take(&n_parts, sizeof(int)) || n_parts < 0 || n_parts > bytes_end - cursor)
+                break;
+            e.parts.resize(n_parts);
+            if (!take(e.parts.data(), n_parts * sizeof(e.parts[0]))) break;
+            for (const auto& [offset, size] : e.parts) end = std::max(end, offset + size);
+            by_time[e.name][e.time] = entries.size();
+            if (e.step >= 0) by_step[e.name][e.step] = entries.size();
+            entries.push_back(std::move(e));
+            valid = cursor - bytes.data();
+        }
+        return valid;
+    }
+
+    inline void TimeSeriesStream::rebuildIndex() {
+        // the rebuilt index is only kept in memory for read only streams
+        if (mode & StreamOut) {
+            auto idx_name = fileName() + ".idx";
+            index.reset(std::fopen(idx_name.c_str(), "w+b"));
+            OP_ASSERT_MSG(index, "TimeSeriesStream: Cannot open {}", idx_name);
+            std::fwrite(&magic, sizeof(magic), 1, index.get());
+            std::fwrite(&nproc, sizeof(nproc), 1, index.get());
+        }
+        entries.clear();
+        by_time.clear();
+        by_step.clear();
+        auto* fp = data.get();
+        auto size = std::filesystem::file_size(fileName());
+        std::fseek(fp, sizeof(magic), SEEK_SET);
+        end = sizeof(magic);
+        while (end + sizeof(std::uint64_t) <= size) {
+            std::uint64_t bytes;
+            Entry e;
+            int len;
+            std::fseek(fp, end, SEEK_SET);
+            if (std::fread(&bytes, sizeof(bytes), 1, fp) != 1 || end + sizeof(bytes) + bytes > size
+                || std::fread(&len, sizeof(len), 1, fp) != 1 || len < 0 || len > bytes)
+                break;
+            e.name.resize(len);
+            if (std::fread(e.name.data(), 1, len, fp) != len
+                || std::fread(&e.time, sizeof(double), 1, fp) != 1
+                || std::fread(&e.step, sizeof(int), 1, fp) != 1)
+                break;
+            e.parts.emplace_back(end, sizeof(bytes) + bytes);
+            end += sizeof(bytes) + bytes;
+            appendIndex(e);
+        }
+    }
+
+    inline void TimeSeriesStream::appendIndex(const Entry& e) {
+        if (index) {
+            std::fseek(index.get(), 0, SEEK_END);
+            int len = e.name.size(), n_parts = e.parts.size();
+            std::fwrite(&len, sizeof(len), 1, index.get());
+            std::fwrite(e.name.data(), 1, len, index.get());
+            std::fwrite(&e.time, sizeof(double), 1, index.get());
+            std::fwrite(&e.step, sizeof(int), 1, index.get());
+            std::fwrite(&n_parts, sizeof(int), 1, index.get());
+            std::fwrite(e.parts.data(), sizeof(e.parts[0]), n_parts, index.get());
+            std::fflush(index.get());
+        }
+        by_time[e.name][e.time] = entries.size();
+        if (e.step >= 0) by_step[e.name][e.step] = entries.size();
+        entries.push_back(e);
+    }
+
+    inline const TimeSeriesStream::Entry* TimeSeriesStream::find(const std::string& name) const {
+        if (numberingType == NumberingType::ByStep) {
+            auto iter = by_step.find(name);
+            if (iter == by_step.end() || !time.step) return nullptr;
+            auto e = iter->second.find(time.step.value());
+            return e == iter->second.end() ? nullptr : &entries[e->second];
+        }
+        auto iter = by_time.find(name);
+        if (iter == by_time.end()) return nullptr;
+        auto e = iter->second.find(time.time);
+        return e == iter->second.end() ? nullptr : &entries[e->second];
+    }
+
+    /// \brief Stream operator for CartesianField
+    /// \note
+    /// The structure of a record in the data file (after the leading <uint32> magic "FPTS"):
+    /// <uint64>        bytes of the record after this entry
+    /// <int>           name length & <char * len> field name
+    /// <double>        time stamp
+    /// <int>           step, or -1 if not set
+    /// <int>           field dim
+    /// <int>           element size
+    /// <dim * 2 * int> mesh range
+    /// <uint8>         mesh coordinates flag & <n1 ... nd * double> mesh coordinates if set
+    /// <dim * 2 * int> field global range
+    /// <dim * 2 * int> field local range
+    /// <T * counts>    field data
+    /// \tparam T Input field type
+    /// \param f Input field
+    /// \return The stream
+    template <CartesianFieldExprType T>
+    TimeSeriesStream& TimeSeriesStream::operator<<(const T& f) {
+        constexpr auto dim = OpFlow::internal::CartesianFieldExprTrait<T>::dim;
+        using elem_type = typename OpFlow::internal::CartesianFieldExprTrait<T>::elem_type;
+        static_assert(std::is_trivially_copyable_v<elem_type>);
+        OP_ASSERT_MSG(mode & StreamOut, "TimeSeriesStream: Stream is not opened for writing");
+        open();
+        f.prepare();
+
+        auto name = f.getName();
+        buffer.clear();
+        auto put = [&](const auto& v) {
+            auto* p = reinterpret_cast<const std::byte*>(&v);
+            buffer.insert(buffer.end(), p, p + sizeof(v));
+        };
+        put(std::uint64_t(0));// patched below
+        put(int(name.size()));
+        auto* name_ptr = reinterpret_cast<const std::byte*>(name.data());
+        buffer.insert(buffer.end(), name_ptr, name_ptr + name.size());
+        put(time.time);
+        put(time.step.value_or(-1));
+        put(int(dim));
+        put(int(sizeof(elem_type)));
+        auto& mesh = f.getMesh();
+        auto mesh_range = mesh.getRange();
+        for (auto i = 0; i < dim; ++i) {
+            put(mesh_range.start[i]);
+            put(mesh_range.end[i]);
+        }
+        std::uint8_t with_coords = !(fixed_mesh && mesh_written[name]);
+        put(with_coords);
+        if (with_coords)
+            for (auto i = 0; i < dim; ++i)
+                for (auto j = mesh_range.start[i]; j < mesh_range.end[i]; ++j) put(double(mesh.x(i, j)));
+        mesh_written[name] = true;
+        for (auto i = 0; i < dim; ++i) {
+            put(f.accessibleRange.start[i]);
+            put(f.accessibleRange.end[i]);
+        }
+        for (auto i = 0; i < dim; ++i) {
+            put(f.localRange.start[i]);
+            put(f.localRange.end[i]);
+        }
+        auto header_bytes = buffer.size();
+        std::uint64_t bytes = header_bytes - sizeof(std::uint64_t) + f.localRange.count() * sizeof(elem_type);
+        std::memcpy(buffer.data(), &bytes, sizeof(bytes));
+
+        // the field data is gathered into the staging buffer in pieces & flushed by sink
+        auto fill = [&](auto&& sink) {
+            auto emit = [&](const void* p, std::size_t n) {
+                auto* b = reinterpret_cast<const std::byte*>(p);
+                buffer.insert(buffer.end(), b, b + n);
+                if (buffer.size() >= buffer_size) {
+                    sink(buffer);
+                    buffer.clear();
+                }
+            };
+            if constexpr (CartesianFieldType<T>) {
+                internal::forEachStorageRun(f, f.localRange, [&](auto* ptr, std::size_t n) {
+                    emit(ptr, n * sizeof(*ptr));
+                });
+            } else {
+                rangeFor_s(f.localRange, [&](auto&& i) {
+                    elem_type v = f.evalAt(i);
+                    emit(&v, sizeof(v));
+                });
+            }
+            if (!buffer.empty()) sink(buffer);
+        };
+
+        Entry e {name, time.time, time.step.value_or(-1), {}};
+        if (!isAggregated()) {
+            std::fseek(data.get(), end, SEEK_SET);
+            fill([&](const auto& b) { std::fwrite(b.data(), 1, b.size(), data.get()); });
+            std::fflush(data.get());
+            e.parts.emplace_back(end, sizeof(bytes) + bytes);
+            end += sizeof(bytes) + bytes;
+            appendIndex(e);
+            return *this;
+        }
+#if defined(OPFLOW_WITH_MPI) && defined(OPFLOW_DISTRIBUTE_MODEL_MPI)
+        // the whole record is staged so that all ranks write at once
+        std::vector<std::byte> record;
+        record.reserve(sizeof(bytes) + bytes);
+        fill([&](const auto& b) { record.insert(record.end(), b.begin(), b.end()); });
+        std::uint64_t size = record.size(), offset = 0, total = 0;
+        MPI_Exscan(&size, &offset, 1, MPI_UINT64_T, MPI_SUM, MPI_COMM_WORLD);
+        if (rank == 0) offset = 0;
+        MPI_Allreduce(&size, &total, 1, MPI_UINT64_T, MPI_SUM, MPI_COMM_WORLD);
+        offset += end;
+        // MPI counts are int, so write in pieces of at most 1 GiB
+        constexpr std::uint64_t max_piece = 1 << 30;
+        std::uint64_t pieces = (size + max_piece - 1) / max_piece, max_pieces;
+        MPI_Allreduce(&pieces, &max_pieces, 1, MPI_UINT64_T, MPI_MAX, MPI_COMM_WORLD);
+        for (std::uint64_t k = 0; k < max_pieces; ++k) {
+            auto begin = std::min<std::uint64_t>(k * max_piece, size);
+            auto n = std::min<std::uint64_t>(max_piece, size - begin);
+            MPI_File_write_at_all(shared.fh, offset + begin, record.data() + begin, n, MPI_BYTE,
+                                  MPI_STATUS_IGNORE);
+        }
+        MPI_File_sync(shared.fh);
+        std::vector<std::uint64_t> parts(2 * nproc);
+        std::uint64_t mine[2] {offset, size};
+        MPI_Allgather(mine, 2, MPI_UINT64_T, parts.data(), 2, MPI_UINT64_T, MPI_COMM_WORLD);
+        for (auto r = 0; r < nproc; ++r) e.parts.emplace_back(parts[2 * r], parts[2 * r + 1]);
+        end += total;
+        appendIndex(e);
+#endif
+        return *this;
+    }
+
+    template <CartesianFieldType T>
+    TimeSeriesStream& TimeSeriesStream::operator>>(T& f) {
+        constexpr auto dim = OpFlow::internal::CartesianFieldExprTrait<T>::dim;
+        using elem_type = typename OpFlow::internal::CartesianFieldExprTrait<T>::elem_type;
+        open();
+        const auto* e = find(f.getName());
+        if (!e) {
+            OP_CRITICAL("Field read error: Field {} at time {} not found in {}", f.getName(), time.time,
+                        fileName());
+            OP_ABORT;
+        }
+        auto [offset, bytes] = e->parts[isAggregated() ? rank : 0];
+        std::vector<std::byte> record(bytes);
+#if defined(OPFLOW_WITH_MPI) && defined(OPFLOW_DISTRIBUTE_MODEL_MPI)
+        if (isAggregated()) {
+            constexpr std::uint64_t max_piece = 1 << 30;
+            for (std::uint64_t begin = 0; begin < bytes; begin += max_piece)
+                MPI_File_read_at(shared.fh, offset + begin, record.data() + begin,
+                                 std::min(max_piece, bytes - begin), MPI_BYTE, MPI_STATUS_IGNORE);
+        }
+#endif
+        if (!isAggregated()) {
+            std::fseek(data.get(), offset, SEEK_SET);
+            auto n = std::fread(record.data(), 1, bytes, data.get());
+            OP_ASSERT_MSG(n == bytes, "Field read error: Record of field {} is truncated in {}", f.getName(),
+                          fileName());
+        }
+
+        // bounds checked cursor over the record
+        const auto* cursor = record.data();
+        const auto* record_end = cursor + record.size();
+        auto take = [&](auto& v) {
+            OP_ASSERT_MSG(cursor + sizeof(v) <= record_end, "Field read error: Unexpected end of record");
+            std::memcpy(&v, cursor, sizeof(v));
+            cursor += sizeof(v);
+        };
+        std::uint64_t record_bytes;
+        int name_len, step, f_dim, elem_size;
+        double t;
+        take(record_bytes);
+        take(name_len);
+        cursor += name_len;
+        take(t);
+        take(step);
+        take(f_dim);
+        OP_ASSERT_MSG(f_dim == dim, "Field read error: Dim mismatch {} != {}", f_dim, dim);
+        take(elem_size);
+        OP_ASSERT_MSG(elem_size == sizeof(elem_type), "Field read error: Element size mismatch {} != {}",
+                      elem_size, sizeof(elem_type));
+        auto m_range = f.mesh.getRange();
+        for (auto i = 0; i < dim; ++i) {
+            take(m_range.start[i]);
+            take(m_range.end[i]);
+        }
+        OP_ASSERT_MSG(m_range == f.mesh.getRange(), "Field read error: Mesh range mismatch {} != {}",
+                      m_range.toString(), f.mesh.getRange().toString());
+        std::uint8_t with_coords;
+        take(with_coords);
+        if (with_coords)
+            for (auto i = 0; i < dim; ++i)
+                for (auto j = m_range.start[i]; j < m_range.end[i]; ++j) {
+                    double x;
+                    take(x);
+                    OP_ASSERT_MSG(x == f.mesh.x(i, j),
+                                  "Field read error: Mesh coordinate mismatch at x[{}][{}] {} != {}", i, j, x,
+                                  f.mesh.x(i, j));
+                }
+        auto f_range = f.accessibleRange;
+        for (auto i = 0; i < dim; ++i) {
+            take(f_range.start[i]);
+            take(f_range.end[i]);
+        }
+        OP_ASSERT_MSG(f_range == f.accessibleRange,
+                      "Field read error: Field accessible range mismatch {} != {}", f_range.toString(),
+                      f.accessibleRange.toString());
+        for (auto i = 0; i < dim; ++i) {
+            take(f_range.start[i]);
+            take(f_range.end[i]);
+        }
+        OP_ASSERT_MSG(f_range == f.localRange, "Field read error: Field local range mismatch {} != {}",
+                      f_range.toString(), f.localRange.toString());
+        OP_ASSERT_MSG((std::uint64_t) (record_end - cursor) == f.localRange.count() * sizeof(elem_type),
+                      "Field read error: Record of field {} is truncated", f.getName());
+        f.detachStorage();
+        internal::forEachStorageRun(f, f.localRange, [&](auto* ptr, std::size_t n) {
+            std::memcpy(ptr, cursor, n * sizeof(*ptr));
+            cursor += n * sizeof(*ptr);
+        });
+        f.updatePadding();
+        return *this;
+    }
+}// namespace OpFlow::Utils
+
+#endif//OPFLOW_TIMESERIESSTREAM_HPP
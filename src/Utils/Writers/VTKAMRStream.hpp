@@ -14,18 +14,23 @@
 #define OPFLOW_VTKAMRSTREAM_HPP
 
 #include "Core/Field/MeshBased/SemiStructured/CartAMRField.hpp"
+#include "DataStructures/Index/LevelRangedIndex.hpp"
 #include "Utils/Writers/FieldStream.hpp"
 #include <format>
 #ifndef OPFLOW_INSIDE_MODULE
+#include <filesystem>
 #include <fstream>
 #include <string>
+#include <tbb/tbb.h>
 #include <utility>
+#include <vector>
 #endif
 
 #ifdef OPFLOW_WITH_VTK
 #ifndef OPFLOW_INSIDE_MODULE
 #include <vtkAMRBox.h>
 #include <vtkAMRUtilities.h>
+#include <vtkAOSDataArrayTemplate.h>
 #include <vtkCell.h>
 #include <vtkCellData.h>
 #include <vtkCompositeDataGeometryFilter.h>
@@ -44,6 +49,7 @@
 #include <vtkUniformGrid.h>
 #include <vtkXMLHierarchicalBoxDataWriter.h>
 #include <vtkXMLImageDataWriter.h>
+#include <vtkXMLWriter.h>
 #include <vtkXMLMultiBlockDataWriter.h>
 #endif
 #endif
@@ -57,6 +63,16 @@ OPFLOW_MODULE_EXPORT namespace OpFlow::Utils {
             static constexpr auto mode_flag = StreamOut | StreamASCII;
         };
     }// namespace internal
+
+    /// \brief VTK overlapping AMR stream
+    /// \details The cell values of the patches are evaluated in parallel; the VTK objects are then built &
+    /// written by the calling thread, as VTK's data objects & writers aren't thread safe. A concrete
+    /// field's patch storage is handed to VTK without copying when it has no ghost layers, since the
+    /// storage order (dim 0 fastest) is VTK's cell order. VTK only reads it & the arrays don't outlive the
+    /// write, so storage shared with copies of the field is safe to hand over. Data is written as raw
+    /// appended binary.
+    /// With setPartitioned(true), the patches are written as separate .vti pieces, distributed
+    /// round-robin over the ranks, and the master rank writes the .vthb meta file referring to them.
     struct VTKAMRStream : FieldStream<VTKAMRStream> {
         VTKAMRStream() = default;
         explicit VTKAMRStream(std::string path) : path(std::move(path)) {}
@@ -66,70 +82,60 @@ OPFLOW_MODULE_EXPORT namespace OpFlow::Utils {
             return *this;
         }
 
+        void setPartitioned(bool o) { partitioned = o; }
+
         template <CartAMRFieldExprType T>
         auto& operator<<(const T& f) {
 #ifdef OPFLOW_WITH_VTK
             constexpr auto dim = OpFlow::internal::CartAMRFieldExprTrait<T>::dim;
-            vtkNew<vtkOverlappingAMR> data;
+            using elem_type = typename OpFlow::internal::CartAMRFieldExprTrait<T>::elem_type;
             int numLevels = f.getLevels();
-            int blocksPerLevel[numLevels];
+            std::vector<int> blocksPerLevel(numLevels);
             for (auto i = 0; i < numLevels; ++i) { blocksPerLevel[i] = f.getPartsOnLevel(i); }
             double origin[3] = {0., 0., 0.};
-
-            data->Initialize(numLevels, blocksPerLevel);
             for (auto k = 0; k < dim; ++k) { origin[k] = f.mesh.x(k, 0, f.localRanges[0][0].start[k]); }
-            data->SetOrigin(origin);
-            if constexpr (dim == 2) {
-                data->SetGridDescription(VTK_XY_PLANE);
-            } else {
-                data->SetGridDescription(VTK_XYZ_GRID);
-            }
+            auto grid_description = dim == 2 ? VTK_XY_PLANE : VTK_XYZ_GRID;
 
-            for (auto i = 0; i < numLevels; ++i) {
-                auto levelId = i;
-                for (auto j = 0; j < blocksPerLevel[i]; ++j) {
-                    auto blockId = j;
-                    vtkNew<vtkUniformGrid> grid;
-                    grid->Initialize();
-                    for (auto k = 0; k < dim; ++k) {
-                        origin[k] = f.mesh.x(k, levelId, f.localRanges[levelId][blockId].start[k]);
-                    }
-                    grid->SetOrigin(origin);
-                    int dims[3] = {1, 1, 1};
-                    auto _dims = f.localRanges[levelId][blockId].getExtends();
-                    for (auto k = 0; k < dim; ++k) dims[k] = _dims[k] + 1;
-                    double h[3] = {1.0, 1.0, 1.0};
-                    for (auto k = 0; k < dim; ++k)
-                        h[k] = f.mesh.dx(0, levelId, f.localRanges[levelId][blockId].start[0]);
-                    grid->SetSpacing(h);
-                    grid->SetDimensions(dims);
-                    vtkAMRBox box(origin, dims, h, data->GetOrigin(), data->GetGridDescription());
-
-                    // Attach data to grid
-                    vtkNew<vtkDoubleArray> xyz;
-                    xyz->SetName(f.getName().c_str());
-                    xyz->SetNumberOfComponents(1);
-                    xyz->SetNumberOfTuples(grid->GetNumberOfCells());
-
-                    auto idx = DS::LevelRangedIndex<dim>(f.localRanges[levelId][blockId]);
-                    for (auto cellIdx = 0; cellIdx < grid->GetNumberOfCells(); ++cellIdx, ++idx) {
-                        xyz->SetTuple1(cellIdx, f.evalSafeAt(idx));
-                    }
-                    grid->GetCellData()->AddArray(xyz);
-
-                    data->SetSpacing(levelId, h);
-                    data->SetAMRBox(levelId, blockId, box);
-                    data->SetDataSet(levelId, blockId, grid);
-                }
+            // evaluate the cells of all patches in parallel, then build the VTK objects serially
+            std::vector<std::pair<int, int>> blocks;
+            for (auto i = 0; i < numLevels; ++i)
+                for (auto j = 0; j < blocksPerLevel[i]; ++j) blocks.emplace_back(i, j);
+            std::vector<std::vector<elem_type>> cells(blocks.size());
+            tbb::task_arena arena(getGlobalParallelPlan().shared_memory_workers_count);
+            arena.execute([&]() {
+                tbb::parallel_for(std::size_t(0), blocks.size(), [&](std::size_t b) {
+                    cells[b] = evalCells(f, blocks[b].first, blocks[b].second);
+                });
+            });
+            std::vector<Patch> patches(blocks.size());
+            for (auto b = 0; b < blocks.size(); ++b)
+                patches[b] = makePatch(f, blocks[b].first, blocks[b].second, origin, grid_description,
+                                       cells[b]);
+
+            vtkNew<vtkOverlappingAMR> data;
+            data->Initialize(numLevels, blocksPerLevel.data());
+            data->SetOrigin(origin);
+            data->SetGridDescription(grid_description);
+            for (auto b = 0; b < blocks.size(); ++b) {
+                auto [levelId, blockId] = blocks[b];
+                data->SetSpacing(levelId, patches[b].h);
+                data->SetAMRBox(levelId, blockId, patches[b].box);
+                data->SetDataSet(levelId, blockId, patches[b].grid);
             }
 
             vtkAMRUtilities::BlankCells(data);
             data->Audit();
-            auto writer = vtkSmartPointer<vtkXMLHierarchicalBoxDataWriter>::New();
-            auto name = std::format("{}_{}.vthb", path, (int) time.time * 100);
-            writer->SetFileName(name.c_str());
-            writer->SetInputData(data);
-            writer->Write();
+            auto name = std::format("{}_{}", path, (int) time.time * 100);
+            if (partitioned) writePartitioned(name, blocks, patches, data, dim);
+            else {
+                auto writer = vtkSmartPointer<vtkXMLHierarchicalBoxDataWriter>::New();
+                name += ".vthb";
+                writer->SetFileName(name.c_str());
+                writer->SetInputData(data);
+                writer->SetDataModeToAppended();
+                writer->EncodeAppendedDataOff();
+                writer->Write();
+            }
 #else
             OP_ERROR("VTKStream not working because OPFLOW_WITH_VTK is not defined");
 #endif
@@ -139,8 +145,118 @@ OPFLOW_MODULE_EXPORT namespace OpFlow::Utils {
         std::string static commonSuffix() { return ""; }
 
     private:
+#ifdef OPFLOW_WITH_VTK
+        struct Patch {
+            vtkSmartPointer<vtkUniformGrid> grid;
+            vtkAMRBox box;
+            double h[3] = {1.0, 1.0, 1.0};
+        };
+
+        // the storage of a concrete field's patch without ghost layers is laid out as VTK's cells
+        template <typename T>
+        static bool wrapsStorage(const T& f, int levelId, int blockId) {
+            if constexpr (T::isConcrete())
+                return f.accessibleRanges[levelId][blockId] == f.localRanges[levelId][blockId];
+            else
+                return false;
+        }
+
+        // the cell values of a patch in VTK's order; empty if the patch's storage is handed over directly
+        template <typename T>
+        static auto evalCells(const T& f, int levelId, int blockId) {
+            constexpr auto dim = OpFlow::internal::CartAMRFieldExprTrait<T>::dim;
+            using elem_type = typename OpFlow::internal::CartAMRFieldExprTrait<T>::elem_type;
+            std::vector<elem_type> ret;
+            if (wrapsStorage(f, levelId, blockId)) return ret;
+            const auto& range = f.localRanges[levelId][blockId];
+            ret.resize(range.count());
+            auto idx = DS::LevelRangedIndex<dim>(range);
+            for (auto& c : ret) {
+                c = f.evalAt(idx);
+                ++idx;
+            }
+            return ret;
+        }
+
+        template <typename T, typename E>
+        static Patch makePatch(const T& f, int levelId, int blockId, const double* amr_origin,
+                               int grid_description, std::vector<E>& cells) {
+            constexpr auto dim = OpFlow::internal::CartAMRFieldExprTrait<T>::dim;
+            using elem_type = typename OpFlow::internal::CartAMRFieldExprTrait<T>::elem_type;
+            const auto& range = f.localRanges[levelId][blockId];
+            Patch ret;
+            ret.grid = vtkSmartPointer<vtkUniformGrid>::New();
+            ret.grid->Initialize();
+            double origin[3] = {0., 0., 0.};
+            for (auto k = 0; k < dim; ++k) { origin[k] = f.mesh.x(k, levelId, range.start[k]); }
+            ret.grid->SetOrigin(origin);
+            int dims[3] = {1, 1, 1};
+            auto _dims = range.getExtends();
+            for (auto k = 0; k < dim; ++k) dims[k] = _dims[k] + 1;
+            for (auto k = 0; k < dim; ++k) ret.h[k] = f.mesh.dx(0, levelId, range.start[0]);
+            ret.grid->SetSpacing(ret.h);
+            ret.grid->SetDimensions(dims);
+            ret.box = vtkAMRBox(origin, dims, ret.h, amr_origin, grid_description);
+
+            // Attach data to grid
+            auto array = vtkSmartPointer<vtkAOSDataArrayTemplate<elem_type>>::New();
+            array->SetName(f.getName().c_str());
+            array->SetNumberOfComponents(1);
+            // both the wrapped storage & the cell buffer outlive the array, which never frees them
+            if (wrapsStorage(f, levelId, blockId)) {
+                auto idx = DS::LevelRangedIndex<dim>(range);
+                array->SetArray(const_cast<elem_type*>(&f.evalAt(idx)), ret.grid->GetNumberOfCells(), 1);
+            } else
+                array->SetArray(cells.data(), ret.grid->GetNumberOfCells(), 1);
+            ret.grid->GetCellData()->AddArray(array);
+            return ret;
+        }
+
+        // write each patch to a .vti piece & the .vthb meta file referring to them
+        void writePartitioned(const std::string& name, const std::vector<std::pair<int, int>>& blocks,
+                              const std::vector<Patch>& patches, vtkOverlappingAMR* data, int dim) {
+            auto dir = std::filesystem::path(name);
+            auto stem = dir.filename().string();
+            auto piece = [&](int l, int p) { return std::format("{}/{}_{}_{}.vti", stem, stem, l, p); };
+            auto nproc = getWorkerCount(), rank = getWorkerId();
+            std::filesystem::create_directories(dir);
+            for (std::size_t b = rank; b < blocks.size(); b += nproc) {
+                auto writer = vtkSmartPointer<vtkXMLImageDataWriter>::New();
+                auto filename = (dir.parent_path() / piece(blocks[b].first, blocks[b].second)).string();
+                writer->SetFileName(filename.c_str());
+                writer->SetInputData(patches[b].grid);
+                writer->SetDataModeToAppended();
+                writer->EncodeAppendedDataOff();
+                writer->Write();
+            }
+            if (rank != 0) return;
+            std::ofstream meta(name + ".vthb");
+            const auto* origin = data->GetOrigin();
+            meta << "<?xml version=\"1.0\"?>\n";
+            meta << "<VTKFile type=\"vtkOverlappingAMR\" version=\"1.1\" byte_order=\"LittleEndian\" "
+                    "header_type=\"UInt32\">\n";
+            meta << std::format("  <vtkOverlappingAMR origin=\"{} {} {}\" grid_description=\"{}\">\n",
+                                origin[0], origin[1], origin[2], dim == 2 ? "XY" : "XYZ");
+            for (unsigned int l = 0; l < data->GetNumberOfLevels(); ++l) {
+                double h[3];
+                data->GetSpacing(l, h);
+                meta << std::format("    <Block level=\"{}\" spacing=\"{} {} {}\">\n", l, h[0], h[1], h[2]);
+                for (unsigned int p = 0; p < data->GetNumberOfDataSets(l); ++p) {
+                    const auto& box = data->GetAMRBox(l, p);
+                    const auto *lo = box.GetLoCorner(), *hi = box.GetHiCorner();
+                    meta << std::format("      <DataSet index=\"{}\" amr_box=\"{} {} {} {} {} {}\" "
+                                        "file=\"{}\"/>\n",
+                                        p, lo[0], hi[0], lo[1], hi[1], lo[2], hi[2], piece(l, p));
+                }
+                meta << "    </Block>\n";
+            }
+            meta << "  </vtkOverlappingAMR>\n</VTKFile>\n";
+        }
+#endif
+
         std::string path;
         TimeStamp time {};
+        bool partitioned = false;
     };
 }// namespace OpFlow::Utils
 #endif//OPFLOW_VTKAMRSTREAM_HPP
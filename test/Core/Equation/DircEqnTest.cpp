@@ -284,6 +284,12 @@ TEST_F(DircEqnTest, AMGCLUnifiedSolveMixedPercision) {
     ASSERT_TRUE(check_solution(5e-7));
 }
 
+TEST_F(DircEqnTest, AMGCLMixedPrecisionSolverAlias) {
+    this->reset_case(0.5, 0.5);
+    Solve<AMGCLMixedPrecisionSolver<>>(poisson_eqn(), p, DS::MDRangeMapper<2> {p.assignableRange});
+    ASSERT_TRUE(check_solution(5e-7));
+}
+
 TEST_F(DircEqnTest, AMGCLUnifiedSolveCG) {
     this->reset_case(0.5, 0.5);
     using Solver = amgcl::make_solver<
@@ -134,6 +134,43 @@ TEST_F(CartesianFieldMPITest, PeriodicValueCheck) {
     });
 }
 
+TEST_F(CartesianFieldMPITest, VectorField_PeriodicValueCheck) {
+    auto v = ExprBuilder<CartesianVectorField<double, Mesh, 2>>()
+                     .setMesh(m)
+                     .setBC(0, OpFlow::DimPos::start, OpFlow::BCType::Periodic)
+                     .setBC(0, OpFlow::DimPos::end, OpFlow::BCType::Periodic)
+                     .setBC(1, OpFlow::DimPos::start, OpFlow::BCType::Periodic)
+                     .setBC(1, OpFlow::DimPos::end, OpFlow::BCType::Periodic)
+                     .setPadding(1)
+                     .setExt(1)
+                     .setSplitStrategy(strategy)
+                     .setLoc({LocOnMesh::Center, LocOnMesh::Center})
+                     .build();
+    auto u_local = ExprBuilder<Field>()
+                           .setMesh(m)
+                           .setBC(0, OpFlow::DimPos::start, OpFlow::BCType::Periodic)
+                           .setBC(0, OpFlow::DimPos::end, OpFlow::BCType::Periodic)
+                           .setBC(1, OpFlow::DimPos::start, OpFlow::BCType::Periodic)
+                           .setBC(1, OpFlow::DimPos::end, OpFlow::BCType::Periodic)
+                           .setExt(1)
+                           .setLoc({LocOnMesh::Center, LocOnMesh::Center})
+                           .build();
+
+    auto mapper = DS::MDRangeMapper<2>(v[0].assignableRange);
+    rangeFor_s(v[0].getLocalWritableRange(), [&](auto&& i) {
+        v[0][i] = mapper(i);
+        v[1][i] = -mapper(i);
+    });
+    rangeFor_s(u_local.getLocalWritableRange(), [&](auto&& i) { u_local[i] = mapper(i); });
+    // both components' paddings are exchanged by the same messages
+    v.updatePadding();
+    u_local.updatePadding();
+    rangeFor_s(v[0].getLocalReadableRange(), [&](auto&& i) {
+        ASSERT_EQ(v[0][i], u_local[i]);
+        ASSERT_EQ(v[1][i], -u_local[i]);
+    });
+}
+
 TEST_F(CartesianFieldMPITest, Serializable_PeriodicValueCheck) {
     class Int : public virtual SerializableObj {
     public:
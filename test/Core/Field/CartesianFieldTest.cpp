@@ -174,4 +174,207 @@ TEST_F(CartesianFieldTest, CenterPeriodicValueCheck) {
         if (u[i] != (i[1] + 10) % 10 * 10 + (i[0] + 10) % 10) std::print(std::cerr, "Not equal at {}", i);
         ASSERT_DOUBLE_EQ(u[i], (i[1] + 10) % 10 * 10 + (i[0] + 10) % 10);
     });
-}
\ No newline at end of file
+}
+
+TEST_F(CartesianFieldTest, ExprSharesLayout) {
+    auto u = ExprBuilder<Field2>()
+                     .setName("u")
+                     .setMesh(m2)
+                     .setBC(0, DimPos::start, BCType::Dirc, 0.)
+                     .setBC(0, DimPos::end, BCType::Dirc, 0.)
+                     .setBC(1, DimPos::start, BCType::Dirc, 0.)
+                     .setBC(1, DimPos::end, BCType::Dirc, 0.)
+                     .setLoc(LocOnMesh::Center)
+                     .build();
+    auto e = u * u + 2. * u;
+    e.prepare();
+    ASSERT_EQ(e.layout.get(), u.layout.get());
+    ASSERT_EQ(e.getSplitMap().size(), 1);
+    // the name is only built on request
+    ASSERT_TRUE(e.name.empty());
+    ASSERT_EQ(e.getName(), "u * u + 2 * u");
+    auto v = u;
+    ASSERT_EQ(v.layout.get(), u.layout.get());
+    // the mesh coordinates are shared as well
+    ASSERT_EQ(v.mesh.coords.get(), u.mesh.coords.get());
+    ASSERT_EQ(u.mesh.coords.get(), m2.coords.get());
+}
+
+TEST_F(CartesianFieldTest, SelfAssignReadWidth) {
+    auto u = ExprBuilder<Field2>()
+                     .setName("u")
+                     .setMesh(m2)
+                     .setBC(0, DimPos::start, BCType::Dirc, 0.)
+                     .setBC(0, DimPos::end, BCType::Dirc, 0.)
+                     .setBC(1, DimPos::start, BCType::Dirc, 0.)
+                     .setBC(1, DimPos::end, BCType::Dirc, 0.)
+                     .setLoc(LocOnMesh::Center)
+                     .setExt(1)
+                     .build();
+    auto v = u;
+    ASSERT_EQ((u * u + 2. * u).readWidth(u), 0);
+    ASSERT_EQ((u * u + 2. * u).readWidth(v), -1);
+    ASSERT_EQ((u + d2x<D2SecondOrderCentered>(u)).readWidth(u), 1);
+    ASSERT_EQ((v + d2x<D2SecondOrderCentered>(d2y<D2SecondOrderCentered>(u))).readWidth(u), 2);
+
+    u.initBy([](auto&& x) { return std::sin(3. * x[0]) * std::cos(2. * x[1]); });
+    // pointwise updates run in place without a temporary
+    auto before = Utils::getScratchPoolStats();
+    v = u;
+    u = u + 0.5 * u * u;
+    v = v + 0.5 * v * v;
+    ASSERT_EQ(Utils::getScratchPoolStats().misses, before.misses);
+    ASSERT_EQ(Utils::getScratchPoolStats().hits, before.hits);
+    rangeFor_s(u.assignableRange, [&](auto&& i) { ASSERT_DOUBLE_EQ(u[i], v[i]); });
+
+    // stencil updates must see the old neighbours
+    auto w = u;
+    w = u + 1e-3 * (d2x<D2SecondOrderCentered>(u) + d2y<D2SecondOrderCentered>(u));
+    u = u + 1e-3 * (d2x<D2SecondOrderCentered>(u) + d2y<D2SecondOrderCentered>(u));
+    rangeFor_s(u.assignableRange, [&](auto&& i) { ASSERT_DOUBLE_EQ(u[i], w[i]); });
+    w = u - 1e-3 * d2x<D2SecondOrderCentered>(d2y<D2SecondOrderCentered>(u));
+    u -= 1e-3 * d2x<D2SecondOrderCentered>(d2y<D2SecondOrderCentered>(u));
+    rangeFor_s(u.assignableRange, [&](auto&& i) { ASSERT_DOUBLE_EQ(u[i], w[i]); });
+}
+
+TEST_F(CartesianFieldTest, MixedPrecision) {
+    using FloatField2 = CartesianField<float, Mesh2>;
+    auto u = ExprBuilder<Field2>()
+                     .setMesh(m2)
+                     .setBC(0, DimPos::start, BCType::Dirc, 0.)
+                     .setBC(0, DimPos::end, BCType::Dirc, 0.)
+                     .setBC(1, DimPos::start, BCType::Dirc, 0.)
+                     .setBC(1, DimPos::end, BCType::Dirc, 0.)
+                     .setLoc(LocOnMesh::Center)
+                     .setExt(1)
+                     .build();
+    u.initBy([](auto&& x) { return std::sin(3. * x[0]) * std::cos(2. * x[1]); });
+    FloatField2 f(u);
+    static_assert(std::same_as<internal::ExprTrait<decltype(f + u)>::elem_type, double>);
+    static_assert(std::same_as<internal::ExprTrait<decltype(f * 2.f)>::elem_type, float>);
+    rangeFor_s(u.assignableRange, [&](auto&& i) { ASSERT_EQ(f[i], (float) u[i]); });
+
+    // float storage is updated from double expressions & read back into double fields
+    auto w = u;
+    w = u + 1e-3 * d2x<D2SecondOrderCentered>(u) + u;
+    f = f + 1e-3 * d2x<D2SecondOrderCentered>(f) + u;
+    auto v = u;
+    v = f - u;
+    rangeFor_s(u.assignableRange, [&](auto&& i) { ASSERT_NEAR(v[i], w[i] - u[i], 1e-6); });
+
+    auto sum = rangeReduce(
+            f.assignableRange, [](auto&& a, auto&& b) { return a + b; }, [&](auto&& i) { return f[i]; });
+    static_assert(std::same_as<decltype(sum), double>);
+    double ref = 0.;
+    rangeFor_s(f.assignableRange, [&](auto&& i) { ref += f[i]; });
+    ASSERT_NEAR(sum, ref, 1e-12 * f.assignableRange.count());
+}
+
+TEST_F(CartesianFieldTest, MixedPrecisionLogicalBC) {
+    using FloatField2 = CartesianField<float, Mesh2>;
+    auto u = ExprBuilder<Field2>()
+                     .setMesh(m2)
+                     .setBC(0, DimPos::start, BCType::Periodic)
+                     .setBC(0, DimPos::end, BCType::Periodic)
+                     .setBC(1, DimPos::start, BCType::Dirc, 0.)
+                     .setBC(1, DimPos::end, BCType::Dirc, 0.)
+                     .setLoc(LocOnMesh::Center)
+                     .build();
+    u.initBy([](auto&& x) { return std::sin(2. * PI * x[0]) + x[1]; });
+    FloatField2 f(u);
+    // the periodic bcs are rebuilt for f instead of reading from u
+    ASSERT_NE(dynamic_cast<PeriodicBC<FloatField2>*>(f.bc[0].start.get()), nullptr);
+    ASSERT_NE(dynamic_cast<PeriodicBC<FloatField2>*>(f.bc[0].end.get()), nullptr);
+    ASSERT_EQ(f.bc[1].start->getBCType(), BCType::Dirc);
+    u = 0.;
+    auto end = m2.getRange().end[0] - 1;
+    for (auto j = f.localRange.start[1]; j < f.localRange.end[1]; ++j)
+        ASSERT_EQ(f.bc[0].end->evalAt(DS::MDIndex<2>(end, j)), f.evalAt(DS::MDIndex<2>(0, j)));
+}
+
+TEST_F(CartesianFieldTest, PackedMask) {
+    using Mask2 = CartesianField<bool, Mesh2>;
+    auto a = ExprBuilder<Mask2>().setMesh(m2).setLoc(LocOnMesh::Center).build();
+    auto b = ExprBuilder<Mask2>().setMesh(m2).setLoc(LocOnMesh::Center).build();
+    a.initBy([](auto&& x) { return x[0] < 0.5; });
+    b.initBy([](auto&& x) { return x[1] < 0.3; });
+    auto c = a;
+    // logical ops of masks of the same layout are evaluated a word at a time
+    c = (a && !b) || (a ^ b);
+    rangeFor_s(c.assignableRange,
+               [&](auto&& i) { ASSERT_EQ(bool(c[i]), (a[i] && !b[i]) || (a[i] != b[i])); });
+    c = a & b;
+    ASSERT_EQ(c.count(), 5 * 3);
+    c = !c;
+    ASSERT_EQ(c.count(), 10 * 10 - 5 * 3);
+
+    // masks from comparisons are evaluated point by point
+    auto u = ExprBuilder<Field2>().setMesh(m2).setLoc(LocOnMesh::Center).build();
+    u.initBy([](auto&& x) { return x[0]; });
+    c = u > 0.5 && a;
+    ASSERT_EQ(c.count(), 0);
+}
+
+TEST_F(CartesianFieldTest, PitchPadding) {
+    // 512 cells plus the halo make the rows about 4 KiB apart
+    auto mesh = MeshBuilder<Mesh2>().newMesh(513, 9).setMeshOfDim(0, 0., 1.).setMeshOfDim(1, 0., 1.).build();
+    auto builder = [&](bool pad) {
+        return ExprBuilder<Field2>()
+                .setMesh(mesh)
+                .setBC(0, DimPos::start, BCType::Dirc, 0.)
+                .setBC(0, DimPos::end, BCType::Dirc, 0.)
+                .setBC(1, DimPos::start, BCType::Dirc, 0.)
+                .setBC(1, DimPos::end, BCType::Dirc, 0.)
+                .setLoc(LocOnMesh::Center)
+                .setExt(1)
+                .setPitchPadding(pad)
+                .build();
+    };
+    auto u = builder(false), v = builder(true);
+    u.initBy([](auto&& x) { return std::sin(2 * PI * x[0]) * x[1]; });
+    v = u;
+    auto w = u, z = v;
+    w = d2x<D2SecondOrderCentered>(u) + d2y<D2SecondOrderCentered>(u);
+    z = d2x<D2SecondOrderCentered>(v) + d2y<D2SecondOrderCentered>(v);
+    rangeFor_s(w.assignableRange, [&](auto&& i) { ASSERT_EQ(w[i], z[i]); });
+    rangeFor_s(v.getLocalReadableRange(), [&](auto&& i) { ASSERT_EQ(u[i], v[i]); });
+}
+
+TEST_F(CartesianFieldTest, CopyOnWrite) {
+    using Alloc = Utils::AlignedAllocator<double>;
+    auto u = ExprBuilder<Field2>()
+                     .setMesh(m2)
+                     .setBC(0, DimPos::start, BCType::Dirc, 0.)
+                     .setBC(0, DimPos::end, BCType::Dirc, 0.)
+                     .setBC(1, DimPos::start, BCType::Dirc, 0.)
+                     .setBC(1, DimPos::end, BCType::Dirc, 0.)
+                     .setLoc(LocOnMesh::Center)
+                     .setExt(1)
+                     .build();
+    u.initBy([](auto&& x) { return x[0] + x[1]; });
+    auto before = Alloc::getStats().live_bytes;
+    // snapshots share the storage until written
+    auto v = u, w = u;
+    ASSERT_EQ(Alloc::getStats().live_bytes, before);
+    v = u + 1.;
+    ASSERT_GT(Alloc::getStats().live_bytes, before);
+    // writes through the element accessors take a private copy first
+    auto x = u;
+    DS::MDIndex<2> i0 {2, 3}, i1 {3, 2};
+    auto u0 = std::as_const(u)[i0], u1 = std::as_const(u)[i1];
+    w[i0] = -1.;
+    w(i1) = -2.;
+    ASSERT_EQ(std::as_const(w)[i0], -1.);
+    ASSERT_EQ(std::as_const(w)[i1], -2.);
+    ASSERT_EQ(std::as_const(u)[i0], u0);
+    ASSERT_EQ(std::as_const(u)[i1], u1);
+    ASSERT_EQ(std::as_const(x)[i0], u0);
+    // in both directions
+    u[i0] = -3.;
+    ASSERT_EQ(std::as_const(x)[i0], u0);
+    ASSERT_EQ(std::as_const(w)[i0], -1.);
+    rangeFor_s(u.assignableRange, [&](auto&& i) {
+        ASSERT_DOUBLE_EQ(std::as_const(v)[i], std::as_const(x)[i] + 1.);
+        if (i != i0 && i != i1) ASSERT_EQ(std::as_const(w)[i], std::as_const(x)[i]);
+    });
+}
@@ -0,0 +1,134 @@
+//  ----------------------------------------------------------------------------
+//
+//  Copyright (c) 2019 - 2026 by the OpFlow developers
+//
+//  This file is part of OpFlow.
+//
+//  OpFlow is free software and is distributed under the MPL v2.0 license.
+//  The full text of the license can be found in the file LICENSE at the top
+//  level directory of OpFlow.
+//
+//  ----------------------------------------------------------------------------
+
+#include <OpFlow>
+#include <gmock/gmock.h>
+
+using namespace OpFlow;
+
+class CartesianVectorFieldTest : public testing::Test {
+protected:
+    using Mesh = CartesianMesh<Meta::int_<2>>;
+    using Field = CartesianField<double, Mesh>;
+    using VField = CartesianVectorField<double, Mesh, 2>;
+
+    void SetUp() override {
+        m = MeshBuilder<Mesh>().newMesh(17, 13).setMeshOfDim(0, 0., 1.).setMeshOfDim(1, 0., 1.).build();
+    }
+
+    auto build() {
+        return ExprBuilder<VField>()
+                .setName("vel")
+                .setMesh(m)
+                .setLoc(LocOnMesh::Center)
+                .setExt(1)
+                .setBC(0, DimPos::start, BCType::Periodic)
+                .setBC(0, DimPos::end, BCType::Periodic)
+                .setBCOfComp(0, 1, DimPos::start, BCType::Dirc, 1.)
+                .setBCOfComp(0, 1, DimPos::end, BCType::Dirc, 1.)
+                .setBCOfComp(1, 1, DimPos::start, BCType::Neum, 0.)
+                .setBCOfComp(1, 1, DimPos::end, BCType::Neum, 0.)
+                .build();
+    }
+
+    static void init(VField& v) {
+        v[0].initBy([](auto&& x) { return std::sin(2 * PI * x[0]) * x[1]; });
+        v[1].initBy([](auto&& x) { return std::cos(2 * PI * x[0]) + x[1] * x[1]; });
+    }
+
+    Mesh m;
+};
+
+TEST_F(CartesianVectorFieldTest, ComponentsShareBlockAndLayout) {
+    VField v = build();
+    ASSERT_EQ(v.getName(), "vel");
+    ASSERT_EQ(v[0].getName(), "vel_0");
+    ASSERT_EQ(v[1].getName(), "vel_1");
+    ASSERT_EQ(v[0].localRange, v[1].localRange);
+    ASSERT_EQ(v[0].getLayout().neighbors.size(), v[1].getLayout().neighbors.size());
+    ASSERT_EQ(&v[0].getLayout(), &v[1].getLayout());
+    ASSERT_EQ(v[0].bc[1].start->getBCType(), BCType::Dirc);
+    ASSERT_EQ(v[1].bc[1].start->getBCType(), BCType::Neum);
+    // the second component follows the first in the same aligned block
+    auto first = DS::MDIndex<2>(v[0].localRange.start);
+    auto gap = &v[1][first] - &v[0][first];
+    ASSERT_GT(gap, 0);
+    ASSERT_EQ(gap * sizeof(double) % 64, 0);
+}
+
+TEST_F(CartesianVectorFieldTest, CopyIsDeepAndMoveKeepsBCs) {
+    VField v = build();
+    init(v);
+    VField w = v;
+    auto first = DS::MDIndex<2>(v[0].localRange.start);
+    ASSERT_NE(&w[0][first], &v[0][first]);
+    w[0] = 0.;
+    ASSERT_NE(v[0][first], 0.);
+
+    VField moved = std::move(w);
+    moved[0].initBy([](auto&& x) { return x[0]; });
+    // the periodic padding is still filled from the moved component itself
+    auto r = moved[0].accessibleRange;
+    ASSERT_DOUBLE_EQ(moved[0].evalAt(DS::MDIndex<2>(r.start[0] - 1, 3)),
+                     moved[0].evalAt(DS::MDIndex<2>(r.end[0] - 1, 3)));
+}
+
+TEST_F(CartesianVectorFieldTest, FusedAssign) {
+    VField v = build();
+    init(v);
+    auto u0 = v[0], u1 = v[1];
+    // pointwise aliasing: both components are read before either is written
+    v.assign(v[1], -1. * v[0]);
+    rangeFor_s(DS::commonRange(v[0].assignableRange, v[0].localRange), [&](auto&& i) {
+        ASSERT_DOUBLE_EQ(v[0][i], u1[i]);
+        ASSERT_DOUBLE_EQ(v[1][i], -u0[i]);
+    });
+}
+
+TEST_F(CartesianVectorFieldTest, StencilAssign) {
+    VField v = build();
+    init(v);
+    Field r0 = v[0], r1 = v[1];
+    r0 = v[0] + d2x<D2SecondOrderCentered>(v[1]);
+    r1 = v[1] + d2y<D2SecondOrderCentered>(v[0]);
+    v.assign(v[0] + d2x<D2SecondOrderCentered>(v[1]), v[1] + d2y<D2SecondOrderCentered>(v[0]));
+    rangeFor_s(DS::commonRange(v[0].assignableRange, v[0].localRange),
+               [&](auto&& i) { ASSERT_DOUBLE_EQ(v[0][i], r0[i]); });
+    rangeFor_s(DS::commonRange(v[1].assignableRange, v[1].localRange),
+               [&](auto&& i) { ASSERT_DOUBLE_EQ(v[1][i], r1[i]); });
+}
+
+TEST_F(CartesianVectorFieldTest, CoupledAssignOverDifferentRanges) {
+    // nodal components with Dirc & Neum bcs have different assignable ranges
+    auto v = ExprBuilder<VField>()
+                     .setName("vel")
+                     .setMesh(m)
+                     .setLoc(LocOnMesh::Corner)
+                     .setBC(0, DimPos::start, BCType::Dirc, 0.)
+                     .setBC(0, DimPos::end, BCType::Dirc, 0.)
+                     .setBCOfComp(0, 1, DimPos::start, BCType::Dirc, 0.)
+                     .setBCOfComp(0, 1, DimPos::end, BCType::Dirc, 0.)
+                     .setBCOfComp(1, 1, DimPos::start, BCType::Neum, 0.)
+                     .setBCOfComp(1, 1, DimPos::end, BCType::Neum, 0.)
+                     .build();
+    ASSERT_FALSE(DS::commonRange(v[0].assignableRange, v[0].localRange)
+                 == DS::commonRange(v[1].assignableRange, v[1].localRange));
+    init(v);
+    Field u0 = v[0], u1 = v[1];
+    const double c = std::cos(0.3), s = std::sin(0.3);
+    // each component reads the other at the point being updated
+    v.assign(c * v[0] - s * v[1], s * v[0] + c * v[1]);
+    rangeFor_s(DS::commonRange(v[0].assignableRange, v[0].localRange),
+               [&](auto&& i) { ASSERT_DOUBLE_EQ(v[0][i], c * u0[i] - s * u1[i]); });
+    rangeFor_s(DS::commonRange(v[1].assignableRange, v[1].localRange),
+               [&](auto&& i) { ASSERT_DOUBLE_EQ(v[1][i], s * u0[i] + c * u1[i]); });
+}
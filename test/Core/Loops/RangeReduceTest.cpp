@@ -67,3 +67,24 @@ TEST_F(RangeReduceTest, D2Reduce) {
             u.assignableRange, [](auto&& a, auto&& b) { return a + b; }, [&](auto&& i) { return u[i]; });
     ASSERT_NEAR(double(val) / double(val2), 1.0, 1e-14);
 }
+
+TEST_F(RangeReduceTest, FloatAccumulatesInDouble) {
+    // past 2^24 adding 1.f to a float sum has no effect
+    DS::Range<1> range {std::array {(1 << 24) + 8}};
+    auto val_s = rangeReduce_s(range, [](auto&& a, auto&& b) { return a + b; }, [](auto&&) { return 1.f; });
+    auto val = rangeReduce(range, [](auto&& a, auto&& b) { return a + b; }, [](auto&&) { return 1.f; });
+    static_assert(std::same_as<decltype(val), double>);
+    ASSERT_EQ(val_s, range.count());
+    ASSERT_EQ(val, range.count());
+}
+
+TEST_F(RangeReduceTest, FloatMaxReduce) {
+    std::vector<float> v(1000);
+    for (std::size_t i = 0; i < v.size(); ++i) v[i] = 1.f + (i * 37 % 1000) * .5f;
+    DS::Range<1> range {std::array {(int) v.size()}};
+    auto max = [](auto&& a, auto&& b) { return std::max(a, b); };
+    auto val_s = rangeReduce_s(range, max, [&](auto&& i) { return v[i[0]]; });
+    auto val = rangeReduce(range, max, [&](auto&& i) { return v[i[0]]; });
+    ASSERT_EQ(val_s, *std::max_element(v.begin(), v.end()));
+    ASSERT_EQ(val, *std::max_element(v.begin(), v.end()));
+}
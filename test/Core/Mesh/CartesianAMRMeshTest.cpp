@@ -0,0 +1,138 @@
+// ----------------------------------------------------------------------------
+//
+// Copyright (c) 2019 - 2026 by the OpFlow developers
+//
+// This file is part of OpFlow.
+//
+// OpFlow is free software and is distributed under the MPL v2.0 license.
+// The full text of the license can be found in the file LICENSE at the top
+// level directory of OpFlow.
+//
+// ----------------------------------------------------------------------------
+
+#include <gmock/gmock.h>
+
+#include <OpFlow>
+
+using namespace OpFlow;
+
+class AMRRegridTest : public testing::Test {
+protected:
+    using Mesh = CartesianAMRMesh<Meta::int_<2>>;
+    using Field = CartAMRField<double, Mesh>;
+    static constexpr int n = 33, ratio = 2;
+
+    // tags the cells in two disks, the second one centered at (c, c)
+    static auto marker(double c) {
+        return [=](auto&& i) {
+            double h = 1. / (n - 1) / Math::int_pow(ratio, i.l);
+            double x = h * (i[0] + .5), y = h * (i[1] + .5);
+            auto in = [&](double cx, double cy) { return (x - cx) * (x - cx) + (y - cy) * (y - cy) < .01; };
+            return in(.25, .25) || in(c, c);
+        };
+    }
+
+    static Mesh build(double c) {
+        return MeshBuilder<Mesh>()
+                .setBaseMesh(MeshBuilder<CartesianMesh<Meta::int_<2>>>()
+                                     .newMesh(n, n)
+                                     .setMeshOfDim(0, 0., 1.)
+                                     .setMeshOfDim(1, 0., 1.)
+                                     .build())
+                .setRefinementRatio(ratio)
+                .setFillRateThreshold(0.8)
+                .setSlimThreshold(3)
+                .setMaxLevel(2)
+                .setIncremental(true)
+                .setMarkerFunction(marker(c))
+                .build();
+    }
+
+    static Mesh regrid(const Mesh& ref, double c) {
+        return MeshBuilder<Mesh>().setRefMesh(ref).setIncremental(true).setMarkerFunction(marker(c)).build();
+    }
+
+    static bool sameBox(const DS::LevelRange<2>& a, const DS::LevelRange<2>& b) {
+        return a.start == b.start && a.end == b.end;
+    }
+
+    // the patches of the first disk, which are far from the changed tags
+    static bool inFirstDisk(const DS::LevelRange<2>& r) { return r.end[0] <= n && r.end[1] <= n; }
+
+    // each tagged cell is covered by a patch on level 1
+    static void checkCovered(const Mesh& m, double c) {
+        auto tag = marker(c);
+        rangeFor_s(DS::Range<2>(std::array {n - 1, n - 1}), [&](auto&& i) {
+            DS::LevelMDIndex<2> k(0, 0, i[0], i[1]);
+            if (!tag(k)) return;
+            auto covered = std::any_of(m.ranges[1].begin(), m.ranges[1].end(), [&](auto&& r) {
+                bool ret = true;
+                for (auto d = 0; d < 2; ++d)
+                    ret &= r.start[d] <= i[d] * ratio && (i[d] + 1) * ratio < r.end[d];
+                return ret;
+            });
+            ASSERT_TRUE(covered) << "cell " << i[0] << ", " << i[1];
+        });
+    }
+};
+
+TEST_F(AMRRegridTest, UnchangedTagsKeepPatches) {
+    auto m = build(.75);
+    auto m2 = regrid(m, .75);
+    ASSERT_EQ(m2.ranges, m.ranges);
+}
+
+TEST_F(AMRRegridTest, CleanPatchesKept) {
+    auto m = build(.75);
+    auto m2 = regrid(m, .7);
+    ASSERT_EQ(m2.ranges.size(), 2u);
+    int kept = 0;
+    for (const auto& r : m.ranges[1]) {
+        if (!inFirstDisk(r)) continue;
+        ASSERT_TRUE(std::any_of(m2.ranges[1].begin(), m2.ranges[1].end(),
+                                [&](auto&& r2) { return sameBox(r, r2); }));
+        kept++;
+    }
+    ASSERT_GT(kept, 0);
+    checkCovered(m2, .7);
+}
+
+TEST_F(AMRRegridTest, StorageMovedForKeptPatches) {
+    auto m = build(.75);
+    auto u = ExprBuilder<Field>()
+                     .setMesh(m)
+                     .setName("u")
+                     .setLoc({LocOnMesh::Center, LocOnMesh::Center})
+                     .setBC(0, DimPos::start, BCType::Dirc, 0.)
+                     .setBC(0, DimPos::end, BCType::Dirc, 0.)
+                     .setBC(1, DimPos::start, BCType::Dirc, 0.)
+                     .setBC(1, DimPos::end, BCType::Dirc, 0.)
+                     .build();
+    u.initBy([](auto&& x) { return std::sin(3 * x[0]) + x[1]; });
+    auto first = [](const Field& f, int l, int p) {
+        return &f.evalAt(DS::LevelRangedIndex<2>(f.localRanges[l][p]));
+    };
+    // the storage & values of the patches to be kept. u has no copies, so that no patch is detached
+    struct Kept {
+        DS::LevelRange<2> range;
+        const double* ptr;
+        std::vector<double> values;
+    };
+    std::vector<Kept> kept;
+    for (auto p = 0; p < u.localRanges[1].size(); ++p) {
+        if (!inFirstDisk(m.ranges[1][p])) continue;
+        auto& k = kept.emplace_back(Kept {u.localRanges[1][p], first(u, 1, p), {}});
+        rangeFor_s(k.range, [&](auto&& i) { k.values.push_back(std::as_const(u)[i]); });
+    }
+    ASSERT_FALSE(kept.empty());
+
+    u.replaceMeshBy(regrid(m, .7));
+    for (const auto& k : kept) {
+        auto p = std::find_if(u.localRanges[1].begin(), u.localRanges[1].end(),
+                              [&](auto&& r) { return sameBox(k.range, r); });
+        ASSERT_NE(p, u.localRanges[1].end());
+        ASSERT_EQ(first(u, 1, p - u.localRanges[1].begin()), k.ptr);
+        auto v = k.values.begin();
+        rangeFor_s(*p, [&](auto&& i) { ASSERT_EQ(std::as_const(u)[i], *v++); });
+    }
+}
@@ -0,0 +1,66 @@
+// ----------------------------------------------------------------------------
+//
+// Copyright (c) 2019 - 2026 by the OpFlow developers
+//
+// This file is part of OpFlow.
+//
+// OpFlow is free software and is distributed under the MPL v2.0 license.
+// The full text of the license can be found in the file LICENSE at the top
+// level directory of OpFlow.
+//
+// ----------------------------------------------------------------------------
+
+#include <OpFlow>
+#include <gmock/gmock.h>
+
+using namespace OpFlow;
+
+class BoxSubtractTest : public testing::Test {
+protected:
+    using Point = DS::Point<int, 3>;
+    using Box = DS::Box<int, 3>;
+
+    // every cell of a is covered by exactly one piece if it's not in b, & by none otherwise
+    static void check(const Box& a, const Box& b) {
+        auto pieces = DS::boxSubtract(a, b);
+        ASSERT_LE(pieces.size(), 6u);
+        for (const auto& p : pieces) ASSERT_TRUE(DS::boxInBox(p, a));
+        for (auto i = a.lo[0]; i <= a.hi[0]; ++i)
+            for (auto j = a.lo[1]; j <= a.hi[1]; ++j)
+                for (auto k = a.lo[2]; k <= a.hi[2]; ++k) {
+                    Point x(i, j, k);
+                    auto covered = std::count_if(pieces.begin(), pieces.end(),
+                                                 [&](auto&& p) { return DS::pointInBox(x, p); });
+                    ASSERT_EQ(covered, DS::pointInBox(x, b) ? 0 : 1);
+                }
+    }
+};
+
+TEST_F(BoxSubtractTest, Disjoint) {
+    Box a {{0, 0, 0}, {3, 3, 3}}, b {{4, 0, 0}, {7, 3, 3}};
+    auto pieces = DS::boxSubtract(a, b);
+    ASSERT_EQ(pieces.size(), 1u);
+    ASSERT_EQ(pieces[0], a);
+    check(a, b);
+}
+
+TEST_F(BoxSubtractTest, Nested) {
+    Box a {{0, 0, 0}, {9, 9, 9}}, b {{3, 4, 5}, {5, 6, 7}};
+    ASSERT_EQ(DS::boxSubtract(a, b).size(), 6u);
+    check(a, b);
+}
+
+TEST_F(BoxSubtractTest, PartialOverlap) {
+    // b covers a corner of a
+    check(Box {{0, 0, 0}, {5, 5, 5}}, Box {{3, 3, 3}, {8, 8, 8}});
+    // b cuts through a along dim 1
+    check(Box {{0, 0, 0}, {5, 5, 5}}, Box {{-2, 2, -2}, {8, 3, 8}});
+    // b covers one face of a
+    check(Box {{0, 0, 0}, {5, 5, 5}}, Box {{0, 0, 4}, {5, 5, 9}});
+}
+
+TEST_F(BoxSubtractTest, Empty) {
+    Box a {{2, 2, 2}, {4, 4, 4}};
+    ASSERT_TRUE(DS::boxSubtract(a, a).empty());
+    ASSERT_TRUE(DS::boxSubtract(a, Box {{0, 0, 0}, {9, 9, 9}}).empty());
+}
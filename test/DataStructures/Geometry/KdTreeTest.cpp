@@ -0,0 +1,79 @@
+// ----------------------------------------------------------------------------
+//
+// Copyright (c) 2019 - 2026 by the OpFlow developers
+//
+// This file is part of OpFlow.
+//
+// OpFlow is free software and is distributed under the MPL v2.0 license.
+// The full text of the license can be found in the file LICENSE at the top
+// level directory of OpFlow.
+//
+// ----------------------------------------------------------------------------
+
+#include <OpFlow>
+#include <gmock/gmock.h>
+#include <random>
+
+using namespace OpFlow;
+
+class KdTreeTest : public testing::Test {
+protected:
+    using Point = DS::Point<int, 3>;
+    using Box = DS::Box<int, 3>;
+
+    void SetUp() override {
+        std::mt19937 gen(42);
+        std::uniform_int_distribution<int> dist(0, 63);
+        // many duplicated coordinates to stress the median split
+        for (auto i = 0; i < 20000; ++i) points.emplace_back(dist(gen), dist(gen), dist(gen) / 8);
+        tree = DS::KdTree<Point, Box>(points);
+    }
+
+    std::size_t bruteCount(const Box& box) const {
+        return std::count_if(points.begin(), points.end(), [&](auto&& p) { return DS::pointInBox(p, box); });
+    }
+
+    std::vector<Point> points;
+    DS::KdTree<Point, Box> tree;
+};
+
+TEST_F(KdTreeTest, Count) {
+    ASSERT_EQ(std::size_t(tree.count()), points.size());
+    auto bbox = tree.boundingBox();
+    ASSERT_EQ(std::size_t(tree.countInBox(bbox)), points.size());
+}
+
+TEST_F(KdTreeTest, CountInBox) {
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<int> dist(0, 63);
+    for (auto k = 0; k < 100; ++k) {
+        Box box;
+        for (auto i = 0; i < 3; ++i) {
+            auto a = dist(gen), b = dist(gen);
+            box.lo[i] = std::min(a, b);
+            box.hi[i] = std::max(a, b);
+        }
+        ASSERT_EQ(std::size_t(tree.countInBox(box)), bruteCount(box));
+        ASSERT_EQ(tree.getPointsInBox(box).size(), bruteCount(box));
+    }
+}
+
+TEST_F(KdTreeTest, PointsPreserved) {
+    auto p = tree.getPoints();
+    std::sort(p.begin(), p.end());
+    std::sort(points.begin(), points.end());
+    ASSERT_TRUE(p == points);
+}
+
+TEST_F(KdTreeTest, BoundingBoxInBox) {
+    Box box {{10, 10, 1}, {40, 30, 5}};
+    Box expect;
+    int counter = 0;
+    for (const auto& p : points) {
+        if (!DS::pointInBox(p, box)) continue;
+        if (counter++ == 0) expect = Box {p.cord, p.cord};
+        else
+            expect = DS::boxMerge(expect, Box {p.cord, p.cord});
+    }
+    ASSERT_EQ(tree.boundingBoxInBox(box), expect);
+}
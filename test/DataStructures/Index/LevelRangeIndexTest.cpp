@@ -0,0 +1,132 @@
+// ----------------------------------------------------------------------------
+//
+// Copyright (c) 2019 - 2026 by the OpFlow developers
+//
+// This file is part of OpFlow.
+//
+// OpFlow is free software and is distributed under the MPL v2.0 license.
+// The full text of the license can be found in the file LICENSE at the top
+// level directory of OpFlow.
+//
+// ----------------------------------------------------------------------------
+
+#include <OpFlow>
+#include <gmock/gmock.h>
+#include <random>
+
+using namespace OpFlow;
+
+class LevelRangeIndexTest : public testing::Test {
+protected:
+    using Range = DS::LevelRange<2>;
+
+    static Range make(int level, std::array<int, 2> start, std::array<int, 2> end) {
+        Range ret(start, end);
+        ret.level = level;
+        return ret;
+    }
+
+    // reference result: all positions of ranges intersecting with r
+    static std::vector<int> bruteQuery(const std::vector<Range>& ranges, const Range& r) {
+        std::vector<int> ret;
+        if (r.empty()) return ret;
+        for (std::size_t k = 0; k < ranges.size(); ++k)
+            if (DS::intersectRange(ranges[k], r)) ret.push_back((int) k);
+        return ret;
+    }
+
+    static void checkAgainstBrute(const std::vector<Range>& ranges, const Range& r) {
+        DS::LevelRangeIndex<2> index(ranges);
+        ASSERT_EQ(index.query(r), bruteQuery(ranges, r)) << r.toString();
+        // the callback version reports each hit exactly once
+        std::vector<int> visits;
+        index.query(r, [&](int k) { visits.push_back(k); });
+        std::sort(visits.begin(), visits.end());
+        ASSERT_EQ(visits, bruteQuery(ranges, r)) << r.toString();
+    }
+
+    // the patches of two levels with refinement ratio 2; the level 1 patches refine parts of level 0
+    std::vector<Range> level0 {make(0, {0, 0}, {8, 8}), make(0, {8, 0}, {16, 8}), make(0, {0, 8}, {16, 16})};
+    std::vector<Range> level1 {make(1, {2, 2}, {10, 6}), make(1, {12, 2}, {20, 10}),
+                               make(1, {4, 20}, {28, 28}), make(1, {10, 10}, {14, 14})};
+};
+
+TEST_F(LevelRangeIndexTest, DefaultIsEmpty) {
+    DS::LevelRangeIndex<2> index;
+    ASSERT_EQ(index.size(), 0u);
+    ASSERT_TRUE(index.query(make(0, {0, 0}, {100, 100})).empty());
+}
+
+TEST_F(LevelRangeIndexTest, EmptyLevel) {
+    DS::LevelRangeIndex<2> index(std::vector<Range> {});
+    ASSERT_EQ(index.size(), 0u);
+    ASSERT_TRUE(index.query(make(1, {-10, -10}, {10, 10})).empty());
+    // rebuilding a non-empty index with an empty level drops all previous ranges
+    index.build(level1);
+    ASSERT_EQ(index.size(), level1.size());
+    index.build({});
+    ASSERT_EQ(index.size(), 0u);
+    ASSERT_TRUE(index.query(make(1, {0, 0}, {32, 32})).empty());
+}
+
+TEST_F(LevelRangeIndexTest, EmptyQuery) {
+    DS::LevelRangeIndex<2> index(level0);
+    ASSERT_TRUE(index.query(make(0, {4, 4}, {4, 8})).empty());
+    ASSERT_TRUE(index.query(make(0, {6, 6}, {2, 2})).empty());
+}
+
+TEST_F(LevelRangeIndexTest, EndIsExclusive) {
+    DS::LevelRangeIndex<2> index(level0);
+    // a range starting at the end of a patch only touches its neighbors
+    ASSERT_EQ(index.query(make(0, {8, 0}, {9, 1})), std::vector<int> {1});
+    ASSERT_EQ(index.query(make(0, {7, 7}, {8, 8})), std::vector<int> {0});
+    ASSERT_EQ(index.query(make(0, {7, 7}, {9, 9})), (std::vector<int> {0, 1, 2}));
+    // ranges at or beyond the end of the bounding box hit nothing
+    ASSERT_TRUE(index.query(make(0, {16, 0}, {20, 16})).empty());
+    ASSERT_TRUE(index.query(make(0, {0, 16}, {16, 20})).empty());
+    ASSERT_TRUE(index.query(make(0, {-4, -4}, {0, 16})).empty());
+    // the last cell of the bounding box is still found
+    ASSERT_EQ(index.query(make(0, {15, 15}, {16, 16})), std::vector<int> {2});
+}
+
+TEST_F(LevelRangeIndexTest, ZeroExtentAtEnd) {
+    // a patch of zero extent lying on the end of the bounding box must not fall out of the bins
+    std::vector<Range> ranges {make(0, {0, 0}, {4, 4}), make(0, {4, 1}, {4, 3})};
+    checkAgainstBrute(ranges, make(0, {3, 0}, {6, 6}));
+    checkAgainstBrute(ranges, make(0, {0, 0}, {4, 4}));
+}
+
+TEST_F(LevelRangeIndexTest, AcrossLevels) {
+    DS::LevelRangeIndex<2> index0(level0), index1(level1);
+    // the fine patches overlapped by each coarse patch, found by querying with the refined coarse patch
+    for (const auto& r : level0) {
+        auto refined = make(1, {r.start[0] * 2, r.start[1] * 2}, {r.end[0] * 2, r.end[1] * 2});
+        ASSERT_EQ(index1.query(refined), bruteQuery(level1, refined));
+    }
+    ASSERT_EQ(index1.query(make(1, {0, 0}, {16, 16})), (std::vector<int> {0, 1, 3}));
+    ASSERT_EQ(index1.query(make(1, {16, 0}, {32, 16})), std::vector<int> {1});
+    ASSERT_EQ(index1.query(make(1, {0, 16}, {32, 32})), std::vector<int> {2});
+    // and the coarse parents of each fine patch, found by querying with the coarsened fine patch
+    for (const auto& r : level1) {
+        auto coarsened = make(0, {r.start[0] / 2, r.start[1] / 2}, {(r.end[0] + 1) / 2, (r.end[1] + 1) / 2});
+        ASSERT_EQ(index0.query(coarsened), bruteQuery(level0, coarsened));
+    }
+    ASSERT_EQ(index0.query(make(0, {6, 1}, {10, 5})), (std::vector<int> {0, 1}));
+}
+
+TEST_F(LevelRangeIndexTest, MatchesBruteForce) {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> pos(-50, 50), ext(0, 12);
+    for (auto trial = 0; trial < 10; ++trial) {
+        // includes degenerated patches of zero extent
+        std::vector<Range> ranges;
+        for (auto k = 0; k < 40; ++k) {
+            std::array<int, 2> start {pos(gen), pos(gen)};
+            ranges.push_back(make(2, start, {start[0] + ext(gen), start[1] + ext(gen)}));
+        }
+        for (auto q = 0; q < 50; ++q) {
+            std::array<int, 2> start {pos(gen), pos(gen)};
+            checkAgainstBrute(ranges, make(2, start, {start[0] + 2 * ext(gen), start[1] + 2 * ext(gen)}));
+        }
+    }
+}
@@ -0,0 +1,214 @@
+//  ----------------------------------------------------------------------------
+//
+//  Copyright (c) 2019 - 2026 by the OpFlow developers
+//
+//  This file is part of OpFlow.
+//
+//  OpFlow is free software and is distributed under the MPL v2.0 license.
+//  The full text of the license can be found in the file LICENSE at the top
+//  level directory of OpFlow.
+//
+//  ----------------------------------------------------------------------------
+
+#include <OpFlow>
+#include <gmock/gmock.h>
+
+using namespace OpFlow;
+
+class CheckpointTest : public virtual ::testing::Test {
+public:
+    CheckpointTest() = default;
+    ~CheckpointTest() override = default;
+
+    void SetUp() override {
+        std::filesystem::remove_all(root);
+        // a stretched mesh, as the restored fields are checked against the saved coordinates
+        m = MeshBuilder<Mesh>()
+                    .newMesh(49, 25, 9)
+                    .setMeshOfDim(0, [](int i) { return std::pow(i / 48., 1.5) * 2.; })
+                    .setMeshOfDim(1, 0., 1.)
+                    .setMeshOfDim(2, 0., 0.5)
+                    .build();
+        u = ExprBuilder<Field>()
+                    .setName("u")
+                    .setMesh(m)
+                    .setLoc(LocOnMesh::Center)
+                    .setBC(0, DimPos::start, BCType::Dirc, 1.)
+                    .setBC(0, DimPos::end, BCType::Dirc, 2.)
+                    .setBC(1, DimPos::start, BCType::Neum, 0.)
+                    .setBC(1, DimPos::end, BCType::Neum, 0.)
+                    .setBC(2, DimPos::start, BCType::Dirc, 0.)
+                    .setBC(2, DimPos::end, BCType::Dirc, 0.)
+                    .build();
+        // v has logical BCs, which carry no values to restore
+        v = ExprBuilder<Field>()
+                    .setName("v")
+                    .setMesh(m)
+                    .setLoc(LocOnMesh::Center)
+                    .setBC(0, DimPos::start, BCType::Periodic)
+                    .setBC(0, DimPos::end, BCType::Periodic)
+                    .setBC(1, DimPos::start, BCType::Neum, 0.)
+                    .setBC(1, DimPos::end, BCType::Neum, 0.)
+                    .setBC(2, DimPos::start, BCType::Dirc, 0.)
+                    .setBC(2, DimPos::end, BCType::Dirc, 0.)
+                    .build();
+        u.initBy([](auto&& x) { return std::exp(-x[0]) * (1. + x[1] * x[2]); });
+        v.initBy([](auto&& x) { return std::cos(PI * x[0]) + 10. * x[1] - x[2]; });
+    }
+
+    void TearDown() override { std::filesystem::remove_all(root); }
+
+    using Mesh = CartesianMesh<Meta::int_<3>>;
+    using Field = CartesianField<double, Mesh>;
+    std::filesystem::path root = "./ckpt_test";
+    Mesh m;
+    Field u, v;
+};
+
+TEST_F(CheckpointTest, RoundTrip) {
+    auto backup = u;
+    {
+        Utils::CheckpointManager ckpt(root);
+        ckpt.add(u);
+        ASSERT_EQ(ckpt.save(Utils::TimeStamp(0.5, 10)), 0);
+    }
+    u = 0.;
+    *u.bc[0].start = ConstDircBC<Field>(0.);
+    Utils::CheckpointManager ckpt(root);
+    ckpt.add(u);
+    ASSERT_EQ(ckpt.latest(), 0);
+    auto t = ckpt.restore();
+    ASSERT_EQ(t.time, 0.5);
+    ASSERT_EQ(t.step.value(), 10);
+    ASSERT_EQ(u.bc[0].start->evalAt(DS::MDIndex<3>()), 1.);
+    rangeFor_s(u.localRange, [&](auto&& i) { ASSERT_EQ(u[i], backup[i]); });
+}
+
+TEST_F(CheckpointTest, Aggregated) {
+    auto bu = u, bv = v;
+    Utils::CheckpointManager ckpt(root);
+    ckpt.setIOMode(Utils::CheckpointIO::Aggregated);
+    ckpt.add(u).add(v);
+    ckpt.save(Utils::TimeStamp(0.));
+    u = 0.;
+    v = 0.;
+    ckpt.restore(0);
+    rangeFor_s(u.localRange, [&](auto&& i) {
+        ASSERT_EQ(u[i], bu[i]);
+        ASSERT_EQ(v[i], bv[i]);
+    });
+}
+
+TEST_F(CheckpointTest, Incremental) {
+    Utils::CheckpointManager ckpt(root);
+    ckpt.setIncremental(true);
+    ckpt.add(u).add(v);
+    ckpt.save(Utils::TimeStamp(0.));
+    auto full = ckpt.getLastWrittenBytes();
+    u = u + 1.;
+    auto bu = u, bv = v;
+    ASSERT_EQ(ckpt.save(Utils::TimeStamp(1.)), 1);
+    // v is unchanged & only refers to the first checkpoint
+    ASSERT_LT(ckpt.getLastWrittenBytes(), full * 3 / 4);
+    u = 0.;
+    v = 0.;
+    ckpt.restore();
+    rangeFor_s(u.localRange, [&](auto&& i) {
+        ASSERT_EQ(u[i], bu[i]);
+        ASSERT_EQ(v[i], bv[i]);
+    });
+}
+
+TEST_F(CheckpointTest, IncompleteIgnored) {
+    Utils::CheckpointManager ckpt(root);
+    ckpt.add(u);
+    ckpt.save(Utils::TimeStamp(0.));
+    ckpt.save(Utils::TimeStamp(1.));
+    std::filesystem::remove(root / "ckpt_1" / "meta.bin");
+    ASSERT_EQ(ckpt.latest(), 0);
+    ASSERT_EQ(ckpt.restore().time, 0.);
+}
+
+TEST_F(CheckpointTest, SolverData) {
+    std::vector<double> x(100), backup;
+    std::iota(x.begin(), x.end(), 0.);
+    backup = x;
+    Utils::CheckpointManager ckpt(root);
+    ckpt.add("x", x);
+    ckpt.save(Utils::TimeStamp(0.));
+    x.clear();
+    ckpt.restore();
+    ASSERT_EQ(x, backup);
+}
+
+class CheckpointAMRTest : public virtual ::testing::Test {
+public:
+    using Mesh = CartesianAMRMesh<Meta::int_<2>>;
+    using Field = CartAMRField<double, Mesh>;
+
+    void SetUp() override { std::filesystem::remove_all(root); }
+
+    void TearDown() override { std::filesystem::remove_all(root); }
+
+    static Field build(int max_level) {
+        int n = 9, ratio = 2;
+        double h = 1. / (n - 1);
+        auto m = MeshBuilder<Mesh>()
+                         .setBaseMesh(MeshBuilder<CartesianMesh<Meta::int_<2>>>()
+                                              .newMesh(n, n)
+                                              .setMeshOfDim(0, 0., 1.)
+                                              .setMeshOfDim(1, 0., 1.)
+                                              .build())
+                         .setRefinementRatio(ratio)
+                         .setFillRateThreshold(0.8)
+                         .setSlimThreshold(3)
+                         .setMaxLevel(max_level)
+                         .setBuffWidth(1)
+                         .setMarkerFunction([=](auto&& i) {
+                             double ht = h / Math::int_pow(ratio, i.l);
+                             double x = ht * (i[0] + .5) - .5, y = ht * (i[1] + .5) - .5;
+                             return x * x + y * y < .04;
+                         })
+                         .build();
+        auto f = ExprBuilder<Field>()
+                         .setMesh(m)
+                         .setName("u")
+                         .setLoc({LocOnMesh::Center, LocOnMesh::Center})
+                         .setBC(0, DimPos::start, BCType::Dirc, 0.)
+                         .setBC(0, DimPos::end, BCType::Dirc, 0.)
+                         .setBC(1, DimPos::start, BCType::Dirc, 0.)
+                         .setBC(1, DimPos::end, BCType::Dirc, 0.)
+                         .build();
+        f.initBy([](auto&& x) { return std::sin(3 * x[0]) + x[1]; });
+        return f;
+    }
+
+    // save a field with \p saved levels & restart a field built with \p restored levels from it
+    void restart(int saved, int restored) {
+        auto u = build(saved);
+        {
+            Utils::CheckpointManager ckpt(root);
+            ckpt.add(u);
+            ckpt.save(Utils::TimeStamp(0.));
+        }
+        auto r = build(restored);
+        ASSERT_NE(r.getLevels(), u.getLevels());
+        Utils::CheckpointManager ckpt(root);
+        ckpt.add(r);
+        ckpt.restore();
+        ASSERT_EQ(r.getLevels(), u.getLevels());
+        for (auto l = 0; l < u.getLevels(); ++l) {
+            ASSERT_EQ(r.getPartsOnLevel(l), u.getPartsOnLevel(l));
+            for (auto p = 0; p < u.getPartsOnLevel(l); ++p) {
+                ASSERT_EQ(r.localRanges[l][p], u.localRanges[l][p]);
+                rangeFor_s(u.localRanges[l][p], [&](auto&& i) { ASSERT_EQ(r[i], u[i]); });
+            }
+        }
+    }
+
+    std::filesystem::path root = "./ckpt_amr_test";
+};
+
+TEST_F(CheckpointAMRTest, RestartWithMoreLevels) { restart(2, 1); }
+
+TEST_F(CheckpointAMRTest, RestartWithFewerLevels) { restart(1, 2); }
@@ -0,0 +1,98 @@
+//  ----------------------------------------------------------------------------
+//
+//  Copyright (c) 2019 - 2026 by the OpFlow developers
+//
+//  This file is part of OpFlow.
+//
+//  OpFlow is free software and is distributed under the MPL v2.0 license.
+//  The full text of the license can be found in the file LICENSE at the top
+//  level directory of OpFlow.
+//
+//  ----------------------------------------------------------------------------
+
+#include <OpFlow>
+#include <gmock/gmock.h>
+
+using namespace OpFlow;
+
+class CompressedStreamTest : public virtual ::testing::Test {
+public:
+    CompressedStreamTest() = default;
+    ~CompressedStreamTest() override = default;
+
+    void SetUp() override {
+        m = MeshBuilder<Mesh>()
+                    .newMesh(65, 33, 17)
+                    .setMeshOfDim(0, 0., 2.)
+                    .setMeshOfDim(1, 0., 1.)
+                    .setMeshOfDim(2, 0., 1.)
+                    .build();
+        u = ExprBuilder<Field>().setName("u").setMesh(m).setLoc(LocOnMesh::Center).build();
+        v = u;
+        v.name = "v";
+        u.initBy([](auto&& x) { return std::sin(x[0] * 3) * std::cos(x[1] * 2) + x[2] * x[2]; });
+        v.initBy([](auto&& x) { return 1e3 * x[0] - 2. * x[1] * x[2]; });
+    }
+
+    using Mesh = CartesianMesh<Meta::int_<3>>;
+    using Field = CartesianField<double, Mesh>;
+    Mesh m;
+    Field u, v;
+};
+
+TEST_F(CompressedStreamTest, Lossless) {
+    {
+        Utils::CompressedStream stream("./u.opz");
+        stream << Utils::TimeStamp(0.) << u;
+        ASSERT_GT(stream.getCompressionRatio(), 1.);
+    }
+    auto r = u;
+    r = 0.;
+    Utils::CompressedStream stream("./u.opz", StreamIn);
+    stream.moveToTime(Utils::TimeStamp(0.)) >> r;
+    rangeFor_s(u.localRange, [&](auto&& i) { ASSERT_EQ(r[i], u[i]); });
+}
+
+TEST_F(CompressedStreamTest, ErrorBounded) {
+    const double tol = 1e-4;
+    double ratio;
+    {
+        Utils::CompressedStream stream("./u.opz");
+        stream.setTolerance("u", tol);
+        stream << Utils::TimeStamp(1.) << u;
+        ratio = stream.getCompressionRatio();
+    }
+    auto r = u;
+    r = 0.;
+    Utils::CompressedStream stream("./u.opz", StreamIn);
+    stream.moveToTime(Utils::TimeStamp(1.)) >> r;
+    rangeFor_s(u.localRange, [&](auto&& i) { ASSERT_LE(std::abs(r[i] - u[i]), tol); });
+    ASSERT_GT(ratio, 4.);
+}
+
+TEST_F(CompressedStreamTest, MultipleFields) {
+    {
+        Utils::CompressedStream stream("./all.opz");
+        stream.setTolerance("v", 1e-6);
+        stream << Utils::TimeStamp(2.);
+        stream.dumpMultiple(u, v);
+    }
+    auto ru = u, rv = v;
+    ru = 0.;
+    rv = 0.;
+    Utils::CompressedStream stream("./all.opz", StreamIn);
+    stream.moveToTime(Utils::TimeStamp(2.)) >> rv >> ru;
+    rangeFor_s(u.localRange, [&](auto&& i) {
+        ASSERT_EQ(ru[i], u[i]);
+        ASSERT_LE(std::abs(rv[i] - v[i]), 1e-6);
+    });
+}
+
+TEST_F(CompressedStreamTest, IOGroup) {
+    auto group = Utils::makeIOGroup<Utils::CompressedStream>("./", StreamIn | StreamOut, u);
+    group.dump(Utils::TimeStamp(0.));
+    auto backup = u;
+    u = 0.;
+    group.read(Utils::TimeStamp(0.));
+    rangeFor_s(u.localRange, [&](auto&& i) { ASSERT_EQ(u[i], backup[i]); });
+}
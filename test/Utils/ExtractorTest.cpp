@@ -0,0 +1,90 @@
+//  ----------------------------------------------------------------------------
+//
+//  Copyright (c) 2019 - 2026 by the OpFlow developers
+//
+//  This file is part of OpFlow.
+//
+//  OpFlow is free software and is distributed under the MPL v2.0 license.
+//  The full text of the license can be found in the file LICENSE at the top
+//  level directory of OpFlow.
+//
+//  ----------------------------------------------------------------------------
+
+#include <OpFlow>
+#include <gmock/gmock.h>
+
+using namespace OpFlow;
+
+class ExtractorTest : public virtual ::testing::Test {
+public:
+    ExtractorTest() = default;
+    ~ExtractorTest() override = default;
+
+    void SetUp() override {
+        m = MeshBuilder<Mesh>()
+                    .newMesh(33, 17, 9)
+                    .setMeshOfDim(0, 0., 2.)
+                    .setMeshOfDim(1, 0., 1.)
+                    .setMeshOfDim(2, 0., 1.)
+                    .build();
+        u = ExprBuilder<Field>().setName("u").setMesh(m).setLoc(LocOnMesh::Center).build();
+        u.initBy([](auto&& x) { return 1. + 2. * x[0] - 3. * x[1] + 4. * x[2]; });
+    }
+
+    using Mesh = CartesianMesh<Meta::int_<3>>;
+    using Field = CartesianField<double, Mesh>;
+    Mesh m;
+    Field u;
+};
+
+TEST_F(ExtractorTest, Slice) {
+    auto s = Utils::makeSlice(u, 2, 3).extract();
+    ASSERT_EQ(s.getName(), "u");
+    ASSERT_EQ(s.localRange.end[0], u.accessibleRange.end[0]);
+    ASSERT_EQ(s.localRange.end[1], u.accessibleRange.end[1]);
+    ASSERT_EQ(s.localRange.end[2], 1);
+    rangeFor_s(s.localRange, [&](auto&& i) {
+        ASSERT_EQ(s[i], u.evalAt(DS::MDIndex<3>(i[0], i[1], 3)));
+        ASSERT_DOUBLE_EQ(s.getMesh().x(0, i[0]), m.x(0, i[0]) + 0.5 * m.dx(0, i[0]));
+    });
+    ASSERT_DOUBLE_EQ(s.getMesh().x(2, 0), m.x(2, 3) + 0.5 * m.dx(2, 3));
+}
+
+TEST_F(ExtractorTest, Downsample) {
+    auto d = Utils::makeDownsample(u, std::array {4, 2, 3}).setName("u_coarse").extract();
+    ASSERT_EQ(d.getName(), "u_coarse");
+    ASSERT_EQ(d.localRange.end[0], 8);
+    ASSERT_EQ(d.localRange.end[1], 8);
+    ASSERT_EQ(d.localRange.end[2], 3);
+    rangeFor_s(d.localRange, [&](auto&& i) {
+        ASSERT_EQ(d[i], u.evalAt(DS::MDIndex<3>(4 * i[0], 2 * i[1], 3 * i[2])));
+    });
+}
+
+TEST_F(ExtractorTest, Expression) {
+    auto e = u * 2.;
+    auto d = Utils::makeDownsample(e, 2).setName("e").extract();
+    rangeFor_s(d.localRange, [&](auto&& i) {
+        ASSERT_EQ(d[i], 2. * u.evalAt(DS::MDIndex<3>(2 * i[0], 2 * i[1], 2 * i[2])));
+    });
+}
+
+TEST_F(ExtractorTest, Probes) {
+    std::vector<std::array<Real, 3>> points {{0.5, 0.5, 0.5}, {1.27, 0.13, 0.71}, {0.1, 0.9, 0.2}};
+    Utils::ProbeSet probes(u, points);
+    auto values = probes.sample();
+    ASSERT_EQ(values.size(), points.size());
+    // u is linear, so it's reproduced exactly by trilinear interpolation
+    for (auto p = 0; p < points.size(); ++p)
+        ASSERT_NEAR(values[p], 1. + 2. * points[p][0] - 3. * points[p][1] + 4. * points[p][2], 1e-12);
+
+    std::filesystem::remove("./probes.dat");
+    probes.dump("./probes.dat", Utils::TimeStamp(0.));
+    probes.dump("./probes.dat", Utils::TimeStamp(1.));
+    std::ifstream is("./probes.dat");
+    std::string line;
+    int rows = 0;
+    while (std::getline(is, line))
+        if (!line.starts_with('#')) ++rows;
+    ASSERT_EQ(rows, 2);
+}
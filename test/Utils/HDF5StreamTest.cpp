@@ -107,3 +107,74 @@ TEST_F(H5RWTest, ReadAfterWriteInEqualDim) {
     istream.close();
     ASSERT_EQ(v.evalAt(DS::MDIndex<2>(2, 2)), u.evalAt(DS::MDIndex<2>(2, 2)));
 }
+
+TEST_F(H5RWTest, ReadTimeSeries) {
+    {
+        Utils::H5Stream stream("./u.rts.h5");
+        stream.setTimeSeries(true);
+        for (auto i = 0; i < 3; ++i) {
+            u[DS::MDIndex<2>(2, 2)] = i;
+            stream << Utils::TimeStamp(i) << u;
+        }
+    }
+
+    auto v = u;
+    v = 0.;
+    Utils::H5Stream istream("./u.rts.h5", StreamIn);
+    istream.moveToTime(Utils::TimeStamp(1));
+    istream >> v;
+    ASSERT_EQ(v.evalAt(DS::MDIndex<2>(2, 2)), 1.);
+    ASSERT_EQ(v.evalAt(DS::MDIndex<2>(1, 1)), u.evalAt(DS::MDIndex<2>(1, 1)));
+}
+
+TEST_F(H5RWTest, ReadCompressed) {
+    auto map = DS::MDRangeMapper<2> {u.accessibleRange};
+    rangeFor(u.assignableRange, [&](auto&& i) { u[i] = map(i); });
+    {
+        Utils::H5Stream stream("./u.rc.h5");
+        stream.setCompression(Utils::H5Filter::Deflate);
+        stream << u;
+    }
+
+    auto v = u;
+    v = 0.;
+    Utils::H5Stream istream("./u.rc.h5", StreamIn);
+    istream >> v;
+    rangeFor_s(u.localRange, [&](auto&& i) { ASSERT_EQ(v.evalAt(i), u.evalAt(i)); });
+}
+
+TEST(H5ChunkTest, ChunkSizeIsCapped) {
+    using Mesh = OpFlow::CartesianMesh<Meta::int_<2>>;
+    using Field = CartesianField<Real, Mesh>;
+    // a single rank's subdomain of 1025^2 doubles exceeds the chunk size cap
+    auto mesh = MeshBuilder<Mesh>()
+                        .newMesh(1025, 1025)
+                        .setMeshOfDim(0, 0., 1.)
+                        .setMeshOfDim(1, 0., 1.)
+                        .build();
+    auto u = ExprBuilder<Field>().setName("u").setMesh(mesh).setLoc(LocOnMesh::Corner).build();
+    u.initBy([](auto&& x) { return x[0] + 2 * x[1]; });
+    {
+        Utils::H5Stream stream("./u.chunk.h5");
+        stream.setChunked(true);
+        stream << u;
+    }
+    auto file = H5Fopen("./u.chunk.h5", H5F_ACC_RDONLY, H5P_DEFAULT);
+    ASSERT_GE(file, 0);
+    auto dataset = H5Dopen(file, "/T=0/u", H5P_DEFAULT);
+    ASSERT_GE(dataset, 0);
+    auto dcpl = H5Dget_create_plist(dataset);
+    hsize_t chunk[2];
+    ASSERT_EQ(H5Pget_chunk(dcpl, 2, chunk), 2);
+    ASSERT_LE(chunk[0] * chunk[1] * sizeof(Real), 4u << 20);
+    ASSERT_GT(chunk[0] * chunk[1] * sizeof(Real), 1u << 20);
+    H5Pclose(dcpl);
+    H5Dclose(dataset);
+    H5Fclose(file);
+
+    auto v = u;
+    v = 0.;
+    Utils::H5Stream istream("./u.chunk.h5", StreamIn);
+    istream >> v;
+    rangeFor_s(u.localRange, [&](auto&& i) { ASSERT_EQ(v.evalAt(i), u.evalAt(i)); });
+}
@@ -0,0 +1,84 @@
+//  ----------------------------------------------------------------------------
+//
+//  Copyright (c) 2019 - 2026 by the OpFlow developers
+//
+//  This file is part of OpFlow.
+//
+//  OpFlow is free software and is distributed under the MPL v2.0 license.
+//  The full text of the license can be found in the file LICENSE at the top
+//  level directory of OpFlow.
+//
+//  ----------------------------------------------------------------------------
+
+#include <OpFlow>
+#include <gmock/gmock.h>
+
+using namespace OpFlow;
+
+class RawBinaryStreamTest : public virtual ::testing::Test {
+public:
+    using Mesh = CartesianMesh<Meta::int_<2>>;
+    using Field = CartesianField<double, Mesh>;
+
+    void SetUp() override {
+        std::filesystem::remove("./uvel_0.cart");
+        std::filesystem::remove("./mask_0.cart");
+        m = MeshBuilder<Mesh>().newMesh(33, 17).setMeshOfDim(0, 0., 2.).setMeshOfDim(1, 0., 1.).build();
+    }
+
+    template <typename F = Field>
+    auto build(const std::string& name) {
+        return ExprBuilder<F>().setName(name).setMesh(m).setLoc(LocOnMesh::Center).build();
+    }
+
+    static double value(auto&& x) { return std::sin(x[0] * 3) * std::cos(x[1] * 2) + 1.; }
+
+    Mesh m;
+};
+
+TEST_F(RawBinaryStreamTest, PackedMaskRoundTrip) {
+    using Mask = CartesianField<bool, Mesh>;
+    auto mask = build<Mask>("mask");
+    mask.initBy([](auto&& x) { return value(x) > 1.; });
+    {
+        Utils::RawBinaryOStream out("./");
+        out << mask;
+    }
+    auto r = build<Mask>("mask");
+    r.initBy([](auto&&) { return false; });
+    Utils::RawBinaryIStream in("./");
+    in >> r;
+    ASSERT_EQ(r.count(), mask.count());
+    rangeFor_s(mask.localRange, [&](auto&& i) { ASSERT_EQ(bool(r[i]), bool(mask[i])); });
+#ifdef OPFLOW_HAS_MMAN_H
+    auto mapped = build<Mask>("mask");
+    Utils::MappedRawBinaryIStream mapped_in("./");
+    mapped_in >> mapped;
+    rangeFor_s(mask.localRange, [&](auto&& i) { ASSERT_EQ(bool(mapped[i]), bool(mask[i])); });
+#endif
+}
+
+#ifdef OPFLOW_HAS_MMAN_H
+TEST_F(RawBinaryStreamTest, MappedRestartWithFirstTouch) {
+    using Storage = DS::PlainTensor<double, 2, Utils::MappedAllocator<double>>;
+    using MappedField = CartesianField<double, Mesh, Storage>;
+    auto plan = getGlobalParallelPlan();
+    plan.first_touch = true;
+    setGlobalParallelPlan(plan);
+    // a 4 chars name keeps the data segment aligned for doubles, so that the pages are adopted
+    auto u = build("uvel");
+    u.initBy([](auto&& x) { return value(x); });
+    {
+        Utils::RawBinaryOStream out("./");
+        out << u;
+    }
+    auto r = build<MappedField>("uvel");
+    Utils::MappedRawBinaryIStream in("./");
+    in >> r;
+    // the adopted pages must not be overwritten by the first touch of the new storage
+    ASSERT_TRUE(Utils::MappedAllocator<double>::isMapped(&std::as_const(r)[r.localRange.first()]));
+    rangeFor_s(u.localRange, [&](auto&& i) { ASSERT_EQ(r[i], u[i]); });
+    plan.first_touch = false;
+    setGlobalParallelPlan(plan);
+}
+#endif
@@ -0,0 +1,85 @@
+//  ----------------------------------------------------------------------------
+//
+//  Copyright (c) 2019 - 2026 by the OpFlow developers
+//
+//  This file is part of OpFlow.
+//
+//  OpFlow is free software and is distributed under the MPL v2.0 license.
+//  The full text of the license can be found in the file LICENSE at the top
+//  level directory of OpFlow.
+//
+//  ----------------------------------------------------------------------------
+
+#include <OpFlow>
+#include <gmock/gmock.h>
+
+using namespace OpFlow;
+
+class ScratchPoolTest : public virtual ::testing::Test {
+public:
+    ScratchPoolTest() = default;
+    ~ScratchPoolTest() override = default;
+
+    void SetUp() override {
+        m = MeshBuilder<Mesh>()
+                    .newMesh(33, 17, 9)
+                    .setMeshOfDim(0, 0., 2.)
+                    .setMeshOfDim(1, 0., 1.)
+                    .setMeshOfDim(2, 0., 1.)
+                    .build();
+        u = ExprBuilder<Field>()
+                    .setName("u")
+                    .setMesh(m)
+                    .setLoc(LocOnMesh::Center)
+                    .setBC(0, DimPos::start, BCType::Dirc, 0.)
+                    .setBC(0, DimPos::end, BCType::Dirc, 0.)
+                    .setBC(1, DimPos::start, BCType::Dirc, 0.)
+                    .setBC(1, DimPos::end, BCType::Dirc, 0.)
+                    .setBC(2, DimPos::start, BCType::Dirc, 0.)
+                    .setBC(2, DimPos::end, BCType::Dirc, 0.)
+                    .setExt(1)
+                    .build();
+        u.initBy([](auto&& x) { return x[0] + x[1] * x[2]; });
+    }
+
+    using Mesh = CartesianMesh<Meta::int_<3>>;
+    using Field = CartesianField<double, Mesh>;
+    Mesh m;
+    Field u;
+};
+
+TEST_F(ScratchPoolTest, AliasedAssignReusesBuffer) {
+    // a stencil update of u needs a buffer for the old values of u
+    auto step = [&] { u = u + 1e-3 * d2x<D2SecondOrderCentered>(u); };
+    step();
+    auto warm = Utils::getScratchPoolStats();
+    ASSERT_EQ(warm.borrowed_bytes, 0);
+    ASSERT_GT(warm.idle_bytes, 0);
+    for (auto n = 0; n < 5; ++n) step();
+    auto s = Utils::getScratchPoolStats();
+    ASSERT_EQ(s.misses, warm.misses);
+    ASSERT_EQ(s.hits, warm.hits + 5);
+    ASSERT_EQ(s.idle_bytes, warm.idle_bytes);
+    auto ref = u;
+    ref = u + 1e-3 * d2x<D2SecondOrderCentered>(u);
+    step();
+    rangeFor_s(u.assignableRange, [&](auto&& i) { ASSERT_DOUBLE_EQ(u[i], ref[i]); });
+}
+
+TEST_F(ScratchPoolTest, ScratchCopy) {
+    auto before = Utils::getScratchPoolStats();
+    std::size_t bytes;
+    {
+        auto t = Utils::scratchCopy(u);
+        bytes = Utils::getScratchPoolStats().borrowed_bytes - before.borrowed_bytes;
+        ASSERT_GE(bytes, u.localRange.count() * sizeof(double));
+        rangeFor_s(u.localRange, [&](auto&& i) { ASSERT_EQ(t[i], u[i]); });
+        // a move keeps the buffer borrowed
+        auto moved = std::move(t);
+    }
+    auto s = Utils::getScratchPoolStats();
+    ASSERT_EQ(s.borrowed_bytes, before.borrowed_bytes);
+    ASSERT_EQ(s.idle_bytes - before.idle_bytes, bytes * (s.misses - before.misses));
+    Utils::ScratchPool<double, Utils::AlignedAllocator<double>>::trim();
+    ASSERT_EQ(Utils::getScratchPoolStats().idle_bytes, 0);
+}
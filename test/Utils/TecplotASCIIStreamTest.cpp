@@ -0,0 +1,157 @@
+//  ----------------------------------------------------------------------------
+//
+//  Copyright (c) 2019 - 2026 by the OpFlow developers
+//
+//  This file is part of OpFlow.
+//
+//  OpFlow is free software and is distributed under the MPL v2.0 license.
+//  The full text of the license can be found in the file LICENSE at the top
+//  level directory of OpFlow.
+//
+//  ----------------------------------------------------------------------------
+
+#include <OpFlow>
+#include <gmock/gmock.h>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+using namespace OpFlow;
+
+class TecplotASCIIStreamTest : public virtual ::testing::Test {
+public:
+    using Mesh = CartesianMesh<Meta::int_<2>>;
+    using Field = CartesianField<double, Mesh>;
+
+    auto build(int nx, int ny) {
+        auto m = MeshBuilder<Mesh>().newMesh(nx, ny).setMeshOfDim(0, 0., 1.).setMeshOfDim(1, 0., 2.).build();
+        auto u = ExprBuilder<Field>().setName("u").setMesh(m).setLoc(LocOnMesh::Center).build();
+        // values over many magnitudes & of both signs
+        u.initBy([](auto&& x) { return std::sin(7 * x[0]) * std::exp(10 * x[1]) - 1e-7; });
+        return u;
+    }
+
+    static std::string readFile(const std::string& name) {
+        std::ifstream is(name, std::ios::binary);
+        std::ostringstream ss;
+        ss << is.rdbuf();
+        return ss.str();
+    }
+
+    // the output of the iostream based formatter the stream used before
+    static std::string legacyFormat(const Field& f, double t) {
+        std::ostringstream os;
+        os << std::format("TITLE = \"Solution of {} \"\n", f.getName());
+        os << std::format("VARIABLES = {}, \"{}\"\n", R"("X", "Y")", f.getName());
+        os << "ZONE\n";
+        os << "ZONETYPE = ORDERED DATAPACKING = BLOCK\n";
+        os << std::format("I = {} J = {}\n", f.localRange.end[0] - f.localRange.start[0],
+                          f.localRange.end[1] - f.localRange.start[1]);
+        os << std::scientific << std::setprecision(10);
+        os << std::format("SOLUTIONTIME = {}\n", t);
+        const auto& m = f.getMesh();
+        for (auto k = 0; k < 2; ++k)
+            rangeFor_s(f.localRange,
+                       [&](auto&& i) { os << Math::mid(m.x(k, i[k]), m.x(k, i[k] + 1)) << "\n"; });
+        rangeFor_s(f.localRange, [&](auto&& i) { os << f.evalAt(i) << "\n"; });
+        return os.str();
+    }
+};
+
+TEST_F(TecplotASCIIStreamTest, MatchesLegacyFormatter) {
+    // more points than a formatting slab, so that several slabs are stitched together
+    auto u = build(301, 257);
+    std::filesystem::remove("./tec_legacy.tec");
+    {
+        Utils::TecplotASCIIStream stream("./tec_legacy.tec");
+        stream << Utils::TimeStamp(0.25) << u;
+    }
+    // compare without printing the files on failure
+    ASSERT_TRUE(readFile("./tec_legacy.tec") == legacyFormat(u, 0.25));
+}
+
+TEST_F(TecplotASCIIStreamTest, BinaryHeader) {
+    auto u = build(9, 5);
+    // an existing file at the stream's path is left alone in binary mode
+    {
+        std::ofstream keep("./tec_bin.tec");
+        keep << "keep";
+    }
+    std::filesystem::remove("./tec_bin_0.500000.plt");
+    {
+        Utils::TecplotASCIIStream stream("./tec_bin.tec");
+        stream.setBinary(true);
+        stream << Utils::TimeStamp(0.5) << u;
+    }
+    ASSERT_EQ(readFile("./tec_bin.tec"), "keep");
+
+    auto bytes = readFile("./tec_bin_0.500000.plt");
+    std::size_t pos = 0;
+    auto take = [&]<typename T>(T) {
+        T v;
+        EXPECT_LE(pos + sizeof(T), bytes.size());
+        std::memcpy(&v, bytes.data() + pos, sizeof(T));
+        pos += sizeof(T);
+        return v;
+    };
+    auto i32 = [&] { return take(int {}); };
+    auto f32 = [&] { return take(float {}); };
+    auto f64 = [&] { return take(double {}); };
+    auto str = [&] {
+        std::string s;
+        for (int c = i32(); c != 0; c = i32()) s.push_back((char) c);
+        return s;
+    };
+
+    ASSERT_EQ(bytes.substr(0, 8), "#!TDV112");
+    pos = 8;
+    ASSERT_EQ(i32(), 1);// byte order
+    ASSERT_EQ(i32(), 0);// full file
+    ASSERT_EQ(str(), "Solution of u ");
+    ASSERT_EQ(i32(), 3);
+    ASSERT_EQ(str(), "X");
+    ASSERT_EQ(str(), "Y");
+    ASSERT_EQ(str(), "u");
+    ASSERT_EQ(f32(), 299.f);
+    ASSERT_EQ(str(), "ZONE 001");
+    ASSERT_EQ(i32(), -1);
+    ASSERT_EQ(i32(), 1);
+    ASSERT_EQ(f64(), 0.5);
+    ASSERT_EQ(i32(), -1);
+    for (auto k = 0; k < 4; ++k) ASSERT_EQ(i32(), 0);
+    auto extends = u.localRange.getExtends();
+    ASSERT_EQ(i32(), extends[0]);
+    ASSERT_EQ(i32(), extends[1]);
+    ASSERT_EQ(i32(), 1);
+    ASSERT_EQ(i32(), 0);
+    ASSERT_EQ(f32(), 357.f);
+
+    // data section of doubles, block packed
+    ASSERT_EQ(f32(), 299.f);
+    for (auto k = 0; k < 3; ++k) ASSERT_EQ(i32(), 2);
+    ASSERT_EQ(i32(), 0);
+    ASSERT_EQ(i32(), 0);
+    ASSERT_EQ(i32(), -1);
+    double min[3], max[3];
+    for (auto k = 0; k < 3; ++k) {
+        min[k] = f64();
+        max[k] = f64();
+    }
+    const auto& m = u.getMesh();
+    for (auto k = 0; k < 2; ++k) {
+        ASSERT_DOUBLE_EQ(min[k], Math::mid(m.x(k, 0), m.x(k, 1)));
+        rangeFor_s(u.localRange,
+                   [&](auto&& i) { ASSERT_DOUBLE_EQ(f64(), Math::mid(m.x(k, i[k]), m.x(k, i[k] + 1))); });
+    }
+    double lo = std::numeric_limits<double>::max(), hi = std::numeric_limits<double>::lowest();
+    rangeFor_s(u.localRange, [&](auto&& i) {
+        ASSERT_EQ(f64(), u.evalAt(i));
+        lo = std::min(lo, u.evalAt(i));
+        hi = std::max(hi, u.evalAt(i));
+    });
+    ASSERT_EQ(min[2], lo);
+    ASSERT_EQ(max[2], hi);
+    ASSERT_EQ(pos, bytes.size());
+}
@@ -0,0 +1,125 @@
+//  ----------------------------------------------------------------------------
+//
+//  Copyright (c) 2019 - 2026 by the OpFlow developers
+//
+//  This file is part of OpFlow.
+//
+//  OpFlow is free software and is distributed under the MPL v2.0 license.
+//  The full text of the license can be found in the file LICENSE at the top
+//  level directory of OpFlow.
+//
+//  ----------------------------------------------------------------------------
+
+#include <OpFlow>
+#include <gmock/gmock.h>
+
+using namespace OpFlow;
+
+class TimeSeriesStreamTest : public virtual ::testing::Test {
+public:
+    using Mesh = CartesianMesh<Meta::int_<3>>;
+    using Field = CartesianField<double, Mesh>;
+
+    TimeSeriesStreamTest() = default;
+    ~TimeSeriesStreamTest() override = default;
+
+    void SetUp() override {
+        std::filesystem::remove("./u.opts");
+        std::filesystem::remove("./u.opts.idx");
+        m = MeshBuilder<Mesh>()
+                    .newMesh(33, 17, 9)
+                    .setMeshOfDim(0, 0., 2.)
+                    .setMeshOfDim(1, 0., 1.)
+                    .setMeshOfDim(2, 0., 1.)
+                    .build();
+        u = ExprBuilder<Field>().setName("u").setMesh(m).setLoc(LocOnMesh::Center).build();
+    }
+
+    // value of u at step n
+    void setStep(int n) {
+        u.initBy([&](auto&& x) { return n + std::sin(x[0] * 3) * std::cos(x[1] * 2) + x[2]; });
+    }
+
+    void expectStep(const Field& f, int n) {
+        auto ref = f;
+        ref.initBy([&](auto&& x) { return n + std::sin(x[0] * 3) * std::cos(x[1] * 2) + x[2]; });
+        rangeFor_s(f.localRange, [&](auto&& i) { ASSERT_EQ(f[i], ref[i]); });
+    }
+
+    Mesh m;
+    Field u;
+};
+
+TEST_F(TimeSeriesStreamTest, RandomAccess) {
+    {
+        Utils::TimeSeriesStream stream("./u.opts");
+        stream.fixedMesh();
+        for (auto n = 0; n < 10; ++n) {
+            setStep(n);
+            stream << Utils::TimeStamp(0.1 * n, n) << u;
+        }
+    }
+    ASSERT_EQ(std::filesystem::exists("./u_0.100000.opts"), false);
+    auto r = u;
+    Utils::TimeSeriesStream stream("./u.opts", StreamIn);
+    ASSERT_EQ(stream.getTimeStamps("u").size(), 10);
+    for (auto n : {7, 2, 9, 0}) {
+        stream.moveToTime(Utils::TimeStamp(0.1 * n)) >> r;
+        expectStep(r, n);
+    }
+    stream.setNumberingType(Utils::NumberingType::ByStep);
+    stream.moveToTime(Utils::TimeStamp(0., 5)) >> r;
+    expectStep(r, 5);
+}
+
+TEST_F(TimeSeriesStreamTest, Append) {
+    {
+        Utils::TimeSeriesStream stream("./u.opts");
+        for (auto n = 0; n < 3; ++n) {
+            setStep(n);
+            stream << Utils::TimeStamp(n) << u;
+        }
+    }
+    {
+        Utils::TimeSeriesStream stream("./u.opts");
+        stream.setAppend(true);
+        for (auto n = 3; n < 5; ++n) {
+            setStep(n);
+            stream << Utils::TimeStamp(n) << u;
+        }
+    }
+    auto r = u;
+    Utils::TimeSeriesStream stream("./u.opts", StreamIn);
+    ASSERT_EQ(stream.getTimeStamps("u").size(), 5);
+    for (auto n = 0; n < 5; ++n) {
+        stream.moveToTime(Utils::TimeStamp(n)) >> r;
+        expectStep(r, n);
+    }
+}
+
+TEST_F(TimeSeriesStreamTest, RebuildIndex) {
+    {
+        Utils::TimeSeriesStream stream("./u.opts");
+        for (auto n = 0; n < 4; ++n) {
+            setStep(n);
+            stream << Utils::TimeStamp(n) << u;
+        }
+    }
+    std::filesystem::remove("./u.opts.idx");
+    auto r = u;
+    Utils::TimeSeriesStream stream("./u.opts", StreamIn);
+    stream.moveToTime(Utils::TimeStamp(2.)) >> r;
+    expectStep(r, 2);
+}
+
+TEST_F(TimeSeriesStreamTest, IOGroup) {
+    std::filesystem::remove("./u.opts");
+    auto group = Utils::makeIOGroup<Utils::TimeSeriesStream>("./", StreamIn | StreamOut, u);
+    for (auto n = 0; n < 3; ++n) {
+        setStep(n);
+        group.dump(Utils::TimeStamp(n));
+    }
+    u = 0.;
+    group.read(Utils::TimeStamp(1.));
+    expectStep(u, 1);
+}
@@ -0,0 +1,119 @@
+//  ----------------------------------------------------------------------------
+//
+//  Copyright (c) 2019 - 2026 by the OpFlow developers
+//
+//  This file is part of OpFlow.
+//
+//  OpFlow is free software and is distributed under the MPL v2.0 license.
+//  The full text of the license can be found in the file LICENSE at the top
+//  level directory of OpFlow.
+//
+//  ----------------------------------------------------------------------------
+
+#include <OpFlow>
+#include <gmock/gmock.h>
+#ifdef OPFLOW_WITH_VTK
+#include <vtkCellData.h>
+#include <vtkDataArray.h>
+#include <vtkOverlappingAMR.h>
+#include <vtkUniformGrid.h>
+#include <vtkXMLUniformGridAMRReader.h>
+#endif
+
+using namespace OpFlow;
+
+#ifdef OPFLOW_WITH_VTK
+class VTKAMRStreamTest : public virtual ::testing::Test {
+public:
+    using Mesh = CartesianAMRMesh<Meta::int_<2>>;
+    using Field = CartAMRField<double, Mesh>;
+
+    void SetUp() override {
+        int n = 9, ratio = 2;
+        double h = 1. / (n - 1);
+        m = MeshBuilder<Mesh>()
+                    .setBaseMesh(MeshBuilder<CartesianMesh<Meta::int_<2>>>()
+                                         .newMesh(n, n)
+                                         .setMeshOfDim(0, 0., 1.)
+                                         .setMeshOfDim(1, 0., 1.)
+                                         .build())
+                    .setRefinementRatio(ratio)
+                    .setFillRateThreshold(0.8)
+                    .setSlimThreshold(3)
+                    .setMaxLevel(2)
+                    .setBuffWidth(1)
+                    .setMarkerFunction([=](auto&& i) {
+                        // refine the cells around the center
+                        double ht = h / Math::int_pow(ratio, i.l);
+                        double x = ht * (i[0] + .5) - .5, y = ht * (i[1] + .5) - .5;
+                        return x * x + y * y < .04;
+                    })
+                    .build();
+        u = ExprBuilder<Field>()
+                    .setMesh(m)
+                    .setName("u")
+                    .setLoc({LocOnMesh::Center, LocOnMesh::Center})
+                    .setBC(0, DimPos::start, BCType::Dirc, 0.)
+                    .setBC(0, DimPos::end, BCType::Dirc, 0.)
+                    .setBC(1, DimPos::start, BCType::Dirc, 0.)
+                    .setBC(1, DimPos::end, BCType::Dirc, 0.)
+                    .build();
+        u.initBy([](auto&& x) { return std::sin(3 * x[0]) + x[1]; });
+    }
+
+    // compare the cells of array \p array_name of all patches in the file with f
+    static void checkFile(const std::string& name, const Field& f, const std::string& array_name = "u") {
+        auto reader = vtkSmartPointer<vtkXMLUniformGridAMRReader>::New();
+        reader->SetFileName(name.c_str());
+        reader->SetMaximumLevelsToReadByDefault(0);
+        reader->Update();
+        auto* amr = vtkOverlappingAMR::SafeDownCast(reader->GetOutputDataObject(0));
+        ASSERT_NE(amr, nullptr);
+        ASSERT_EQ(amr->GetNumberOfLevels(), f.getLevels());
+        for (auto l = 0; l < f.getLevels(); ++l) {
+            ASSERT_EQ(amr->GetNumberOfDataSets(l), f.getPartsOnLevel(l));
+            for (auto p = 0; p < f.getPartsOnLevel(l); ++p) {
+                auto* array = amr->GetDataSet(l, p)->GetCellData()->GetArray(array_name.c_str());
+                ASSERT_NE(array, nullptr);
+                const auto& range = f.localRanges[l][p];
+                ASSERT_EQ(array->GetNumberOfTuples(), range.count());
+                auto idx = DS::LevelRangedIndex<2>(range);
+                for (auto c = 0; c < array->GetNumberOfTuples(); ++c, ++idx)
+                    ASSERT_DOUBLE_EQ(array->GetComponent(c, 0), f.evalAt(idx));
+            }
+        }
+    }
+
+    Mesh m;
+    Field u;
+};
+
+TEST_F(VTKAMRStreamTest, WriteAndReadBack) {
+    ASSERT_GT(u.getLevels(), 1);
+    Utils::VTKAMRStream stream("./vtkamr");
+    stream << Utils::TimeStamp(0) << u;
+    checkFile("./vtkamr_0.vthb", u);
+}
+
+TEST_F(VTKAMRStreamTest, SharedStorageIsWrittenUnchanged) {
+    // the copy shares the patches' storage with u until u is written to
+    auto w = u;
+    auto ref = u;
+    ref.detachStorage();
+    Utils::VTKAMRStream stream("./vtkamr_shared");
+    stream << Utils::TimeStamp(0) << w;
+    u = 0.;
+    checkFile("./vtkamr_shared_0.vthb", ref);
+    checkFile("./vtkamr_shared_0.vthb", w);
+}
+
+TEST_F(VTKAMRStreamTest, PartitionedReadBack) {
+    Utils::VTKAMRStream stream("./vtkamr_part");
+    stream.setPartitioned(true);
+    stream << Utils::TimeStamp(0) << u + 1.;
+    auto v = u;
+    v = u + 1.;
+    // expressions are evaluated into cell buffers instead of handing over the storage
+    checkFile("./vtkamr_part_0.vthb", v, "u + 1");
+}
+#endif